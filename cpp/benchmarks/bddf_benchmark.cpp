@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Writes a BDDF file of the given size with a series of 1 MiB images and two series of small
+// messages, then measures opening it, FindBlock(), reading every image and verifying the checksum.
+//
+// Usage: bddf_benchmark [size in MiB, default 1024] [path, default bddf_benchmark.bddf]
+// The file is removed afterwards. Pass a size of a few GiB to reproduce multi-GB numbers; the
+// read numbers depend on whether the file is still in the page cache.
+
+#include <bosdyn/api/geometry.pb.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "benchmark_util.h"
+#include "bosdyn/bddf/data_reader.h"
+#include "bosdyn/bddf/data_writer.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::benchmarks::SecondsSince;
+
+namespace {
+
+constexpr size_t kImageBytes = 1 << 20;
+constexpr int64_t kImagePeriodNsec = 100'000'000;
+// Small messages written per image.
+constexpr int kMessagesPerImage = 30;
+
+::bosdyn::api::SeriesIdentifier Identifier(const std::string& name) {
+    ::bosdyn::api::SeriesIdentifier identifier;
+    identifier.set_series_type("bosdyn:grpc:requests");
+    (*identifier.mutable_spec())["service"] = name;
+    return identifier;
+}
+
+bool Check(const ::bosdyn::common::Status& status, const char* what) {
+    if (!status) std::printf("%s failed: %s\n", what, status.DebugString().c_str());
+    return static_cast<bool>(status);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t size_bytes = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024) << 20;
+    const std::string path = argc > 2 ? argv[2] : "bddf_benchmark.bddf";
+    const size_t num_images = std::max<uint64_t>(1, size_bytes / kImageBytes);
+
+    std::string image(kImageBytes, '\0');
+    for (size_t i = 0; i < image.size(); ++i) image[i] = static_cast<char>(i * 2654435761u >> 24);
+    ::bosdyn::api::SE3Pose pose;
+    pose.mutable_position()->set_x(1.0);
+    pose.mutable_rotation()->set_w(1.0);
+
+    PrintHeader("BDDF file with " + std::to_string(num_images) + " images of 1 MiB");
+    {
+        ::bosdyn::bddf::DataWriter writer;
+        uint32_t images = 0, poses = 0, commands = 0;
+        if (!Check(writer.Open(path), "Open") ||
+            !Check(writer.AddPodSeries(Identifier("image"), ::bosdyn::api::TYPE_UINT8,
+                                       {kImageBytes}, &images),
+                   "AddPodSeries") ||
+            !Check(writer.AddProtobufSeries(Identifier("pose"), "bosdyn.api.SE3Pose", &poses),
+                   "AddProtobufSeries") ||
+            !Check(writer.AddProtobufSeries(Identifier("command"), "bosdyn.api.SE3Pose",
+                                            &commands),
+                   "AddProtobufSeries")) {
+            return 1;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < num_images; ++i) {
+            const int64_t timestamp = static_cast<int64_t>(i) * kImagePeriodNsec;
+            image[0] = static_cast<char>(i);
+            if (!Check(writer.WriteData(images, timestamp, image.data(), image.size()),
+                       "WriteData")) {
+                return 1;
+            }
+            for (int j = 0; j < kMessagesPerImage; ++j) {
+                const int64_t message_timestamp =
+                    timestamp + j * (kImagePeriodNsec / kMessagesPerImage);
+                pose.mutable_position()->set_y(j);
+                if (!Check(writer.WriteMessage(j % 2 ? poses : commands, message_timestamp, pose),
+                           "WriteMessage")) {
+                    return 1;
+                }
+            }
+        }
+        if (!Check(writer.Close(), "Close")) return 1;
+        const double seconds = SecondsSince(start);
+        PrintResult("write with checksum", writer.bytes_written() / seconds / 1e6, "MB/s");
+    }
+
+    ::bosdyn::bddf::DataReader reader;
+    auto start = std::chrono::steady_clock::now();
+    if (!Check(reader.Open(path), "Open")) return 1;
+    PrintResult("open", SecondsSince(start) * 1e3, "ms");
+    reader.Close();
+    PrintResult("open, repeated", NsPerCall([&reader, &path]() {
+                    auto status = reader.Open(path);
+                    DoNotOptimize(status);
+                    reader.Close();
+                }) / 1e6,
+                "ms");
+    if (!Check(reader.Open(path), "Open")) return 1;
+
+    uint32_t poses = 0;
+    reader.FindSeries(Identifier("pose"), &poses);
+    std::mt19937_64 random(1);
+    const int64_t end_nsec = static_cast<int64_t>(num_images) * kImagePeriodNsec;
+    PrintResult("FindBlock in " + std::to_string(reader.NumBlocks(poses)) + " blocks",
+                NsPerCall([&]() {
+                    DoNotOptimize(reader.FindBlock(poses, random() % end_nsec));
+                }),
+                "ns/call");
+
+    uint32_t images = 0;
+    reader.FindSeries(Identifier("image"), &images);
+    start = std::chrono::steady_clock::now();
+    uint64_t checksum = 0;
+    auto status = reader.ForEachBlock(images, 0, end_nsec,
+                                      [&checksum](const ::bosdyn::bddf::DataBlock& block) {
+                                          for (size_t i = 0; i < block.data.size(); i += 4096) {
+                                              checksum += static_cast<uint8_t>(block.data[i]);
+                                          }
+                                          return true;
+                                      });
+    if (!Check(status, "ForEachBlock")) return 1;
+    DoNotOptimize(checksum);
+    PrintResult("read every image page", num_images * kImageBytes / SecondsSince(start) / 1e6,
+                "MB/s");
+
+    start = std::chrono::steady_clock::now();
+    if (!Check(reader.VerifyChecksum(), "VerifyChecksum")) return 1;
+    PrintResult("verify checksum", num_images * kImageBytes / SecondsSince(start) / 1e6, "MB/s");
+
+    reader.Close();
+    std::remove(path.c_str());
+    return 0;
+}
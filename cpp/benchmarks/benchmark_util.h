@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace bosdyn {
+
+namespace benchmarks {
+
+// Keep the compiler from optimizing away the computation of value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+inline double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Call fn repeatedly for at least min_seconds, after one warm-up call, and return the mean time
+// of a call in nanoseconds.
+template <typename Fn>
+double NsPerCall(Fn&& fn, double min_seconds = 0.5) {
+    fn();
+    uint64_t iterations = 1;
+    while (true) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) fn();
+        const double elapsed = SecondsSince(start);
+        if (elapsed >= min_seconds) return elapsed * 1e9 / static_cast<double>(iterations);
+        // Aim a little past min_seconds, growing at most 100x per round.
+        const double scale = elapsed > 0 ? 1.2 * min_seconds / elapsed : 100.0;
+        iterations = static_cast<uint64_t>(static_cast<double>(iterations) *
+                                           std::min(std::max(scale, 2.0), 100.0));
+    }
+}
+
+struct LatencySummary {
+    size_t count = 0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Percentiles of the given samples, by nearest rank.
+inline LatencySummary Summarize(std::vector<double> samples) {
+    LatencySummary summary;
+    summary.count = samples.size();
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&samples](double percentile) {
+        const size_t index = static_cast<size_t>(percentile * static_cast<double>(samples.size()));
+        return samples[std::min(index, samples.size() - 1)];
+    };
+    summary.p50 = rank(0.50);
+    summary.p90 = rank(0.90);
+    summary.p99 = rank(0.99);
+    summary.max = samples.back();
+    return summary;
+}
+
+// A command line parameter for a header, without trailing zeros, e.g. "2" or "0.5".
+inline std::string FormatNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%g", value);
+    return text;
+}
+
+// Number of threads of the process, or -1 where /proc is not available.
+inline int NumProcessThreads() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) return std::atoi(line.c_str() + 8);
+    }
+    return -1;
+}
+
+inline void PrintHeader(const std::string& title) { std::printf("\n== %s ==\n", title.c_str()); }
+
+inline void PrintResult(const std::string& name, double value, const char* unit) {
+    std::printf("  %-52s %12.2f %s\n", name.c_str(), value, unit);
+}
+
+inline void PrintLatency(const std::string& name, const LatencySummary& summary,
+                         const char* unit) {
+    std::printf("  %-36s n=%-7zu p50 %9.3f  p90 %9.3f  p99 %9.3f  max %9.3f %s\n", name.c_str(),
+                summary.count, summary.p50, summary.p90, summary.p99, summary.max, unit);
+}
+
+}  // namespace benchmarks
+
+}  // namespace bosdyn
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Cost of reading the clock and of converting Timestamp protos, on 1 thread and on N contending
+// threads. The "shared_ptr clock" case is the previous NowNsec(), which loaded a
+// std::shared_ptr<ClockFn> atomically on every call, and the TimeUtil cases are the previous
+// conversions.
+
+#include <google/protobuf/util/time_util.h>
+
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "bosdyn/common/time.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using google::protobuf::util::TimeUtil;
+
+namespace {
+
+std::shared_ptr<::bosdyn::common::ClockFn> g_shared_clock =
+    std::make_shared<::bosdyn::common::ClockFn>([]() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch());
+    });
+
+int64_t SharedPtrNowNsec() {
+    auto fn_shared = std::atomic_load_explicit(&g_shared_clock, std::memory_order_acquire);
+    return (*fn_shared)().count();
+}
+
+// Mean ns per call of fn, with num_threads threads calling it at the same time.
+template <typename Fn>
+double ConcurrentNsPerCall(int num_threads, const Fn& fn) {
+    std::vector<double> results(num_threads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&results, &fn, i]() { results[i] = NsPerCall(fn); });
+    }
+    for (auto& thread : threads) thread.join();
+    double total = 0.0;
+    for (double result : results) total += result;
+    return total / num_threads;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int num_threads = argc > 1 ? std::atoi(argv[1]) : 16;
+    const std::string threads = std::to_string(num_threads) + " threads";
+
+    auto now_nsec = []() { DoNotOptimize(::bosdyn::common::NowNsec()); };
+    auto shared_now_nsec = []() { DoNotOptimize(SharedPtrNowNsec()); };
+
+    PrintHeader("Reading the clock");
+    PrintResult("shared_ptr clock, 1 thread", NsPerCall(shared_now_nsec), "ns/call");
+    PrintResult("shared_ptr clock, " + threads, ConcurrentNsPerCall(num_threads, shared_now_nsec),
+                "ns/call");
+    PrintResult("NowNsec, 1 thread", NsPerCall(now_nsec), "ns/call");
+    PrintResult("NowNsec, " + threads, ConcurrentNsPerCall(num_threads, now_nsec), "ns/call");
+    ::bosdyn::common::SetClock([]() { return std::chrono::nanoseconds(1234); });
+    PrintResult("NowNsec with SetClock override, 1 thread", NsPerCall(now_nsec), "ns/call");
+    PrintResult("NowNsec with SetClock override, " + threads,
+                ConcurrentNsPerCall(num_threads, now_nsec), "ns/call");
+    ::bosdyn::common::RestoreDefaultClock();
+
+    PrintHeader("Timestamp conversion");
+    ::google::protobuf::Timestamp timestamp;
+    ::bosdyn::common::SetTimestamp(::bosdyn::common::NowNsec(), &timestamp);
+    int64_t nsec = ::bosdyn::common::NowNsec();
+    PrintResult("TimeUtil::TimestampToNanoseconds", NsPerCall([&timestamp]() {
+                    DoNotOptimize(TimeUtil::TimestampToNanoseconds(timestamp));
+                }),
+                "ns/call");
+    PrintResult("TimestampToNsec", NsPerCall([&timestamp]() {
+                    DoNotOptimize(::bosdyn::common::TimestampToNsec(timestamp));
+                }),
+                "ns/call");
+    PrintResult("TimeUtil::NanosecondsToTimestamp", NsPerCall([&nsec, &timestamp]() {
+                    timestamp = TimeUtil::NanosecondsToTimestamp(++nsec);
+                    DoNotOptimize(timestamp);
+                }),
+                "ns/call");
+    PrintResult("SetTimestamp", NsPerCall([&nsec, &timestamp]() {
+                    ::bosdyn::common::SetTimestamp(++nsec, &timestamp);
+                    DoNotOptimize(timestamp);
+                }),
+                "ns/call");
+    return 0;
+}
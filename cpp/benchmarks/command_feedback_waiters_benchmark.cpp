@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// RobotCommandFeedback RPCs issued while N waiters wait for robot commands to finish, against a
+// stand-in RobotCommandService on localhost that takes a fixed time to answer. Compares one
+// blocking feedback loop and thread per waiter, as the BlockUntil helpers used to run, with
+// CommandFeedbackTracker. The waiters are split into arm and gripper waits on N/2 synchronized
+// commands, as for a synchronized arm and gripper command, and then spread over N commands. Also
+// reports how long after its command finished each wait completed, and the threads the process
+// added, which include those gRPC starts for its own use.
+//
+// Usage: command_feedback_waiters_benchmark [max waiters, default 128] [server delay in ms,
+//                                           default 20]
+
+#include <bosdyn/api/robot_command_service.grpc.pb.h>
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "local_server.h"
+#include "bosdyn/client/robot_command/command_feedback_tracker.h"
+#include "bosdyn/client/robot_command/robot_command_helpers.h"
+
+using bosdyn::benchmarks::LocalServer;
+using bosdyn::benchmarks::NumProcessThreads;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintLatency;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::benchmarks::Summarize;
+
+namespace {
+
+constexpr auto kPollPeriod = std::chrono::milliseconds(100);
+
+// Answers feedback for the commands it was told about, reporting the arm and the gripper still
+// moving until the command's finish time and at their goals after.
+class FakeRobotCommandService : public ::bosdyn::api::RobotCommandService::Service {
+ public:
+    explicit FakeRobotCommandService(std::chrono::microseconds delay) : m_delay(delay) {}
+
+    void AddCommand(int cmd_id, std::chrono::steady_clock::time_point finish_time) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finish_times[cmd_id] = finish_time;
+    }
+
+    std::chrono::steady_clock::time_point FinishTime(int cmd_id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_finish_times.at(cmd_id);
+    }
+
+    grpc::Status RobotCommandFeedback(
+        grpc::ServerContext*, const ::bosdyn::api::RobotCommandFeedbackRequest* request,
+        ::bosdyn::api::RobotCommandFeedbackResponse* response) override {
+        std::this_thread::sleep_for(m_delay);
+        ++m_num_requests;
+        const bool finished =
+            std::chrono::steady_clock::now() >= FinishTime(request->robot_command_id());
+        auto* feedback = response->mutable_feedback()->mutable_synchronized_feedback();
+        feedback->mutable_arm_command_feedback()->mutable_arm_cartesian_feedback()->set_status(
+            finished ? ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_COMPLETE
+                     : ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_IN_PROGRESS);
+        feedback->mutable_gripper_command_feedback()->mutable_claw_gripper_feedback()->set_status(
+            finished ? ::bosdyn::api::ClawGripperCommand::Feedback::STATUS_AT_GOAL
+                     : ::bosdyn::api::ClawGripperCommand::Feedback::STATUS_IN_PROGRESS);
+        return grpc::Status::OK;
+    }
+
+    size_t TakeNumRequests() { return m_num_requests.exchange(0); }
+
+ private:
+    const std::chrono::microseconds m_delay;
+    std::mutex m_mutex;
+    std::map<int, std::chrono::steady_clock::time_point> m_finish_times;
+    std::atomic<size_t> m_num_requests{0};
+};
+
+struct Wait {
+    int cmd_id = 0;
+    ::bosdyn::client::CommandFinishedFn is_finished;
+};
+
+// Waiters alternate between arm and gripper waits on num_commands commands, which finish 1 to 3 s
+// from now. Command ids start at first_cmd_id so that each case has commands of its own.
+std::vector<Wait> StartCommands(FakeRobotCommandService* service, size_t num_waiters,
+                                size_t num_commands, int first_cmd_id) {
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_commands; ++i) {
+        service->AddCommand(first_cmd_id + static_cast<int>(i),
+                            now + std::chrono::milliseconds(1000 + 1000 * (i % 3)));
+    }
+    std::vector<Wait> waits(num_waiters);
+    for (size_t i = 0; i < num_waiters; ++i) {
+        waits[i].cmd_id = first_cmd_id + static_cast<int>(i % num_commands);
+        waits[i].is_finished = i / num_commands % 2 == 0 ? ::bosdyn::client::ArmCommandFinished
+                                                         : ::bosdyn::client::GripperCommandFinished;
+    }
+    return waits;
+}
+
+// The loop the BlockUntil helpers used to run on the caller's thread: a blocking feedback request,
+// then a sleep of the poll period.
+void PollLoop(::bosdyn::client::RobotCommandClient* client, const Wait& wait) {
+    ::bosdyn::api::RobotCommandFeedbackRequest request;
+    request.set_robot_command_id(wait.cmd_id);
+    while (true) {
+        auto result = client->RobotCommandFeedback(request);
+        ::bosdyn::common::Status status;
+        if (!result.status || wait.is_finished(result.response, &status)) return;
+        std::this_thread::sleep_for(kPollPeriod);
+    }
+}
+
+// Milliseconds from the finish time of each wait's command to the given completion times.
+std::vector<double> Lags(FakeRobotCommandService* service, const std::vector<Wait>& waits,
+                         const std::vector<std::chrono::steady_clock::time_point>& done_times) {
+    std::vector<double> lags;
+    for (size_t i = 0; i < waits.size(); ++i) {
+        lags.push_back(std::chrono::duration<double, std::milli>(
+                           done_times[i] - service->FinishTime(waits[i].cmd_id))
+                           .count());
+    }
+    return lags;
+}
+
+void RunPollLoops(::bosdyn::client::RobotCommandClient* client, FakeRobotCommandService* service,
+                  const std::vector<Wait>& waits, int base_threads) {
+    std::vector<std::chrono::steady_clock::time_point> done_times(waits.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < waits.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            PollLoop(client, waits[i]);
+            done_times[i] = std::chrono::steady_clock::now();
+        });
+    }
+    const int num_threads = NumProcessThreads();
+    for (auto& thread : threads) thread.join();
+
+    PrintResult("one poll loop per waiter, RPCs", static_cast<double>(service->TakeNumRequests()),
+                "");
+    PrintLatency("one poll loop per waiter, lag", Summarize(Lags(service, waits, done_times)),
+                 "ms");
+    PrintResult("one poll loop per waiter, process threads added",
+                static_cast<double>(num_threads - base_threads), "");
+}
+
+void RunTracker(::bosdyn::client::RobotCommandClient* client, FakeRobotCommandService* service,
+                const std::vector<Wait>& waits, int base_threads) {
+    ::bosdyn::client::CommandFeedbackTracker tracker(client);
+    std::vector<std::chrono::steady_clock::time_point> done_times(waits.size());
+    std::vector<std::shared_future<::bosdyn::client::RobotCommandFeedbackResultType>> futures;
+    for (size_t i = 0; i < waits.size(); ++i) {
+        futures.push_back(tracker.WaitForCommand(
+            waits[i].cmd_id, waits[i].is_finished, std::chrono::seconds(0), kPollPeriod,
+            [&done_times, i](const ::bosdyn::client::RobotCommandFeedbackResultType&) {
+                done_times[i] = std::chrono::steady_clock::now();
+            }));
+    }
+    const int num_threads = NumProcessThreads();
+    for (auto& future : futures) future.wait();
+
+    PrintResult("CommandFeedbackTracker, RPCs", static_cast<double>(tracker.NumFeedbackRequests()),
+                "");
+    service->TakeNumRequests();
+    PrintLatency("CommandFeedbackTracker, lag", Summarize(Lags(service, waits, done_times)), "ms");
+    PrintResult("CommandFeedbackTracker, process threads added",
+                static_cast<double>(num_threads - base_threads), "");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t max_waiters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 128;
+    const double delay_ms = argc > 2 ? std::atof(argv[2]) : 20.0;
+
+    FakeRobotCommandService service(
+        std::chrono::microseconds(static_cast<int64_t>(delay_ms * 1000)));
+    LocalServer server({&service});
+    if (!server.ok()) {
+        std::fprintf(stderr, "Failed to start the local server.\n");
+        return 1;
+    }
+
+    auto pump = std::make_shared<::bosdyn::client::MessagePump>();
+    pump->AutoUpdate(std::chrono::milliseconds(100));
+    ::bosdyn::client::RobotCommandClient client;
+    client.SetComms(server.Channel());
+    client.SetMessagePump(pump);
+    // Start the scheduler threads before counting the threads of the process.
+    ::bosdyn::client::PeriodicScheduler::GetDefault();
+    const int base_threads = NumProcessThreads();
+
+    int next_cmd_id = 1;
+    for (size_t num_waiters : {1, 8, 32, 128, 512}) {
+        if (num_waiters > max_waiters) break;
+        const std::vector<size_t> num_commands_cases =
+            num_waiters == 1 ? std::vector<size_t>{1}
+                             : std::vector<size_t>{num_waiters / 2, num_waiters};
+        for (size_t num_commands : num_commands_cases) {
+            PrintHeader(std::to_string(num_waiters) + " waiters on " +
+                        std::to_string(num_commands) + " commands, " +
+                        std::to_string(kPollPeriod.count()) + " ms poll period, " +
+                        bosdyn::benchmarks::FormatNumber(delay_ms) + " ms server delay");
+            RunPollLoops(&client, &service,
+                         StartCommands(&service, num_waiters, num_commands, next_cmd_id),
+                         base_threads);
+            next_cmd_id += static_cast<int>(num_commands);
+            RunTracker(&client, &service,
+                       StartCommands(&service, num_waiters, num_commands, next_cmd_id),
+                       base_threads);
+            next_cmd_id += static_cast<int>(num_commands);
+        }
+    }
+
+    pump->RequestShutdown();
+    return 0;
+}
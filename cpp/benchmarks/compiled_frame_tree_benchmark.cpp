@@ -0,0 +1,242 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Answering 10, 20 and 30 transform and velocity queries on one FrameTreeSnapshot shaped like the
+// one in a Spot robot state with an arm and some fiducials in view: the free functions in
+// frame_helpers.h, which rebuild the tree on each query, against CompiledFrameTree, compiled once
+// per snapshot and queried by frame name and by cached frame id. Checks that all three give the
+// same answers.
+//
+// Usage: compiled_frame_tree_benchmark
+
+#include <bosdyn/api/geometry.pb.h>
+
+#include <cmath>
+#include <random>
+
+#include "benchmark_util.h"
+#include "bosdyn/math/api_common_frames.h"
+#include "bosdyn/math/compiled_frame_tree.h"
+#include "bosdyn/math/frame_helpers.h"
+
+using bosdyn::api::CompiledFrameTree;
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+
+namespace {
+
+struct Query {
+    std::string frame_a;
+    std::string frame_b;
+    // Velocity queries express a velocity in frame_a in frame_b; the rest ask for a_tform_b.
+    bool velocity = false;
+};
+
+void AddEdge(::bosdyn::api::FrameTreeSnapshot* snapshot, const std::string& child,
+             const std::string& parent, std::mt19937* random) {
+    std::uniform_real_distribution<double> offset(-1.0, 1.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    const Eigen::Quaterniond rotation(Eigen::AngleAxisd(angle(*random), Eigen::Vector3d::UnitZ()) *
+                                      Eigen::AngleAxisd(angle(*random), Eigen::Vector3d::UnitY()));
+    auto& edge = (*snapshot->mutable_child_to_parent_edge_map())[child];
+    edge.set_parent_frame_name(parent);
+    auto* pose = edge.mutable_parent_tform_child();
+    pose->mutable_position()->set_x(offset(*random));
+    pose->mutable_position()->set_y(offset(*random));
+    pose->mutable_position()->set_z(offset(*random));
+    pose->mutable_rotation()->set_w(rotation.w());
+    pose->mutable_rotation()->set_x(rotation.x());
+    pose->mutable_rotation()->set_y(rotation.y());
+    pose->mutable_rotation()->set_z(rotation.z());
+}
+
+// Body at the root, the world frames, the ground plane estimate, the five body cameras, the arm
+// links down to the hand and its camera, and some fiducials seen from vision.
+::bosdyn::api::FrameTreeSnapshot MakeRobotStateSnapshot(std::mt19937* random) {
+    ::bosdyn::api::FrameTreeSnapshot snapshot;
+    (*snapshot.mutable_child_to_parent_edge_map())[::bosdyn::api::kBodyFrame];
+    for (const std::string& frame :
+         {::bosdyn::api::kOdomFrame, ::bosdyn::api::kVisionFrame,
+          ::bosdyn::api::kGravAlignedBodyFrame, ::bosdyn::api::kGroundPlaneEstimateFrame,
+          std::string("frontleft_fisheye"), std::string("frontright_fisheye"),
+          std::string("left_fisheye"), std::string("right_fisheye"), std::string("back_fisheye"),
+          std::string("head")}) {
+        AddEdge(&snapshot, frame, ::bosdyn::api::kBodyFrame, random);
+    }
+    std::string parent = ::bosdyn::api::kBodyFrame;
+    for (const std::string& link : {std::string("arm0.link_sh0"), std::string("arm0.link_sh1"),
+                                    std::string("arm0.link_hr0"), std::string("arm0.link_el0"),
+                                    std::string("arm0.link_el1"), std::string("arm0.link_wr0"),
+                                    ::bosdyn::api::kWr1Frame, ::bosdyn::api::kHandFrame}) {
+        AddEdge(&snapshot, link, parent, random);
+        parent = link;
+    }
+    AddEdge(&snapshot, "hand_color_image_sensor", ::bosdyn::api::kHandFrame, random);
+    AddEdge(&snapshot, "hand_depth_sensor", ::bosdyn::api::kHandFrame, random);
+    for (int i = 0; i < 6; ++i) {
+        AddEdge(&snapshot, "fiducial_" + std::to_string(500 + i), ::bosdyn::api::kVisionFrame,
+                random);
+    }
+    return snapshot;
+}
+
+std::vector<Query> MakeQueries(const ::bosdyn::api::FrameTreeSnapshot& snapshot, int num_queries,
+                               std::mt19937* random) {
+    std::vector<std::string> frames;
+    for (const auto& edge : snapshot.child_to_parent_edge_map()) frames.push_back(edge.first);
+    std::sort(frames.begin(), frames.end());
+    std::uniform_int_distribution<size_t> frame(0, frames.size() - 1);
+    std::vector<Query> queries;
+    for (int i = 0; i < num_queries; ++i) {
+        Query query;
+        query.frame_a = frames[frame(*random)];
+        query.frame_b = frames[frame(*random)];
+        query.velocity = i % 3 == 2;
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+::bosdyn::api::SE3Velocity MakeVelocity() {
+    ::bosdyn::api::SE3Velocity velocity;
+    velocity.mutable_linear()->set_x(0.5);
+    velocity.mutable_linear()->set_y(-0.2);
+    velocity.mutable_angular()->set_z(0.3);
+    return velocity;
+}
+
+// Translation and linear velocity of each answer, to compare the ways of answering the queries.
+using Answers = std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>;
+
+void AnswerWithFreeFunctions(const ::bosdyn::api::FrameTreeSnapshot& snapshot,
+                             const std::vector<Query>& queries,
+                             const ::bosdyn::api::SE3Velocity& velocity, Answers* answers) {
+    answers->clear();
+    for (const Query& query : queries) {
+        if (query.velocity) {
+            ::bosdyn::api::SE3Velocity out;
+            ::bosdyn::api::ExpressVelocityInNewFrame(snapshot, query.frame_a, query.frame_b,
+                                                     velocity, &out);
+            answers->emplace_back(out.linear().x(), out.linear().y(), out.linear().z());
+        } else {
+            ::bosdyn::api::SE3Pose out;
+            ::bosdyn::api::get_a_tform_b(snapshot, query.frame_a, query.frame_b, &out);
+            answers->emplace_back(out.position().x(), out.position().y(), out.position().z());
+        }
+    }
+}
+
+void AnswerWithCompiledNames(CompiledFrameTree* tree,
+                             const ::bosdyn::api::FrameTreeSnapshot& snapshot,
+                             const std::vector<Query>& queries,
+                             const ::bosdyn::api::SE3Velocity& velocity, Answers* answers) {
+    tree->Compile(snapshot);
+    answers->clear();
+    for (const Query& query : queries) {
+        if (query.velocity) {
+            ::bosdyn::api::SE3Velocity out;
+            tree->ExpressVelocityInNewFrame(query.frame_a, query.frame_b, velocity, &out);
+            answers->emplace_back(out.linear().x(), out.linear().y(), out.linear().z());
+        } else {
+            ::bosdyn::api::SE3Pose out;
+            tree->get_a_tform_b(query.frame_a, query.frame_b, &out);
+            answers->emplace_back(out.position().x(), out.position().y(), out.position().z());
+        }
+    }
+}
+
+// The frame ids of the queries are looked up once, before timing. Ids only hold for one compiled
+// tree, but recompiling the same snapshot gives the same ids.
+void AnswerWithCompiledIds(CompiledFrameTree* tree,
+                           const ::bosdyn::api::FrameTreeSnapshot& snapshot,
+                           const std::vector<std::pair<int, int>>& query_ids,
+                           const std::vector<Query>& queries,
+                           const Eigen::Matrix<double, 6, 1>& velocity, Answers* answers) {
+    tree->Compile(snapshot);
+    answers->clear();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (queries[i].velocity) {
+            Eigen::Matrix<double, 6, 1> out;
+            tree->ExpressVelocityInNewFrame(query_ids[i].first, query_ids[i].second, velocity,
+                                            &out);
+            answers->emplace_back(out.head<3>());
+        } else {
+            Eigen::Isometry3d out;
+            tree->a_tform_b(query_ids[i].first, query_ids[i].second, &out);
+            answers->emplace_back(out.translation());
+        }
+    }
+}
+
+double MaxDifference(const Answers& a, const Answers& b) {
+    double max_difference = a.size() == b.size() ? 0.0 : INFINITY;
+    for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+        max_difference = std::max(max_difference, (a[i] - b[i]).cwiseAbs().maxCoeff());
+    }
+    return max_difference;
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 random(5);
+    const auto snapshot = MakeRobotStateSnapshot(&random);
+    const ::bosdyn::api::SE3Velocity velocity = MakeVelocity();
+    Eigen::Matrix<double, 6, 1> eigen_velocity;
+    eigen_velocity << 0.5, -0.2, 0.0, 0.0, 0.0, 0.3;
+    double max_difference = 0.0;
+
+    for (int num_queries : {10, 20, 30}) {
+        PrintHeader(std::to_string(num_queries) + " queries on a snapshot of " +
+                    std::to_string(snapshot.child_to_parent_edge_map_size()) +
+                    " frames, a third of them velocities");
+        const std::vector<Query> queries = MakeQueries(snapshot, num_queries, &random);
+        CompiledFrameTree tree(snapshot);
+        std::vector<std::pair<int, int>> query_ids;
+        for (const Query& query : queries) {
+            query_ids.emplace_back(tree.FrameId(query.frame_a), tree.FrameId(query.frame_b));
+        }
+
+        Answers free_answers, name_answers, id_answers;
+        const double free_ns = NsPerCall([&]() {
+            AnswerWithFreeFunctions(snapshot, queries, velocity, &free_answers);
+            DoNotOptimize(free_answers.data());
+        });
+        const double name_ns = NsPerCall([&]() {
+            AnswerWithCompiledNames(&tree, snapshot, queries, velocity, &name_answers);
+            DoNotOptimize(name_answers.data());
+        });
+        const double id_ns = NsPerCall([&]() {
+            AnswerWithCompiledIds(&tree, snapshot, query_ids, queries, eigen_velocity,
+                                  &id_answers);
+            DoNotOptimize(id_answers.data());
+        });
+        const double compile_ns = NsPerCall([&]() {
+            tree.Compile(snapshot);
+            DoNotOptimize(tree.RootFrameId());
+        });
+
+        PrintResult("free functions", free_ns / 1e3, "us/snapshot");
+        PrintResult("CompiledFrameTree, Compile only", compile_ns / 1e3, "us/snapshot");
+        PrintResult("CompiledFrameTree, Compile and queries by name", name_ns / 1e3,
+                    "us/snapshot");
+        PrintResult("CompiledFrameTree, Compile and queries by cached id", id_ns / 1e3,
+                    "us/snapshot");
+        PrintResult("speedup by name", free_ns / name_ns, "x");
+        PrintResult("speedup by cached id", free_ns / id_ns, "x");
+
+        max_difference = std::max(max_difference, MaxDifference(free_answers, name_answers));
+        max_difference = std::max(max_difference, MaxDifference(free_answers, id_answers));
+    }
+
+    std::printf("\n  largest difference from the free functions: %g\n", max_difference);
+    return max_difference < 1e-9 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Throughput and peak memory of splitting a large message into DataChunks and reassembling it,
+// with the chunk streams of data_chunking.h against the serialize-to-string-then-copy approach they
+// replace, for messages of 10 MB to 1 GB and two chunk sizes. Each path runs in a process of its
+// own, forked once its input is in memory, and its peak memory is how far ru_maxrss rose above
+// that input. The 1 GB case needs about 3.5 GB of free memory.
+//
+// Usage: data_chunking_benchmark [max message size in MB, default 1000]
+
+#include <bosdyn/api/image.pb.h>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <cstdlib>
+#include <functional>
+
+#include "benchmark_util.h"
+#include "bosdyn/client/data_chunk/data_chunking.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+
+namespace {
+
+::bosdyn::api::GetImageResponse MakeResponse(size_t image_bytes) {
+    ::bosdyn::api::GetImageResponse response;
+    auto* image = response.add_image_responses()->mutable_shot()->mutable_image();
+    image->set_rows(480);
+    image->set_cols(640);
+    std::string* data = image->mutable_data();
+    data->resize(image_bytes);
+    for (size_t i = 0; i < image_bytes; ++i) (*data)[i] = static_cast<char>(i * 131);
+    return response;
+}
+
+std::vector<const ::bosdyn::api::DataChunk*> Pointers(
+    const std::vector<::bosdyn::api::DataChunk>& chunks) {
+    std::vector<const ::bosdyn::api::DataChunk*> pointers;
+    for (const auto& chunk : chunks) pointers.push_back(&chunk);
+    return pointers;
+}
+
+// Peak resident memory of the process so far, in bytes. Linux reports ru_maxrss in KiB.
+double MaxRssBytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) * 1024.0;
+}
+
+struct Measurement {
+    double ns_per_call = 0.0;
+    double peak_bytes = 0.0;
+};
+
+// Run fn in a forked process, which starts with the memory of this one, and measure how far its
+// first call raised the peak memory, then its mean time per call.
+bool MeasureInChild(const std::function<void()>& fn, Measurement* measurement) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+#ifdef __GLIBC__
+    // Return the memory of freed allocations to the system, so that the child cannot reuse it
+    // without raising its peak.
+    malloc_trim(0);
+#endif
+    std::fflush(stdout);
+    const pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        close(fds[0]);
+        Measurement result;
+        const double start_rss = MaxRssBytes();
+        fn();
+        result.peak_bytes = MaxRssBytes() - start_rss;
+        result.ns_per_call = NsPerCall(fn);
+        const bool written = write(fds[1], &result, sizeof(result)) == sizeof(result);
+        _exit(written ? 0 : 1);
+    }
+    close(fds[1]);
+    const bool read_all = read(fds[0], measurement, sizeof(*measurement)) == sizeof(*measurement);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return read_all && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Print the throughput and peak memory of a path, or that its process failed, for example when
+// it ran out of memory.
+bool RunPath(const std::string& name, double message_bytes, const std::function<void()>& fn) {
+    Measurement measurement;
+    if (!MeasureInChild(fn, &measurement)) {
+        std::printf("  %-52s failed\n", name.c_str());
+        return false;
+    }
+    PrintResult(name + ", throughput", message_bytes / measurement.ns_per_call * 1e3, "MB/s");
+    PrintResult(name + ", peak memory", measurement.peak_bytes / 1e6, "MB");
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t max_megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+
+    bool ok = true;
+    for (size_t megabytes : {10, 100, 1000}) {
+        if (megabytes > max_megabytes) break;
+        for (size_t chunk_size : {size_t(64) << 10, ::bosdyn::client::kDefaultDataChunkSize}) {
+            PrintHeader("GetImageResponse of " + std::to_string(megabytes) + " MB, " +
+                        std::to_string(chunk_size >> 10) + " KiB chunks");
+
+            auto response = std::make_unique<::bosdyn::api::GetImageResponse>(
+                MakeResponse(megabytes * 1000 * 1000));
+            const double bytes = static_cast<double>(response->ByteSizeLong());
+
+            ok &= RunPath("split, serialize to string and copy", bytes, [&]() {
+                std::vector<::bosdyn::api::DataChunk> chunks;
+                std::string serialized;
+                response->SerializeToString(&serialized);
+                ::bosdyn::client::StringToDataChunks(serialized, &chunks, chunk_size);
+                DoNotOptimize(chunks);
+            });
+            ok &= RunPath("split, MessageToDataChunks", bytes, [&]() {
+                std::vector<::bosdyn::api::DataChunk> chunks;
+                auto status = ::bosdyn::client::MessageToDataChunks(*response, &chunks, chunk_size);
+                DoNotOptimize(status);
+                DoNotOptimize(chunks);
+            });
+            // As a request stream sends it: each chunk is dropped once it was produced.
+            ok &= RunPath("split, MessageDataChunkSource", bytes, [&]() {
+                ::bosdyn::client::MessageDataChunkSource source(*response, chunk_size);
+                ::bosdyn::api::DataChunk chunk;
+                bool has_chunk = true;
+                while (has_chunk && source.NextChunk(&chunk, &has_chunk)) DoNotOptimize(chunk);
+            });
+
+            // Only the chunks are in memory when reassembling.
+            std::vector<::bosdyn::api::DataChunk> chunks;
+            if (!::bosdyn::client::MessageToDataChunks(*response, &chunks, chunk_size)) return 1;
+            response.reset();
+            const auto pointers = Pointers(chunks);
+            ok &= RunPath("reassemble, concatenate and parse", bytes, [&pointers]() {
+                auto joined = ::bosdyn::client::StringFromDataChunks(pointers);
+                ::bosdyn::api::GetImageResponse parsed;
+                parsed.ParseFromString(joined.response);
+                DoNotOptimize(parsed);
+            });
+            ok &= RunPath("reassemble, MessageFromDataChunks", bytes, [&pointers]() {
+                auto parsed =
+                    ::bosdyn::client::MessageFromDataChunks<::bosdyn::api::GetImageResponse>(
+                        pointers);
+                DoNotOptimize(parsed);
+            });
+        }
+    }
+    return ok ? 0 : 1;
+}
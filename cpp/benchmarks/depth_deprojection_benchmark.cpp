@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Cost per pixel of deprojecting depth images into points in the odom frame with
+// DepthDeprojector, for FORMAT_RAW and FORMAT_RLE images, against a scalar loop that computes the
+// ray of every pixel as it goes. The images have a quarter of their pixels without depth, in runs.
+
+#include <cmath>
+
+#include "benchmark_util.h"
+#include "bosdyn/client/image/depth_deprojection.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+
+namespace {
+
+constexpr double kDepthScale = 1000.0;
+
+// Depth of each pixel in depth units: a tilted plane, with every fourth block of 16 pixels empty.
+std::vector<uint16_t> MakeDepth(int cols, int rows) {
+    std::vector<uint16_t> depth(static_cast<size_t>(cols) * rows);
+    for (int v = 0; v < rows; ++v) {
+        for (int u = 0; u < cols; ++u) {
+            const size_t pixel = static_cast<size_t>(v) * cols + u;
+            depth[pixel] = (pixel / 16) % 4 == 3 ? 0 : static_cast<uint16_t>(1500 + 4 * v + u / 8);
+        }
+    }
+    return depth;
+}
+
+std::string EncodeRaw(const std::vector<uint16_t>& depth) {
+    std::string data(depth.size() * 2, '\0');
+    for (size_t i = 0; i < depth.size(); ++i) {
+        data[2 * i] = static_cast<char>(depth[i] & 0xff);
+        data[2 * i + 1] = static_cast<char>(depth[i] >> 8);
+    }
+    return data;
+}
+
+// Runs of at most 255 equal depth values: the run length followed by the little-endian depth.
+std::string EncodeRLE(const std::vector<uint16_t>& depth) {
+    std::string data;
+    size_t i = 0;
+    while (i < depth.size()) {
+        size_t count = 1;
+        while (i + count < depth.size() && count < 255 && depth[i + count] == depth[i]) ++count;
+        data.push_back(static_cast<char>(count));
+        data.push_back(static_cast<char>(depth[i] & 0xff));
+        data.push_back(static_cast<char>(depth[i] >> 8));
+        i += count;
+    }
+    return data;
+}
+
+::bosdyn::api::ImageResponse MakeResponse(int cols, int rows, const std::string& data,
+                                          ::bosdyn::api::Image::Format format) {
+    ::bosdyn::api::ImageResponse response;
+    auto* source = response.mutable_source();
+    source->set_name("frontleft_depth");
+    source->set_cols(cols);
+    source->set_rows(rows);
+    source->set_depth_scale(kDepthScale);
+    auto* intrinsics = source->mutable_pinhole()->mutable_intrinsics();
+    intrinsics->mutable_focal_length()->set_x(0.8 * cols);
+    intrinsics->mutable_focal_length()->set_y(0.8 * cols);
+    intrinsics->mutable_principal_point()->set_x(cols / 2.0);
+    intrinsics->mutable_principal_point()->set_y(rows / 2.0);
+
+    auto* shot = response.mutable_shot();
+    shot->set_frame_name_image_sensor("frontleft_fisheye");
+    auto& edges = *shot->mutable_transforms_snapshot()->mutable_child_to_parent_edge_map();
+    edges["odom"];
+    auto& edge = edges["frontleft_fisheye"];
+    edge.set_parent_frame_name("odom");
+    auto* pose = edge.mutable_parent_tform_child();
+    pose->mutable_position()->set_x(0.4);
+    pose->mutable_position()->set_z(0.7);
+    pose->mutable_rotation()->set_w(std::cos(0.3));
+    pose->mutable_rotation()->set_y(std::sin(0.3));
+
+    auto* image = shot->mutable_image();
+    image->set_cols(cols);
+    image->set_rows(rows);
+    image->set_format(format);
+    image->set_pixel_format(::bosdyn::api::Image::PIXEL_FORMAT_DEPTH_U16);
+    image->set_data(data);
+    return response;
+}
+
+// The straightforward loop: compute each pixel's ray, then rotate and translate the point.
+size_t NaiveDeproject(const std::vector<uint16_t>& depth, int cols, int rows,
+                      std::vector<float>* xyz) {
+    const double f = 0.8 * cols, cx = cols / 2.0, cy = rows / 2.0;
+    const double c = std::cos(0.6), s = std::sin(0.6);
+    xyz->resize(depth.size() * 3);
+    size_t num_points = 0;
+    for (int v = 0; v < rows; ++v) {
+        for (int u = 0; u < cols; ++u) {
+            const uint16_t d = depth[static_cast<size_t>(v) * cols + u];
+            if (d == 0) continue;
+            const double z = d / kDepthScale;
+            const double x = (u - cx) * z / f;
+            const double y = (v - cy) * z / f;
+            (*xyz)[3 * num_points] = static_cast<float>(c * x + s * z + 0.4);
+            (*xyz)[3 * num_points + 1] = static_cast<float>(y);
+            (*xyz)[3 * num_points + 2] = static_cast<float>(-s * x + c * z + 0.7);
+            ++num_points;
+        }
+    }
+    return num_points;
+}
+
+}  // namespace
+
+int main() {
+    for (auto size : {std::make_pair(424, 240), std::make_pair(640, 480)}) {
+        const int cols = size.first, rows = size.second;
+        const double pixels = static_cast<double>(cols) * rows;
+        const auto depth = MakeDepth(cols, rows);
+        const auto raw =
+            MakeResponse(cols, rows, EncodeRaw(depth), ::bosdyn::api::Image::FORMAT_RAW);
+        const auto rle =
+            MakeResponse(cols, rows, EncodeRLE(depth), ::bosdyn::api::Image::FORMAT_RLE);
+        PrintHeader(std::to_string(cols) + "x" + std::to_string(rows) + " depth image to odom");
+
+        ::bosdyn::client::DepthDeprojector deprojector;
+        ::bosdyn::client::DepthDeprojectionOptions options;
+        options.frame = "odom";
+        ::bosdyn::client::DeprojectedPoints points;
+        for (const auto* response : {&raw, &rle}) {
+            auto status = deprojector.Deproject(*response, options, &points);
+            if (!status) {
+                std::printf("Deprojection failed: %s\n", status.DebugString().c_str());
+                return 1;
+            }
+        }
+
+        std::vector<float> naive_xyz;
+        PrintResult("scalar loop", NsPerCall([&]() {
+                        DoNotOptimize(NaiveDeproject(depth, cols, rows, &naive_xyz));
+                    }) / pixels,
+                    "ns/pixel");
+        PrintResult("DepthDeprojector, FORMAT_RAW", NsPerCall([&]() {
+                        auto status = deprojector.Deproject(raw, options, &points);
+                        DoNotOptimize(status);
+                    }) / pixels,
+                    "ns/pixel");
+        PrintResult("DepthDeprojector, FORMAT_RLE", NsPerCall([&]() {
+                        auto status = deprojector.Deproject(rle, options, &points);
+                        DoNotOptimize(status);
+                    }) / pixels,
+                    "ns/pixel");
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Throughput of a reachability sweep through InverseKinematicsBatch against a stand-in
+// InverseKinematicsService on localhost that takes a fixed time to solve each request. Compares
+// one blocking call at a time, a window of futures polled every millisecond, and
+// InverseKinematicsBatch with several window sizes, with and without the reachability cache.
+//
+// Usage: inverse_kinematics_batch_benchmark [solve time in ms, default 2] [requests, default 1000]
+
+#include <bosdyn/api/spot/inverse_kinematics_service.grpc.pb.h>
+
+#include <cstdlib>
+#include <deque>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "local_server.h"
+#include "bosdyn/client/inverse_kinematics/inverse_kinematics_client.h"
+
+using bosdyn::benchmarks::LocalServer;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::benchmarks::SecondsSince;
+
+namespace {
+
+class FakeInverseKinematicsService : public ::bosdyn::api::spot::InverseKinematicsService::Service {
+ public:
+    explicit FakeInverseKinematicsService(std::chrono::microseconds solve_time)
+        : m_solve_time(solve_time) {}
+
+    grpc::Status InverseKinematics(
+        grpc::ServerContext*, const ::bosdyn::api::spot::InverseKinematicsRequest* request,
+        ::bosdyn::api::spot::InverseKinematicsResponse* response) override {
+        std::this_thread::sleep_for(m_solve_time);
+        // Tool poses beyond 1 m in front of the body are out of reach.
+        const double x = request->tool_pose_task().task_tform_desired_tool().position().x();
+        response->set_status(x < 1.0
+                                 ? ::bosdyn::api::spot::InverseKinematicsResponse::STATUS_OK
+                                 : ::bosdyn::api::spot::InverseKinematicsResponse::
+                                       STATUS_NO_SOLUTION_FOUND);
+        ++m_num_requests;
+        return grpc::Status::OK;
+    }
+
+    size_t TakeNumRequests() { return m_num_requests.exchange(0); }
+
+ private:
+    const std::chrono::microseconds m_solve_time;
+    std::atomic<size_t> m_num_requests{0};
+};
+
+// Candidate tool poses on a grid in front of the body, 5 cm apart.
+std::vector<::bosdyn::api::spot::InverseKinematicsRequest> MakeSweep(size_t num_requests) {
+    std::vector<::bosdyn::api::spot::InverseKinematicsRequest> requests(num_requests);
+    for (size_t i = 0; i < num_requests; ++i) {
+        auto* tool = requests[i].mutable_tool_pose_task()->mutable_task_tform_desired_tool();
+        tool->mutable_position()->set_x(0.5 + 0.05 * (i % 20));
+        tool->mutable_position()->set_y(-0.5 + 0.05 * (i / 20 % 20));
+        tool->mutable_position()->set_z(0.05 * (i / 400));
+        tool->mutable_rotation()->set_w(1.0);
+        requests[i].set_root_frame_name("odom");
+    }
+    return requests;
+}
+
+// The window InverseKinematicsBatch used to run: futures checked in turn, with a 1 ms wait on the
+// oldest when none is ready.
+void PolledWindow(::bosdyn::client::InverseKinematicsClient* client,
+                  const std::vector<::bosdyn::api::spot::InverseKinematicsRequest>& requests,
+                  size_t window) {
+    std::deque<std::shared_future<::bosdyn::client::InverseKinematicsResultType>> in_flight;
+    size_t next = 0;
+    while (next < requests.size() || !in_flight.empty()) {
+        while (next < requests.size() && in_flight.size() < window) {
+            ::bosdyn::api::spot::InverseKinematicsRequest request = requests[next++];
+            in_flight.push_back(client->InverseKinematicsAsync(request));
+        }
+        bool any_done = false;
+        for (auto it = in_flight.begin(); it != in_flight.end();) {
+            if (it->wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+                it = in_flight.erase(it);
+                any_done = true;
+            } else {
+                ++it;
+            }
+        }
+        if (!any_done) in_flight.front().wait_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Report(const std::string& name, double seconds, size_t num_requests,
+            FakeInverseKinematicsService* service) {
+    PrintResult(name, num_requests / seconds, "requests/s");
+    PrintResult(name + ", RPCs sent", static_cast<double>(service->TakeNumRequests()), "");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double solve_ms = argc > 1 ? std::atof(argv[1]) : 2.0;
+    const size_t num_requests = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+    FakeInverseKinematicsService service(
+        std::chrono::microseconds(static_cast<int64_t>(solve_ms * 1000)));
+    LocalServer server({&service});
+    if (!server.ok()) {
+        std::fprintf(stderr, "Failed to start the local server.\n");
+        return 1;
+    }
+
+    auto pump = std::make_shared<::bosdyn::client::MessagePump>();
+    pump->AutoUpdate(std::chrono::milliseconds(100));
+    ::bosdyn::client::InverseKinematicsClient client;
+    client.SetComms(server.Channel());
+    client.SetMessagePump(pump);
+
+    const auto requests = MakeSweep(num_requests);
+    PrintHeader("InverseKinematics sweep of " + std::to_string(num_requests) + " tool poses, " +
+                bosdyn::benchmarks::FormatNumber(solve_ms) + " ms per solve");
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& sweep_request : requests) {
+        ::bosdyn::api::spot::InverseKinematicsRequest request = sweep_request;
+        auto result = client.InverseKinematics(request);
+        bosdyn::benchmarks::DoNotOptimize(result);
+    }
+    Report("one call at a time", SecondsSince(start), num_requests, &service);
+
+    for (size_t window : {1, 8, 32}) {
+        const std::string suffix = ", window " + std::to_string(window);
+        start = std::chrono::steady_clock::now();
+        PolledWindow(&client, requests, window);
+        Report("futures polled every 1 ms" + suffix, SecondsSince(start), num_requests, &service);
+
+        ::bosdyn::client::InverseKinematicsBatchOptions options;
+        options.max_in_flight = window;
+        start = std::chrono::steady_clock::now();
+        auto results = client.InverseKinematicsBatch(requests, options);
+        Report("InverseKinematicsBatch" + suffix, SecondsSince(start), num_requests, &service);
+        // Out of reach poses fail with STATUS_NO_SOLUTION_FOUND, but every RPC gets an answer.
+        for (const auto& result : results) {
+            if (result.response.status() ==
+                ::bosdyn::api::spot::InverseKinematicsResponse::STATUS_UNKNOWN) {
+                std::fprintf(stderr, "InverseKinematicsBatch failed: %s\n",
+                             result.status.DebugString().c_str());
+                return 1;
+            }
+        }
+    }
+
+    // The first pass sends every request and fills the cache, and the second is answered from it.
+    ::bosdyn::client::InverseKinematicsReachabilityCache cache;
+    ::bosdyn::client::InverseKinematicsBatchOptions options;
+    options.cache = &cache;
+    for (const char* pass :
+         {"InverseKinematicsBatch with cache, cold", "InverseKinematicsBatch with cache, warm"}) {
+        start = std::chrono::steady_clock::now();
+        auto results = client.InverseKinematicsBatch(requests, options);
+        bosdyn::benchmarks::DoNotOptimize(results);
+        Report(pass, SecondsSince(start), num_requests, &service);
+    }
+
+    pump->RequestShutdown();
+    return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Tick jitter and command-to-state round trip of JointControlLoop at 333 Hz and 1 kHz. The loop
+// writes through its StreamWriter seam, either to an in-process writer or to a joint control
+// stream on a local stand-in RobotCommandStreamingService. A stand-in RobotStateStreamingService
+// streams state every millisecond reporting the last command key it received, and a stand-in
+// TimeSyncService lets the loop establish time sync.
+//
+// Usage: joint_control_loop_benchmark [seconds per case, default 5]
+
+#include <bosdyn/api/robot_command_service.grpc.pb.h>
+#include <bosdyn/api/robot_state_service.grpc.pb.h>
+#include <bosdyn/api/time_sync_service.grpc.pb.h>
+
+#include <cstdlib>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "local_server.h"
+#include "bosdyn/client/error_codes/joint_control_stream_error_code.h"
+#include "bosdyn/client/robot_command/joint_control_loop.h"
+
+using bosdyn::benchmarks::LocalServer;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintLatency;
+using bosdyn::benchmarks::PrintResult;
+
+namespace {
+
+// Key of the last joint command the stand-in robot received.
+std::atomic<uint32_t> g_last_command_key{0};
+
+class FakeTimeSyncService : public ::bosdyn::api::TimeSyncService::Service {
+ public:
+    grpc::Status TimeSyncUpdate(grpc::ServerContext*, const ::bosdyn::api::TimeSyncUpdateRequest*,
+                                ::bosdyn::api::TimeSyncUpdateResponse* response) override {
+        response->set_clock_identifier("benchmark");
+        response->mutable_state()->set_status(::bosdyn::api::TimeSyncState::STATUS_OK);
+        return grpc::Status::OK;
+    }
+};
+
+class FakeRobotCommandStreamingService
+    : public ::bosdyn::api::RobotCommandStreamingService::Service {
+ public:
+    grpc::Status JointControlStream(
+        grpc::ServerContext*, grpc::ServerReader<::bosdyn::api::JointControlStreamRequest>* reader,
+        ::bosdyn::api::JointControlStreamResponse*) override {
+        ::bosdyn::api::JointControlStreamRequest request;
+        while (reader->Read(&request)) {
+            g_last_command_key = request.joint_command().user_command_key();
+        }
+        return grpc::Status::OK;
+    }
+};
+
+class FakeRobotStateStreamingService
+    : public ::bosdyn::api::RobotStateStreamingService::Service {
+ public:
+    grpc::Status GetRobotStateStream(
+        grpc::ServerContext* context, const ::bosdyn::api::RobotStateStreamRequest*,
+        grpc::ServerWriter<::bosdyn::api::RobotStateStreamResponse>* writer) override {
+        ::bosdyn::api::RobotStateStreamResponse response;
+        response.mutable_joint_states()->mutable_position()->Resize(12, 0.0f);
+        auto deadline = std::chrono::steady_clock::now();
+        while (!context->IsCancelled()) {
+            response.mutable_last_command()->set_user_command_key(g_last_command_key);
+            if (!writer->Write(response)) break;
+            deadline += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(deadline);
+        }
+        return grpc::Status::OK;
+    }
+};
+
+// Joint control stream written through the StreamWriter seam, closed when it goes out of scope.
+class GrpcJointControlStream {
+ public:
+    explicit GrpcJointControlStream(const std::shared_ptr<grpc::Channel>& channel)
+        : m_stub(channel) {
+        m_writer = m_stub.JointControlStream(&m_context, &m_response);
+    }
+
+    ~GrpcJointControlStream() {
+        m_writer->WritesDone();
+        grpc::Status status = m_writer->Finish();
+        (void)status;
+    }
+
+    ::bosdyn::common::Status Write(const ::bosdyn::api::JointControlStreamRequest& request) {
+        if (!m_writer->Write(request)) {
+            return ::bosdyn::common::Status(JointControlStreamErrorCode::StreamingFailed);
+        }
+        return ::bosdyn::common::Status(JointControlStreamErrorCode::Success);
+    }
+
+ private:
+    ::bosdyn::api::RobotCommandStreamingService::Stub m_stub;
+    grpc::ClientContext m_context;
+    ::bosdyn::api::JointControlStreamResponse m_response;
+    std::unique_ptr<grpc::ClientWriterInterface<::bosdyn::api::JointControlStreamRequest>>
+        m_writer;
+};
+
+::bosdyn::benchmarks::LatencySummary InMicroseconds(
+    const ::bosdyn::client::LatencySummary& summary) {
+    auto us = [](::bosdyn::common::Duration duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    };
+    ::bosdyn::benchmarks::LatencySummary result;
+    result.count = summary.num_samples;
+    result.p50 = us(summary.p50);
+    result.p90 = us(summary.p90);
+    result.p99 = us(summary.p99);
+    result.max = us(summary.max);
+    return result;
+}
+
+void RunCase(const LocalServer& server, ::bosdyn::client::TimeSyncEndpoint* time_sync_endpoint,
+             int rate_hz, bool over_grpc, double seconds) {
+    ::bosdyn::client::JointControlLoopParameters parameters;
+    parameters.period = std::chrono::nanoseconds(1000000000 / rate_hz);
+
+    std::unique_ptr<GrpcJointControlStream> stream;
+    ::bosdyn::client::JointControlLoop::StreamWriter writer;
+    if (over_grpc) {
+        stream = std::make_unique<GrpcJointControlStream>(server.Channel());
+        writer = [stream_ptr = stream.get()](const ::bosdyn::api::JointControlStreamRequest& r) {
+            return stream_ptr->Write(r);
+        };
+    } else {
+        writer = [](const ::bosdyn::api::JointControlStreamRequest& request) {
+            g_last_command_key = request.joint_command().user_command_key();
+            return ::bosdyn::common::Status(JointControlStreamErrorCode::Success);
+        };
+    }
+    ::bosdyn::client::JointControlLoop loop(writer, time_sync_endpoint, parameters);
+
+    // Read the state stream on its own thread and feed it to the loop for the round trip.
+    ::bosdyn::api::RobotStateStreamingService::Stub state_stub(server.Channel());
+    grpc::ClientContext state_context;
+    auto state_reader =
+        state_stub.GetRobotStateStream(&state_context, ::bosdyn::api::RobotStateStreamRequest());
+    std::thread state_thread([&loop, &state_reader]() {
+        ::bosdyn::api::RobotStateStreamResponse response;
+        while (state_reader->Read(&response)) loop.OnRobotStateStreamResponse(response);
+    });
+
+    ::bosdyn::client::JointSetpoint setpoint;
+    setpoint.k_q_p.fill(100.0f);
+    setpoint.k_qd_p.fill(1.0f);
+    loop.SetSetpoint(setpoint);
+    auto status = loop.Start();
+    if (!status) {
+        std::fprintf(stderr, "Failed to start the loop: %s\n", status.DebugString().c_str());
+    } else {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        loop.Stop();
+    }
+
+    state_context.TryCancel();
+    state_thread.join();
+    grpc::Status state_status = state_reader->Finish();
+    (void)state_status;
+
+    const auto stats = loop.GetStats();
+    const std::string prefix = std::to_string(rate_hz) + " Hz, " +
+                               (over_grpc ? "localhost stream" : "in-process writer");
+    PrintLatency(prefix + " jitter", InMicroseconds(stats.jitter), "us");
+    PrintLatency(prefix + " round trip", InMicroseconds(stats.round_trip), "us");
+    PrintResult(prefix + " missed ticks", static_cast<double>(stats.missed_ticks), "");
+    PrintResult(prefix + " write failures", static_cast<double>(stats.write_failures), "");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+
+    FakeTimeSyncService time_sync_service;
+    FakeRobotCommandStreamingService command_service;
+    FakeRobotStateStreamingService state_service;
+    LocalServer server({&time_sync_service, &command_service, &state_service});
+    if (!server.ok()) {
+        std::fprintf(stderr, "Failed to start the local server.\n");
+        return 1;
+    }
+
+    auto pump = std::make_shared<::bosdyn::client::MessagePump>();
+    pump->AutoUpdate(std::chrono::milliseconds(100));
+    ::bosdyn::client::TimeSyncClient time_sync_client;
+    time_sync_client.SetComms(server.Channel());
+    time_sync_client.SetMessagePump(pump);
+    ::bosdyn::client::TimeSyncEndpoint time_sync_endpoint(&time_sync_client);
+    if (!time_sync_endpoint.EstablishTimeSync(10, true)) {
+        std::fprintf(stderr, "Failed to establish time sync with the local server.\n");
+        return 1;
+    }
+
+    for (int rate_hz : {333, 1000}) {
+        PrintHeader("JointControlLoop at " + std::to_string(rate_hz) + " Hz, 12 joints, " +
+                    bosdyn::benchmarks::FormatNumber(seconds) + " s");
+        for (bool over_grpc : {false, true}) {
+            RunCase(server, &time_sync_endpoint, rate_hz, over_grpc, seconds);
+        }
+    }
+    pump->RequestShutdown();
+    return 0;
+}
@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Many lease keepalives, E-Stop keepalives and time sync threads on the shared PeriodicScheduler
+// and one MessagePump, against stand-in Lease, E-Stop and TimeSync services on localhost that take
+// a fixed time to answer. Reports the time between consecutive check-ins of each keepalive as the
+// server sees them, the number of threads of the process, and its CPU use, which includes the
+// stand-in server.
+//
+// Usage: keepalive_scale_benchmark [max keepalives of each kind, default 1000] [seconds, default 5]
+//                                  [server delay in ms, default 2]
+
+#include <bosdyn/api/estop_service.grpc.pb.h>
+#include <bosdyn/api/lease_service.grpc.pb.h>
+#include <bosdyn/api/time_sync_service.grpc.pb.h>
+
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "local_server.h"
+#include "bosdyn/client/estop/estop_keepalive.h"
+#include "bosdyn/client/lease/lease_keepalive.h"
+#include "bosdyn/client/time_sync/time_sync_helpers.h"
+
+using bosdyn::benchmarks::LocalServer;
+using bosdyn::benchmarks::NumProcessThreads;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintLatency;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::benchmarks::SecondsSince;
+using bosdyn::benchmarks::Summarize;
+
+namespace {
+
+constexpr auto kInterval = std::chrono::seconds(1);
+
+// Times between consecutive check-ins of each keepalive, in milliseconds.
+class CheckInGaps {
+ public:
+    void Record(const std::string& key) {
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto inserted = m_last.emplace(key, now);
+        if (!inserted.second) {
+            m_gaps.push_back(
+                std::chrono::duration<double, std::milli>(now - inserted.first->second).count());
+            inserted.first->second = now;
+        }
+    }
+
+    std::vector<double> Take() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_last.clear();
+        return std::move(m_gaps);
+    }
+
+ private:
+    std::mutex m_mutex;
+    std::map<std::string, std::chrono::steady_clock::time_point> m_last;
+    std::vector<double> m_gaps;
+};
+
+class FakeLeaseService : public ::bosdyn::api::LeaseService::Service {
+ public:
+    explicit FakeLeaseService(std::chrono::microseconds delay) : m_delay(delay) {}
+
+    grpc::Status RetainLease(grpc::ServerContext*, const ::bosdyn::api::RetainLeaseRequest* request,
+                             ::bosdyn::api::RetainLeaseResponse* response) override {
+        std::this_thread::sleep_for(m_delay);
+        gaps.Record(request->lease().resource());
+        response->mutable_lease_use_result()->set_status(
+            ::bosdyn::api::LeaseUseResult::STATUS_OK);
+        return grpc::Status::OK;
+    }
+
+    CheckInGaps gaps;
+
+ private:
+    const std::chrono::microseconds m_delay;
+};
+
+class FakeEstopService : public ::bosdyn::api::EstopService::Service {
+ public:
+    explicit FakeEstopService(std::chrono::microseconds delay) : m_delay(delay) {}
+
+    grpc::Status EstopCheckIn(grpc::ServerContext*,
+                              const ::bosdyn::api::EstopCheckInRequest* request,
+                              ::bosdyn::api::EstopCheckInResponse* response) override {
+        std::this_thread::sleep_for(m_delay);
+        gaps.Record(request->endpoint().name());
+        response->set_challenge(request->challenge() + 1);
+        response->set_status(::bosdyn::api::EstopCheckInResponse::STATUS_OK);
+        return grpc::Status::OK;
+    }
+
+    CheckInGaps gaps;
+
+ private:
+    const std::chrono::microseconds m_delay;
+};
+
+class FakeTimeSyncService : public ::bosdyn::api::TimeSyncService::Service {
+ public:
+    explicit FakeTimeSyncService(std::chrono::microseconds delay) : m_delay(delay) {}
+
+    grpc::Status TimeSyncUpdate(grpc::ServerContext*,
+                                const ::bosdyn::api::TimeSyncUpdateRequest* request,
+                                ::bosdyn::api::TimeSyncUpdateResponse* response) override {
+        std::this_thread::sleep_for(m_delay);
+        // Each thread gets its own clock identifier on its first update, and sends it after.
+        std::string clock_identifier = request->clock_identifier();
+        if (clock_identifier.empty()) {
+            clock_identifier = "clock-" + std::to_string(m_num_clocks++);
+        } else {
+            gaps.Record(clock_identifier);
+        }
+        response->set_clock_identifier(clock_identifier);
+        response->mutable_state()->set_status(::bosdyn::api::TimeSyncState::STATUS_OK);
+        return grpc::Status::OK;
+    }
+
+    CheckInGaps gaps;
+
+ private:
+    const std::chrono::microseconds m_delay;
+    std::atomic<int> m_num_clocks{0};
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t max_keepalives = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 5.0;
+    const double delay_ms = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+    const std::chrono::microseconds delay(static_cast<int64_t>(delay_ms * 1000));
+    FakeLeaseService lease_service(delay);
+    FakeEstopService estop_service(delay);
+    FakeTimeSyncService time_sync_service(delay);
+    LocalServer server({&lease_service, &estop_service, &time_sync_service});
+    if (!server.ok()) {
+        std::fprintf(stderr, "Failed to start the local server.\n");
+        return 1;
+    }
+
+    auto pump = std::make_shared<::bosdyn::client::MessagePump>();
+    pump->AutoUpdate(std::chrono::milliseconds(100));
+    auto channel = server.Channel();
+    auto wallet = std::make_shared<::bosdyn::client::LeaseWallet>("keepalive_scale_benchmark");
+    ::bosdyn::client::RequestProcessorChain request_processors;
+    ::bosdyn::client::ResponseProcessorChain response_processors;
+    ::bosdyn::client::LeaseClient lease_client;
+    lease_client.SetComms(channel);
+    lease_client.SetMessagePump(pump);
+    lease_client.UpdateServiceFrom(request_processors, response_processors, wallet);
+    ::bosdyn::client::EstopClient estop_client;
+    estop_client.SetComms(channel);
+    estop_client.SetMessagePump(pump);
+    ::bosdyn::client::TimeSyncClient time_sync_client;
+    time_sync_client.SetComms(channel);
+    time_sync_client.SetMessagePump(pump);
+    auto scheduler = ::bosdyn::client::PeriodicScheduler::GetDefault();
+    const int base_threads = NumProcessThreads();
+
+    for (size_t num_keepalives = 10; num_keepalives <= max_keepalives; num_keepalives *= 10) {
+        PrintHeader(std::to_string(num_keepalives) + " each of lease, E-Stop and time sync, " +
+                    std::to_string(kInterval.count()) + " s interval, " +
+                    bosdyn::benchmarks::FormatNumber(delay_ms) + " ms server delay");
+
+        std::vector<std::unique_ptr<::bosdyn::client::LeaseKeepAlive>> lease_keepalives;
+        std::vector<std::unique_ptr<::bosdyn::client::EstopEndpoint>> estop_endpoints;
+        std::vector<std::unique_ptr<::bosdyn::client::EstopKeepAlive>> estop_keepalives;
+        std::vector<std::unique_ptr<::bosdyn::client::TimeSyncThread>> time_sync_threads;
+        for (size_t i = 0; i < num_keepalives; ++i) {
+            const std::string resource = "body-" + std::to_string(i);
+            ::bosdyn::api::Lease lease;
+            lease.set_resource(resource);
+            lease.set_epoch("benchmark");
+            lease.add_sequence(1);
+            wallet->AddLease(::bosdyn::client::Lease(lease));
+            lease_keepalives.push_back(std::make_unique<::bosdyn::client::LeaseKeepAlive>(
+                &lease_client, wallet, resource, kInterval, nullptr, scheduler));
+
+            estop_endpoints.push_back(std::make_unique<::bosdyn::client::EstopEndpoint>(
+                &estop_client, "endpoint-" + std::to_string(i), 3 * kInterval));
+            estop_keepalives.push_back(std::make_unique<::bosdyn::client::EstopKeepAlive>(
+                estop_endpoints.back().get(), kInterval, kInterval, scheduler));
+
+            time_sync_threads.push_back(std::make_unique<::bosdyn::client::TimeSyncThread>(
+                &time_sync_client, kInterval, scheduler));
+            time_sync_threads.back()->Start();
+        }
+
+        // Measure from the second check-in of each keepalive on.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        lease_service.gaps.Take();
+        estop_service.gaps.Take();
+        time_sync_service.gaps.Take();
+        const std::clock_t cpu_start = std::clock();
+        const auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        const double wall_seconds = SecondsSince(start);
+        const int num_threads = NumProcessThreads();
+
+        PrintLatency("lease check-in gap", Summarize(lease_service.gaps.Take()), "ms");
+        PrintLatency("E-Stop check-in gap", Summarize(estop_service.gaps.Take()), "ms");
+        PrintLatency("time sync update gap (10% jitter)", Summarize(time_sync_service.gaps.Take()),
+                     "ms");
+        PrintResult("scheduler tasks", static_cast<double>(scheduler->NumTasks()), "");
+        PrintResult("scheduler threads", static_cast<double>(scheduler->NumThreads()), "");
+        PrintResult("process threads added", static_cast<double>(num_threads - base_threads), "");
+        PrintResult("process CPU, including the server", 100.0 * cpu_seconds / wall_seconds, "%");
+
+        estop_keepalives.clear();
+        lease_keepalives.clear();
+        time_sync_threads.clear();
+    }
+
+    pump->RequestShutdown();
+    return 0;
+}
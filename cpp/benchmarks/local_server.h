@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bosdyn {
+
+namespace benchmarks {
+
+// In-process gRPC server on a free localhost port, standing in for the robot's services. Clients
+// connect with Channel() and skip the proxy, so no certificates or tokens are involved.
+class LocalServer {
+ public:
+    explicit LocalServer(const std::vector<grpc::Service*>& services) {
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &m_port);
+        builder.SetMaxSendMessageSize(-1);
+        builder.SetMaxReceiveMessageSize(-1);
+        for (grpc::Service* service : services) builder.RegisterService(service);
+        m_server = builder.BuildAndStart();
+    }
+
+    ~LocalServer() {
+        if (m_server) m_server->Shutdown();
+    }
+
+    bool ok() const { return m_server != nullptr && m_port != 0; }
+
+    std::string Address() const { return "127.0.0.1:" + std::to_string(m_port); }
+
+    // A new channel to the server. Each channel has its own connection.
+    std::shared_ptr<grpc::Channel> Channel() const {
+        grpc::ChannelArguments args;
+        args.SetMaxReceiveMessageSize(-1);
+        args.SetMaxSendMessageSize(-1);
+        args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        return grpc::CreateCustomChannel(Address(), grpc::InsecureChannelCredentials(), args);
+    }
+
+ private:
+    int m_port = 0;
+    std::unique_ptr<grpc::Server> m_server;
+};
+
+}  // namespace benchmarks
+
+}  // namespace bosdyn
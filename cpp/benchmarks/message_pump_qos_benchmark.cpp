@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Latency of a LATENCY_CRITICAL call (E-Stop status) while BULK_THROUGHPUT calls (8 MiB images)
+// complete on the same MessagePump, with one completion queue, one queue per QualityOfService
+// serviced by AutoUpdate, and one queue per QualityOfService serviced by a single CompleteOne
+// thread. The services are in-process stand-ins on localhost.
+
+#include <bosdyn/api/estop_service.grpc.pb.h>
+#include <bosdyn/api/image_service.grpc.pb.h>
+
+#include <thread>
+
+#include "benchmark_util.h"
+#include "local_server.h"
+#include "bosdyn/client/estop/estop_client.h"
+#include "bosdyn/client/image/image_client.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::LocalServer;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintLatency;
+using bosdyn::benchmarks::Summarize;
+
+namespace {
+
+constexpr size_t kImageBytes = 8 << 20;
+constexpr size_t kNumLoadThreads = 4;
+constexpr size_t kNumSamples = 2000;
+
+class FakeEstopService : public ::bosdyn::api::EstopService::Service {
+ public:
+    grpc::Status GetEstopSystemStatus(grpc::ServerContext*,
+                                      const ::bosdyn::api::GetEstopSystemStatusRequest*,
+                                      ::bosdyn::api::GetEstopSystemStatusResponse*) override {
+        return grpc::Status::OK;
+    }
+};
+
+class FakeImageService : public ::bosdyn::api::ImageService::Service {
+ public:
+    FakeImageService() {
+        auto* image = m_response.add_image_responses()->mutable_shot()->mutable_image();
+        image->set_rows(2048);
+        image->set_cols(4096);
+        image->mutable_data()->assign(kImageBytes, '\x5a');
+    }
+
+    grpc::Status GetImage(grpc::ServerContext*, const ::bosdyn::api::GetImageRequest*,
+                          ::bosdyn::api::GetImageResponse* response) override {
+        *response = m_response;
+        return grpc::Status::OK;
+    }
+
+ private:
+    ::bosdyn::api::GetImageResponse m_response;
+};
+
+// Image client issuing its calls as BULK_THROUGHPUT, like a point cloud or log download client.
+class BulkImageClient : public ::bosdyn::client::ImageClient {
+ public:
+    QualityOfService GetQualityOfService() const override {
+        return QualityOfService::BULK_THROUGHPUT;
+    }
+};
+
+enum class PumpMode { kSingleQueue, kQueuePerQos, kQueuePerQosCompleteOne };
+
+// E-Stop status round trip latencies in microseconds, with or without image load.
+std::vector<double> MeasureEstopLatency(const LocalServer& server, PumpMode mode, bool with_load) {
+    auto pump = std::make_shared<::bosdyn::client::MessagePump>(
+        mode == PumpMode::kSingleQueue ? 1 : ::bosdyn::client::kNumCompletionQueueClasses);
+    std::thread complete_one_thread;
+    if (mode == PumpMode::kQueuePerQosCompleteOne) {
+        complete_one_thread = std::thread([pump_ptr = pump.get()]() {
+            while (pump_ptr->CompleteOne(std::chrono::milliseconds(100)) !=
+                   ::bosdyn::client::Shutdown) {
+            }
+        });
+    } else {
+        pump->AutoUpdate(std::chrono::milliseconds(100));
+    }
+
+    ::bosdyn::client::EstopClient estop_client;
+    estop_client.SetComms(server.Channel());
+    estop_client.SetMessagePump(pump);
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> load_threads;
+    std::vector<std::unique_ptr<BulkImageClient>> image_clients;
+    if (with_load) {
+        for (size_t i = 0; i < kNumLoadThreads; ++i) {
+            image_clients.push_back(std::make_unique<BulkImageClient>());
+            BulkImageClient* client = image_clients.back().get();
+            client->SetComms(server.Channel());
+            client->SetMessagePump(pump);
+            load_threads.emplace_back([client, &stop]() {
+                while (!stop) DoNotOptimize(client->GetImage({"camera"}));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    size_t errors = 0;
+    std::vector<double> samples;
+    samples.reserve(kNumSamples);
+    for (size_t i = 0; i < kNumSamples; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = estop_client.GetEstopStatus();
+        samples.push_back(
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                .count());
+        if (!result) errors++;
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    stop = true;
+    for (auto& thread : load_threads) thread.join();
+    pump->RequestShutdown();
+    if (complete_one_thread.joinable()) complete_one_thread.join();
+    if (errors > 0) std::fprintf(stderr, "%zu E-Stop status calls failed.\n", errors);
+    return samples;
+}
+
+}  // namespace
+
+int main() {
+    FakeEstopService estop_service;
+    FakeImageService image_service;
+    LocalServer server({&estop_service, &image_service});
+    if (!server.ok()) {
+        std::fprintf(stderr, "Failed to start the local server.\n");
+        return 1;
+    }
+
+    const std::pair<PumpMode, const char*> modes[] = {
+        {PumpMode::kSingleQueue, "1 queue, AutoUpdate"},
+        {PumpMode::kQueuePerQos, "queue per QoS, AutoUpdate"},
+        {PumpMode::kQueuePerQosCompleteOne, "queue per QoS, CompleteOne"},
+    };
+    for (bool with_load : {false, true}) {
+        PrintHeader(with_load ? "E-Stop status latency, " + std::to_string(kNumLoadThreads) +
+                                    " concurrent 8 MiB BULK_THROUGHPUT image calls"
+                              : std::string("E-Stop status latency, idle"));
+        for (const auto& mode : modes) {
+            PrintLatency(mode.second, Summarize(MeasureEstopLatency(server, mode.first, with_load)),
+                         "us");
+        }
+    }
+    return 0;
+}
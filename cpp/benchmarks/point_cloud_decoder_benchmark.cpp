@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Decoding speed of DecodePointCloud for XYZ_32F, XYZ_4SC and XYZ_5SC clouds of 10k to 2M points,
+// with the scalar kernels and the AVX2 or NEON kernels, against a per-point loop that follows
+// point_cloud.proto directly. Also reports the largest relative difference of each kernel from the
+// per-point loop.
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "benchmark_util.h"
+#include "bosdyn/client/point_cloud/point_cloud_decoder.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::client::PointCloudKernel;
+
+namespace {
+
+::bosdyn::api::PointCloud MakeCloud(::bosdyn::api::PointCloud::Encoding encoding,
+                                    size_t num_points) {
+    ::bosdyn::api::PointCloud cloud;
+    cloud.set_encoding(encoding);
+    cloud.set_num_points(static_cast<int>(num_points));
+    auto* parameters = cloud.mutable_encoding_parameters();
+    parameters->set_scale_factor(encoding == ::bosdyn::api::PointCloud::ENCODING_XYZ_4SC ? 6 : 40);
+    parameters->set_max_x(20.0);
+    parameters->set_max_y(20.0);
+    parameters->set_max_z(10.0);
+    parameters->set_remapping_constant(1.2);
+
+    std::mt19937 random(7);
+    std::string* data = cloud.mutable_data();
+    data->resize(num_points * ::bosdyn::client::PointCloudBytesPerPoint(encoding));
+    if (encoding == ::bosdyn::api::PointCloud::ENCODING_XYZ_32F) {
+        std::uniform_real_distribution<float> coordinate(-20.0f, 20.0f);
+        for (size_t i = 0; i < 3 * num_points; ++i) {
+            const float value = coordinate(random);
+            std::memcpy(&(*data)[i * sizeof(float)], &value, sizeof(float));
+        }
+    } else {
+        const uint32_t max_extra = encoding == ::bosdyn::api::PointCloud::ENCODING_XYZ_4SC
+                                       ? 6 * 6 * 6 - 1
+                                       : 40 * 40 * 40 - 1;
+        std::uniform_int_distribution<uint32_t> byte(0, 255);
+        std::uniform_int_distribution<uint32_t> extra(0, max_extra);
+        const size_t bytes_per_point = ::bosdyn::client::PointCloudBytesPerPoint(encoding);
+        for (size_t i = 0; i < num_points; ++i) {
+            char* point = &(*data)[i * bytes_per_point];
+            for (int axis = 0; axis < 3; ++axis) point[axis] = static_cast<char>(byte(random));
+            const uint32_t value = extra(random);
+            point[3] = static_cast<char>(value & 0xff);
+            if (bytes_per_point == 5) point[4] = static_cast<char>(value >> 8);
+        }
+    }
+    return cloud;
+}
+
+// Decode one point at a time, as written in point_cloud.proto.
+void DecodePerPoint(const ::bosdyn::api::PointCloud& cloud, float* xyz) {
+    const auto* data = reinterpret_cast<const uint8_t*>(cloud.data().data());
+    const size_t num_points = cloud.num_points();
+    if (cloud.encoding() == ::bosdyn::api::PointCloud::ENCODING_XYZ_32F) {
+        std::memcpy(xyz, data, num_points * 3 * sizeof(float));
+        return;
+    }
+    const auto& parameters = cloud.encoding_parameters();
+    const int f = parameters.scale_factor();
+    const double c = parameters.remapping_constant();
+    const double max[3] = {parameters.max_x(), parameters.max_y(), parameters.max_z()};
+    const bool is_5sc = cloud.encoding() == ::bosdyn::api::PointCloud::ENCODING_XYZ_5SC;
+    const size_t bytes_per_point = is_5sc ? 5 : 4;
+    for (size_t i = 0; i < num_points; ++i) {
+        const uint8_t* point = data + i * bytes_per_point;
+        int extra = is_5sc ? (point[3] | (point[4] << 8)) : point[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const int p1 = static_cast<int8_t>(point[axis]);
+            const int p2 = extra % f - f / 2;
+            extra /= f;
+            xyz[3 * i + axis] = static_cast<float>(max[axis] * (p1 * f + p2) / (c * f));
+        }
+    }
+}
+
+// Largest difference relative to the magnitude of the reference value, at least 1 m.
+double MaxRelativeDifference(const std::vector<float>& values,
+                             const std::vector<float>& reference) {
+    double difference = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const double scale = std::max(1.0, std::abs(static_cast<double>(reference[i])));
+        difference = std::max(difference, std::abs(values[i] - reference[i]) / scale);
+    }
+    return difference;
+}
+
+const char* EncodingName(::bosdyn::api::PointCloud::Encoding encoding) {
+    switch (encoding) {
+        case ::bosdyn::api::PointCloud::ENCODING_XYZ_32F:
+            return "XYZ_32F";
+        case ::bosdyn::api::PointCloud::ENCODING_XYZ_4SC:
+            return "XYZ_4SC";
+        default:
+            return "XYZ_5SC";
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::vector<std::pair<PointCloudKernel, const char*>> kernels = {
+        {PointCloudKernel::kScalar, "scalar"}};
+    if (::bosdyn::client::SetPointCloudKernel(PointCloudKernel::kAvx2)) {
+        kernels.push_back({PointCloudKernel::kAvx2, "AVX2"});
+    } else if (::bosdyn::client::SetPointCloudKernel(PointCloudKernel::kNeon)) {
+        kernels.push_back({PointCloudKernel::kNeon, "NEON"});
+    } else {
+        std::printf("Neither AVX2 nor NEON kernels are supported by this build and CPU.\n");
+    }
+
+    ::bosdyn::api::SE3Pose pose;
+    pose.mutable_position()->set_x(1.0);
+    pose.mutable_position()->set_z(0.5);
+    pose.mutable_rotation()->set_w(std::cos(0.3));
+    pose.mutable_rotation()->set_z(std::sin(0.3));
+    const auto transform = ::bosdyn::client::PointTransform::FromSE3Pose(pose);
+
+    for (auto encoding : {::bosdyn::api::PointCloud::ENCODING_XYZ_32F,
+                          ::bosdyn::api::PointCloud::ENCODING_XYZ_4SC,
+                          ::bosdyn::api::PointCloud::ENCODING_XYZ_5SC}) {
+        for (size_t num_points : {10000, 100000, 1000000, 2000000}) {
+            const auto cloud = MakeCloud(encoding, num_points);
+            PrintHeader(std::string(EncodingName(encoding)) + ", " + std::to_string(num_points) +
+                        " points");
+            const double points = static_cast<double>(num_points);
+
+            std::vector<float> reference(3 * num_points);
+            PrintResult("per-point loop, interleaved",
+                        NsPerCall([&]() { DecodePerPoint(cloud, reference.data()); }) / points,
+                        "ns/point");
+
+            std::vector<float> xyz(3 * num_points);
+            std::vector<float> x(num_points), y(num_points), z(num_points);
+            for (const auto& kernel : kernels) {
+                ::bosdyn::client::SetPointCloudKernel(kernel.first);
+                const std::string name = kernel.second;
+                PrintResult(name + ", interleaved", NsPerCall([&]() {
+                                auto status = ::bosdyn::client::DecodePointCloud(cloud, xyz.data());
+                                DoNotOptimize(status);
+                            }) / points,
+                            "ns/point");
+                PrintResult(name + ", separate + transform", NsPerCall([&]() {
+                                auto status = ::bosdyn::client::DecodePointCloud(
+                                    cloud, x.data(), y.data(), z.data(), &transform);
+                                DoNotOptimize(status);
+                            }) / points,
+                            "ns/point");
+                if (!::bosdyn::client::DecodePointCloud(cloud, xyz.data())) return 1;
+                PrintResult(name + ", max difference from per-point loop",
+                            MaxRelativeDifference(xyz, reference) * 1e6, "ppm");
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// RoutePlanner on a synthetic grid-shaped graph of side x side waypoints (316, about 100k
+// waypoints, by default), with 15% of the grid edges missing and 10% of the rest carrying a cost
+// annotation. Compares A* (anchored graph) and bidirectional Dijkstra (unanchored graph) against
+// Dijkstra over maps keyed by waypoint id, and checks that they find routes of the same cost.
+//
+// Usage: route_planner_benchmark [side]
+
+#include <bosdyn/api/graph_nav/map.pb.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <queue>
+#include <random>
+
+#include "benchmark_util.h"
+#include "bosdyn/client/graph_nav/route_planner.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::benchmarks::SecondsSince;
+using bosdyn::client::RoutePlanner;
+
+namespace {
+
+std::string WaypointId(int row, int col) {
+    return "waypoint_" + std::to_string(row) + "_" + std::to_string(col);
+}
+
+::bosdyn::api::graph_nav::Graph MakeGrid(int side) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    ::bosdyn::api::graph_nav::Graph graph;
+    std::vector<std::pair<double, double>> positions;
+    for (int row = 0; row < side; ++row) {
+        for (int col = 0; col < side; ++col) {
+            const std::string id = WaypointId(row, col);
+            graph.add_waypoints()->set_id(id);
+            positions.emplace_back(col + jitter(random), row + jitter(random));
+            auto* anchor = graph.mutable_anchoring()->add_anchors();
+            anchor->set_id(id);
+            auto* pose = anchor->mutable_seed_tform_waypoint();
+            pose->mutable_position()->set_x(positions.back().first);
+            pose->mutable_position()->set_y(positions.back().second);
+            pose->mutable_rotation()->set_w(1.0);
+        }
+    }
+    auto add_edge = [&](int row, int col, int to_row, int to_col) {
+        if (to_row >= side || to_col >= side || unit(random) < 0.15) return;
+        const auto& from = positions[row * side + col];
+        const auto& to = positions[to_row * side + to_col];
+        auto* edge = graph.add_edges();
+        edge->mutable_id()->set_from_waypoint(WaypointId(row, col));
+        edge->mutable_id()->set_to_waypoint(WaypointId(to_row, to_col));
+        edge->mutable_from_tform_to()->mutable_position()->set_x(to.first - from.first);
+        edge->mutable_from_tform_to()->mutable_position()->set_y(to.second - from.second);
+        edge->mutable_from_tform_to()->mutable_rotation()->set_w(1.0);
+        if (unit(random) < 0.1) {
+            edge->mutable_annotations()->mutable_cost()->set_value(1.5 + unit(random));
+        }
+    };
+    for (int row = 0; row < side; ++row) {
+        for (int col = 0; col < side; ++col) {
+            add_edge(row, col, row, col + 1);
+            add_edge(row, col, row + 1, col);
+        }
+    }
+    return graph;
+}
+
+// Dijkstra over the graph as maps keyed by waypoint id.
+class MapDijkstra {
+ public:
+    explicit MapDijkstra(const ::bosdyn::api::graph_nav::Graph& graph) {
+        for (const auto& edge : graph.edges()) {
+            const auto& p = edge.from_tform_to().position();
+            const double cost = edge.annotations().has_cost()
+                                    ? edge.annotations().cost().value()
+                                    : std::sqrt(p.x() * p.x() + p.y() * p.y() + p.z() * p.z());
+            m_adjacency[edge.id().from_waypoint()].emplace_back(edge.id().to_waypoint(), cost);
+            m_adjacency[edge.id().to_waypoint()].emplace_back(edge.id().from_waypoint(), cost);
+        }
+    }
+
+    double Cost(const std::string& from, const std::string& to) const {
+        using Entry = std::pair<double, std::string>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        std::map<std::string, double> costs;
+        costs[from] = 0.0;
+        queue.emplace(0.0, from);
+        while (!queue.empty()) {
+            Entry entry = queue.top();
+            queue.pop();
+            if (entry.second == to) return entry.first;
+            if (entry.first > costs[entry.second]) continue;
+            auto it = m_adjacency.find(entry.second);
+            if (it == m_adjacency.end()) continue;
+            for (const auto& next : it->second) {
+                const double cost = entry.first + next.second;
+                auto found = costs.find(next.first);
+                if (found == costs.end() || cost < found->second) {
+                    costs[next.first] = cost;
+                    queue.emplace(cost, next.first);
+                }
+            }
+        }
+        return INFINITY;
+    }
+
+ private:
+    std::map<std::string, std::vector<std::pair<std::string, double>>> m_adjacency;
+};
+
+// Mean ms per FindRoute over the queries. Counts the routes whose cost differs from
+// expected_costs, which covers the first queries, in mismatches.
+double TimeFindRoute(const RoutePlanner& planner,
+                     const std::vector<std::pair<std::string, std::string>>& queries,
+                     const std::vector<double>& expected_costs, int* mismatches) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<double> costs(queries.size(), INFINITY);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        ::bosdyn::api::graph_nav::Route route;
+        auto status = planner.FindRoute(queries[i].first, queries[i].second, &route, &costs[i]);
+        DoNotOptimize(status);
+    }
+    const double ms = SecondsSince(start) * 1e3 / queries.size();
+    for (size_t i = 0; i < expected_costs.size(); ++i) {
+        if (std::abs(costs[i] - expected_costs[i]) > 1e-6 * std::max(1.0, expected_costs[i]) &&
+            !(std::isinf(costs[i]) && std::isinf(expected_costs[i]))) {
+            ++*mismatches;
+        }
+    }
+    return ms;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int side = argc > 1 ? std::atoi(argv[1]) : 316;
+    const auto graph = MakeGrid(side);
+    auto unanchored_graph = graph;
+    unanchored_graph.clear_anchoring();
+    PrintHeader(std::to_string(graph.waypoints_size()) + " waypoints, " +
+                std::to_string(graph.edges_size()) + " edges");
+
+    RoutePlanner planner;
+    auto start = std::chrono::steady_clock::now();
+    auto status = planner.Build(graph);
+    PrintResult("Build", SecondsSince(start) * 1e3, "ms");
+    RoutePlanner unanchored_planner;
+    if (!status || !(status = unanchored_planner.Build(unanchored_graph))) {
+        std::printf("Build failed: %s\n", status.DebugString().c_str());
+        return 1;
+    }
+
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> coordinate(0, side - 1);
+    auto random_waypoint = [&]() { return WaypointId(coordinate(random), coordinate(random)); };
+    std::vector<std::pair<std::string, std::string>> queries;
+    for (int i = 0; i < 100; ++i) queries.emplace_back(random_waypoint(), random_waypoint());
+
+    // The map-based search is slow, so only the first queries are checked against it.
+    const size_t num_checked = 10;
+    MapDijkstra map_dijkstra(graph);
+    std::vector<double> expected_costs;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_checked; ++i) {
+        expected_costs.push_back(map_dijkstra.Cost(queries[i].first, queries[i].second));
+    }
+    PrintResult("FindRoute, Dijkstra over std::map ids", SecondsSince(start) * 1e3 / num_checked,
+                "ms/query");
+
+    int mismatches = 0;
+    PrintResult("FindRoute, A*", TimeFindRoute(planner, queries, expected_costs, &mismatches),
+                "ms/query");
+    PrintResult("FindRoute, bidirectional Dijkstra",
+                TimeFindRoute(unanchored_planner, queries, expected_costs, &mismatches),
+                "ms/query");
+
+    std::vector<std::string> sources, targets;
+    for (int i = 0; i < 20; ++i) sources.push_back(random_waypoint());
+    for (int i = 0; i < 50; ++i) targets.push_back(random_waypoint());
+    std::vector<double> costs;
+    start = std::chrono::steady_clock::now();
+    status = planner.ComputeCostMatrix(sources, targets, &costs);
+    DoNotOptimize(status);
+    PrintResult("ComputeCostMatrix 20x50", SecondsSince(start) * 1e3 / sources.size(),
+                "ms/source");
+
+    const int num_added = 1000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_added; ++i) {
+        ::bosdyn::api::graph_nav::Edge edge;
+        edge.mutable_id()->set_from_waypoint(random_waypoint());
+        edge.mutable_id()->set_to_waypoint("recorded_" + std::to_string(i));
+        edge.mutable_from_tform_to()->mutable_position()->set_x(1.0);
+        status = planner.AddEdge(edge);
+        DoNotOptimize(status);
+    }
+    PrintResult("AddEdge", SecondsSince(start) * 1e6 / num_added, "us/call");
+
+    std::printf("  %d of %zu checked routes differ from the map-based search\n", mismatches,
+                2 * num_checked);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Stress test of the service client cache of a Robot. In each round, N threads are released at
+// once on a set of new service names of several client types, half of them through
+// EnsureServiceClient and half through GetServiceClientHandle. They first go through the names in
+// the same order, racing through the create path, then again in orders of their own, through the
+// shared-lock lookup. Checks that every thread got the same client for each service name, and that
+// each client was constructed exactly once. Exits with 1 if a check fails. With few cores the race
+// is rarely lost, hence the many rounds.
+//
+// Usage: service_client_cache_stress [threads, default 8] [rounds, default 20000]
+
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "bosdyn/client/estop/estop_client.h"
+#include "bosdyn/client/lease/lease_client.h"
+#include "bosdyn/client/robot_state/robot_state_client.h"
+#include "bosdyn/client/sdk/client_sdk.h"
+#include "bosdyn/client/time_sync/time_sync_client.h"
+
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::benchmarks::SecondsSince;
+
+namespace {
+
+constexpr int kNamesPerType = 4;
+
+// A client type that counts its constructions, so that a client created by a thread that lost the
+// race to create it would show up even though only one of them is cached.
+template <class Client>
+class CountedClient : public Client {
+ public:
+    CountedClient() { ++num_constructed; }
+    static std::atomic<int> num_constructed;
+};
+
+template <class Client>
+std::atomic<int> CountedClient<Client>::num_constructed{0};
+
+typedef CountedClient<::bosdyn::client::TimeSyncClient> CountedTimeSyncClient;
+typedef CountedClient<::bosdyn::client::LeaseClient> CountedLeaseClient;
+typedef CountedClient<::bosdyn::client::EstopClient> CountedEstopClient;
+typedef CountedClient<::bosdyn::client::RobotStateClient> CountedRobotStateClient;
+
+constexpr int kNumTypes = 4;
+
+// Get the client of the type_index-th type for service_name, through EnsureServiceClient or a
+// handle, and return its address, or nullptr on an error.
+const void* GetClient(::bosdyn::client::Robot* robot, int type_index,
+                      const std::string& service_name,
+                      const std::shared_ptr<grpc::Channel>& channel, bool use_handle) {
+    auto get = [&](auto* type) -> const void* {
+        typedef std::remove_pointer_t<decltype(type)> T;
+        if (use_handle) {
+            auto handle = robot->GetServiceClientHandle<T>(service_name, channel);
+            return handle ? handle.response.get() : nullptr;
+        }
+        auto client = robot->EnsureServiceClient<T>(service_name, channel);
+        return client ? client.response : nullptr;
+    };
+    switch (type_index) {
+        case 0:
+            return get(static_cast<CountedTimeSyncClient*>(nullptr));
+        case 1:
+            return get(static_cast<CountedLeaseClient*>(nullptr));
+        case 2:
+            return get(static_cast<CountedEstopClient*>(nullptr));
+        default:
+            return get(static_cast<CountedRobotStateClient*>(nullptr));
+    }
+}
+
+int NumConstructed() {
+    return CountedTimeSyncClient::num_constructed + CountedLeaseClient::num_constructed +
+           CountedEstopClient::num_constructed + CountedRobotStateClient::num_constructed;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int num_threads = argc > 1 ? std::atoi(argv[1]) : 8;
+    const int num_rounds = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    auto sdk = ::bosdyn::client::CreateStandardSDK("service_client_cache_stress");
+    auto robot_result = sdk->CreateRobot("127.0.0.1");
+    if (!robot_result) {
+        std::printf("Could not create robot: %s\n", robot_result.status.DebugString().c_str());
+        return 1;
+    }
+    auto robot = robot_result.move();
+    // The channel is never connected; the clients are only created and looked up.
+    auto channel = grpc::CreateChannel("127.0.0.1:1", grpc::InsecureChannelCredentials());
+
+    PrintHeader(std::to_string(num_threads) + " threads, " + std::to_string(num_rounds) +
+                " rounds of " + std::to_string(kNumTypes * kNamesPerType) + " new clients of " +
+                std::to_string(kNumTypes) + " types");
+
+    // Each round's service names are new, so each round races to create its clients.
+    const int num_clients = kNumTypes * kNamesPerType;
+    std::vector<std::string> service_names;
+    for (int round = 0; round < num_rounds; ++round) {
+        for (int i = 0; i < num_clients; ++i) {
+            service_names.push_back("stress-" + std::to_string(round) + "-" + std::to_string(i));
+        }
+    }
+
+    // clients[thread][round * num_clients + i] is the client the thread got for that name.
+    std::vector<std::vector<const void*>> clients(num_threads,
+                                                  std::vector<const void*>(service_names.size()));
+    std::atomic<int> round_started{-1};
+    std::atomic<int> num_done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 random(t);
+            std::vector<int> order(num_clients);
+            for (int round = 0; round < num_rounds; ++round) {
+                while (round_started.load() < round) std::this_thread::yield();
+                // All threads go through the names in the same order first, so that they race to
+                // create each client, then in an order of their own, which only hits the lookup.
+                for (int i = 0; i < num_clients; ++i) order[i] = i;
+                for (int pass = 0; pass < 2; ++pass) {
+                    if (pass == 1) std::shuffle(order.begin(), order.end(), random);
+                    for (int i : order) {
+                        const size_t index = static_cast<size_t>(round * num_clients + i);
+                        const void* client =
+                            GetClient(robot.get(), i % kNumTypes, service_names[index], channel,
+                                      (t + pass) % 2 == 1);
+                        if (pass == 0) {
+                            clients[t][index] = client;
+                        } else if (client != clients[t][index]) {
+                            clients[t][index] = nullptr;
+                        }
+                    }
+                }
+                ++num_done;
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < num_rounds; ++round) {
+        num_done = 0;
+        round_started = round;
+        while (num_done.load() < num_threads) std::this_thread::yield();
+    }
+    const double seconds = SecondsSince(start);
+    for (auto& thread : threads) thread.join();
+
+    int num_mismatches = 0;
+    for (size_t index = 0; index < service_names.size(); ++index) {
+        for (int t = 0; t < num_threads; ++t) {
+            if (clients[t][index] == nullptr || clients[t][index] != clients[0][index]) {
+                ++num_mismatches;
+                break;
+            }
+        }
+    }
+    const int num_created = NumConstructed();
+
+    PrintResult("rounds", num_rounds / seconds, "rounds/s");
+    PrintResult("clients expected", static_cast<double>(service_names.size()), "");
+    PrintResult("clients constructed", static_cast<double>(num_created), "");
+    PrintResult("names with a different or missing client", static_cast<double>(num_mismatches),
+                "");
+    const bool ok = num_mismatches == 0 && num_created == static_cast<int>(service_names.size());
+    std::printf("  %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
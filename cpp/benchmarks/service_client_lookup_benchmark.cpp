@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Cost of getting a cached ServiceClient from a Robot: Robot::EnsureServiceClient, which looks the
+// service name up under a shared lock on every call, against a ServiceClientHandle resolved once.
+// Each case runs on 1 and on N threads at once to show contention on the cache lock.
+
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+
+#include <cstdlib>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "bosdyn/client/sdk/client_sdk.h"
+#include "bosdyn/client/time_sync/time_sync_client.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+using bosdyn::client::TimeSyncClient;
+
+namespace {
+
+constexpr int kCachedClients = 32;
+
+// Mean ns per call of fn, with num_threads threads calling it at the same time.
+template <typename Fn>
+double ConcurrentNsPerCall(int num_threads, const Fn& fn) {
+    std::vector<double> results(num_threads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&results, &fn, i]() { results[i] = NsPerCall(fn); });
+    }
+    for (auto& thread : threads) thread.join();
+    double total = 0.0;
+    for (double result : results) total += result;
+    return total / num_threads;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int num_threads = argc > 1 ? std::atoi(argv[1]) : 4;
+
+    auto sdk = ::bosdyn::client::CreateStandardSDK("service_client_lookup_benchmark");
+    auto robot_result = sdk->CreateRobot("127.0.0.1");
+    if (!robot_result) {
+        std::printf("Could not create robot: %s\n", robot_result.status.DebugString().c_str());
+        return 1;
+    }
+    auto robot = robot_result.move();
+
+    // The channel is never connected; the clients are only looked up.
+    auto channel = grpc::CreateChannel("127.0.0.1:1", grpc::InsecureChannelCredentials());
+    for (int i = 0; i < kCachedClients; ++i) {
+        auto client = robot->EnsureServiceClient<TimeSyncClient>(
+            "time-sync-" + std::to_string(i), channel);
+        if (!client) {
+            std::printf("Could not create client: %s\n", client.status.DebugString().c_str());
+            return 1;
+        }
+    }
+    const std::string service_name = "time-sync-" + std::to_string(kCachedClients / 2);
+    auto handle = robot->GetServiceClientHandle<TimeSyncClient>(service_name, channel).move();
+
+    auto ensure = [&robot, &service_name]() {
+        auto client = robot->EnsureServiceClient<TimeSyncClient>(service_name);
+        DoNotOptimize(client.response);
+    };
+    auto use_handle = [&handle]() {
+        TimeSyncClient* client = handle.get();
+        DoNotOptimize(client);
+    };
+
+    PrintHeader("Cached client lookup, " + std::to_string(kCachedClients) + " clients cached");
+    PrintResult("EnsureServiceClient, 1 thread", NsPerCall(ensure), "ns/call");
+    PrintResult("EnsureServiceClient, " + std::to_string(num_threads) + " threads",
+                ConcurrentNsPerCall(num_threads, ensure), "ns/call");
+    PrintResult("ServiceClientHandle, 1 thread", NsPerCall(use_handle), "ns/call");
+    PrintResult("ServiceClientHandle, " + std::to_string(num_threads) + " threads",
+                ConcurrentNsPerCall(num_threads, use_handle), "ns/call");
+    return 0;
+}
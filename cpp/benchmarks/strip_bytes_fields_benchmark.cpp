@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+// Cost of echoing a request into a response header with PrepareResponseHeader, which copies the
+// request without its whitelisted bytes fields, against copying the whole request and then
+// stripping the copy. Also the cost of finding the strip function of a message type by
+// descriptor, against looking its full name up in kWhitelistedBytesFieldsMap.
+
+#include <bosdyn/api/robot_state.pb.h>
+
+#include <memory>
+
+#include "benchmark_util.h"
+#include "bosdyn/common/common_header_handling.h"
+#include "bosdyn/common/strip_bytes_fields.h"
+
+using bosdyn::benchmarks::DoNotOptimize;
+using bosdyn::benchmarks::NsPerCall;
+using bosdyn::benchmarks::PrintHeader;
+using bosdyn::benchmarks::PrintResult;
+namespace strip_messages = ::bosdyn::common::strip_messages;
+
+namespace {
+
+::bosdyn::api::GetImageResponse MakeImageResponse(int num_images, size_t image_bytes) {
+    ::bosdyn::api::GetImageResponse response;
+    for (int i = 0; i < num_images; ++i) {
+        auto* image_response = response.add_image_responses();
+        image_response->mutable_source()->set_name("camera_" + std::to_string(i));
+        auto* image = image_response->mutable_shot()->mutable_image();
+        image->set_rows(480);
+        image->set_cols(640);
+        image->mutable_data()->assign(image_bytes, static_cast<char>(i));
+    }
+    return response;
+}
+
+::bosdyn::api::StoreDataRequest MakeStoreDataRequest(size_t data_bytes) {
+    ::bosdyn::api::StoreDataRequest request;
+    request.mutable_data()->assign(data_bytes, 'x');
+    request.mutable_data_id()->set_channel("payload");
+    request.set_file_extension("bin");
+    return request;
+}
+
+// The echo as done before: copy everything, then clear the large fields of the copy.
+void CopyThenStrip(const ::bosdyn::api::RequestHeader& request_header,
+                   const google::protobuf::Message& request,
+                   ::bosdyn::api::ResponseHeader* header) {
+    header->mutable_request_header()->CopyFrom(request_header);
+    std::unique_ptr<google::protobuf::Message> copy(request.New());
+    copy->CopyFrom(request);
+    ::bosdyn::common::StripLargeByteFields(copy.get());
+    header->mutable_request()->PackFrom(*copy);
+}
+
+void CompareEcho(const std::string& name, const google::protobuf::Message& request) {
+    ::bosdyn::api::RequestHeader request_header;
+    request_header.set_client_name("benchmark");
+    PrintHeader(name + ", " + std::to_string(request.ByteSizeLong() >> 20) + " MiB");
+    PrintResult("copy, then strip", NsPerCall([&]() {
+                    ::bosdyn::api::ResponseHeader header;
+                    CopyThenStrip(request_header, request, &header);
+                    DoNotOptimize(header);
+                }) / 1e3,
+                "us/call");
+    PrintResult("PrepareResponseHeader", NsPerCall([&]() {
+                    ::bosdyn::api::ResponseHeader header;
+                    ::bosdyn::common::PrepareResponseHeader(request_header, &request, &header);
+                    DoNotOptimize(header);
+                }) / 1e3,
+                "us/call");
+}
+
+void CompareLookup(const google::protobuf::Descriptor* descriptor) {
+    PrintResult(descriptor->name() + ", full name in map", NsPerCall([descriptor]() {
+                    auto it = strip_messages::kWhitelistedBytesFieldsMap.find(
+                        descriptor->full_name());
+                    DoNotOptimize(it);
+                }),
+                "ns/call");
+    PrintResult(descriptor->name() + ", FindStripFunction", NsPerCall([descriptor]() {
+                    DoNotOptimize(strip_messages::FindStripFunction(descriptor));
+                }),
+                "ns/call");
+}
+
+}  // namespace
+
+int main() {
+    CompareEcho("GetImageResponse with 4 images", MakeImageResponse(4, 1 << 20));
+    CompareEcho("StoreDataRequest", MakeStoreDataRequest(8 << 20));
+
+    PrintHeader("Strip function lookup");
+    CompareLookup(::bosdyn::api::GetImageResponse::descriptor());
+    CompareLookup(::bosdyn::api::RobotStateRequest::descriptor());
+
+    PrintHeader("StripLargeByteFields on a stripped GetImageResponse");
+    auto response = MakeImageResponse(4, 0);
+    PrintResult("StripLargeByteFields", NsPerCall([&response]() {
+                    ::bosdyn::common::StripLargeByteFields(&response);
+                    DoNotOptimize(response);
+                }),
+                "ns/call");
+    return 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/bddf/bddf_format.h"
+
+#include <map>
+#include <string>
+
+#include "bosdyn/bddf/sha1.h"
+
+namespace bosdyn {
+
+namespace bddf {
+
+uint64_t SeriesIdentifierHash(const ::bosdyn::api::SeriesIdentifier& series_identifier) {
+    // Protobuf maps are unordered, so sort the spec first.
+    const std::map<std::string, std::string> spec(series_identifier.spec().begin(),
+                                                  series_identifier.spec().end());
+    Sha1 sha1;
+    sha1.Update(series_identifier.series_type().data(), series_identifier.series_type().size());
+    for (const auto& key_value : spec) {
+        sha1.Update(key_value.first.data(), key_value.first.size());
+        sha1.Update(key_value.second.data(), key_value.second.size());
+    }
+    const Sha1::Digest digest = sha1.Final();
+    uint64_t hash = 0;
+    for (int i = 0; i < 8; ++i) hash = (hash << 8) | digest[i];
+    return hash;
+}
+
+}  // namespace bddf
+
+}  // namespace bosdyn
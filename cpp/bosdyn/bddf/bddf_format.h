@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/bddf.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Framing of a BDDF file (see bosdyn/api/bddf.proto), with all integers little-endian:
+//
+//   "BDDF"                                        magic
+//   block*                                        descriptor and data blocks
+//   uint64 index_offset                           offset of the FileIndex descriptor block
+//   uint8[20] checksum                            SHA1 of all preceding bytes, or zeros
+//   "FDDB"                                        end magic
+//
+// Each block starts with a uint64 header holding the block type in its top byte and the number
+// of bytes following the header in the lower 56 bits:
+//   - a descriptor block holds a serialized DescriptorBlock,
+//   - a data block holds a uint32 size, a serialized DataDescriptor of that size and the data,
+//   - the end block holds the index offset of the footer.
+// The first block is the FileFormatDescriptor, and the last descriptor blocks are a
+// SeriesBlockIndex for each series followed by the FileIndex.
+
+namespace bosdyn {
+
+namespace bddf {
+
+constexpr char kMagic[4] = {'B', 'D', 'D', 'F'};
+constexpr char kEndMagic[4] = {'F', 'D', 'D', 'B'};
+
+constexpr uint8_t kDataBlockType = 0x00;
+constexpr uint8_t kDescriptorBlockType = 0x01;
+constexpr uint8_t kEndBlockType = 0x02;
+
+constexpr int kBlockTypeShift = 56;
+constexpr uint64_t kBlockSizeMask = 0x00ffffffffffffffULL;
+constexpr size_t kBlockHeaderBytes = sizeof(uint64_t);
+
+constexpr size_t kChecksumNumBytes = 20;
+// End block header, index offset, checksum and end magic.
+constexpr size_t kFooterBytes =
+    kBlockHeaderBytes + sizeof(uint64_t) + kChecksumNumBytes + sizeof(kEndMagic);
+
+constexpr uint32_t kVersionMajor = 1;
+constexpr uint32_t kVersionMinor = 0;
+constexpr uint32_t kVersionPatch = 0;
+
+inline uint64_t MakeBlockHeader(uint8_t type, uint64_t size) {
+    return (static_cast<uint64_t>(type) << kBlockTypeShift) | (size & kBlockSizeMask);
+}
+
+// The identifier_hash of a SeriesDescriptor: the first 64 bits, read as big-endian, of the SHA1
+// of the series type followed by the keys and values of the spec in key order.
+uint64_t SeriesIdentifierHash(const ::bosdyn::api::SeriesIdentifier& series_identifier);
+
+}  // namespace bddf
+
+}  // namespace bosdyn
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/bddf/data_reader.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+
+#include "bosdyn/bddf/bddf_format.h"
+#include "bosdyn/bddf/sha1.h"
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/common/time.h"
+
+namespace bosdyn {
+
+namespace bddf {
+
+namespace {
+
+using ::bosdyn::client::SDKErrorCode;
+
+::bosdyn::common::Status ReaderError(const std::string& message) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError, "BDDF reader: " + message);
+}
+
+::bosdyn::common::Status Success() { return ::bosdyn::common::Status(SDKErrorCode::Success); }
+
+uint64_t LoadLittleEndian(const uint8_t* p, size_t num_bytes) {
+    uint64_t value = 0;
+    for (size_t i = num_bytes; i-- > 0;) value = (value << 8) | p[i];
+    return value;
+}
+
+}  // namespace
+
+DataReader::~DataReader() { Close(); }
+
+void DataReader::Close() {
+    if (m_data) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_series.clear();
+    m_file_index.Clear();
+    m_file_descriptor.Clear();
+}
+
+::bosdyn::common::Status DataReader::Open(const std::string& path) {
+    Close();
+    m_path = path;
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return ReaderError("could not open " + path + ": " + std::strerror(errno));
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0) {
+        const int error = errno;
+        ::close(fd);
+        return ReaderError("could not stat " + path + ": " + std::strerror(error));
+    }
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    if (size < sizeof(kMagic) + kFooterBytes) {
+        ::close(fd);
+        return ReaderError(path + " is too short to be a BDDF file.");
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return ReaderError("could not map " + path + ": " + std::strerror(error));
+    }
+    m_data = static_cast<const uint8_t*>(mapping);
+    m_size = size;
+
+    auto status = ReadIndex();
+    if (!status) Close();
+    return status;
+}
+
+::bosdyn::common::Status DataReader::ReadDescriptorBlock(
+    uint64_t offset, ::bosdyn::api::DescriptorBlock* block) const {
+    if (offset > m_size || m_size - offset < kBlockHeaderBytes) {
+        return ReaderError("descriptor block offset is out of the file.");
+    }
+    const uint64_t header = LoadLittleEndian(m_data + offset, kBlockHeaderBytes);
+    const uint64_t size = header & kBlockSizeMask;
+    if ((header >> kBlockTypeShift) != kDescriptorBlockType) {
+        return ReaderError("expected a descriptor block.");
+    }
+    if (size > m_size - offset - kBlockHeaderBytes) {
+        return ReaderError("descriptor block extends past the end of the file.");
+    }
+    if (!block->ParseFromArray(m_data + offset + kBlockHeaderBytes, static_cast<int>(size))) {
+        return ReaderError("could not parse descriptor block.");
+    }
+    return Success();
+}
+
+::bosdyn::common::Status DataReader::ReadIndex() {
+    if (std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0 ||
+        std::memcmp(m_data + m_size - sizeof(kEndMagic), kEndMagic, sizeof(kEndMagic)) != 0) {
+        return ReaderError(m_path + " is not a complete BDDF file.");
+    }
+
+    ::bosdyn::api::DescriptorBlock block;
+    STATUS_OK_ELSE_RETURN(ReadDescriptorBlock(sizeof(kMagic), &block));
+    if (!block.has_file_descriptor()) return ReaderError("first block is not a file descriptor.");
+    m_file_descriptor = block.file_descriptor();
+    if (m_file_descriptor.version().major_version() != kVersionMajor) {
+        return ReaderError("unsupported BDDF major version.");
+    }
+
+    const uint8_t* footer = m_data + m_size - kFooterBytes;
+    if (LoadLittleEndian(footer, kBlockHeaderBytes) >> kBlockTypeShift != kEndBlockType) {
+        return ReaderError("missing end block.");
+    }
+    const uint64_t index_offset = LoadLittleEndian(footer + kBlockHeaderBytes, sizeof(uint64_t));
+    STATUS_OK_ELSE_RETURN(ReadDescriptorBlock(index_offset, &block));
+    if (!block.has_file_index()) return ReaderError("index block is not a file index.");
+    m_file_index = block.file_index();
+    const int num_series = m_file_index.series_block_index_offsets_size();
+    if (m_file_index.series_identifiers_size() != num_series ||
+        m_file_index.series_identifier_hashes_size() != num_series) {
+        return ReaderError("inconsistent file index.");
+    }
+
+    m_series.resize(num_series);
+    for (int i = 0; i < num_series; ++i) {
+        Series& series = m_series[i];
+        STATUS_OK_ELSE_RETURN(ReadDescriptorBlock(m_file_index.series_block_index_offsets(i),
+                                                  &block));
+        if (!block.has_series_block_index()) return ReaderError("expected a series block index.");
+        series.block_index.Swap(block.mutable_series_block_index());
+        STATUS_OK_ELSE_RETURN(
+            ReadDescriptorBlock(series.block_index.descriptor_file_offset(), &block));
+        if (!block.has_series_descriptor()) return ReaderError("expected a series descriptor.");
+        series.descriptor.Swap(block.mutable_series_descriptor());
+
+        const auto& entries = series.block_index.block_entries();
+        series.timestamps.resize(entries.size());
+        for (int j = 0; j < entries.size(); ++j) {
+            series.timestamps[j] = ::bosdyn::common::TimestampToNsec(entries[j].timestamp());
+        }
+        if (!std::is_sorted(series.timestamps.begin(), series.timestamps.end())) {
+            series.entry_order.resize(entries.size());
+            std::iota(series.entry_order.begin(), series.entry_order.end(), 0);
+            std::stable_sort(series.entry_order.begin(), series.entry_order.end(),
+                             [&series](uint32_t a, uint32_t b) {
+                                 return series.timestamps[a] < series.timestamps[b];
+                             });
+            std::sort(series.timestamps.begin(), series.timestamps.end());
+        }
+    }
+    return Success();
+}
+
+bool DataReader::FindSeries(const ::bosdyn::api::SeriesIdentifier& series_identifier,
+                            uint32_t* series_index) const {
+    const uint64_t hash = SeriesIdentifierHash(series_identifier);
+    for (int i = 0; i < m_file_index.series_identifier_hashes_size(); ++i) {
+        if (m_file_index.series_identifier_hashes(i) == hash) {
+            *series_index = static_cast<uint32_t>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t DataReader::FindBlock(uint32_t series_index, int64_t timestamp_nsec) const {
+    const auto& timestamps = m_series[series_index].timestamps;
+    return std::lower_bound(timestamps.begin(), timestamps.end(), timestamp_nsec) -
+           timestamps.begin();
+}
+
+::bosdyn::common::Status DataReader::ReadBlock(uint32_t series_index, size_t block_index,
+                                               DataBlock* block) const {
+    if (series_index >= m_series.size()) return ReaderError("unknown series index.");
+    const Series& series = m_series[series_index];
+    if (block_index >= series.timestamps.size()) return ReaderError("block index out of range.");
+    const size_t entry_index =
+        series.entry_order.empty() ? block_index : series.entry_order[block_index];
+    const auto& entry = series.block_index.block_entries(static_cast<int>(entry_index));
+
+    const uint64_t offset = entry.file_offset();
+    const size_t prefix = kBlockHeaderBytes + sizeof(uint32_t);
+    if (offset > m_size || m_size - offset < prefix) {
+        return ReaderError("data block offset is out of the file.");
+    }
+    const uint64_t header = LoadLittleEndian(m_data + offset, kBlockHeaderBytes);
+    const uint64_t size = header & kBlockSizeMask;
+    const uint64_t descriptor_size =
+        LoadLittleEndian(m_data + offset + kBlockHeaderBytes, sizeof(uint32_t));
+    if ((header >> kBlockTypeShift) != kDataBlockType ||
+        size > m_size - offset - kBlockHeaderBytes ||
+        descriptor_size > size - sizeof(uint32_t)) {
+        return ReaderError("malformed data block.");
+    }
+    block->timestamp_nsec = series.timestamps[block_index];
+    block->data = std::string_view(reinterpret_cast<const char*>(m_data + offset + prefix +
+                                                                 descriptor_size),
+                                   size - sizeof(uint32_t) - descriptor_size);
+    block->additional_indexes = &entry.additional_indexes();
+    return Success();
+}
+
+::bosdyn::common::Status DataReader::ForEachBlock(
+    uint32_t series_index, int64_t start_nsec, int64_t end_nsec,
+    const std::function<bool(const DataBlock&)>& fn) const {
+    if (series_index >= m_series.size()) return ReaderError("unknown series index.");
+    const auto& timestamps = m_series[series_index].timestamps;
+    DataBlock block;
+    for (size_t i = FindBlock(series_index, start_nsec);
+         i < timestamps.size() && timestamps[i] < end_nsec; ++i) {
+        STATUS_OK_ELSE_RETURN(ReadBlock(series_index, i, &block));
+        if (!fn(block)) break;
+    }
+    return Success();
+}
+
+::bosdyn::common::Status DataReader::VerifyChecksum() const {
+    if (!m_data) return ReaderError("no file is open.");
+    if (m_file_descriptor.checksum_type() !=
+        ::bosdyn::api::FileFormatDescriptor::CHECKSUM_TYPE_SHA1) {
+        return ReaderError("the file has no checksum.");
+    }
+    // Hashing reads the file front to back once.
+    const size_t hashed_size = m_size - kChecksumNumBytes - sizeof(kEndMagic);
+    ::madvise(const_cast<uint8_t*>(m_data), m_size, MADV_SEQUENTIAL);
+    Sha1 sha1;
+    sha1.Update(m_data, hashed_size);
+    const Sha1::Digest digest = sha1.Final();
+    ::madvise(const_cast<uint8_t*>(m_data), m_size, MADV_NORMAL);
+    if (std::memcmp(digest.data(), m_data + hashed_size, kChecksumNumBytes) != 0) {
+        return ReaderError("checksum mismatch in " + m_path + ".");
+    }
+    return Success();
+}
+
+}  // namespace bddf
+
+}  // namespace bosdyn
+
+#endif  // _WIN32
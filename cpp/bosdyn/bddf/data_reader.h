@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/bddf.pb.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bosdyn/common/status.h"
+
+#ifndef _WIN32
+
+namespace bosdyn {
+
+namespace bddf {
+
+// A data block of a series. The data points into the memory-mapped file, and is valid as long as
+// the DataReader that returned it is open.
+struct DataBlock {
+    int64_t timestamp_nsec = 0;
+    std::string_view data;
+    // Values of the additional indexes of the block, in the order of the additional_index_names
+    // of its series.
+    const ::google::protobuf::RepeatedField<int64_t>* additional_indexes = nullptr;
+};
+
+// Reader of BDDF files written by DataWriter or any other BDDF writer.
+//
+// The file is memory-mapped, and Open() only reads the descriptors and indexes at its start and
+// end, so opening a large file is cheap. The blocks of each series are ordered by timestamp, and
+// FindBlock() finds the first block at or after a time by binary search over the index. Data is
+// returned as views into the mapping, so reading it copies nothing until the pages are touched.
+//
+// All const functions may be called concurrently.
+class DataReader {
+ public:
+    DataReader() = default;
+    ~DataReader();
+
+    DataReader(const DataReader&) = delete;
+    DataReader& operator=(const DataReader&) = delete;
+
+    // Map the file and read its indexes. Returns an error if the file is not a complete BDDF
+    // file, e.g. if its writer was not closed.
+    ::bosdyn::common::Status Open(const std::string& path);
+    void Close();
+    bool is_open() const { return m_data != nullptr; }
+
+    const ::bosdyn::api::FileFormatDescriptor& file_descriptor() const {
+        return m_file_descriptor;
+    }
+
+    size_t NumSeries() const { return m_series.size(); }
+    const ::bosdyn::api::SeriesDescriptor& series_descriptor(uint32_t series_index) const {
+        return m_series[series_index].descriptor;
+    }
+    // Find the series with the given identifier. Returns false if the file has no such series.
+    bool FindSeries(const ::bosdyn::api::SeriesIdentifier& series_identifier,
+                    uint32_t* series_index) const;
+
+    size_t NumBlocks(uint32_t series_index) const {
+        return m_series[series_index].timestamps.size();
+    }
+    // Index of the first block of the series with a timestamp at or after timestamp_nsec, or
+    // NumBlocks() if there is none.
+    size_t FindBlock(uint32_t series_index, int64_t timestamp_nsec) const;
+
+    // Read the block with the given index, in timestamp order, of the series.
+    ::bosdyn::common::Status ReadBlock(uint32_t series_index, size_t block_index,
+                                       DataBlock* block) const;
+
+    // Call fn on each block of the series with a timestamp in [start_nsec, end_nsec), in
+    // timestamp order, until fn returns false.
+    ::bosdyn::common::Status ForEachBlock(uint32_t series_index, int64_t start_nsec,
+                                          int64_t end_nsec,
+                                          const std::function<bool(const DataBlock&)>& fn) const;
+
+    // Compute the SHA1 of the file and compare it to the checksum at its end. Returns an error
+    // for a mismatch, or if the writer of the file did not compute a checksum.
+    ::bosdyn::common::Status VerifyChecksum() const;
+
+ private:
+    struct Series {
+        ::bosdyn::api::SeriesDescriptor descriptor;
+        ::bosdyn::api::SeriesBlockIndex block_index;
+        // Block timestamps in increasing order, and the index into block_entries of each of them
+        // if the entries are not already in timestamp order.
+        std::vector<int64_t> timestamps;
+        std::vector<uint32_t> entry_order;
+    };
+
+    // Parse the descriptor block at the given offset.
+    ::bosdyn::common::Status ReadDescriptorBlock(uint64_t offset,
+                                                 ::bosdyn::api::DescriptorBlock* block) const;
+    ::bosdyn::common::Status ReadIndex();
+
+    std::string m_path;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    ::bosdyn::api::FileFormatDescriptor m_file_descriptor;
+    ::bosdyn::api::FileIndex m_file_index;
+    std::vector<Series> m_series;
+};
+
+}  // namespace bddf
+
+}  // namespace bosdyn
+
+#endif  // _WIN32
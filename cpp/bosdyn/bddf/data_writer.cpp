@@ -0,0 +1,281 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/bddf/data_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "bosdyn/bddf/bddf_format.h"
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/common/time.h"
+
+namespace bosdyn {
+
+namespace bddf {
+
+namespace {
+
+using ::bosdyn::client::SDKErrorCode;
+
+::bosdyn::common::Status WriterError(const std::string& message) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError, "BDDF writer: " + message);
+}
+
+::bosdyn::common::Status Success() { return ::bosdyn::common::Status(SDKErrorCode::Success); }
+
+void StoreLittleEndian(uint64_t value, size_t num_bytes, char* out) {
+    for (size_t i = 0; i < num_bytes; ++i) out[i] = static_cast<char>(value >> (8 * i));
+}
+
+}  // namespace
+
+DataWriter::~DataWriter() {
+    if (m_file) Close().IgnoreError();
+}
+
+::bosdyn::common::Status DataWriter::Open(const std::string& path,
+                                          const DataWriterParameters& parameters) {
+    if (m_file) return WriterError("a file is already open.");
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        return WriterError("could not open " + path + ": " + std::strerror(errno));
+    }
+    // The writer does its own buffering.
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    m_path = path;
+    m_parameters = parameters;
+    m_failed = false;
+    m_offset = 0;
+    m_buffer.assign(std::max<size_t>(parameters.buffer_size, 64), 0);
+    m_buffer_used = 0;
+    m_sha1.Reset();
+    m_series.clear();
+
+    STATUS_OK_ELSE_RETURN(Append(kMagic, sizeof(kMagic)));
+    ::bosdyn::api::DescriptorBlock block;
+    auto* file_descriptor = block.mutable_file_descriptor();
+    file_descriptor->mutable_version()->set_major_version(kVersionMajor);
+    file_descriptor->mutable_version()->set_minor_version(kVersionMinor);
+    file_descriptor->mutable_version()->set_patch_level(kVersionPatch);
+    for (const auto& annotation : parameters.annotations) {
+        (*file_descriptor->mutable_annotations())[annotation.first] = annotation.second;
+    }
+    file_descriptor->set_checksum_type(
+        parameters.compute_checksum ? ::bosdyn::api::FileFormatDescriptor::CHECKSUM_TYPE_SHA1
+                                    : ::bosdyn::api::FileFormatDescriptor::CHECKSUM_TYPE_NONE);
+    file_descriptor->set_checksum_num_bytes(kChecksumNumBytes);
+    return WriteDescriptorBlock(block);
+}
+
+::bosdyn::common::Status DataWriter::AddSeries(const ::bosdyn::api::SeriesDescriptor& descriptor,
+                                               uint32_t* series_index) {
+    if (!m_file) return NotOpen();
+    const uint64_t hash = SeriesIdentifierHash(descriptor.series_identifier());
+    for (const Series& series : m_series) {
+        if (series.identifier_hash == hash) {
+            return WriterError("series " + descriptor.series_identifier().series_type() +
+                               " was already added.");
+        }
+    }
+
+    Series series;
+    series.identifier = descriptor.series_identifier();
+    series.identifier_hash = hash;
+    series.descriptor_offset = m_offset;
+    series.num_additional_indexes = descriptor.additional_index_names_size();
+    ::bosdyn::api::DescriptorBlock block;
+    auto* series_descriptor = block.mutable_series_descriptor();
+    *series_descriptor = descriptor;
+    series_descriptor->set_series_index(static_cast<uint32_t>(m_series.size()));
+    series_descriptor->set_identifier_hash(hash);
+    STATUS_OK_ELSE_RETURN(WriteDescriptorBlock(block));
+
+    *series_index = static_cast<uint32_t>(m_series.size());
+    m_series.push_back(std::move(series));
+    return Success();
+}
+
+::bosdyn::common::Status DataWriter::AddProtobufSeries(
+    const ::bosdyn::api::SeriesIdentifier& series_identifier, const std::string& type_name,
+    uint32_t* series_index) {
+    ::bosdyn::api::SeriesDescriptor descriptor;
+    *descriptor.mutable_series_identifier() = series_identifier;
+    descriptor.mutable_message_type()->set_content_type("application/protobuf");
+    descriptor.mutable_message_type()->set_type_name(type_name);
+    return AddSeries(descriptor, series_index);
+}
+
+::bosdyn::common::Status DataWriter::AddPodSeries(
+    const ::bosdyn::api::SeriesIdentifier& series_identifier, ::bosdyn::api::PodTypeEnum pod_type,
+    const std::vector<uint32_t>& dimensions, uint32_t* series_index) {
+    ::bosdyn::api::SeriesDescriptor descriptor;
+    *descriptor.mutable_series_identifier() = series_identifier;
+    descriptor.mutable_pod_type()->set_pod_type(pod_type);
+    for (uint32_t dimension : dimensions) descriptor.mutable_pod_type()->add_dimension(dimension);
+    return AddSeries(descriptor, series_index);
+}
+
+::bosdyn::common::Status DataWriter::WriteData(uint32_t series_index, int64_t timestamp_nsec,
+                                               const void* data, size_t size,
+                                               const std::vector<int64_t>& additional_indexes) {
+    if (!m_file) return NotOpen();
+    if (series_index >= m_series.size()) return WriterError("unknown series index.");
+    Series& series = m_series[series_index];
+    if (additional_indexes.size() != series.num_additional_indexes) {
+        return WriterError("wrong number of additional indexes for the series.");
+    }
+
+    m_data_descriptor.set_series_index(series_index);
+    ::bosdyn::common::SetTimestamp(timestamp_nsec, m_data_descriptor.mutable_timestamp());
+    m_data_descriptor.mutable_additional_indexes()->Assign(additional_indexes.begin(),
+                                                           additional_indexes.end());
+    const size_t descriptor_size = m_data_descriptor.ByteSizeLong();
+
+    // Header, descriptor size and descriptor go out as one piece, followed by the data.
+    m_scratch.resize(kBlockHeaderBytes + sizeof(uint32_t) + descriptor_size);
+    StoreLittleEndian(MakeBlockHeader(kDataBlockType, sizeof(uint32_t) + descriptor_size + size),
+                      kBlockHeaderBytes, &m_scratch[0]);
+    StoreLittleEndian(descriptor_size, sizeof(uint32_t), &m_scratch[kBlockHeaderBytes]);
+    m_data_descriptor.SerializeWithCachedSizesToArray(
+        reinterpret_cast<uint8_t*>(&m_scratch[kBlockHeaderBytes + sizeof(uint32_t)]));
+
+    const uint64_t block_offset = m_offset;
+    STATUS_OK_ELSE_RETURN(Append(m_scratch.data(), m_scratch.size()));
+    STATUS_OK_ELSE_RETURN(Append(data, size));
+    series.blocks.push_back({timestamp_nsec, block_offset});
+    series.additional_indexes.insert(series.additional_indexes.end(), additional_indexes.begin(),
+                                     additional_indexes.end());
+    series.total_bytes += size;
+    return Success();
+}
+
+::bosdyn::common::Status DataWriter::WriteMessage(uint32_t series_index, int64_t timestamp_nsec,
+                                                  const google::protobuf::MessageLite& message,
+                                                  const std::vector<int64_t>& additional_indexes) {
+    if (!message.SerializeToString(&m_message_scratch)) {
+        return WriterError("could not serialize message.");
+    }
+    return WriteData(series_index, timestamp_nsec, m_message_scratch.data(),
+                     m_message_scratch.size(), additional_indexes);
+}
+
+::bosdyn::common::Status DataWriter::Close() {
+    if (!m_file) return m_failed ? m_error : Success();
+
+    ::bosdyn::api::DescriptorBlock file_index_block;
+    auto* file_index = file_index_block.mutable_file_index();
+    for (size_t i = 0; i < m_series.size(); ++i) {
+        const Series& series = m_series[i];
+        *file_index->add_series_identifiers() = series.identifier;
+        file_index->add_series_block_index_offsets(m_offset);
+        file_index->add_series_identifier_hashes(series.identifier_hash);
+
+        ::bosdyn::api::DescriptorBlock block;
+        auto* block_index = block.mutable_series_block_index();
+        block_index->set_series_index(static_cast<uint32_t>(i));
+        block_index->set_descriptor_file_offset(series.descriptor_offset);
+        block_index->set_total_bytes(series.total_bytes);
+        block_index->mutable_block_entries()->Reserve(static_cast<int>(series.blocks.size()));
+        const int64_t* additional_indexes = series.additional_indexes.data();
+        for (const BlockEntry& entry : series.blocks) {
+            auto* block_entry = block_index->add_block_entries();
+            ::bosdyn::common::SetTimestamp(entry.timestamp_nsec, block_entry->mutable_timestamp());
+            block_entry->set_file_offset(entry.file_offset);
+            for (size_t j = 0; j < series.num_additional_indexes; ++j) {
+                block_entry->add_additional_indexes(*additional_indexes++);
+            }
+        }
+        STATUS_OK_ELSE_RETURN(WriteDescriptorBlock(block));
+    }
+
+    const uint64_t index_offset = m_offset;
+    STATUS_OK_ELSE_RETURN(WriteDescriptorBlock(file_index_block));
+    char end_block[kBlockHeaderBytes + sizeof(uint64_t)];
+    StoreLittleEndian(MakeBlockHeader(kEndBlockType, sizeof(uint64_t)), kBlockHeaderBytes,
+                      end_block);
+    StoreLittleEndian(index_offset, sizeof(uint64_t), end_block + kBlockHeaderBytes);
+    STATUS_OK_ELSE_RETURN(Append(end_block, sizeof(end_block)));
+    // The checksum covers everything before it, so the buffer is flushed before it is taken.
+    STATUS_OK_ELSE_RETURN(Flush());
+    Sha1::Digest checksum{};
+    if (m_parameters.compute_checksum) checksum = m_sha1.Final();
+    STATUS_OK_ELSE_RETURN(WriteToFile(checksum.data(), checksum.size()));
+    STATUS_OK_ELSE_RETURN(WriteToFile(kEndMagic, sizeof(kEndMagic)));
+    m_offset += checksum.size() + sizeof(kEndMagic);
+
+    const int result = std::fclose(m_file);
+    m_file = nullptr;
+    m_series.clear();
+    if (result != 0) {
+        m_failed = true;
+        m_error = WriterError("could not close " + m_path + ": " + std::strerror(errno));
+        return m_error;
+    }
+    return Success();
+}
+
+::bosdyn::common::Status DataWriter::Append(const void* data, size_t size) {
+    if (m_buffer_used + size > m_buffer.size()) {
+        STATUS_OK_ELSE_RETURN(Flush());
+    }
+    if (size >= m_buffer.size()) {
+        if (m_parameters.compute_checksum) m_sha1.Update(data, size);
+        STATUS_OK_ELSE_RETURN(WriteToFile(data, size));
+    } else {
+        std::memcpy(m_buffer.data() + m_buffer_used, data, size);
+        m_buffer_used += size;
+    }
+    m_offset += size;
+    return Success();
+}
+
+::bosdyn::common::Status DataWriter::Flush() {
+    if (m_buffer_used == 0) return Success();
+    if (m_parameters.compute_checksum) m_sha1.Update(m_buffer.data(), m_buffer_used);
+    const size_t size = m_buffer_used;
+    m_buffer_used = 0;
+    return WriteToFile(m_buffer.data(), size);
+}
+
+::bosdyn::common::Status DataWriter::WriteToFile(const void* data, size_t size) {
+    if (std::fwrite(data, 1, size, m_file) != size) {
+        return Fail(WriterError("could not write " + m_path + ": " + std::strerror(errno)));
+    }
+    return Success();
+}
+
+::bosdyn::common::Status DataWriter::WriteDescriptorBlock(
+    const ::bosdyn::api::DescriptorBlock& block) {
+    const size_t size = block.ByteSizeLong();
+    m_scratch.resize(kBlockHeaderBytes + size);
+    StoreLittleEndian(MakeBlockHeader(kDescriptorBlockType, size), kBlockHeaderBytes,
+                      &m_scratch[0]);
+    block.SerializeWithCachedSizesToArray(
+        reinterpret_cast<uint8_t*>(&m_scratch[kBlockHeaderBytes]));
+    return Append(m_scratch.data(), m_scratch.size());
+}
+
+::bosdyn::common::Status DataWriter::NotOpen() const {
+    return m_failed ? m_error : WriterError("the file is not open.");
+}
+
+::bosdyn::common::Status DataWriter::Fail(const ::bosdyn::common::Status& status) {
+    m_failed = true;
+    m_error = status;
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_series.clear();
+    return status;
+}
+
+}  // namespace bddf
+
+}  // namespace bosdyn
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/bddf.pb.h>
+#include <google/protobuf/message_lite.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bosdyn/bddf/sha1.h"
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace bddf {
+
+struct DataWriterParameters {
+    // File-wide annotations, e.g. {"bosdyn/robot-serial-number", "..."}.
+    std::map<std::string, std::string> annotations;
+    // Bytes of blocks buffered in memory before they are written to the file. Data larger than
+    // the buffer is written straight from the caller's memory, so this bounds the memory used by
+    // the writer apart from the index.
+    size_t buffer_size = 1 << 20;
+    // Write a SHA1 checksum of the file at its end. Without it, the checksum is all zeros.
+    bool compute_checksum = true;
+};
+
+// Streaming writer of BDDF files (see bddf_format.h).
+//
+// Series are added with one of the Add*Series() functions, and data is then appended to them
+// with WriteData() or WriteMessage(). The writer only keeps the timestamp and offset of each
+// block in memory, to write the SeriesBlockIndex and FileIndex blocks when the file is closed.
+//
+// A DataWriter is not thread-safe.
+class DataWriter {
+ public:
+    DataWriter() = default;
+    // Closes the file if it is still open.
+    ~DataWriter();
+
+    DataWriter(const DataWriter&) = delete;
+    DataWriter& operator=(const DataWriter&) = delete;
+
+    // Create the file at path and write its FileFormatDescriptor.
+    ::bosdyn::common::Status Open(const std::string& path,
+                                  const DataWriterParameters& parameters = DataWriterParameters());
+
+    // Add a series described by the given descriptor, setting its series_index and
+    // identifier_hash. Returns an error if a series with the same identifier was already added.
+    ::bosdyn::common::Status AddSeries(const ::bosdyn::api::SeriesDescriptor& descriptor,
+                                       uint32_t* series_index);
+
+    // Add a series of protobuf messages of the given full type name, e.g.
+    // "bosdyn.api.RobotState".
+    ::bosdyn::common::Status AddProtobufSeries(
+        const ::bosdyn::api::SeriesIdentifier& series_identifier, const std::string& type_name,
+        uint32_t* series_index);
+
+    // Add a series of POD samples, each an array of the given dimensions (a single value if
+    // dimensions is empty).
+    ::bosdyn::common::Status AddPodSeries(
+        const ::bosdyn::api::SeriesIdentifier& series_identifier,
+        ::bosdyn::api::PodTypeEnum pod_type, const std::vector<uint32_t>& dimensions,
+        uint32_t* series_index);
+
+    // Append a data block to the series. There must be one additional index value per
+    // additional_index_name of the series.
+    ::bosdyn::common::Status WriteData(uint32_t series_index, int64_t timestamp_nsec,
+                                       const void* data, size_t size,
+                                       const std::vector<int64_t>& additional_indexes = {});
+
+    // Serialize the message and append it to the series.
+    ::bosdyn::common::Status WriteMessage(uint32_t series_index, int64_t timestamp_nsec,
+                                          const google::protobuf::MessageLite& message,
+                                          const std::vector<int64_t>& additional_indexes = {});
+
+    // Write the indexes and the footer and close the file. Returns the first error of the
+    // writer, if any.
+    ::bosdyn::common::Status Close();
+
+    bool is_open() const { return m_file != nullptr; }
+    // Bytes written to the file so far, including buffered bytes.
+    uint64_t bytes_written() const { return m_offset; }
+
+ private:
+    struct BlockEntry {
+        int64_t timestamp_nsec;
+        uint64_t file_offset;
+    };
+
+    struct Series {
+        ::bosdyn::api::SeriesIdentifier identifier;
+        uint64_t identifier_hash = 0;
+        uint64_t descriptor_offset = 0;
+        size_t num_additional_indexes = 0;
+        uint64_t total_bytes = 0;
+        std::vector<BlockEntry> blocks;
+        // num_additional_indexes values per block.
+        std::vector<int64_t> additional_indexes;
+    };
+
+    ::bosdyn::common::Status Append(const void* data, size_t size);
+    ::bosdyn::common::Status Flush();
+    ::bosdyn::common::Status WriteToFile(const void* data, size_t size);
+    ::bosdyn::common::Status WriteDescriptorBlock(const ::bosdyn::api::DescriptorBlock& block);
+    // Remember the first error and close the file.
+    ::bosdyn::common::Status Fail(const ::bosdyn::common::Status& status);
+    // Error for calls made while no file is open: the error that closed it, if any.
+    ::bosdyn::common::Status NotOpen() const;
+
+    std::FILE* m_file = nullptr;
+    std::string m_path;
+    DataWriterParameters m_parameters;
+    bool m_failed = false;
+    ::bosdyn::common::Status m_error;
+    uint64_t m_offset = 0;
+    std::vector<char> m_buffer;
+    size_t m_buffer_used = 0;
+    Sha1 m_sha1;
+    std::vector<Series> m_series;
+    // Reused to serialize descriptors and messages without allocating.
+    ::bosdyn::api::DataDescriptor m_data_descriptor;
+    std::string m_scratch;
+    std::string m_message_scratch;
+};
+
+}  // namespace bddf
+
+}  // namespace bosdyn
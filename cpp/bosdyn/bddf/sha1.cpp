@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/bddf/sha1.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bosdyn {
+
+namespace bddf {
+
+namespace {
+
+inline uint32_t RotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+inline uint32_t LoadBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+}  // namespace
+
+void Sha1::Reset() {
+    m_state[0] = 0x67452301;
+    m_state[1] = 0xEFCDAB89;
+    m_state[2] = 0x98BADCFE;
+    m_state[3] = 0x10325476;
+    m_state[4] = 0xC3D2E1F0;
+    m_total_bytes = 0;
+    m_buffer_size = 0;
+}
+
+void Sha1::ProcessBlock(const uint8_t* block) {
+    // The message schedule is kept as a rolling window of 16 words.
+    uint32_t w[16];
+    for (int i = 0; i < 16; ++i) w[i] = LoadBigEndian32(block + 4 * i);
+    uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4];
+    // One loop per round function, so the loops have no branches.
+    auto round = [&](int i, uint32_t f, uint32_t k) {
+        if (i >= 16) {
+            w[i & 15] = RotateLeft(
+                w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+        }
+        const uint32_t temp = RotateLeft(a, 5) + f + e + k + w[i & 15];
+        e = d;
+        d = c;
+        c = RotateLeft(b, 30);
+        b = a;
+        a = temp;
+    };
+    for (int i = 0; i < 20; ++i) round(i, (b & c) | (~b & d), 0x5A827999);
+    for (int i = 20; i < 40; ++i) round(i, b ^ c ^ d, 0x6ED9EBA1);
+    for (int i = 40; i < 60; ++i) round(i, (b & c) | (b & d) | (c & d), 0x8F1BBCDC);
+    for (int i = 60; i < 80; ++i) round(i, b ^ c ^ d, 0xCA62C1D6);
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+    m_state[4] += e;
+}
+
+void Sha1::Update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    m_total_bytes += size;
+    if (m_buffer_size > 0) {
+        const size_t fill = std::min(size, sizeof(m_buffer) - m_buffer_size);
+        std::memcpy(m_buffer + m_buffer_size, bytes, fill);
+        m_buffer_size += fill;
+        bytes += fill;
+        size -= fill;
+        if (m_buffer_size < sizeof(m_buffer)) return;
+        ProcessBlock(m_buffer);
+        m_buffer_size = 0;
+    }
+    // Whole blocks are hashed straight from the input.
+    for (; size >= sizeof(m_buffer); bytes += sizeof(m_buffer), size -= sizeof(m_buffer)) {
+        ProcessBlock(bytes);
+    }
+    std::memcpy(m_buffer, bytes, size);
+    m_buffer_size = size;
+}
+
+Sha1::Digest Sha1::Final() {
+    const uint64_t total_bits = m_total_bytes * 8;
+    uint8_t padding[72] = {0x80};
+    const size_t padding_size =
+        (m_buffer_size < 56 ? 56 - m_buffer_size : 120 - m_buffer_size);
+    for (int i = 0; i < 8; ++i) {
+        padding[padding_size + i] = static_cast<uint8_t>(total_bits >> (56 - 8 * i));
+    }
+    Update(padding, padding_size + 8);
+
+    Digest digest;
+    for (int i = 0; i < 5; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(m_state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(m_state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(m_state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(m_state[i]);
+    }
+    return digest;
+}
+
+}  // namespace bddf
+
+}  // namespace bosdyn
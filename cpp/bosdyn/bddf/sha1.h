@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace bosdyn {
+
+namespace bddf {
+
+// Streaming SHA1 (FIPS 180-4), used for the BDDF stream checksum and series identifier hashes.
+class Sha1 {
+ public:
+    static constexpr size_t kDigestBytes = 20;
+    using Digest = std::array<uint8_t, kDigestBytes>;
+
+    Sha1() { Reset(); }
+
+    void Reset();
+    void Update(const void* data, size_t size);
+    // Digest of all data passed to Update() since the last Reset(). The object must be Reset()
+    // before it is updated again.
+    Digest Final();
+
+ private:
+    void ProcessBlock(const uint8_t* block);
+
+    uint32_t m_state[5];
+    uint64_t m_total_bytes;
+    uint8_t m_buffer[64];
+    size_t m_buffer_size;
+};
+
+}  // namespace bddf
+
+}  // namespace bosdyn
@@ -41,13 +41,19 @@ std::shared_future<AuthResultType> AuthClient::GetAuthTokenAsync(const std::stri
             request,
             std::bind(&::bosdyn::api::AuthService::StubInterface::AsyncGetAuthToken, m_stub.get(),
                       _1, _2, _3),
-            std::bind(&AuthClient::OnGetAuthTokenComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&AuthClient::OnGetAuthTokenComplete, this, _1, _2, _3, _4, _5, nullptr),
             std::move(response), parameters);
     return future;
 }
 
 std::shared_future<AuthResultType> AuthClient::GetAuthTokenAsync(const std::string& token,
                                                                  const RPCParameters& parameters) {
+    return GetAuthTokenAsync(token, parameters, nullptr);
+}
+
+std::shared_future<AuthResultType> AuthClient::GetAuthTokenAsync(const std::string& token,
+                                                                 const RPCParameters& parameters,
+                                                                 AuthCallback on_complete) {
     std::promise<AuthResultType> response;
     std::shared_future<AuthResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -61,7 +67,8 @@ std::shared_future<AuthResultType> AuthClient::GetAuthTokenAsync(const std::stri
             request,
             std::bind(&::bosdyn::api::AuthService::StubInterface::AsyncGetAuthToken, m_stub.get(),
                       _1, _2, _3),
-            std::bind(&AuthClient::OnGetAuthTokenComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&AuthClient::OnGetAuthTokenComplete, this, _1, _2, _3, _4, _5,
+                      std::move(on_complete)),
             std::move(response), parameters);
 
     return future;
@@ -81,16 +88,14 @@ void AuthClient::OnGetAuthTokenComplete(MessagePumpCallBase* call,
                                         const ::bosdyn::api::GetAuthTokenRequest& request,
                                         ::bosdyn::api::GetAuthTokenResponse&& response,
                                         const grpc::Status& status,
-                                        std::promise<AuthResultType> promise) {
+                                        std::promise<AuthResultType> promise,
+                                        const AuthCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::GetAuthTokenResponse>(status, response,
                                                                               response.status());
-    if (!ret_status) {
-        promise.set_value({ret_status, std::move(response)});
-        return;
-    }
-
-    promise.set_value({ret_status, std::move(response)});
+    AuthResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 // Start of ServiceClient overrides.
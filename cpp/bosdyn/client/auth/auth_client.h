@@ -14,6 +14,7 @@
 
 #include <bosdyn/api/auth_service.grpc.pb.h>
 #include <bosdyn/api/auth_service.pb.h>
+#include <functional>
 #include <future>
 
 namespace bosdyn {
@@ -23,6 +24,7 @@ namespace client {
 // This typedef needs to be a std::shared_ptr to satisfy the InitiateCall templatized method in
 // ServiceClient
 typedef Result<::bosdyn::api::GetAuthTokenResponse> AuthResultType;
+typedef std::function<void(const AuthResultType&)> AuthCallback;
 
 class AuthClient : public ServiceClient {
  public:
@@ -43,6 +45,12 @@ class AuthClient : public ServiceClient {
     std::shared_future<AuthResultType> GetAuthTokenAsync(
         const std::string& token, const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<AuthResultType> GetAuthTokenAsync(const std::string& token,
+                                                         const RPCParameters& parameters,
+                                                         AuthCallback on_complete);
+
     // Synchronous method to get an auth token for provided token.
     AuthResultType GetAuthToken(const std::string& token,
                                 const RPCParameters& parameters = RPCParameters());
@@ -67,7 +75,8 @@ class AuthClient : public ServiceClient {
     void OnGetAuthTokenComplete(MessagePumpCallBase* call,
                                 const ::bosdyn::api::GetAuthTokenRequest& request,
                                 ::bosdyn::api::GetAuthTokenResponse&& response,
-                                const grpc::Status& status, std::promise<AuthResultType> promise);
+                                const grpc::Status& status, std::promise<AuthResultType> promise,
+                                const AuthCallback& on_complete);
 
     std::unique_ptr<::bosdyn::api::AuthService::StubInterface> m_stub;
 
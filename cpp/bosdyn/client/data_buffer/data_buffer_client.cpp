@@ -23,6 +23,12 @@ const char* DataBufferClient::s_service_type = "bosdyn.api.DataBufferService";
 
 std::shared_future<RecordTextMessagesResultType> DataBufferClient::RecordTextMessagesAsync(
     ::bosdyn::api::RecordTextMessagesRequest& request, const RPCParameters& parameters) {
+    return RecordTextMessagesAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RecordTextMessagesResultType> DataBufferClient::RecordTextMessagesAsync(
+    ::bosdyn::api::RecordTextMessagesRequest& request, const RPCParameters& parameters,
+    RecordTextMessagesCallback on_complete) {
     std::promise<RecordTextMessagesResultType> response;
     std::shared_future<RecordTextMessagesResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -33,7 +39,8 @@ std::shared_future<RecordTextMessagesResultType> DataBufferClient::RecordTextMes
         request,
         std::bind(&::bosdyn::api::DataBufferService::StubInterface::AsyncRecordTextMessages,
                   m_stub.get(), _1, _2, _3),
-        std::bind(&DataBufferClient::OnRecordTextMessagesComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&DataBufferClient::OnRecordTextMessagesComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
     return future;
 }
@@ -46,7 +53,10 @@ RecordTextMessagesResultType DataBufferClient::RecordTextMessages(
 std::shared_future<RecordTextMessagesResultType> DataBufferClient::RecordTextMessagesAsync(
     const std::vector<::bosdyn::api::TextMessage>& text_messages, const RPCParameters& parameters) {
     ::bosdyn::api::RecordTextMessagesRequest request;
-    *request.mutable_text_messages() = {text_messages.begin(), text_messages.end()};
+    request.mutable_text_messages()->Reserve(text_messages.size());
+    for (const auto& record : text_messages) {
+        *request.add_text_messages() = record;
+    }
     return RecordTextMessagesAsync(request, parameters);
 }
 
@@ -69,6 +79,12 @@ RecordTextMessagesResultType DataBufferClient::RecordTextMessage(
 
 std::shared_future<RecordOperatorCommentsResultType> DataBufferClient::RecordOperatorCommentsAsync(
     ::bosdyn::api::RecordOperatorCommentsRequest& request, const RPCParameters& parameters) {
+    return RecordOperatorCommentsAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RecordOperatorCommentsResultType> DataBufferClient::RecordOperatorCommentsAsync(
+    ::bosdyn::api::RecordOperatorCommentsRequest& request, const RPCParameters& parameters,
+    RecordOperatorCommentsCallback on_complete) {
     std::promise<RecordOperatorCommentsResultType> response;
     std::shared_future<RecordOperatorCommentsResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -81,7 +97,7 @@ std::shared_future<RecordOperatorCommentsResultType> DataBufferClient::RecordOpe
             std::bind(&::bosdyn::api::DataBufferService::StubInterface::AsyncRecordOperatorComments,
                       m_stub.get(), _1, _2, _3),
             std::bind(&DataBufferClient::OnRecordOperatorCommentsComplete, this, _1, _2, _3, _4,
-                      _5),
+                      _5, std::move(on_complete)),
             std::move(response), parameters);
     return future;
 }
@@ -94,7 +110,10 @@ RecordOperatorCommentsResultType DataBufferClient::RecordOperatorComments(
 std::shared_future<RecordOperatorCommentsResultType> DataBufferClient::RecordOperatorCommentsAsync(
     const std::vector<::bosdyn::api::OperatorComment>& comments, const RPCParameters& parameters) {
     ::bosdyn::api::RecordOperatorCommentsRequest request;
-    *request.mutable_operator_comments() = {comments.begin(), comments.end()};
+    request.mutable_operator_comments()->Reserve(comments.size());
+    for (const auto& record : comments) {
+        *request.add_operator_comments() = record;
+    }
     return RecordOperatorCommentsAsync(request, parameters);
 }
 
@@ -117,6 +136,12 @@ RecordOperatorCommentsResultType DataBufferClient::RecordOperatorComment(
 
 std::shared_future<RecordDataBlobsResultType> DataBufferClient::RecordDataBlobsAsync(
     ::bosdyn::api::RecordDataBlobsRequest& request, const RPCParameters& parameters) {
+    return RecordDataBlobsAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RecordDataBlobsResultType> DataBufferClient::RecordDataBlobsAsync(
+    ::bosdyn::api::RecordDataBlobsRequest& request, const RPCParameters& parameters,
+    RecordDataBlobsCallback on_complete) {
     std::promise<RecordDataBlobsResultType> response;
     std::shared_future<RecordDataBlobsResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -127,7 +152,8 @@ std::shared_future<RecordDataBlobsResultType> DataBufferClient::RecordDataBlobsA
         request,
         std::bind(&::bosdyn::api::DataBufferService::StubInterface::AsyncRecordDataBlobs,
                   m_stub.get(), _1, _2, _3),
-        std::bind(&DataBufferClient::OnRecordDataBlobsComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&DataBufferClient::OnRecordDataBlobsComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
     return future;
 }
@@ -140,7 +166,10 @@ RecordDataBlobsResultType DataBufferClient::RecordDataBlobs(
 std::shared_future<RecordDataBlobsResultType> DataBufferClient::RecordDataBlobsAsync(
     const std::vector<::bosdyn::api::DataBlob>& blobs, const RPCParameters& parameters) {
     ::bosdyn::api::RecordDataBlobsRequest request;
-    *request.mutable_blob_data() = {blobs.begin(), blobs.end()};
+    request.mutable_blob_data()->Reserve(blobs.size());
+    for (const auto& record : blobs) {
+        *request.add_blob_data() = record;
+    }
     return RecordDataBlobsAsync(request, parameters);
 }
 
@@ -163,6 +192,12 @@ RecordDataBlobsResultType DataBufferClient::RecordDataBlob(const ::bosdyn::api::
 
 std::shared_future<RecordSignalTicksResultType> DataBufferClient::RecordSignalTicksAsync(
     ::bosdyn::api::RecordSignalTicksRequest& request, const RPCParameters& parameters) {
+    return RecordSignalTicksAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RecordSignalTicksResultType> DataBufferClient::RecordSignalTicksAsync(
+    ::bosdyn::api::RecordSignalTicksRequest& request, const RPCParameters& parameters,
+    RecordSignalTicksCallback on_complete) {
     std::promise<RecordSignalTicksResultType> response;
     std::shared_future<RecordSignalTicksResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -173,7 +208,8 @@ std::shared_future<RecordSignalTicksResultType> DataBufferClient::RecordSignalTi
         request,
         std::bind(&::bosdyn::api::DataBufferService::StubInterface::AsyncRecordSignalTicks,
                   m_stub.get(), _1, _2, _3),
-        std::bind(&DataBufferClient::OnRecordSignalTicksComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&DataBufferClient::OnRecordSignalTicksComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
     return future;
 }
@@ -186,7 +222,10 @@ RecordSignalTicksResultType DataBufferClient::RecordSignalTicks(
 std::shared_future<RecordSignalTicksResultType> DataBufferClient::RecordSignalTicksAsync(
     const std::vector<::bosdyn::api::SignalTick>& ticks, const RPCParameters& parameters) {
     ::bosdyn::api::RecordSignalTicksRequest request;
-    *request.mutable_tick_data() = {ticks.begin(), ticks.end()};
+    request.mutable_tick_data()->Reserve(ticks.size());
+    for (const auto& record : ticks) {
+        *request.add_tick_data() = record;
+    }
     return RecordSignalTicksAsync(request, parameters);
 }
 
@@ -209,6 +248,12 @@ RecordSignalTicksResultType DataBufferClient::RecordSignalTick(
 
 std::shared_future<RecordEventsResultType> DataBufferClient::RecordEventsAsync(
     ::bosdyn::api::RecordEventsRequest& request, const RPCParameters& parameters) {
+    return RecordEventsAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RecordEventsResultType> DataBufferClient::RecordEventsAsync(
+    ::bosdyn::api::RecordEventsRequest& request, const RPCParameters& parameters,
+    RecordEventsCallback on_complete) {
     std::promise<RecordEventsResultType> response;
     std::shared_future<RecordEventsResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -219,7 +264,8 @@ std::shared_future<RecordEventsResultType> DataBufferClient::RecordEventsAsync(
             request,
             std::bind(&::bosdyn::api::DataBufferService::StubInterface::AsyncRecordEvents,
                       m_stub.get(), _1, _2, _3),
-            std::bind(&DataBufferClient::OnRecordEventsComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&DataBufferClient::OnRecordEventsComplete, this, _1, _2, _3, _4, _5,
+                      std::move(on_complete)),
             std::move(response), parameters);
     return future;
 }
@@ -232,7 +278,10 @@ RecordEventsResultType DataBufferClient::RecordEvents(::bosdyn::api::RecordEvent
 std::shared_future<RecordEventsResultType> DataBufferClient::RecordEventsAsync(
     const std::vector<::bosdyn::api::Event>& events, const RPCParameters& parameters) {
     ::bosdyn::api::RecordEventsRequest request;
-    *request.mutable_events() = {events.begin(), events.end()};
+    request.mutable_events()->Reserve(events.size());
+    for (const auto& record : events) {
+        *request.add_events() = record;
+    }
     return RecordEventsAsync(request, parameters);
 }
 
@@ -290,137 +339,124 @@ RegisterSignalSchemaResultType DataBufferClient::RegisterSignalSchema(
 void DataBufferClient::OnRecordTextMessagesComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::RecordTextMessagesRequest& request,
     ::bosdyn::api::RecordTextMessagesResponse&& response, const grpc::Status& status,
-    std::promise<RecordTextMessagesResultType> promise) {
+    std::promise<RecordTextMessagesResultType> promise,
+    const RecordTextMessagesCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::RecordTextMessagesResponse>(
             status, response, SDKErrorCode::Success);
 
-    if (!ret_status) {
-        promise.set_value({ret_status, std::move(response)});
-        return;
-    }
-
-    for (const auto& error : response.errors()) {
-        std::error_code code = error.type();
-        if (code != SuccessCondition::Success) {
-            promise.set_value(
-                {::bosdyn::common::Status(
-                     code, "RecordTextMessagesResponse ::bosdyn::common::Status unsuccessful"),
-                 std::move(response)});
-            return;
+    if (ret_status) {
+        for (const auto& error : response.errors()) {
+            std::error_code code = error.type();
+            if (code != SuccessCondition::Success) {
+                ret_status = ::bosdyn::common::Status(
+                    code, "RecordTextMessagesResponse ::bosdyn::common::Status unsuccessful");
+                break;
+            }
         }
     }
 
-    promise.set_value({ret_status, std::move(response)});
+    RecordTextMessagesResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 void DataBufferClient::OnRecordOperatorCommentsComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::RecordOperatorCommentsRequest& request,
     ::bosdyn::api::RecordOperatorCommentsResponse&& response, const grpc::Status& status,
-    std::promise<RecordOperatorCommentsResultType> promise) {
+    std::promise<RecordOperatorCommentsResultType> promise,
+    const RecordOperatorCommentsCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::RecordOperatorCommentsResponse>(
             status, response, SDKErrorCode::Success);
 
-    if (!ret_status) {
-        promise.set_value({ret_status, std::move(response)});
-        return;
-    }
-
-    for (const auto& error : response.errors()) {
-        std::error_code code = error.type();
-        if (code != SuccessCondition::Success) {
-            promise.set_value(
-                {::bosdyn::common::Status(
-                     code, "RecordOperatorCommentsResponse ::bosdyn::common::Status unsuccessful"),
-                 std::move(response)});
-            return;
+    if (ret_status) {
+        for (const auto& error : response.errors()) {
+            std::error_code code = error.type();
+            if (code != SuccessCondition::Success) {
+                ret_status = ::bosdyn::common::Status(
+                    code, "RecordOperatorCommentsResponse ::bosdyn::common::Status unsuccessful");
+                break;
+            }
         }
     }
 
-    promise.set_value({ret_status, std::move(response)});
+    RecordOperatorCommentsResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 void DataBufferClient::OnRecordDataBlobsComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::RecordDataBlobsRequest& request,
     ::bosdyn::api::RecordDataBlobsResponse&& response, const grpc::Status& status,
-    std::promise<RecordDataBlobsResultType> promise) {
+    std::promise<RecordDataBlobsResultType> promise, const RecordDataBlobsCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::RecordDataBlobsResponse>(
             status, response, SDKErrorCode::Success);
 
-    if (!ret_status) {
-        promise.set_value({ret_status, std::move(response)});
-        return;
-    }
-
-    for (const auto& error : response.errors()) {
-        std::error_code code = error.type();
-        if (code != SuccessCondition::Success) {
-            promise.set_value(
-                {::bosdyn::common::Status(
-                     code, "RecordDataBlobsResponse ::bosdyn::common::Status unsuccessful"),
-                 std::move(response)});
-            return;
+    if (ret_status) {
+        for (const auto& error : response.errors()) {
+            std::error_code code = error.type();
+            if (code != SuccessCondition::Success) {
+                ret_status = ::bosdyn::common::Status(
+                    code, "RecordDataBlobsResponse ::bosdyn::common::Status unsuccessful");
+                break;
+            }
         }
     }
 
-    promise.set_value({ret_status, std::move(response)});
+    RecordDataBlobsResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 void DataBufferClient::OnRecordSignalTicksComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::RecordSignalTicksRequest& request,
     ::bosdyn::api::RecordSignalTicksResponse&& response, const grpc::Status& status,
-    std::promise<RecordSignalTicksResultType> promise) {
+    std::promise<RecordSignalTicksResultType> promise,
+    const RecordSignalTicksCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::RecordSignalTicksResponse>(
             status, response, SDKErrorCode::Success);
 
-    if (!ret_status) {
-        promise.set_value({ret_status, std::move(response)});
-        return;
-    }
-
-    for (const auto& error : response.errors()) {
-        std::error_code code = error.type();
-        if (code != SuccessCondition::Success) {
-            promise.set_value(
-                {::bosdyn::common::Status(
-                     code, "RecordSignalTicksResponse ::bosdyn::common::Status unsuccessful"),
-                 std::move(response)});
-            return;
+    if (ret_status) {
+        for (const auto& error : response.errors()) {
+            std::error_code code = error.type();
+            if (code != SuccessCondition::Success) {
+                ret_status = ::bosdyn::common::Status(
+                    code, "RecordSignalTicksResponse ::bosdyn::common::Status unsuccessful");
+                break;
+            }
         }
     }
 
-    promise.set_value({ret_status, std::move(response)});
+    RecordSignalTicksResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
-void DataBufferClient::OnRecordEventsComplete(MessagePumpCallBase* call,
-                                              const ::bosdyn::api::RecordEventsRequest& request,
-                                              ::bosdyn::api::RecordEventsResponse&& response,
-                                              const grpc::Status& status,
-                                              std::promise<RecordEventsResultType> promise) {
+void DataBufferClient::OnRecordEventsComplete(
+    MessagePumpCallBase* call, const ::bosdyn::api::RecordEventsRequest& request,
+    ::bosdyn::api::RecordEventsResponse&& response, const grpc::Status& status,
+    std::promise<RecordEventsResultType> promise, const RecordEventsCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::RecordEventsResponse>(
             status, response, SDKErrorCode::Success);
 
-    if (!ret_status) {
-        promise.set_value({ret_status, std::move(response)});
-        return;
-    }
-
-    for (const auto& error : response.errors()) {
-        std::error_code code = error.type();
-        if (code != SuccessCondition::Success) {
-            promise.set_value(
-                {::bosdyn::common::Status(
-                     code, "RecordEventsResponse ::bosdyn::common::Status unsuccessful"),
-                 std::move(response)});
-            return;
+    if (ret_status) {
+        for (const auto& error : response.errors()) {
+            std::error_code code = error.type();
+            if (code != SuccessCondition::Success) {
+                ret_status = ::bosdyn::common::Status(
+                    code, "RecordEventsResponse ::bosdyn::common::Status unsuccessful");
+                break;
+            }
         }
     }
 
-    promise.set_value({ret_status, std::move(response)});
+    RecordEventsResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 void DataBufferClient::OnRegisterSignalSchemaComplete(
@@ -13,6 +13,7 @@
 #include <bosdyn/api/data_buffer_service.grpc.pb.h>
 #include <bosdyn/api/data_buffer_service.pb.h>
 
+#include <functional>
 #include <future>
 #include <memory>
 #include <string>
@@ -32,6 +33,14 @@ typedef Result<::bosdyn::api::RecordSignalTicksResponse> RecordSignalTicksResult
 typedef Result<::bosdyn::api::RecordEventsResponse> RecordEventsResultType;
 typedef Result<::bosdyn::api::RegisterSignalSchemaResponse> RegisterSignalSchemaResultType;
 
+// Called with the result of a record request as soon as it arrives.
+typedef std::function<void(const RecordTextMessagesResultType&)> RecordTextMessagesCallback;
+typedef std::function<void(const RecordOperatorCommentsResultType&)>
+    RecordOperatorCommentsCallback;
+typedef std::function<void(const RecordDataBlobsResultType&)> RecordDataBlobsCallback;
+typedef std::function<void(const RecordSignalTicksResultType&)> RecordSignalTicksCallback;
+typedef std::function<void(const RecordEventsResultType&)> RecordEventsCallback;
+
 class DataBufferClient : public ServiceClient {
  public:
     DataBufferClient() = default;
@@ -43,6 +52,12 @@ class DataBufferClient : public ServiceClient {
         ::bosdyn::api::RecordTextMessagesRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<RecordTextMessagesResultType> RecordTextMessagesAsync(
+        ::bosdyn::api::RecordTextMessagesRequest& request, const RPCParameters& parameters,
+        RecordTextMessagesCallback on_complete);
+
     // Synchronous method to record text messages.
     RecordTextMessagesResultType RecordTextMessages(
         ::bosdyn::api::RecordTextMessagesRequest& request,
@@ -73,6 +88,11 @@ class DataBufferClient : public ServiceClient {
         ::bosdyn::api::RecordOperatorCommentsRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result before the future is ready.
+    std::shared_future<RecordOperatorCommentsResultType> RecordOperatorCommentsAsync(
+        ::bosdyn::api::RecordOperatorCommentsRequest& request, const RPCParameters& parameters,
+        RecordOperatorCommentsCallback on_complete);
+
     // Synchronous method to record operator comments.
     RecordOperatorCommentsResultType RecordOperatorComments(
         ::bosdyn::api::RecordOperatorCommentsRequest& request,
@@ -103,6 +123,11 @@ class DataBufferClient : public ServiceClient {
         ::bosdyn::api::RecordDataBlobsRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result before the future is ready.
+    std::shared_future<RecordDataBlobsResultType> RecordDataBlobsAsync(
+        ::bosdyn::api::RecordDataBlobsRequest& request, const RPCParameters& parameters,
+        RecordDataBlobsCallback on_complete);
+
     // Synchronous method to record data blobs.
     RecordDataBlobsResultType RecordDataBlobs(::bosdyn::api::RecordDataBlobsRequest& request,
                                               const RPCParameters& parameters = RPCParameters());
@@ -129,6 +154,11 @@ class DataBufferClient : public ServiceClient {
         ::bosdyn::api::RecordSignalTicksRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result before the future is ready.
+    std::shared_future<RecordSignalTicksResultType> RecordSignalTicksAsync(
+        ::bosdyn::api::RecordSignalTicksRequest& request, const RPCParameters& parameters,
+        RecordSignalTicksCallback on_complete);
+
     // Synchronous method to record signal ticks
     RecordSignalTicksResultType RecordSignalTicks(
         ::bosdyn::api::RecordSignalTicksRequest& request,
@@ -157,6 +187,11 @@ class DataBufferClient : public ServiceClient {
         ::bosdyn::api::RecordEventsRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result before the future is ready.
+    std::shared_future<RecordEventsResultType> RecordEventsAsync(
+        ::bosdyn::api::RecordEventsRequest& request, const RPCParameters& parameters,
+        RecordEventsCallback on_complete);
+
     // Synchronous method to record events.
     RecordEventsResultType RecordEvents(::bosdyn::api::RecordEventsRequest& request,
                                         const RPCParameters& parameters = RPCParameters());
@@ -217,34 +252,39 @@ class DataBufferClient : public ServiceClient {
                                       const ::bosdyn::api::RecordTextMessagesRequest& request,
                                       ::bosdyn::api::RecordTextMessagesResponse&& response,
                                       const grpc::Status& status,
-                                      std::promise<RecordTextMessagesResultType> promise);
+                                      std::promise<RecordTextMessagesResultType> promise,
+                                      const RecordTextMessagesCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to record operator comments.
     void OnRecordOperatorCommentsComplete(
         MessagePumpCallBase* call, const ::bosdyn::api::RecordOperatorCommentsRequest& request,
         ::bosdyn::api::RecordOperatorCommentsResponse&& response, const grpc::Status& status,
-        std::promise<RecordOperatorCommentsResultType> promise);
+        std::promise<RecordOperatorCommentsResultType> promise,
+        const RecordOperatorCommentsCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to record data blobs.
     void OnRecordDataBlobsComplete(MessagePumpCallBase* call,
                                    const ::bosdyn::api::RecordDataBlobsRequest& request,
                                    ::bosdyn::api::RecordDataBlobsResponse&& response,
                                    const grpc::Status& status,
-                                   std::promise<RecordDataBlobsResultType> promise);
+                                   std::promise<RecordDataBlobsResultType> promise,
+                                   const RecordDataBlobsCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to record signal ticks.
     void OnRecordSignalTicksComplete(MessagePumpCallBase* call,
                                      const ::bosdyn::api::RecordSignalTicksRequest& request,
                                      ::bosdyn::api::RecordSignalTicksResponse&& response,
                                      const grpc::Status& status,
-                                     std::promise<RecordSignalTicksResultType> promise);
+                                     std::promise<RecordSignalTicksResultType> promise,
+                                     const RecordSignalTicksCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to record events.
     void OnRecordEventsComplete(MessagePumpCallBase* call,
                                 const ::bosdyn::api::RecordEventsRequest& request,
                                 ::bosdyn::api::RecordEventsResponse&& response,
                                 const grpc::Status& status,
-                                std::promise<RecordEventsResultType> promise);
+                                std::promise<RecordEventsResultType> promise,
+                                const RecordEventsCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to register a signal schema.
     void OnRegisterSignalSchemaComplete(MessagePumpCallBase* call,
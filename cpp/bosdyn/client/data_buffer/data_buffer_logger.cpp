@@ -0,0 +1,315 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/data_buffer/data_buffer_logger.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace bosdyn {
+
+namespace client {
+
+DataBufferLogger::DataBufferLogger(DataBufferClient* data_buffer_client,
+                                   const DataBufferLoggerParameters& parameters)
+    : m_data_buffer_client(data_buffer_client), m_parameters(parameters) {
+    m_flush_thread = std::thread(&DataBufferLogger::FlushLoop, this);
+}
+
+DataBufferLogger::~DataBufferLogger() { Stop(); }
+
+bool DataBufferLogger::AddTextMessage(::bosdyn::api::TextMessage text_message) {
+    return AddRecord(std::move(text_message), &m_text_message_queue);
+}
+
+bool DataBufferLogger::AddOperatorComment(::bosdyn::api::OperatorComment comment) {
+    return AddRecord(std::move(comment), &m_operator_comment_queue);
+}
+
+bool DataBufferLogger::AddDataBlob(::bosdyn::api::DataBlob blob) {
+    return AddRecord(std::move(blob), &m_data_blob_queue);
+}
+
+bool DataBufferLogger::AddSignalTick(::bosdyn::api::SignalTick tick) {
+    return AddRecord(std::move(tick), &m_signal_tick_queue);
+}
+
+bool DataBufferLogger::AddEvent(::bosdyn::api::Event event) {
+    return AddRecord(std::move(event), &m_event_queue);
+}
+
+template <class Record>
+bool DataBufferLogger::AddRecord(Record&& record, data_buffer::RecordQueue<Record>* queue) {
+    const size_t byte_size = record.ByteSizeLong();
+    const size_t queued_bytes = m_queued_bytes.fetch_add(byte_size) + byte_size;
+    if (m_stopped || queued_bytes > m_parameters.max_queued_bytes) {
+        m_queued_bytes -= byte_size;
+        ++m_records_dropped;
+        return false;
+    }
+
+    auto* node = new typename data_buffer::RecordQueue<Record>::Node();
+    node->record = std::move(record);
+    node->byte_size = byte_size;
+    node->enqueue_time = std::chrono::steady_clock::now();
+    queue->Push(node);
+    ++m_records_added;
+
+    // Wake the flush thread early once there may be a full batch. Only the producer that sets
+    // the flag takes the mutex, which keeps the wakeup from falling between the thread checking
+    // the flag and starting to wait.
+    if (queued_bytes >= m_parameters.max_batch_bytes && !m_batch_ready.exchange(true)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_all();
+    }
+    return true;
+}
+
+Result<uint64_t> DataBufferLogger::RegisterSignalSchema(
+    const ::bosdyn::api::SignalSchema& schema) {
+    data_buffer::SignalSchemaKey key(m_parameters.client_name, schema.SerializeAsString());
+    {
+        std::lock_guard<std::mutex> lock(m_schema_mutex);
+        auto range = m_schema_ids.equal_range(key.Hash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.first.IsEquivalent(key)) {
+                return {::bosdyn::common::Status(SDKErrorCode::Success), it->second.second};
+            }
+        }
+    }
+
+    auto result = m_data_buffer_client->RegisterSignalSchema(schema, m_parameters.rpc_parameters);
+    if (!result) return {result.status, 0};
+
+    const uint64_t schema_id = result.response.schema_id();
+    std::lock_guard<std::mutex> lock(m_schema_mutex);
+    m_schema_ids.emplace(key.Hash(), std::make_pair(key, schema_id));
+    return {result.status, schema_id};
+}
+
+void DataBufferLogger::Flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_thread_should_stop) return;
+    const uint64_t flush_id = ++m_flush_requested;
+    m_cv.notify_all();
+    m_cv.wait(lock, [this, flush_id]() {
+        return m_flush_completed >= flush_id || m_thread_should_stop;
+    });
+}
+
+void DataBufferLogger::Stop() {
+    m_stopped = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_thread_should_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_flush_thread.joinable()) {
+        m_flush_thread.join();
+    }
+}
+
+DataBufferLoggerStats DataBufferLogger::GetStats() const {
+    DataBufferLoggerStats stats;
+    stats.records_added = m_records_added;
+    stats.records_dropped = m_records_dropped;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.records_sent = m_records_sent;
+    stats.records_failed = m_records_failed;
+    stats.requests_sent = m_requests_sent;
+    stats.requests_failed = m_requests_failed;
+    stats.last_latency = m_last_latency;
+    stats.max_latency = m_max_latency;
+    stats.last_error = m_last_error;
+    return stats;
+}
+
+void DataBufferLogger::FlushLoop() {
+    while (true) {
+        uint64_t flush_id = 0;
+        bool should_stop = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_until(lock, NextBatchDeadline(), [this]() {
+                return m_thread_should_stop || m_flush_requested > m_flush_completed ||
+                       m_batch_ready || m_request_completed;
+            });
+            m_request_completed = false;
+            flush_id = m_flush_requested;
+            should_stop = m_thread_should_stop;
+        }
+        m_batch_ready = false;
+
+        const bool force = should_stop || flush_id > m_flush_completed;
+        SendBatches(force);
+        if (force) {
+            // Everything queued before the flush was requested has been sent; wait for it.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_num_in_flight == 0; });
+            m_flush_completed = flush_id;
+            m_cv.notify_all();
+        }
+        if (should_stop) break;
+    }
+
+    // Records that raced with Stop() are dropped.
+    const auto drop = [this](auto* queue) {
+        auto* node = queue->TakeAll();
+        for (auto* it = node; it; it = it->next) {
+            m_queued_bytes -= it->byte_size;
+            ++m_records_dropped;
+        }
+        queue->Free(node);
+    };
+    drop(&m_text_message_queue);
+    drop(&m_operator_comment_queue);
+    drop(&m_data_blob_queue);
+    drop(&m_signal_tick_queue);
+    drop(&m_event_queue);
+}
+
+void DataBufferLogger::SendBatches(bool force) {
+    DrainQueue(
+        &m_text_message_queue, &m_text_message_batch,
+        [](::bosdyn::api::RecordTextMessagesRequest* request) {
+            return request->add_text_messages();
+        },
+        &DataBufferClient::RecordTextMessagesAsync, force);
+    DrainQueue(
+        &m_operator_comment_queue, &m_operator_comment_batch,
+        [](::bosdyn::api::RecordOperatorCommentsRequest* request) {
+            return request->add_operator_comments();
+        },
+        &DataBufferClient::RecordOperatorCommentsAsync, force);
+    DrainQueue(
+        &m_data_blob_queue, &m_data_blob_batch,
+        [](::bosdyn::api::RecordDataBlobsRequest* request) { return request->add_blob_data(); },
+        &DataBufferClient::RecordDataBlobsAsync, force);
+    DrainQueue(
+        &m_signal_tick_queue, &m_signal_tick_batch,
+        [](::bosdyn::api::RecordSignalTicksRequest* request) { return request->add_tick_data(); },
+        &DataBufferClient::RecordSignalTicksAsync, force);
+    DrainQueue(
+        &m_event_queue, &m_event_batch,
+        [](::bosdyn::api::RecordEventsRequest* request) { return request->add_events(); },
+        &DataBufferClient::RecordEventsAsync, force);
+}
+
+template <class Record, class Request, class AddFn, class Result>
+void DataBufferLogger::DrainQueue(
+    data_buffer::RecordQueue<Record>* queue, PendingBatch<Request>* batch, AddFn add_record,
+    std::shared_future<Result> (DataBufferClient::*record_fn)(Request&, const RPCParameters&,
+                                                              std::function<void(const Result&)>),
+    bool force) {
+    auto* nodes = queue->TakeAll();
+    for (auto* node = nodes; node; node = node->next) {
+        if (batch->num_records == 0) {
+            batch->oldest_enqueue_time = node->enqueue_time;
+        }
+        *add_record(&batch->request) = std::move(node->record);
+        batch->num_records++;
+        batch->byte_size += node->byte_size;
+
+        // Full batches are always sent, so requests stay bounded in size.
+        if (batch->byte_size >= m_parameters.max_batch_bytes) {
+            SendBatch(batch, record_fn);
+        }
+    }
+    queue->Free(nodes);
+
+    if (batch->num_records == 0) return;
+    const bool is_old =
+        std::chrono::steady_clock::now() - batch->oldest_enqueue_time >= m_parameters.max_batch_age;
+    // While too many requests are in flight, keep coalescing records into this batch.
+    if (force || (is_old && m_num_in_flight < m_parameters.max_requests_in_flight)) {
+        SendBatch(batch, record_fn);
+    }
+}
+
+template <class Request, class Result>
+void DataBufferLogger::SendBatch(
+    PendingBatch<Request>* batch,
+    std::shared_future<Result> (DataBufferClient::*record_fn)(Request&, const RPCParameters&,
+                                                              std::function<void(const Result&)>)) {
+    const size_t num_records = batch->num_records;
+    const size_t byte_size = batch->byte_size;
+    const auto oldest_enqueue_time = batch->oldest_enqueue_time;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_num_in_flight;
+    }
+    // Set by the callback before the future is ready, so a ready future without it means the
+    // request could not be started and the callback will never run.
+    auto callback_called = std::make_shared<std::atomic<bool>>(false);
+    auto future = (m_data_buffer_client->*record_fn)(
+        batch->request, m_parameters.rpc_parameters,
+        [this, callback_called, num_records, byte_size, oldest_enqueue_time](const Result& result) {
+            *callback_called = true;
+            CompleteRequest(result.status, num_records, byte_size, oldest_enqueue_time);
+        });
+    if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+        !*callback_called) {
+        CompleteRequest(future.get().status, num_records, byte_size, oldest_enqueue_time);
+    }
+
+    batch->request.Clear();
+    batch->num_records = 0;
+    batch->byte_size = 0;
+}
+
+void DataBufferLogger::CompleteRequest(const ::bosdyn::common::Status& status, size_t num_records,
+                                       size_t byte_size,
+                                       std::chrono::steady_clock::time_point oldest_enqueue_time) {
+    const auto latency = std::chrono::duration_cast<::bosdyn::common::Duration>(
+        std::chrono::steady_clock::now() - oldest_enqueue_time);
+    m_queued_bytes -= byte_size;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests_sent++;
+    if (status) {
+        m_records_sent += num_records;
+    } else {
+        m_requests_failed++;
+        m_records_failed += num_records;
+        m_last_error = status;
+    }
+    m_last_latency = latency;
+    m_max_latency = std::max(m_max_latency, latency);
+    --m_num_in_flight;
+    m_request_completed = true;
+    // The logger may be destroyed as soon as the mutex is released, once nothing is in flight.
+    m_cv.notify_all();
+}
+
+std::chrono::steady_clock::time_point DataBufferLogger::NextBatchDeadline() const {
+    auto oldest = std::chrono::steady_clock::time_point::max();
+    const auto update = [&oldest](const auto& batch) {
+        if (batch.num_records > 0) oldest = std::min(oldest, batch.oldest_enqueue_time);
+    };
+    update(m_text_message_batch);
+    update(m_operator_comment_batch);
+    update(m_data_blob_batch);
+    update(m_signal_tick_batch);
+    update(m_event_batch);
+
+    // Records still in the queues are drained at least every max_batch_age. Batches due by age
+    // are held back while too many requests are in flight, until a completion wakes the thread.
+    const auto max_batch_age =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_parameters.max_batch_age);
+    const auto next_drain = std::chrono::steady_clock::now() + max_batch_age;
+    if (oldest == std::chrono::steady_clock::time_point::max() ||
+        m_num_in_flight >= m_parameters.max_requests_in_flight) {
+        return next_drain;
+    }
+    return std::min(next_drain, oldest + max_batch_age);
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,284 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/data_buffer.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bosdyn/client/data_buffer/data_buffer_client.h"
+#include "bosdyn/client/data_buffer/signal_schema_key.h"
+#include "bosdyn/common/status.h"
+#include "bosdyn/common/time.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace data_buffer {
+
+// Unbounded multi-producer, single-consumer queue of records. Push() is lock-free and may be
+// called from any thread. TakeAll() may only be called from one thread at a time, and removes
+// every queued record in the order it was pushed.
+template <class Record>
+class RecordQueue {
+ public:
+    struct Node {
+        Record record;
+        // Size of the serialized record and the steady clock time it was pushed.
+        size_t byte_size = 0;
+        std::chrono::steady_clock::time_point enqueue_time;
+        Node* next = nullptr;
+    };
+
+    RecordQueue() = default;
+    ~RecordQueue() { Free(TakeAll()); }
+
+    RecordQueue(const RecordQueue&) = delete;
+    RecordQueue& operator=(const RecordQueue&) = delete;
+
+    void Push(Node* node) {
+        node->next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+    }
+
+    // Returns the oldest record, linked to the newer ones through Node::next, or nullptr if the
+    // queue is empty. The caller owns the returned nodes.
+    Node* TakeAll() {
+        // Records are pushed onto the head of a list, so reverse it into insertion order.
+        Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        Node* oldest = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->next = oldest;
+            oldest = node;
+            node = next;
+        }
+        return oldest;
+    }
+
+    static void Free(Node* node) {
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+ private:
+    std::atomic<Node*> m_head{nullptr};
+};
+
+}  // namespace data_buffer
+
+// Settings for batching records in a DataBufferLogger.
+struct DataBufferLoggerParameters {
+    // Records of one type are sent once this many bytes of them are waiting.
+    size_t max_batch_bytes = 256 * 1024;
+
+    // Records are sent at most this long after they were added.
+    ::bosdyn::common::Duration max_batch_age = std::chrono::milliseconds(100);
+
+    // Records are dropped while this many bytes of records are waiting to be sent or in flight,
+    // e.g. because the robot is not keeping up.
+    size_t max_queued_bytes = 16 * 1024 * 1024;
+
+    // Maximum number of record RPCs in flight before records that are due by age are sent. While
+    // this many are outstanding, records keep coalescing until their batch is full.
+    size_t max_requests_in_flight = 4;
+
+    // Client name used to key the cache of signal schema registrations.
+    std::string client_name;
+
+    // Parameters for the record RPCs.
+    RPCParameters rpc_parameters;
+};
+
+// Counters of a DataBufferLogger.
+struct DataBufferLoggerStats {
+    // Records accepted by the Add*() methods.
+    uint64_t records_added = 0;
+    // Records dropped because too many bytes were queued or the logger was stopped.
+    uint64_t records_dropped = 0;
+    // Records in requests that completed successfully.
+    uint64_t records_sent = 0;
+    // Records in requests that failed.
+    uint64_t records_failed = 0;
+    // Record requests sent, and how many of them failed.
+    uint64_t requests_sent = 0;
+    uint64_t requests_failed = 0;
+    // Time from adding the oldest record of a request to completion of the request, for the most
+    // recent request and the worst request so far.
+    ::bosdyn::common::Duration last_latency{0};
+    ::bosdyn::common::Duration max_latency{0};
+    // Last error returned by a record request.
+    ::bosdyn::common::Status last_error;
+};
+
+// DataBufferLogger batches text messages, operator comments, data blobs, signal ticks and events
+// into as few Record* RPCs as possible.
+//
+// The Add*() methods never block: records are pushed onto lock-free queues, and a background
+// thread coalesces the records of each type into one request, sending it through the
+// DataBufferClient once it holds max_batch_bytes of records or its oldest record is max_batch_age
+// old. Requests are accounted for by their completion callbacks on the MessagePump thread.
+// Records are dropped, and counted as such, when more than max_queued_bytes are waiting. The
+// logger does not retry failed requests.
+class DataBufferLogger {
+ public:
+    // The client must outlive the logger.
+    explicit DataBufferLogger(
+        DataBufferClient* data_buffer_client,
+        const DataBufferLoggerParameters& parameters = DataBufferLoggerParameters());
+
+    // Sends any records still queued, waits for outstanding requests and stops the thread.
+    ~DataBufferLogger();
+
+    // Queue a record to be sent. These return false if the record is dropped.
+    bool AddTextMessage(::bosdyn::api::TextMessage text_message);
+    bool AddOperatorComment(::bosdyn::api::OperatorComment comment);
+    bool AddDataBlob(::bosdyn::api::DataBlob blob);
+    bool AddSignalTick(::bosdyn::api::SignalTick tick);
+    bool AddEvent(::bosdyn::api::Event event);
+
+    // Register a signal schema, and return the schema id to set in SignalTicks. Each schema is
+    // only registered with the robot once; later calls return the cached id.
+    Result<uint64_t> RegisterSignalSchema(const ::bosdyn::api::SignalSchema& schema);
+
+    // Send all records added before this call without waiting for the batch thresholds, and wait
+    // until their requests have completed.
+    void Flush();
+
+    // Send the records still queued, wait for outstanding requests and stop the thread. Records
+    // added afterwards are dropped.
+    void Stop();
+
+    DataBufferLoggerStats GetStats() const;
+
+    // The logger owns a thread, so it is not copyable or movable.
+    DataBufferLogger(const DataBufferLogger&) = delete;
+    DataBufferLogger& operator=(const DataBufferLogger&) = delete;
+
+ private:
+    // Records of one type that are being coalesced into the next request.
+    template <class Request>
+    struct PendingBatch {
+        Request request;
+        size_t num_records = 0;
+        size_t byte_size = 0;
+        std::chrono::steady_clock::time_point oldest_enqueue_time;
+    };
+
+    template <class Record>
+    bool AddRecord(Record&& record, data_buffer::RecordQueue<Record>* queue);
+
+    // Main loop of the flush thread.
+    void FlushLoop();
+
+    // Move queued records into the pending batches, and send the batches that are due. When
+    // force is true, every pending batch is sent regardless of size and age.
+    void SendBatches(bool force);
+
+    // Move the records of one queue into its pending batch, adding each with add_record. Full
+    // batches are sent with record_fn, and so is the rest of the batch if it is due by age or if
+    // force is true.
+    template <class Record, class Request, class AddFn, class Result>
+    void DrainQueue(data_buffer::RecordQueue<Record>* queue, PendingBatch<Request>* batch,
+                    AddFn add_record,
+                    std::shared_future<Result> (DataBufferClient::*record_fn)(
+                        Request&, const RPCParameters&, std::function<void(const Result&)>),
+                    bool force);
+
+    // Send the records of the batch with record_fn, and empty the batch.
+    template <class Request, class Result>
+    void SendBatch(PendingBatch<Request>* batch,
+                   std::shared_future<Result> (DataBufferClient::*record_fn)(
+                       Request&, const RPCParameters&, std::function<void(const Result&)>));
+
+    // Record the outcome of a request and wake the flush thread. Called from the completion
+    // callback of the request, or by SendBatch() if the request could not be started.
+    void CompleteRequest(const ::bosdyn::common::Status& status, size_t num_records,
+                         size_t byte_size,
+                         std::chrono::steady_clock::time_point oldest_enqueue_time);
+
+    // Time at which the oldest pending batch is due, or at which the queues are drained next if
+    // no more requests may be sent.
+    std::chrono::steady_clock::time_point NextBatchDeadline() const;
+
+    DataBufferClient* m_data_buffer_client = nullptr;
+    const DataBufferLoggerParameters m_parameters;
+
+    data_buffer::RecordQueue<::bosdyn::api::TextMessage> m_text_message_queue;
+    data_buffer::RecordQueue<::bosdyn::api::OperatorComment> m_operator_comment_queue;
+    data_buffer::RecordQueue<::bosdyn::api::DataBlob> m_data_blob_queue;
+    data_buffer::RecordQueue<::bosdyn::api::SignalTick> m_signal_tick_queue;
+    data_buffer::RecordQueue<::bosdyn::api::Event> m_event_queue;
+
+    // Bytes of records added whose requests have not completed yet.
+    std::atomic<size_t> m_queued_bytes{0};
+
+    // Set by producers when a queue may hold a full batch, to wake the flush thread early.
+    std::atomic<bool> m_batch_ready{false};
+
+    // Set once the logger stops accepting records.
+    std::atomic<bool> m_stopped{false};
+
+    // Only accessed by the flush thread.
+    PendingBatch<::bosdyn::api::RecordTextMessagesRequest> m_text_message_batch;
+    PendingBatch<::bosdyn::api::RecordOperatorCommentsRequest> m_operator_comment_batch;
+    PendingBatch<::bosdyn::api::RecordDataBlobsRequest> m_data_blob_batch;
+    PendingBatch<::bosdyn::api::RecordSignalTicksRequest> m_signal_tick_batch;
+    PendingBatch<::bosdyn::api::RecordEventsRequest> m_event_batch;
+
+    // Requests sent that have not completed yet. Only changed with m_mutex held, so the flush
+    // thread can wait for it under the mutex.
+    std::atomic<size_t> m_num_in_flight{0};
+
+    // Guards the flush requests, the flags of the thread and the non-atomic counters.
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    // Flush() calls are numbered; the thread completes them in order.
+    uint64_t m_flush_requested = 0;
+    uint64_t m_flush_completed = 0;
+    // Set when a request completes, since batches held back while too many requests were in
+    // flight may be sent now.
+    bool m_request_completed = false;
+    bool m_thread_should_stop = false;
+    std::thread m_flush_thread;
+
+    std::atomic<uint64_t> m_records_added{0};
+    std::atomic<uint64_t> m_records_dropped{0};
+    uint64_t m_records_sent = 0;
+    uint64_t m_records_failed = 0;
+    uint64_t m_requests_sent = 0;
+    uint64_t m_requests_failed = 0;
+    ::bosdyn::common::Duration m_last_latency{0};
+    ::bosdyn::common::Duration m_max_latency{0};
+    ::bosdyn::common::Status m_last_error;
+
+    // Cache of registered signal schemas, keyed by the hash of their SignalSchemaKey.
+    std::mutex m_schema_mutex;
+    std::unordered_multimap<uint64_t, std::pair<data_buffer::SignalSchemaKey, uint64_t>>
+        m_schema_ids;
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -9,17 +9,565 @@
 
 #include "bosdyn/client/data_chunk/data_chunking.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/wire_format.h"
+#include "google/protobuf/wire_format_lite.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "bosdyn/common/assert_precondition.h"
+
 namespace bosdyn {
 
 namespace client {
 
-void StringToDataChunks(const std::string& data, std::vector<::bosdyn::api::DataChunk>* chunks) {
-    int chunk_size = 2 * 1024 * 1024;
-    int start_index = 0;
-    int left;
+DataChunkOutputStream::DataChunkOutputStream(std::vector<::bosdyn::api::DataChunk>* chunks,
+                                             size_t total_size, size_t chunk_size)
+    : m_chunks(chunks), m_total_size(total_size), m_chunk_size(chunk_size) {
+    BOSDYN_ASSERT_PRECONDITION(m_chunks != nullptr, "Chunks cannot be null.");
+    BOSDYN_ASSERT_PRECONDITION(m_chunk_size > 0, "Chunk size must be positive.");
+}
+
+bool DataChunkOutputStream::Next(void** data, int* size) {
+    // Hand back space in the last chunk that was returned through BackUp.
+    if (!m_chunks->empty()) {
+        std::string* last_data = m_chunks->back().mutable_data();
+        if (last_data->size() < m_last_chunk_capacity) {
+            const size_t offset = last_data->size();
+            last_data->resize(m_last_chunk_capacity);
+            *data = &(*last_data)[offset];
+            *size = static_cast<int>(m_last_chunk_capacity - offset);
+            m_byte_count += m_last_chunk_capacity - offset;
+            return true;
+        }
+    }
+
+    if (m_byte_count >= m_total_size) {
+        return false;
+    }
+    m_last_chunk_capacity = std::min(m_chunk_size, m_total_size - m_byte_count);
+    m_chunks->emplace_back();
+    ::bosdyn::api::DataChunk& chunk = m_chunks->back();
+    chunk.set_total_size(m_total_size);
+    std::string* chunk_data = chunk.mutable_data();
+    chunk_data->resize(m_last_chunk_capacity);
+    *data = &(*chunk_data)[0];
+    *size = static_cast<int>(m_last_chunk_capacity);
+    m_byte_count += m_last_chunk_capacity;
+    return true;
+}
+
+void DataChunkOutputStream::BackUp(int count) {
+    if (count <= 0 || m_chunks->empty()) {
+        return;
+    }
+    std::string* last_data = m_chunks->back().mutable_data();
+    last_data->resize(last_data->size() - count);
+    m_byte_count -= count;
+}
+
+DataChunkInputStream::DataChunkInputStream(
+    const std::vector<const ::bosdyn::api::DataChunk*>& data_chunks)
+    : m_data_chunks(data_chunks) {}
+
+bool DataChunkInputStream::Next(const void** data, int* size) {
+    while (m_chunk_index < m_data_chunks.size() &&
+           m_offset >= m_data_chunks[m_chunk_index]->data().size()) {
+        ++m_chunk_index;
+        m_offset = 0;
+    }
+    if (m_chunk_index >= m_data_chunks.size()) {
+        return false;
+    }
+    const std::string& chunk_data = m_data_chunks[m_chunk_index]->data();
+    *data = chunk_data.data() + m_offset;
+    *size = static_cast<int>(chunk_data.size() - m_offset);
+    m_byte_count += chunk_data.size() - m_offset;
+    m_offset = chunk_data.size();
+    return true;
+}
+
+void DataChunkInputStream::BackUp(int count) {
+    // BackUp is only valid for bytes returned by the last call to Next, which are all in the
+    // current chunk.
+    m_offset -= count;
+    m_byte_count -= count;
+}
+
+bool DataChunkInputStream::Skip(int count) {
+    size_t remaining = count;
+    while (remaining > 0) {
+        if (m_chunk_index >= m_data_chunks.size()) {
+            return false;
+        }
+        const size_t available = m_data_chunks[m_chunk_index]->data().size() - m_offset;
+        if (remaining < available) {
+            m_offset += remaining;
+            m_byte_count += remaining;
+            return true;
+        }
+        remaining -= available;
+        m_byte_count += available;
+        ++m_chunk_index;
+        m_offset = 0;
+    }
+    return true;
+}
+
+::bosdyn::common::Status VectorDataChunkSource::NextChunk(::bosdyn::api::DataChunk* chunk,
+                                                          bool* has_chunk) {
+    *has_chunk = m_next_chunk < m_chunks.size();
+    if (*has_chunk) {
+        *chunk = std::move(m_chunks[m_next_chunk]);
+        // Release the moved-from chunk, in case the move had to copy.
+        m_chunks[m_next_chunk].Clear();
+        ++m_next_chunk;
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+IstreamDataChunkSource::IstreamDataChunkSource(std::unique_ptr<std::istream> input,
+                                               uint64_t total_size, size_t chunk_size)
+    : m_input(std::move(input)), m_total_size(total_size), m_chunk_size(chunk_size) {
+    BOSDYN_ASSERT_PRECONDITION(m_input != nullptr, "Input stream cannot be null.");
+    BOSDYN_ASSERT_PRECONDITION(m_chunk_size > 0, "Chunk size must be positive.");
+}
+
+Result<std::unique_ptr<DataChunkSource>> IstreamDataChunkSource::FromFile(const std::string& path,
+                                                                          size_t chunk_size) {
+    auto input = std::make_unique<std::ifstream>(path, std::ios::binary | std::ios::ate);
+    if (!input->is_open()) {
+        return {::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                         "Could not open file " + path),
+                nullptr};
+    }
+    const std::streamoff total_size = input->tellg();
+    input->seekg(0, std::ios::beg);
+    if (total_size < 0 || !input->good()) {
+        return {::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                         "Could not determine size of file " + path),
+                nullptr};
+    }
+    return {::bosdyn::common::Status(SDKErrorCode::Success),
+            std::make_unique<IstreamDataChunkSource>(std::move(input),
+                                                     static_cast<uint64_t>(total_size),
+                                                     chunk_size)};
+}
+
+::bosdyn::common::Status IstreamDataChunkSource::NextChunk(::bosdyn::api::DataChunk* chunk,
+                                                           bool* has_chunk) {
+    *has_chunk = m_bytes_read < m_total_size || !m_produced_any;
+    if (!*has_chunk) {
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+    const size_t chunk_length =
+        static_cast<size_t>(std::min<uint64_t>(m_chunk_size, m_total_size - m_bytes_read));
+    chunk->set_total_size(m_total_size);
+    std::string* chunk_data = chunk->mutable_data();
+    chunk_data->resize(chunk_length);
+    if (chunk_length > 0) {
+        m_input->read(&(*chunk_data)[0], static_cast<std::streamsize>(chunk_length));
+        if (static_cast<size_t>(m_input->gcount()) != chunk_length) {
+            *has_chunk = false;
+            return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                            "Input stream ended before the reported total size");
+        }
+    }
+    m_bytes_read += chunk_length;
+    m_produced_any = true;
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+MessageDataChunkSource::MessageDataChunkSource(const google::protobuf::Message& message,
+                                               size_t chunk_size)
+    : m_message(&message), m_chunk_size(chunk_size) {
+    BOSDYN_ASSERT_PRECONDITION(m_chunk_size > 0, "Chunk size must be positive.");
+}
+
+MessageDataChunkSource::MessageDataChunkSource(
+    std::unique_ptr<const google::protobuf::Message> message, size_t chunk_size)
+    : m_owned_message(std::move(message)), m_message(m_owned_message.get()),
+      m_chunk_size(chunk_size) {
+    BOSDYN_ASSERT_PRECONDITION(m_message != nullptr, "Message cannot be null.");
+    BOSDYN_ASSERT_PRECONDITION(m_chunk_size > 0, "Chunk size must be positive.");
+}
+
+void MessageDataChunkSource::PushMessage(const google::protobuf::Message& message) {
+    m_frames.emplace_back();
+    m_frames.back().message = &message;
+    message.GetReflection()->ListFields(message, &m_frames.back().fields);
+}
+
+::bosdyn::common::Status MessageDataChunkSource::NextChunk(::bosdyn::api::DataChunk* chunk,
+                                                           bool* has_chunk) {
+    *has_chunk = false;
+    if (!m_output) {
+        // Also caches the sizes of all submessages.
+        m_total_size = m_message->ByteSizeLong();
+        if (m_total_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                            "Could not serialize message");
+        }
+        m_output = std::make_unique<DataChunkOutputStream>(&m_chunks, m_total_size, m_chunk_size);
+        if (m_total_size == 0) {
+            // Keep sending a single empty chunk for empty messages.
+            StringToDataChunks(std::string(), &m_chunks, m_chunk_size);
+        } else {
+            PushMessage(*m_message);
+        }
+    }
+
+    // The last chunk is only complete once the next one was started or the message was written.
+    while (m_next_chunk + 1 >= m_chunks.size() && !m_frames.empty()) {
+        ::bosdyn::common::Status status = WriteNextPart();
+        if (!status) {
+            m_frames.clear();
+            m_chunks.clear();
+            m_next_chunk = 0;
+            return status;
+        }
+    }
+    if (m_next_chunk < m_chunks.size()) {
+        *chunk = std::move(m_chunks[m_next_chunk]);
+        m_chunks[m_next_chunk].Clear();
+        ++m_next_chunk;
+        *has_chunk = true;
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status MessageDataChunkSource::WriteNextPart() {
+    using google::protobuf::FieldDescriptor;
+    using google::protobuf::internal::WireFormat;
+    using google::protobuf::internal::WireFormatLite;
+
+    // Drop the chunks already produced. Only the last one, still being written, is left.
+    m_chunks.erase(m_chunks.begin(), m_chunks.begin() + m_next_chunk);
+    m_next_chunk = 0;
+
+    bool had_error;
+    {
+        google::protobuf::io::CodedOutputStream output(m_output.get());
+        Frame& frame = m_frames.back();
+        const google::protobuf::Message& message = *frame.message;
+        const google::protobuf::Reflection* reflection = message.GetReflection();
+        if (frame.data != nullptr) {
+            const size_t length = std::min(m_chunk_size, frame.data->size() - frame.data_offset);
+            output.WriteRaw(frame.data->data() + frame.data_offset, static_cast<int>(length));
+            frame.data_offset += length;
+            if (frame.data_offset == frame.data->size()) {
+                frame.data = nullptr;
+                ++frame.element_index;
+            }
+        } else if (frame.field_index == frame.fields.size()) {
+            WireFormat::SerializeUnknownFields(reflection->GetUnknownFields(message), &output);
+            m_frames.pop_back();
+        } else {
+            const FieldDescriptor* field = frame.fields[frame.field_index];
+            const int num_elements =
+                field->is_repeated() ? reflection->FieldSize(message, field) : 1;
+            if (frame.element_index == num_elements) {
+                ++frame.field_index;
+                frame.element_index = 0;
+            } else if (field->type() == FieldDescriptor::TYPE_MESSAGE) {
+                const google::protobuf::Message& element =
+                    field->is_repeated()
+                        ? reflection->GetRepeatedMessage(message, field, frame.element_index)
+                        : reflection->GetMessage(message, field);
+                // Map entries do not get their sizes cached by the parent, so size each element.
+                const size_t size = element.ByteSizeLong();
+                output.WriteTag(WireFormatLite::MakeTag(field->number(),
+                                                        WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+                output.WriteVarint32(static_cast<uint32_t>(size));
+                ++frame.element_index;
+                if (size > m_chunk_size &&
+                    !element.GetDescriptor()->options().message_set_wire_format()) {
+                    PushMessage(element);
+                } else {
+                    element.SerializeWithCachedSizes(&output);
+                }
+            } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+                const std::string& value =
+                    field->is_repeated()
+                        ? reflection->GetRepeatedStringReference(message, field,
+                                                                 frame.element_index,
+                                                                 &frame.data_scratch)
+                        : reflection->GetStringReference(message, field, &frame.data_scratch);
+                output.WriteTag(WireFormatLite::MakeTag(field->number(),
+                                                        WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+                output.WriteVarint32(static_cast<uint32_t>(value.size()));
+                if (value.size() > m_chunk_size) {
+                    frame.data = &value;
+                    frame.data_offset = 0;
+                } else {
+                    output.WriteRaw(value.data(), static_cast<int>(value.size()));
+                    ++frame.element_index;
+                }
+            } else {
+                // Scalars, enums and groups, with all elements of a repeated field at once since
+                // packed fields are written as one.
+                WireFormat::SerializeFieldWithCachedSizes(field, message, &output);
+                ++frame.field_index;
+            }
+        }
+        output.Trim();
+        had_error = output.HadError();
+    }
+    if (had_error) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not serialize message");
+    }
+    if (m_frames.empty() && static_cast<size_t>(m_output->ByteCount()) != m_total_size) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Size mismatch in MessageDataChunkSource");
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status DataChunkSink::AddChunk(const ::bosdyn::api::DataChunk& chunk) {
+    if (m_failed) {
+        return m_failure;
+    }
+    if (!m_started) {
+        m_total_size = chunk.total_size();
+        ::bosdyn::common::Status status = Reserve(m_total_size);
+        if (!status) {
+            m_failed = true;
+            m_failure = status;
+            return status;
+        }
+        m_started = true;
+    } else if (chunk.total_size() != m_total_size) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Mismatch in reported total size in streamed data chunks");
+    }
+    if (chunk.data().size() > m_total_size - m_bytes_written) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Streamed data chunks exceed the reported total size");
+    }
+    ::bosdyn::common::Status status = WriteData(chunk.data());
+    if (!status) {
+        m_failed = true;
+        m_failure = status;
+        return status;
+    }
+    m_bytes_written += chunk.data().size();
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status DataChunkSink::Finish() {
+    if (m_failed) {
+        return m_failure;
+    }
+    if (!m_started) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "No data chunks were received");
+    }
+    if (m_bytes_written != m_total_size) {
+        return ::bosdyn::common::Status(
+            SDKErrorCode::GenericSDKError,
+            "Streamed data chunks do not add up to the reported total size");
+    }
+    return FinishData();
+}
+
+::bosdyn::common::Status DataChunkSink::Reserve(uint64_t /*total_size*/) {
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status DataChunkSink::FinishData() {
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status StringDataChunkSink::Reserve(uint64_t total_size) {
+    if (total_size > m_data.max_size()) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Reported total size is too large for a string");
+    }
+    m_data.clear();
+    m_data.reserve(static_cast<size_t>(total_size));
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status StringDataChunkSink::WriteData(const std::string& data) {
+    m_data.append(data);
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+TempFileDataChunkSink::~TempFileDataChunkSink() {
+    if (m_file != nullptr) {
+        std::fclose(m_file);
+        std::error_code error;
+        std::filesystem::remove(m_temp_path, error);
+    }
+}
+
+::bosdyn::common::Status TempFileDataChunkSink::Reserve(uint64_t /*total_size*/) {
+    m_file = std::fopen(m_temp_path.c_str(), "wb");
+    if (m_file == nullptr) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not create file " + m_temp_path + ": " +
+                                            std::strerror(errno));
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status TempFileDataChunkSink::WriteData(const std::string& data) {
+    if (std::fwrite(data.data(), 1, data.size(), m_file) != data.size()) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not write file " + m_temp_path + ": " +
+                                            std::strerror(errno));
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status TempFileDataChunkSink::FinishData() {
+    const bool closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+    std::error_code error;
+    if (!closed) {
+        std::filesystem::remove(m_temp_path, error);
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not write file " + m_temp_path);
+    }
+    std::filesystem::rename(m_temp_path, m_path, error);
+    if (error) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not rename " + m_temp_path + " to " + m_path +
+                                            ": " + error.message());
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+#ifndef _WIN32
+::bosdyn::common::Status FileDescriptorDataChunkSink::WriteData(const std::string& data) {
+    const char* remaining = data.data();
+    size_t remaining_size = data.size();
+    while (remaining_size > 0) {
+        const ssize_t written = ::write(m_fd, remaining, remaining_size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                            std::string("Failed to write data chunk: ") +
+                                                std::strerror(errno));
+        }
+        remaining += written;
+        remaining_size -= static_cast<size_t>(written);
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+MappedFileDataChunkSink::~MappedFileDataChunkSink() { Unmap(); }
+
+void MappedFileDataChunkSink::Unmap() {
+    if (m_mapping != nullptr) {
+        ::munmap(m_mapping, static_cast<size_t>(m_mapping_size));
+        m_mapping = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+::bosdyn::common::Status MappedFileDataChunkSink::Reserve(uint64_t total_size) {
+    m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not open file " + m_path + ": " +
+                                            std::strerror(errno));
+    }
+    if (::ftruncate(m_fd, static_cast<off_t>(total_size)) != 0) {
+        const int error = errno;
+        Unmap();
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not resize file " + m_path + ": " +
+                                            std::strerror(error));
+    }
+    // mmap does not accept empty mappings; an empty file needs no data written.
+    if (total_size == 0) {
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+    void* mapping = ::mmap(nullptr, static_cast<size_t>(total_size), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, m_fd, 0);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        Unmap();
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not map file " + m_path + ": " +
+                                            std::strerror(error));
+    }
+    m_mapping = static_cast<char*>(mapping);
+    m_mapping_size = total_size;
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status MappedFileDataChunkSink::WriteData(const std::string& data) {
+    if (!data.empty()) {
+        std::memcpy(m_mapping + bytes_written(), data.data(), data.size());
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status MappedFileDataChunkSink::FinishData() {
+    if (m_mapping != nullptr && ::msync(m_mapping, static_cast<size_t>(m_mapping_size),
+                                        MS_SYNC) != 0) {
+        const int error = errno;
+        Unmap();
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Could not flush file " + m_path + ": " +
+                                            std::strerror(error));
+    }
+    Unmap();
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+#endif
+
+::bosdyn::common::Status ValidateDataChunks(
+    const std::vector<const ::bosdyn::api::DataChunk*>& data_chunks) {
+    if (data_chunks.empty()) {
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+
+    const uint64_t reported_total_size = data_chunks[0]->total_size();
+    uint64_t total_size = 0;
+    for (auto chunk : data_chunks) {
+        if (chunk->total_size() != reported_total_size) {
+            return ::bosdyn::common::Status(
+                SDKErrorCode::GenericSDKError,
+                "Mismatch in reported total size in vector of data chunks");
+        }
+        total_size += chunk->data().size();
+    }
+
+    if (total_size != reported_total_size) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Size mismatch in StringFromDataChunks");
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+void StringToDataChunks(const std::string& data, std::vector<::bosdyn::api::DataChunk>* chunks,
+                        size_t chunk_size) {
+    BOSDYN_ASSERT_PRECONDITION(chunk_size > 0, "Chunk size must be positive.");
+    size_t start_index = 0;
+    size_t left;
     const char* buffer = data.c_str();
 
-    int total_size = data.length();
+    size_t total_size = data.length();
+    chunks->reserve(chunks->size() + total_size / chunk_size + 1);
     while (true) {
         ::bosdyn::api::DataChunk chunk;
         left = total_size - start_index;
@@ -42,25 +590,17 @@ Result<std::string> StringFromDataChunks(
         return {::bosdyn::common::Status(SDKErrorCode::Success), ""};
     }
 
+    ::bosdyn::common::Status status = ValidateDataChunks(data_chunks);
+    if (!status) {
+        return {status, ""};
+    }
+
     std::string full_data;
-    int reported_total_size = data_chunks[0]->total_size();
-    full_data.reserve(reported_total_size);
+    full_data.reserve(data_chunks[0]->total_size());
     for (auto chunk : data_chunks) {
-        if (chunk->total_size() != reported_total_size) {
-            return {::bosdyn::common::Status(
-                        SDKErrorCode::GenericSDKError,
-                        "Mismatch in reported total size in vector of data chunks"),
-                    ""};
-        }
         full_data.append(chunk->data());
     }
 
-    if (full_data.length() != reported_total_size) {
-        return {::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
-                                         "Size mismatch in StringFromDataChunks"),
-                ""};
-    }
-
     return {::bosdyn::common::Status(SDKErrorCode::Success), std::move(full_data)};
 }
 
@@ -11,15 +11,317 @@
 
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message.h"
 #include "bosdyn/client/error_codes/sdk_error_code.h"
 #include "bosdyn/client/service_client/result.h"
 
 #include <bosdyn/api/data_chunk.pb.h>
 
+#include <cstdio>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace bosdyn {
 
 namespace client {
 
+// Default size of the data field of each DataChunk created by the chunking helpers.
+constexpr size_t kDefaultDataChunkSize = 2 * 1024 * 1024;
+
+/**
+ * ZeroCopyOutputStream that writes directly into the data fields of a vector of DataChunks.
+ *
+ * The total number of bytes to write must be known up front (e.g. from ByteSizeLong), so every
+ * chunk is sized exactly once and tagged with the total size. Serializing a message through this
+ * stream avoids building an intermediate std::string of the full message.
+ */
+class DataChunkOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+    DataChunkOutputStream(std::vector<::bosdyn::api::DataChunk>* chunks, size_t total_size,
+                          size_t chunk_size = kDefaultDataChunkSize);
+
+    bool Next(void** data, int* size) override;
+    void BackUp(int count) override;
+    int64_t ByteCount() const override { return static_cast<int64_t>(m_byte_count); }
+
+ private:
+    std::vector<::bosdyn::api::DataChunk>* m_chunks;
+    size_t m_total_size;
+    size_t m_chunk_size;
+    size_t m_byte_count = 0;
+    // Size the last chunk was created with, so space returned by BackUp can be handed out again.
+    size_t m_last_chunk_capacity = 0;
+};
+
+/**
+ * ZeroCopyInputStream that reads the data fields of a sequence of DataChunks in order, without
+ * concatenating them. The chunks must outlive the stream.
+ */
+class DataChunkInputStream : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+    explicit DataChunkInputStream(const std::vector<const ::bosdyn::api::DataChunk*>& data_chunks);
+
+    bool Next(const void** data, int* size) override;
+    void BackUp(int count) override;
+    bool Skip(int count) override;
+    int64_t ByteCount() const override { return static_cast<int64_t>(m_byte_count); }
+
+ private:
+    const std::vector<const ::bosdyn::api::DataChunk*>& m_data_chunks;
+    size_t m_chunk_index = 0;
+    size_t m_offset = 0;
+    size_t m_byte_count = 0;
+};
+
+/**
+ * Source of DataChunks that are produced one at a time, so a request stream only needs to hold the
+ * chunk it is currently writing instead of the full chunked payload.
+ */
+class DataChunkSource {
+ public:
+    virtual ~DataChunkSource() = default;
+
+    /**
+     * Produce the next chunk.
+     *
+     * @param chunk Output argument filled in with the next chunk. Reusing the same chunk across
+     *              calls lets its data buffer be reused.
+     * @param has_chunk Set to true if chunk was filled in, or false once all data was produced.
+     *
+     * @return ::bosdyn::common::Status with any errors found.
+     */
+    virtual ::bosdyn::common::Status NextChunk(::bosdyn::api::DataChunk* chunk,
+                                               bool* has_chunk) = 0;
+};
+
+/**
+ * DataChunkSource over chunks that were already created in memory. Each chunk is moved out as it
+ * is produced, so its memory is released once the stream has sent it.
+ */
+class VectorDataChunkSource : public DataChunkSource {
+ public:
+    explicit VectorDataChunkSource(std::vector<::bosdyn::api::DataChunk>&& chunks)
+        : m_chunks(std::move(chunks)) {}
+
+    ::bosdyn::common::Status NextChunk(::bosdyn::api::DataChunk* chunk, bool* has_chunk) override;
+
+ private:
+    std::vector<::bosdyn::api::DataChunk> m_chunks;
+    size_t m_next_chunk = 0;
+};
+
+/**
+ * DataChunkSource that reads chunk_size bytes at a time from an input stream, for example a
+ * serialized message stored on disk. Memory use is bounded by one chunk regardless of the total
+ * size. An empty input produces a single empty chunk.
+ */
+class IstreamDataChunkSource : public DataChunkSource {
+ public:
+    IstreamDataChunkSource(std::unique_ptr<std::istream> input, uint64_t total_size,
+                           size_t chunk_size = kDefaultDataChunkSize);
+
+    // Create a source reading the whole file at the given path.
+    static Result<std::unique_ptr<DataChunkSource>> FromFile(
+        const std::string& path, size_t chunk_size = kDefaultDataChunkSize);
+
+    ::bosdyn::common::Status NextChunk(::bosdyn::api::DataChunk* chunk, bool* has_chunk) override;
+
+ private:
+    std::unique_ptr<std::istream> m_input;
+    uint64_t m_total_size;
+    size_t m_chunk_size;
+    uint64_t m_bytes_read = 0;
+    bool m_produced_any = false;
+};
+
+/**
+ * DataChunkSource that serializes a message as its chunks are requested, instead of all at once
+ * like MessageToDataChunks. Fields are written in order, and submessages and string fields larger
+ * than a chunk are written a piece at a time, so besides the message only about one chunk of
+ * serialized data is held. Other repeated fields and unknown fields are written whole.
+ *
+ * The message must not change until the source is done. A source created from a reference does not
+ * own the message, which must outlive it.
+ */
+class MessageDataChunkSource : public DataChunkSource {
+ public:
+    explicit MessageDataChunkSource(const google::protobuf::Message& message,
+                                    size_t chunk_size = kDefaultDataChunkSize);
+    explicit MessageDataChunkSource(std::unique_ptr<const google::protobuf::Message> message,
+                                    size_t chunk_size = kDefaultDataChunkSize);
+
+    ::bosdyn::common::Status NextChunk(::bosdyn::api::DataChunk* chunk, bool* has_chunk) override;
+
+ private:
+    // A message being written one field element at a time.
+    struct Frame {
+        const google::protobuf::Message* message;
+        std::vector<const google::protobuf::FieldDescriptor*> fields;
+        size_t field_index = 0;
+        int element_index = 0;
+        // String element larger than a chunk being written, and how much of it was written.
+        const std::string* data = nullptr;
+        size_t data_offset = 0;
+        std::string data_scratch;
+    };
+
+    void PushMessage(const google::protobuf::Message& message);
+    // Write the next piece of the message into m_chunks.
+    ::bosdyn::common::Status WriteNextPart();
+
+    std::unique_ptr<const google::protobuf::Message> m_owned_message;
+    const google::protobuf::Message* m_message;
+    size_t m_chunk_size;
+    size_t m_total_size = 0;
+    std::vector<Frame> m_frames;
+    // Chunks written and not produced yet. All but the last one are complete.
+    std::vector<::bosdyn::api::DataChunk> m_chunks;
+    size_t m_next_chunk = 0;
+    std::unique_ptr<DataChunkOutputStream> m_output;
+};
+
+/**
+ * Destination for DataChunks that arrive one at a time on a response stream. Each chunk is
+ * reassembled into the output as soon as it is received, so a download only needs to hold the
+ * chunk it is currently processing instead of every response of the stream.
+ *
+ * Chunks must be added in order. AddChunk checks that all chunks agree on the total size, and
+ * Finish checks that exactly the total size was received.
+ */
+class DataChunkSink {
+ public:
+    virtual ~DataChunkSink() = default;
+
+    // Append the data of the next chunk to the output. Once a chunk fails to be reserved or
+    // written, this and Finish() return that failure for the rest of the stream.
+    ::bosdyn::common::Status AddChunk(const ::bosdyn::api::DataChunk& chunk);
+
+    // Complete the output after the last chunk was added.
+    ::bosdyn::common::Status Finish();
+
+    // Total size reported by the chunks, and the number of bytes added so far.
+    uint64_t total_size() const { return m_total_size; }
+    uint64_t bytes_written() const { return m_bytes_written; }
+
+ protected:
+    // Called once with the total size, before the data of the first chunk is written.
+    virtual ::bosdyn::common::Status Reserve(uint64_t total_size);
+    // Write the data of a chunk at the current end of the output.
+    virtual ::bosdyn::common::Status WriteData(const std::string& data) = 0;
+    // Called once all data was written.
+    virtual ::bosdyn::common::Status FinishData();
+
+ private:
+    uint64_t m_total_size = 0;
+    uint64_t m_bytes_written = 0;
+    bool m_started = false;
+    // First failure of Reserve() or WriteData(), returned by every later call.
+    ::bosdyn::common::Status m_failure;
+    bool m_failed = false;
+};
+
+/**
+ * DataChunkSink that reassembles the chunks into a string. The string is allocated once with the
+ * total size, so parsing a message from it needs at most one copy of the data in memory on top of
+ * the parsed message.
+ */
+class StringDataChunkSink : public DataChunkSink {
+ public:
+    const std::string& data() const { return m_data; }
+    std::string Release() { return std::move(m_data); }
+
+ protected:
+    ::bosdyn::common::Status Reserve(uint64_t total_size) override;
+    ::bosdyn::common::Status WriteData(const std::string& data) override;
+
+ private:
+    std::string m_data;
+};
+
+/**
+ * DataChunkSink that writes the chunks to a temporary file next to the given path as they arrive,
+ * and renames it to the path once all of the data was written. The file at the path is therefore
+ * either absent or complete. A sink destroyed before then removes its temporary file.
+ */
+class TempFileDataChunkSink : public DataChunkSink {
+ public:
+    explicit TempFileDataChunkSink(const std::string& path,
+                                   const std::string& temp_suffix = ".tmp")
+        : m_path(path), m_temp_path(path + temp_suffix) {}
+    ~TempFileDataChunkSink() override;
+
+    TempFileDataChunkSink(const TempFileDataChunkSink&) = delete;
+    TempFileDataChunkSink& operator=(const TempFileDataChunkSink&) = delete;
+
+ protected:
+    ::bosdyn::common::Status Reserve(uint64_t total_size) override;
+    ::bosdyn::common::Status WriteData(const std::string& data) override;
+    ::bosdyn::common::Status FinishData() override;
+
+ private:
+    std::string m_path;
+    std::string m_temp_path;
+    std::FILE* m_file = nullptr;
+};
+
+#ifndef _WIN32
+/**
+ * DataChunkSink that writes the chunks to an open file descriptor as they arrive. The file
+ * descriptor is not closed by the sink.
+ */
+class FileDescriptorDataChunkSink : public DataChunkSink {
+ public:
+    explicit FileDescriptorDataChunkSink(int fd) : m_fd(fd) {}
+
+ protected:
+    ::bosdyn::common::Status WriteData(const std::string& data) override;
+
+ private:
+    int m_fd;
+};
+
+/**
+ * DataChunkSink that reassembles the chunks into a memory-mapped file at the given path. The file
+ * is created, or truncated, and sized to the total size when the first chunk arrives, and each
+ * chunk is copied straight into the mapping.
+ */
+class MappedFileDataChunkSink : public DataChunkSink {
+ public:
+    explicit MappedFileDataChunkSink(const std::string& path) : m_path(path) {}
+    ~MappedFileDataChunkSink() override;
+
+    MappedFileDataChunkSink(const MappedFileDataChunkSink&) = delete;
+    MappedFileDataChunkSink& operator=(const MappedFileDataChunkSink&) = delete;
+
+ protected:
+    ::bosdyn::common::Status Reserve(uint64_t total_size) override;
+    ::bosdyn::common::Status WriteData(const std::string& data) override;
+    ::bosdyn::common::Status FinishData() override;
+
+ private:
+    void Unmap();
+
+    std::string m_path;
+    int m_fd = -1;
+    char* m_mapping = nullptr;
+    uint64_t m_mapping_size = 0;
+};
+#endif
+
+/**
+ * Check that a vector of data chunks agrees on its total size and that the chunk sizes add up to
+ * it.
+ *
+ * @param data_chunks Vector of data chunks to check.
+ *
+ * @return ::bosdyn::common::Status with any errors found.
+ */
+::bosdyn::common::Status ValidateDataChunks(
+    const std::vector<const ::bosdyn::api::DataChunk*>& data_chunks);
+
 /**
  * Create a std::string from a vector of data chunks.
  *
@@ -33,20 +335,24 @@ Result<std::string> StringFromDataChunks(
 /**
  * Create a message from deserializing concatenated data chunks.
  *
+ * The chunks are parsed in place rather than concatenated first. Protobuf reserves at most 50 MB
+ * for a string field it reads from a stream and grows it from there, so a larger bytes field can
+ * briefly take up to twice its size while it is read.
+ *
  * @param data_chunks Vector of chunks to concatenate and deserialize into a message.
  *
  * @return Result struct with std::shared_ptr with the deserialized message.
  */
 template <class T>
 Result<T> MessageFromDataChunks(const std::vector<const ::bosdyn::api::DataChunk*>& data_chunks) {
-    const Result<std::string>& result = StringFromDataChunks(data_chunks);
-    if (!result) {
-        return {result.status, {}};
+    ::bosdyn::common::Status status = ValidateDataChunks(data_chunks);
+    if (!status) {
+        return {status, {}};
     }
 
-    google::protobuf::io::ArrayInputStream array_input(result.response.data(),
-                                                       result.response.size());
-    google::protobuf::io::CodedInputStream coded_input(&array_input);
+    // Parse straight from the chunks instead of concatenating them first.
+    DataChunkInputStream chunk_input(data_chunks);
+    google::protobuf::io::CodedInputStream coded_input(&chunk_input);
     coded_input.SetRecursionLimit(500);
     T output;
     if (!output.ParseFromCodedStream(&coded_input)) {
@@ -62,30 +368,57 @@ Result<T> MessageFromDataChunks(const std::vector<const ::bosdyn::api::DataChunk
  *
  * @param data Input buffer to chunk into data chunks.
  * @param chunks Output argument with the vector of data chunks.
+ * @param chunk_size Maximum number of bytes in each data chunk.
  *
  * @return None, output from method is returned in chunks argument.
  */
-void StringToDataChunks(const std::string& data, std::vector<::bosdyn::api::DataChunk>* chunks);
+void StringToDataChunks(const std::string& data, std::vector<::bosdyn::api::DataChunk>* chunks,
+                        size_t chunk_size = kDefaultDataChunkSize);
 
 /**
  * Create a vector of data chunks from a templatized message.
  *
+ * The message is serialized directly into the data fields of the chunks, without an intermediate
+ * copy of the full serialized message.
+ *
  * NOTE: this is not using a Result return type for consistency with the StringToDataChunk method.
  *
- * @param message Message to be serialized and chunked into 4MB chunks.
+ * @param message Message to be serialized and chunked.
  * @param chunks Vector of chunks created from the serialized message.
+ * @param chunk_size Maximum number of bytes in each data chunk.
  *
  * @return ::bosdyn::common::Status with any errors found.
  */
 template <class T>
 ::bosdyn::common::Status MessageToDataChunks(const T& message,
-                                             std::vector<::bosdyn::api::DataChunk>* chunks) {
-    std::string buffer;
-    if (!message.SerializeToString(&buffer)) {
+                                             std::vector<::bosdyn::api::DataChunk>* chunks,
+                                             size_t chunk_size = kDefaultDataChunkSize) {
+    const size_t total_size = message.ByteSizeLong();
+    if (total_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
         return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
                                         "Could not serialize message");
     }
-    StringToDataChunks(buffer, chunks);
+    if (total_size == 0) {
+        // Keep sending a single empty chunk for empty messages.
+        StringToDataChunks(std::string(), chunks, chunk_size);
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+
+    chunks->reserve(chunks->size() + (total_size + chunk_size - 1) / chunk_size);
+    DataChunkOutputStream chunk_output(chunks, total_size, chunk_size);
+    {
+        google::protobuf::io::CodedOutputStream coded_output(&chunk_output);
+        // ByteSizeLong above cached the sizes of all submessages.
+        message.SerializeWithCachedSizes(&coded_output);
+        if (coded_output.HadError()) {
+            return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                            "Could not serialize message");
+        }
+    }
+    if (static_cast<size_t>(chunk_output.ByteCount()) != total_size) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Size mismatch in MessageToDataChunks");
+    }
     return ::bosdyn::common::Status(SDKErrorCode::Success);
 }
 
@@ -208,6 +208,12 @@ GetEstopSystemStatusResultType EstopClient::GetEstopStatus(const RPCParameters&
 
 std::shared_future<EstopCheckInResultType> EstopClient::EstopCheckInAsync(
     ::bosdyn::api::EstopCheckInRequest& request, const RPCParameters& parameters) {
+    return EstopCheckInAsync(request, parameters, nullptr);
+}
+
+std::shared_future<EstopCheckInResultType> EstopClient::EstopCheckInAsync(
+    ::bosdyn::api::EstopCheckInRequest& request, const RPCParameters& parameters,
+    EstopCheckInCallback on_complete) {
     std::promise<EstopCheckInResultType> response;
     std::shared_future<EstopCheckInResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -218,7 +224,8 @@ std::shared_future<EstopCheckInResultType> EstopClient::EstopCheckInAsync(
             request,
             std::bind(&::bosdyn::api::EstopService::StubInterface::AsyncEstopCheckIn, m_stub.get(),
                       _1, _2, _3),
-            std::bind(&EstopClient::OnEstopCheckInComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&EstopClient::OnEstopCheckInComplete, this, _1, _2, _3, _4, _5,
+                      std::move(on_complete)),
             std::move(response), parameters);
 
     return future;
@@ -228,12 +235,15 @@ void EstopClient::OnEstopCheckInComplete(MessagePumpCallBase* call,
                                          const ::bosdyn::api::EstopCheckInRequest& request,
                                          ::bosdyn::api::EstopCheckInResponse&& response,
                                          const grpc::Status& status,
-                                         std::promise<EstopCheckInResultType> promise) {
+                                         std::promise<EstopCheckInResultType> promise,
+                                         const EstopCheckInCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::EstopCheckInResponse>(status, response,
                                                                               response.status());
 
-    promise.set_value({ret_status, std::move(response)});
+    EstopCheckInResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 EstopCheckInResultType EstopClient::EstopCheckIn(::bosdyn::api::EstopCheckInRequest& request,
@@ -13,6 +13,7 @@
 #include <bosdyn/api/estop_service.grpc.pb.h>
 #include <bosdyn/api/estop_service.pb.h>
 
+#include <functional>
 #include <future>
 
 #include "bosdyn/client/estop/estop_error_codes.h"
@@ -28,6 +29,7 @@ typedef Result<::bosdyn::api::DeregisterEstopEndpointResponse> DeregisterEstopEn
 typedef Result<::bosdyn::api::GetEstopConfigResponse> GetEstopConfigResultType;
 typedef Result<::bosdyn::api::SetEstopConfigResponse> SetEstopConfigResultType;
 typedef Result<::bosdyn::api::EstopCheckInResponse> EstopCheckInResultType;
+typedef std::function<void(const EstopCheckInResultType&)> EstopCheckInCallback;
 typedef Result<::bosdyn::api::GetEstopSystemStatusResponse> GetEstopSystemStatusResultType;
 
 // EstopClient for using the E-Stop service.
@@ -88,6 +90,12 @@ class EstopClient : public ServiceClient {
         ::bosdyn::api::EstopCheckInRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<EstopCheckInResultType> EstopCheckInAsync(
+        ::bosdyn::api::EstopCheckInRequest& request, const RPCParameters& parameters,
+        EstopCheckInCallback on_complete);
+
     // Synchronous method to checkin with the E-Stop service of the robot.
     EstopCheckInResultType EstopCheckIn(::bosdyn::api::EstopCheckInRequest& request,
                                         const RPCParameters& parameters = RPCParameters());
@@ -143,7 +151,8 @@ class EstopClient : public ServiceClient {
                                 const ::bosdyn::api::EstopCheckInRequest& request,
                                 ::bosdyn::api::EstopCheckInResponse&& response,
                                 const grpc::Status& status,
-                                std::promise<EstopCheckInResultType> promise);
+                                std::promise<EstopCheckInResultType> promise,
+                                const EstopCheckInCallback& on_complete);
 
     std::unique_ptr<::bosdyn::api::EstopService::StubInterface> m_stub;
 
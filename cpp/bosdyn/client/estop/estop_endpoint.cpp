@@ -165,9 +165,24 @@ std::shared_future<DeregisterEstopEndpointResultType> EstopEndpoint::DeregisterA
 
 ::bosdyn::common::Status EstopEndpoint::CheckInAtLevel(
     const ::bosdyn::api::EstopStopLevel& stop_level, const RPCParameters& parameters) {
+    return FinishCheckIn(CheckInAtLevelAsync(stop_level, parameters).get());
+}
+
+std::shared_future<EstopCheckInResultType> EstopEndpoint::CheckInAtLevelAsync(
+    const ::bosdyn::api::EstopStopLevel& stop_level, const RPCParameters& parameters) {
+    return CheckInAtLevelAsync(stop_level, parameters, nullptr);
+}
+
+std::shared_future<EstopCheckInResultType> EstopEndpoint::CheckInAtLevelAsync(
+    const ::bosdyn::api::EstopStopLevel& stop_level, const RPCParameters& parameters,
+    EstopCheckInCallback on_complete) {
     ::bosdyn::api::EstopCheckInRequest request =
         ::bosdyn::client::MakeCheckInRequest(stop_level, this, m_challenge, this->GetResponse());
-    auto checkin_results = m_estop_client->EstopCheckIn(request, parameters);
+    return m_estop_client->EstopCheckInAsync(request, parameters, std::move(on_complete));
+}
+
+::bosdyn::common::Status EstopEndpoint::FinishCheckIn(
+    const EstopCheckInResultType& checkin_results) {
     // If first_checkin == true, then we want to suppress any estop response errors (specifically
     // the incorrect challenge response) and automatically set the challenge
     bool is_first_checkin = this->GetFirstCheckIn();
@@ -81,6 +81,21 @@ class EstopEndpoint {
     ::bosdyn::common::Status CheckInAtLevel(const ::bosdyn::api::EstopStopLevel& stop_level,
                                             const RPCParameters& parameters = RPCParameters());
 
+    // Async version for the CheckInAtLevel function. The result must be passed to FinishCheckIn,
+    // which updates the challenge for the next check-in as CheckInAtLevel does.
+    std::shared_future<EstopCheckInResultType> CheckInAtLevelAsync(
+        const ::bosdyn::api::EstopStopLevel& stop_level,
+        const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<EstopCheckInResultType> CheckInAtLevelAsync(
+        const ::bosdyn::api::EstopStopLevel& stop_level, const RPCParameters& parameters,
+        EstopCheckInCallback on_complete);
+
+    // Process the result of a check-in started with CheckInAtLevelAsync.
+    ::bosdyn::common::Status FinishCheckIn(const EstopCheckInResultType& checkin_results);
+
     // Issue a CUT stop level command to the robot, cutting motor power immediately.
     ::bosdyn::common::Status Stop();
 
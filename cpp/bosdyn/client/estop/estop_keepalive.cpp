@@ -19,7 +19,8 @@ namespace client {
 
 EstopKeepAlive::EstopKeepAlive(EstopEndpoint* estop_endpoint,
                                ::bosdyn::common::Duration rpc_timeout,
-                               ::bosdyn::common::Duration rpc_interval)
+                               ::bosdyn::common::Duration rpc_interval,
+                               std::shared_ptr<PeriodicScheduler> scheduler)
     : m_estop_endpoint(estop_endpoint), m_rpc_interval(rpc_interval) {
     if (rpc_timeout == std::chrono::seconds(0)) {
         m_rpc_parameters.timeout = m_estop_endpoint->GetEstopTimeout();
@@ -41,15 +42,21 @@ EstopKeepAlive::EstopKeepAlive(EstopEndpoint* estop_endpoint,
     if (!checkin_status) {
     }
 
-    // Start the keepalive thread, which will run the periodicCheckin unless
-    // the keep_running callback says otherwise.
-    m_keepalive_thread = std::thread(&EstopKeepAlive::PeriodicCheckIn, this);
+    // Start the keepalive task, which checks in every interval until it is stopped. A check-in
+    // still in flight after a full interval is reported as an error while it is waited on.
+    if (!scheduler) scheduler = PeriodicScheduler::GetDefault();
+    PeriodicTaskOptions options;
+    options.period = m_rpc_interval;
+    options.deadline = m_rpc_interval;
+    scheduler->Schedule([this](bool deadline_exceeded) { return CheckInStep(deadline_exceeded); },
+                        options, &m_keepalive_task);
 }
 
 EstopKeepAlive::~EstopKeepAlive() {
     m_thread_is_alive = false;
-    m_cv.notify_one();
-    m_keepalive_thread.join();
+    m_keepalive_task.Cancel();
+    // The endpoint and client complete the check-in in flight, if any, so wait for it.
+    m_checkin_rpc.Wait();
 }
 
 void EstopKeepAlive::UpdateStatus(EstopKeepAliveStatus status, const std::string& error_msg) {
@@ -66,17 +73,20 @@ void EstopKeepAlive::UpdateStatus(EstopKeepAliveStatus status, const std::string
 }
 
 void EstopKeepAlive::SetStopLevel(::bosdyn::api::EstopStopLevel desired_stop_level) {
-    std::lock_guard<std::mutex> lock(m_keepalive_mutex);
-    if (m_desired_stop_level == desired_stop_level) return;
+    {
+        std::lock_guard<std::mutex> lock(m_keepalive_mutex);
+        if (m_desired_stop_level == desired_stop_level) return;
+        m_desired_stop_level = desired_stop_level;
+    }
 
-    // Change the stop level and wake the background thread.
-    m_desired_stop_level = desired_stop_level;
-    m_cv.notify_one();
+    // Check in with the new stop level now. A check-in in flight is followed by another as soon as
+    // it completes.
+    m_keepalive_task.Trigger();
 }
 
 void EstopKeepAlive::StopKeepAliveThread(const std::string& error_msg) {
     m_thread_is_alive = false;
-    m_cv.notify_one();
+    m_keepalive_task.Cancel();
     this->UpdateStatus(EstopKeepAliveStatus::KEEPALIVE_DISABLED, error_msg);
 }
 
@@ -91,57 +101,66 @@ void EstopKeepAlive::SendOk() {
     this->UpdateStatus(EstopKeepAliveStatus::KEEPALIVE_OK);
 }
 
-void EstopKeepAlive::PeriodicCheckIn() {
-    while (this->m_thread_is_alive) {
-        // Include the time it takes to execute keep_running, in case it takes a significant
-        // portion of our check in period.
-        auto exec_start_ns = std::chrono::steady_clock::now().time_since_epoch();
-
-        // Attempt a check-in to the robot's estop-service.
-        ::bosdyn::common::Status checkin_status = this->CheckIn();
-        if (checkin_status.code() == ErrorTypeCondition::RPCError) {
-            // ::bosdyn::common::Status shows a GRPC related error.
-            std::string error_msg;
-            if (checkin_status.code() == RPCErrorCode::TimedOutError) {
-                error_msg = "RPC took longer than " +
-                            std::to_string(m_rpc_parameters.timeout.count()) + "[ms].";
-            } else {
-                error_msg =
-                    "Transport exception during check-in: " + std::to_string(checkin_status) +
-                    "\n (resuming check-in)";
-            }
-            this->SendError(error_msg);
-        } else if (checkin_status.code() == ErrorTypeCondition::SDKError &&
-                   !(checkin_status.code() == SDKErrorCode::Success)) {
-            // ::bosdyn::common::Status shows an SDK error.
+PeriodicTaskResult EstopKeepAlive::CheckInStep(bool deadline_exceeded) {
+    if (!m_thread_is_alive) return PeriodicTaskResult::kStop;
+    if (!m_checkin_rpc.InFlight()) {
+        // Attempt a check-in to the robot's estop-service. Its completion triggers the task.
+        std::lock_guard<std::mutex> lock(m_keepalive_mutex);
+        m_checkin_stop_level = m_desired_stop_level;
+        m_checkin_rpc.Start(&m_keepalive_task, [this](EstopCheckInCallback on_complete) {
+            return m_estop_endpoint->CheckInAtLevelAsync(m_checkin_stop_level, m_rpc_parameters,
+                                                         std::move(on_complete));
+        });
+    }
+    if (!m_checkin_rpc.Ready()) {
+        if (deadline_exceeded) {
+            const auto interval_ms =
+                std::chrono::duration_cast<std::chrono::milliseconds>(m_rpc_interval).count();
+            this->SendError("Check-in took longer than the check-in interval of " +
+                            std::to_string(interval_ms) + "[ms] (still waiting).");
+        }
+        return PeriodicTaskResult::kWaitForTrigger;
+    }
+
+    ::bosdyn::common::Status checkin_status = m_estop_endpoint->FinishCheckIn(m_checkin_rpc.Take());
+    HandleCheckInStatus(checkin_status);
+    if (!m_thread_is_alive) return PeriodicTaskResult::kStop;
+    // Send a stop level set while the check-in was in flight right away.
+    std::lock_guard<std::mutex> lock(m_keepalive_mutex);
+    return m_desired_stop_level != m_checkin_stop_level ? PeriodicTaskResult::kRetry
+                                                        : PeriodicTaskResult::kSuccess;
+}
+
+void EstopKeepAlive::HandleCheckInStatus(const ::bosdyn::common::Status& checkin_status) {
+    if (checkin_status.code() == ErrorTypeCondition::RPCError) {
+        // ::bosdyn::common::Status shows a GRPC related error.
+        std::string error_msg;
+        if (checkin_status.code() == RPCErrorCode::TimedOutError) {
+            error_msg = "RPC took longer than " +
+                        std::to_string(m_rpc_parameters.timeout.count()) + "[ms].";
+        } else {
+            error_msg = "Transport exception during check-in: " + std::to_string(checkin_status) +
+                        "\n (resuming check-in)";
+        }
+        this->SendError(error_msg);
+    } else if (checkin_status.code() == ErrorTypeCondition::SDKError &&
+               !(checkin_status.code() == SDKErrorCode::Success)) {
+        // ::bosdyn::common::Status shows an SDK error.
+        this->SendError(checkin_status.message());
+    } else if (checkin_status.code() ==
+               ::bosdyn::api::EstopCheckInResponse::STATUS_ENDPOINT_UNKNOWN) {
+        // E-Stop checkin responded that it does not know the endpoint for the check-in request.
+        // Disable the keep-alive in response.
+        this->SendError(checkin_status.message(), EstopKeepAliveStatus::KEEPALIVE_DISABLED);
+    } else {
+        if (!checkin_status) {
+            // Some other response error has occurred, but not one worthy of disabling the
+            // E-Stop keep-alive.
             this->SendError(checkin_status.message());
-        } else if (checkin_status.code() ==
-                   ::bosdyn::api::EstopCheckInResponse::STATUS_ENDPOINT_UNKNOWN) {
-            // E-Stop checkin responded that it does not know the endpoint for the check-in request.
-            // Disable the keep-alive in response.
-            this->SendError(checkin_status.message(), EstopKeepAliveStatus::KEEPALIVE_DISABLED);
         } else {
-            if (!checkin_status) {
-                // Some other response error has occurred, but not one worthy of disabling the
-                // E-Stop keep-alive.
-                this->SendError(checkin_status.message());
-            } else {
-                // No notable errors!
-                this->SendOk();
-            }
+            // No notable errors!
+            this->SendOk();
         }
-
-        // How long should the thread wait if it isn't stopped by an external application.
-        std::chrono::nanoseconds exec_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now().time_since_epoch() - exec_start_ns);
-        auto wait_time = this->m_rpc_interval - exec_ns;
-
-        // Block and wait for the stop signal. If we receive it within the check-in period,
-        // leave the loop. This check must be at the end of the loop!
-        // Wait for m_rpc_interval time minus the RPC processing time.
-        // (values < 0 are OK and will return immediately)
-        std::unique_lock<std::mutex> lock(this->m_keepalive_mutex);
-        this->m_cv.wait_for(lock, wait_time);
     }
 }
 
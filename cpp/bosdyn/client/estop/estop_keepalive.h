@@ -9,17 +9,19 @@
 
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include <bosdyn/api/estop.pb.h>
 
 #include "bosdyn/client/estop/estop_client.h"
 #include "bosdyn/client/estop/estop_endpoint.h"
+#include "bosdyn/client/util/periodic_scheduler.h"
 #include "bosdyn/common/status.h"
 
 namespace bosdyn {
@@ -31,16 +33,22 @@ enum EstopKeepAliveStatus { KEEPALIVE_OK, KEEPALIVE_ERROR, KEEPALIVE_DISABLED };
 // Wraps an EstopEndpoint to do periodic check-ins, keeping software E-Stop from timing out. This
 // is intended to be the common implementation of both periodic checking-in and one-time
 // check-ins.
+//
+// The periodic check-ins are a task of a PeriodicScheduler, shared by default with every other
+// keepalive in the process, rather than a thread per keepalive. The "keepalive thread" of the
+// methods below refers to that task.
 class EstopKeepAlive {
  public:
     // Constructor for the keepalive thread. This requires the E-Stop endpoint to do check-ins for.
     // Additionally, an rpc timeout seconds can be passed, but uses the endpoint's E-Stop timeout by
     // default. The rpc interval time can also be passed, but will use the (estop_timeout) / 3
-    // seconds if nothing is provided.
+    // seconds if nothing is provided. The check-ins run on the given scheduler, or on
+    // PeriodicScheduler::GetDefault() if none is provided.
     explicit EstopKeepAlive(
         EstopEndpoint* estop_endpoint,
         ::bosdyn::common::Duration rpc_timeout_seconds = std::chrono::seconds(0),
-        ::bosdyn::common::Duration rpc_interval_time = std::chrono::seconds(0));
+        ::bosdyn::common::Duration rpc_interval_time = std::chrono::seconds(0),
+        std::shared_ptr<PeriodicScheduler> scheduler = nullptr);
 
     // Destructor for the keepalive thread, to shutdown the thread nicely.
     ~EstopKeepAlive();
@@ -66,8 +74,8 @@ class EstopKeepAlive {
     // Adjust the stop level that is being sent.
     void SetStopLevel(::bosdyn::api::EstopStopLevel desired_stop_level);
 
-    // The main component of the keepalive class is std::thread, which is not copyable.
-    // Therefore, the keepalive class is also not movable or copyable.
+    // The scheduled task refers to the keepalive, so the keepalive class is not movable or
+    // copyable.
     EstopKeepAlive(const EstopKeepAlive&) = delete;
     EstopKeepAlive operator=(const EstopKeepAlive&) = delete;
 
@@ -75,15 +83,9 @@ class EstopKeepAlive {
     // The E-Stop endpoint to keepalive with periodic check-ins.
     EstopEndpoint* m_estop_endpoint;
 
-    // Keepalive thread.
-    std::thread m_keepalive_thread;
-
-    // Lock for the condition variable
+    // Lock for the stop level and the status.
     std::mutex m_keepalive_mutex;
 
-    // Condition Variable for checking if the thread should still be sleeping or be stopped.
-    std::condition_variable m_cv;
-
     // Boolean indicating it the thread is still running or if it has returned.
     std::atomic<bool> m_thread_is_alive = {true};
 
@@ -106,9 +108,18 @@ class EstopKeepAlive {
     // Check-in to maintain the desired E-Stop system level.
     ::bosdyn::common::Status CheckIn();
 
-    // Main loop for the keepalive thread, which will send E-Stop API CheckIn messages to robot
-    // E-Stop system in loop, then wait a fixed amount of time.
-    void PeriodicCheckIn();
+    // Step of the keepalive task, which starts an E-Stop API CheckIn to the robot E-Stop system,
+    // and is called again when it completes.
+    PeriodicTaskResult CheckInStep(bool deadline_exceeded);
+
+    // Update the status from the result of a periodic check-in.
+    void HandleCheckInStatus(const ::bosdyn::common::Status& checkin_status);
+
+    // The check-in in flight, if any, and the stop level it sends. Only used by CheckInStep, and by
+    // the destructor once the task is cancelled.
+    PeriodicTaskRpc<EstopCheckInResultType> m_checkin_rpc;
+    ::bosdyn::api::EstopStopLevel m_checkin_stop_level =
+        ::bosdyn::api::EstopStopLevel::ESTOP_LEVEL_NONE;
 
     // Add a new status to the status queue.
     void UpdateStatus(EstopKeepAliveStatus status, const std::string& error_msg = "");
@@ -119,6 +130,9 @@ class EstopKeepAlive {
 
     // Handle an OK check-in state.
     void SendOk();
+
+    // Keepalive task. Declared last, so it is cancelled before the members it uses are destroyed.
+    PeriodicTaskHandle m_keepalive_task;
 };
 
 }  // namespace client
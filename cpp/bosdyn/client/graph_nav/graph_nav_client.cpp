@@ -19,6 +19,57 @@ namespace bosdyn {
 
 namespace client {
 
+namespace {
+
+// Producer wrapping each chunk from the source in an upload request. Each request gets the body
+// lease applied as it is produced, instead of building every request up front.
+template <typename Request>
+std::function<::bosdyn::common::Status(Request*, bool*)> LeasedChunkProducer(
+    std::unique_ptr<DataChunkSource> source, std::shared_ptr<LeaseWallet> lease_wallet) {
+    std::shared_ptr<DataChunkSource> shared_source = std::move(source);
+    return [shared_source, lease_wallet](Request* request, bool* has_request) {
+        auto status = shared_source->NextChunk(request->mutable_chunk(), has_request);
+        if (!status || !*has_request) {
+            return status;
+        }
+        return ProcessRequestWithLease(request, lease_wallet.get(),
+                                       ::bosdyn::client::kBodyResource);
+    };
+}
+
+// Get the error of the request producer of a finished upload, such as a lease error or a failed
+// read of its source, so it is returned as is rather than as the ABORTED RPC error it caused.
+template <typename Request, typename Response>
+bool GetUploadProducerError(MessagePumpCallBase* call, ::bosdyn::common::Status* status) {
+    return static_cast<RequestStreamCall<Request, Response, Response>*>(call)->GetProducerError(
+        status);
+}
+
+typedef ResponseStreamCall<::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest,
+                           ::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse, uint64_t>
+    DownloadWaypointSnapshotToSinkCall;
+typedef ResponseStreamCall<::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest,
+                           ::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse, uint64_t>
+    DownloadEdgeSnapshotToSinkCall;
+
+// Complete a snapshot download into a sink once the stream has finished. An error of the response
+// sink, such as the status of a response, is returned as is rather than as an RPC error.
+template <typename Call>
+DownloadSnapshotToSinkResultType FinishDownloadToSink(const Call* call, const grpc::Status& status,
+                                                      DataChunkSink* sink) {
+    ::bosdyn::common::Status sink_error;
+    if (call->GetSinkError(&sink_error)) {
+        return {std::move(sink_error), sink->bytes_written()};
+    }
+    ::bosdyn::common::Status ret_status = ConvertGRPCStatus(status);
+    if (!ret_status) {
+        return {ret_status, sink->bytes_written()};
+    }
+    return {sink->Finish(), sink->bytes_written()};
+}
+
+}  // namespace
+
 const char* GraphNavClient::s_default_service_name = "graph-nav-service";
 
 const char* GraphNavClient::s_service_type = "bosdyn.api.graph_nav.GraphNavService";
@@ -419,48 +470,42 @@ void GraphNavClient::OnUploadGraphComplete(
 
 std::shared_future<UploadWaypointSnapshotResultType> GraphNavClient::UploadWaypointSnapshotAsync(
     ::bosdyn::api::graph_nav::WaypointSnapshot& input_request, const RPCParameters& parameters) {
-    std::promise<UploadWaypointSnapshotResultType> response;
-    std::shared_future<UploadWaypointSnapshotResultType> future = response.get_future();
-    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
-
     std::vector<::bosdyn::api::DataChunk> chunks;
-    std::vector<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest> requests;
-
     ::bosdyn::common::Status status =
         MessageToDataChunks<::bosdyn::api::graph_nav::WaypointSnapshot>(input_request, &chunks);
     if (!status) {
+        std::promise<UploadWaypointSnapshotResultType> response;
         response.set_value({status, {}});
-        return future;
+        return response.get_future();
     }
 
-    for (auto& chunk : chunks) {
-        ::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest request;
-
-        auto request_chunk = request.mutable_chunk();
-        *request_chunk = std::move(chunk);
+    return UploadWaypointSnapshotAsync(std::make_unique<VectorDataChunkSource>(std::move(chunks)),
+                                       parameters);
+}
 
-        // For each request, apply the lease processor to automatically include a lease.
-        auto lease_status = ProcessRequestWithLease(&request, m_lease_wallet.get(),
-                                                    ::bosdyn::client::kBodyResource);
-        if (!lease_status) {
-            // Failed to set a lease with the lease wallet. Return early since the request will fail
-            // without a lease.
-            response.set_value({lease_status, {}});
-            return future;
-        }
+std::shared_future<UploadWaypointSnapshotResultType> GraphNavClient::UploadWaypointSnapshotAsync(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters) {
+    return UploadWaypointSnapshotAsync(std::move(serialized_request), parameters, nullptr);
+}
 
-        requests.emplace_back(std::move(request));
-    }
+std::shared_future<UploadWaypointSnapshotResultType> GraphNavClient::UploadWaypointSnapshotAsync(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters,
+    UploadWaypointSnapshotCallback on_complete) {
+    std::promise<UploadWaypointSnapshotResultType> response;
+    std::shared_future<UploadWaypointSnapshotResultType> future = response.get_future();
+    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
 
-    MessagePumpCallBase* one_time = InitiateRequestStreamAsyncCall<
+    MessagePumpCallBase* one_time = InitiateRequestStreamAsyncCallWithProducer<
         ::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest,
         ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse,
         ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse>(
-        std::move(requests),
+        LeasedChunkProducer<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest>(
+            std::move(serialized_request), m_lease_wallet),
         std::bind(
             &::bosdyn::api::graph_nav::GraphNavService::StubInterface::AsyncUploadWaypointSnapshot,
             m_stub.get(), _1, _2, _3, _4),
-        std::bind(&GraphNavClient::OnUploadWaypointSnapshotComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&GraphNavClient::OnUploadWaypointSnapshotComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
 
     return future;
@@ -468,132 +513,145 @@ std::shared_future<UploadWaypointSnapshotResultType> GraphNavClient::UploadWaypo
 
 UploadWaypointSnapshotResultType GraphNavClient::UploadWaypointSnapshot(
     ::bosdyn::api::graph_nav::WaypointSnapshot& input_request, const RPCParameters& parameters) {
-    return UploadWaypointSnapshotAsync(input_request, parameters).get();
+    return UploadWaypointSnapshotAsync(std::make_unique<MessageDataChunkSource>(input_request),
+                                       parameters)
+        .get();
+}
+
+UploadWaypointSnapshotResultType GraphNavClient::UploadWaypointSnapshot(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters) {
+    return UploadWaypointSnapshotAsync(std::move(serialized_request), parameters).get();
 }
 
 void GraphNavClient::OnUploadWaypointSnapshotComplete(
     MessagePumpCallBase* call,
     const std::vector<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest>&& request,
     ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse&& response, const grpc::Status& status,
-    std::promise<UploadWaypointSnapshotResultType> promise) {
-    ::bosdyn::common::Status ret_status = ProcessResponseWithLeaseAndGetFinalStatus<
-        ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse>(
-        status, response, response.status(), m_lease_wallet.get());
+    std::promise<UploadWaypointSnapshotResultType> promise,
+    const UploadWaypointSnapshotCallback& on_complete) {
+    ::bosdyn::common::Status ret_status;
+    if (!GetUploadProducerError<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest,
+                                ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse>(
+            call, &ret_status)) {
+        ret_status = ProcessResponseWithLeaseAndGetFinalStatus<
+            ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse>(
+            status, response, response.status(), m_lease_wallet.get());
+    }
 
-    promise.set_value({ret_status, std::move(response)});
+    UploadWaypointSnapshotResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 std::shared_future<UploadEdgeSnapshotResultType> GraphNavClient::UploadEdgeSnapshotAsync(
     ::bosdyn::api::graph_nav::EdgeSnapshot& input_request, const RPCParameters& parameters) {
-    std::promise<UploadEdgeSnapshotResultType> response;
-    std::shared_future<UploadEdgeSnapshotResultType> future = response.get_future();
-    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
-
     std::vector<::bosdyn::api::DataChunk> chunks;
-    std::vector<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest> requests;
     ::bosdyn::common::Status status =
         MessageToDataChunks<::bosdyn::api::graph_nav::EdgeSnapshot>(input_request, &chunks);
     if (!status) {
+        std::promise<UploadEdgeSnapshotResultType> response;
         response.set_value({status, {}});
-        return future;
+        return response.get_future();
     }
 
-    for (auto& chunk : chunks) {
-        ::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest request;
-
-        auto request_chunk = request.mutable_chunk();
-        *request_chunk = std::move(chunk);
+    return UploadEdgeSnapshotAsync(std::make_unique<VectorDataChunkSource>(std::move(chunks)),
+                                   parameters);
+}
 
-        // For each request, apply the lease processor to automatically include a lease.
-        auto lease_status = ProcessRequestWithLease(&request, m_lease_wallet.get(),
-                                                    ::bosdyn::client::kBodyResource);
-        if (!lease_status) {
-            // Failed to set a lease with the lease wallet. Return early since the request will fail
-            // without a lease.
-            response.set_value({lease_status, {}});
-            return future;
-        }
+std::shared_future<UploadEdgeSnapshotResultType> GraphNavClient::UploadEdgeSnapshotAsync(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters) {
+    return UploadEdgeSnapshotAsync(std::move(serialized_request), parameters, nullptr);
+}
 
-        requests.emplace_back(std::move(request));
-    }
+std::shared_future<UploadEdgeSnapshotResultType> GraphNavClient::UploadEdgeSnapshotAsync(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters,
+    UploadEdgeSnapshotCallback on_complete) {
+    std::promise<UploadEdgeSnapshotResultType> response;
+    std::shared_future<UploadEdgeSnapshotResultType> future = response.get_future();
+    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
 
-    MessagePumpCallBase* one_time =
-        InitiateRequestStreamAsyncCall<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest,
-                                       ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse,
-                                       ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse>(
-            std::move(requests),
-            std::bind(
-                &::bosdyn::api::graph_nav::GraphNavService::StubInterface::AsyncUploadEdgeSnapshot,
-                m_stub.get(), _1, _2, _3, _4),
-            std::bind(&GraphNavClient::OnUploadEdgeSnapshotComplete, this, _1, _2, _3, _4, _5),
-            std::move(response), parameters);
+    MessagePumpCallBase* one_time = InitiateRequestStreamAsyncCallWithProducer<
+        ::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest,
+        ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse,
+        ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse>(
+        LeasedChunkProducer<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest>(
+            std::move(serialized_request), m_lease_wallet),
+        std::bind(
+            &::bosdyn::api::graph_nav::GraphNavService::StubInterface::AsyncUploadEdgeSnapshot,
+            m_stub.get(), _1, _2, _3, _4),
+        std::bind(&GraphNavClient::OnUploadEdgeSnapshotComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
+        std::move(response), parameters);
 
     return future;
 }
 
 UploadEdgeSnapshotResultType GraphNavClient::UploadEdgeSnapshot(
     ::bosdyn::api::graph_nav::EdgeSnapshot& input_request, const RPCParameters& parameters) {
-    return UploadEdgeSnapshotAsync(input_request, parameters).get();
+    return UploadEdgeSnapshotAsync(std::make_unique<MessageDataChunkSource>(input_request),
+                                   parameters)
+        .get();
+}
+
+UploadEdgeSnapshotResultType GraphNavClient::UploadEdgeSnapshot(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters) {
+    return UploadEdgeSnapshotAsync(std::move(serialized_request), parameters).get();
 }
 
 void GraphNavClient::OnUploadEdgeSnapshotComplete(
     MessagePumpCallBase* call,
     const std::vector<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest>&& request,
     ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse&& response, const grpc::Status& status,
-    std::promise<UploadEdgeSnapshotResultType> promise) {
-    ::bosdyn::common::Status ret_status = ProcessResponseWithLeaseAndGetFinalStatus<
-        ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse>(
-        status, response, SDKErrorCode::Success, m_lease_wallet.get());
+    std::promise<UploadEdgeSnapshotResultType> promise,
+    const UploadEdgeSnapshotCallback& on_complete) {
+    ::bosdyn::common::Status ret_status;
+    if (!GetUploadProducerError<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest,
+                                ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse>(
+            call, &ret_status)) {
+        ret_status = ProcessResponseWithLeaseAndGetFinalStatus<
+            ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse>(
+            status, response, SDKErrorCode::Success, m_lease_wallet.get());
+    }
 
-    promise.set_value({ret_status, std::move(response)});
+    UploadEdgeSnapshotResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 std::shared_future<UploadSnapshotsResultType> GraphNavClient::UploadSnapshotsAsync(
     ::bosdyn::api::graph_nav::UploadSnapshotsRequest::Snapshots& input_request,
     const RPCParameters& parameters) {
-    std::promise<UploadSnapshotsResultType> response;
-    std::shared_future<UploadSnapshotsResultType> future = response.get_future();
-    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
-
     std::vector<::bosdyn::api::DataChunk> chunks;
-    std::vector<::bosdyn::api::graph_nav::UploadSnapshotsRequest> requests;
     ::bosdyn::common::Status status =
         MessageToDataChunks<::bosdyn::api::graph_nav::UploadSnapshotsRequest::Snapshots>(
             input_request, &chunks);
     if (!status) {
+        std::promise<UploadSnapshotsResultType> response;
         response.set_value({status, {}});
-        return future;
+        return response.get_future();
     }
 
-    for (auto& chunk : chunks) {
-        ::bosdyn::api::graph_nav::UploadSnapshotsRequest request;
-
-        auto request_chunk = request.mutable_chunk();
-        *request_chunk = std::move(chunk);
-
-        // For each request, apply the lease processor to automatically include a lease.
-        auto lease_status = ProcessRequestWithLease(&request, m_lease_wallet.get(),
-                                                    ::bosdyn::client::kBodyResource);
-        if (!lease_status) {
-            // Failed to set a lease with the lease wallet. Return early since the request will fail
-            // without a lease.
-            response.set_value({lease_status, {}});
-            return future;
-        }
+    return UploadSnapshotsAsync(std::make_unique<VectorDataChunkSource>(std::move(chunks)),
+                                parameters);
+}
 
-        requests.emplace_back(std::move(request));
-    }
+std::shared_future<UploadSnapshotsResultType> GraphNavClient::UploadSnapshotsAsync(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters) {
+    std::promise<UploadSnapshotsResultType> response;
+    std::shared_future<UploadSnapshotsResultType> future = response.get_future();
+    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
 
-    MessagePumpCallBase* one_time =
-        InitiateRequestStreamAsyncCall<::bosdyn::api::graph_nav::UploadSnapshotsRequest,
-                                       ::bosdyn::api::graph_nav::UploadSnapshotsResponse,
-                                       ::bosdyn::api::graph_nav::UploadSnapshotsResponse>(
-            std::move(requests),
-            std::bind(
-                &::bosdyn::api::graph_nav::GraphNavService::StubInterface::AsyncUploadSnapshots,
-                m_stub.get(), _1, _2, _3, _4),
-            std::bind(&GraphNavClient::OnUploadSnapshotsComplete, this, _1, _2, _3, _4, _5),
-            std::move(response), parameters);
+    MessagePumpCallBase* one_time = InitiateRequestStreamAsyncCallWithProducer<
+        ::bosdyn::api::graph_nav::UploadSnapshotsRequest,
+        ::bosdyn::api::graph_nav::UploadSnapshotsResponse,
+        ::bosdyn::api::graph_nav::UploadSnapshotsResponse>(
+        LeasedChunkProducer<::bosdyn::api::graph_nav::UploadSnapshotsRequest>(
+            std::move(serialized_request), m_lease_wallet),
+        std::bind(
+            &::bosdyn::api::graph_nav::GraphNavService::StubInterface::AsyncUploadSnapshots,
+            m_stub.get(), _1, _2, _3, _4),
+        std::bind(&GraphNavClient::OnUploadSnapshotsComplete, this, _1, _2, _3, _4, _5),
+        std::move(response), parameters);
 
     return future;
 }
@@ -601,7 +659,13 @@ std::shared_future<UploadSnapshotsResultType> GraphNavClient::UploadSnapshotsAsy
 UploadSnapshotsResultType GraphNavClient::UploadSnapshots(
     ::bosdyn::api::graph_nav::UploadSnapshotsRequest::Snapshots& input_request,
     const RPCParameters& parameters) {
-    return UploadSnapshotsAsync(input_request, parameters).get();
+    return UploadSnapshotsAsync(std::make_unique<MessageDataChunkSource>(input_request), parameters)
+        .get();
+}
+
+UploadSnapshotsResultType GraphNavClient::UploadSnapshots(
+    std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters) {
+    return UploadSnapshotsAsync(std::move(serialized_request), parameters).get();
 }
 
 void GraphNavClient::OnUploadSnapshotsComplete(
@@ -609,9 +673,14 @@ void GraphNavClient::OnUploadSnapshotsComplete(
     const std::vector<::bosdyn::api::graph_nav::UploadSnapshotsRequest>&& request,
     ::bosdyn::api::graph_nav::UploadSnapshotsResponse&& response, const grpc::Status& status,
     std::promise<UploadSnapshotsResultType> promise) {
-    ::bosdyn::common::Status ret_status = ProcessResponseWithLeaseAndGetFinalStatus<
-        ::bosdyn::api::graph_nav::UploadSnapshotsResponse>(status, response, SDKErrorCode::Success,
-                                                           m_lease_wallet.get());
+    ::bosdyn::common::Status ret_status;
+    if (!GetUploadProducerError<::bosdyn::api::graph_nav::UploadSnapshotsRequest,
+                                ::bosdyn::api::graph_nav::UploadSnapshotsResponse>(
+            call, &ret_status)) {
+        ret_status = ProcessResponseWithLeaseAndGetFinalStatus<
+            ::bosdyn::api::graph_nav::UploadSnapshotsResponse>(
+            status, response, SDKErrorCode::Success, m_lease_wallet.get());
+    }
 
     promise.set_value({ret_status, std::move(response)});
 }
@@ -645,6 +714,72 @@ DownloadWaypointSnapshotResultType GraphNavClient::DownloadWaypointSnapshot(
     return DownloadWaypointSnapshotAsync(request, parameters).get();
 }
 
+std::shared_future<DownloadSnapshotToSinkResultType> GraphNavClient::DownloadWaypointSnapshotAsync(
+    ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters) {
+    return DownloadWaypointSnapshotAsync(request, std::move(sink), parameters, nullptr);
+}
+
+std::shared_future<DownloadSnapshotToSinkResultType> GraphNavClient::DownloadWaypointSnapshotAsync(
+    ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+    DownloadSnapshotToSinkCallback on_complete) {
+    std::promise<DownloadSnapshotToSinkResultType> response;
+    std::shared_future<DownloadSnapshotToSinkResultType> future = response.get_future();
+    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
+    BOSDYN_ASSERT_PRECONDITION(sink != nullptr, "Data chunk sink cannot be null.");
+
+    // Each response is processed and its chunk reassembled as soon as it arrives.
+    std::string waypoint_snapshot_id;
+    bool first_response = true;
+    auto response_sink = [this, sink, waypoint_snapshot_id, first_response](
+                             ::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse&&
+                                 snapshot_response) mutable {
+        ::bosdyn::common::Status ret_status = ProcessStreamedResponseAndGetFinalStatus<
+            ::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse>(snapshot_response);
+        if (!ret_status) {
+            return ret_status;
+        }
+        if (first_response) {
+            waypoint_snapshot_id = snapshot_response.waypoint_snapshot_id();
+            first_response = false;
+        } else if (snapshot_response.waypoint_snapshot_id() != waypoint_snapshot_id) {
+            return ::bosdyn::common::Status(
+                SDKErrorCode::GenericSDKError,
+                "Multiple waypoint IDs in DownloadWaypointSnapshotResponse stream received");
+        }
+        return sink->AddChunk(snapshot_response.chunk());
+    };
+
+    MessagePumpCallBase* one_time = InitiateResponseStreamAsyncCallWithSink<
+        ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest,
+        ::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse, uint64_t>(
+        request,
+        std::bind(&::bosdyn::api::graph_nav::GraphNavService::StubInterface::
+                      AsyncDownloadWaypointSnapshot,
+                  m_stub.get(), _1, _2, _3, _4),
+        response_sink,
+        [sink, on_complete = std::move(on_complete)](
+            DownloadWaypointSnapshotToSinkCall* call,
+            const ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+            std::vector<::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse>&& responses,
+            const grpc::Status& status, std::promise<DownloadSnapshotToSinkResultType> promise) {
+            DownloadSnapshotToSinkResultType result =
+                FinishDownloadToSink(call, status, sink.get());
+            if (on_complete) on_complete(result);
+            promise.set_value(std::move(result));
+        },
+        std::move(response), parameters);
+
+    return future;
+}
+
+DownloadSnapshotToSinkResultType GraphNavClient::DownloadWaypointSnapshot(
+    ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters) {
+    return DownloadWaypointSnapshotAsync(request, std::move(sink), parameters).get();
+}
+
 void GraphNavClient::OnDownloadWaypointSnapshotComplete(
     MessagePumpCallBase* call,
     const ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
@@ -712,6 +847,72 @@ DownloadEdgeSnapshotResultType GraphNavClient::DownloadEdgeSnapshot(
     return DownloadEdgeSnapshotAsync(request, parameters).get();
 }
 
+std::shared_future<DownloadSnapshotToSinkResultType> GraphNavClient::DownloadEdgeSnapshotAsync(
+    ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters) {
+    return DownloadEdgeSnapshotAsync(request, std::move(sink), parameters, nullptr);
+}
+
+std::shared_future<DownloadSnapshotToSinkResultType> GraphNavClient::DownloadEdgeSnapshotAsync(
+    ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+    DownloadSnapshotToSinkCallback on_complete) {
+    std::promise<DownloadSnapshotToSinkResultType> response;
+    std::shared_future<DownloadSnapshotToSinkResultType> future = response.get_future();
+    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
+    BOSDYN_ASSERT_PRECONDITION(sink != nullptr, "Data chunk sink cannot be null.");
+
+    // Each response is processed and its chunk reassembled as soon as it arrives.
+    std::string edge_snapshot_id;
+    bool first_response = true;
+    auto response_sink = [this, sink, edge_snapshot_id, first_response](
+                             ::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse&&
+                                 snapshot_response) mutable {
+        ::bosdyn::common::Status ret_status = ProcessStreamedResponseAndGetFinalStatus<
+            ::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse>(snapshot_response);
+        if (!ret_status) {
+            return ret_status;
+        }
+        if (first_response) {
+            edge_snapshot_id = snapshot_response.edge_snapshot_id();
+            first_response = false;
+        } else if (snapshot_response.edge_snapshot_id() != edge_snapshot_id) {
+            return ::bosdyn::common::Status(
+                SDKErrorCode::GenericSDKError,
+                "Multiple edge IDs in DownloadEdgeSnapshotResponse stream received");
+        }
+        return sink->AddChunk(snapshot_response.chunk());
+    };
+
+    MessagePumpCallBase* one_time = InitiateResponseStreamAsyncCallWithSink<
+        ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest,
+        ::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse, uint64_t>(
+        request,
+        std::bind(
+            &::bosdyn::api::graph_nav::GraphNavService::StubInterface::AsyncDownloadEdgeSnapshot,
+            m_stub.get(), _1, _2, _3, _4),
+        response_sink,
+        [sink, on_complete = std::move(on_complete)](
+            DownloadEdgeSnapshotToSinkCall* call,
+            const ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+            std::vector<::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse>&& responses,
+            const grpc::Status& status, std::promise<DownloadSnapshotToSinkResultType> promise) {
+            DownloadSnapshotToSinkResultType result =
+                FinishDownloadToSink(call, status, sink.get());
+            if (on_complete) on_complete(result);
+            promise.set_value(std::move(result));
+        },
+        std::move(response), parameters);
+
+    return future;
+}
+
+DownloadSnapshotToSinkResultType GraphNavClient::DownloadEdgeSnapshot(
+    ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters) {
+    return DownloadEdgeSnapshotAsync(request, std::move(sink), parameters).get();
+}
+
 void GraphNavClient::OnDownloadEdgeSnapshotComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
     std::vector<::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse>&& responses,
@@ -786,9 +987,13 @@ void GraphNavClient::OnUploadGraphStreamingComplete(
     const std::vector<::bosdyn::api::graph_nav::UploadGraphStreamingRequest>&& request,
     ::bosdyn::api::graph_nav::UploadGraphResponse&& response, const grpc::Status& status,
     std::promise<UploadGraphResultType> promise) {
-    ::bosdyn::common::Status ret_status =
-        ProcessResponseAndGetFinalStatus<::bosdyn::api::graph_nav::UploadGraphResponse>(
-            status, response, response.status());
+    ::bosdyn::common::Status ret_status;
+    if (!GetUploadProducerError<::bosdyn::api::graph_nav::UploadGraphStreamingRequest,
+                                ::bosdyn::api::graph_nav::UploadGraphResponse>(call, &ret_status)) {
+        ret_status =
+            ProcessResponseAndGetFinalStatus<::bosdyn::api::graph_nav::UploadGraphResponse>(
+                status, response, response.status());
+    }
 
     promise.set_value({ret_status, std::move(response)});
 }
@@ -63,6 +63,16 @@ typedef Result<::bosdyn::api::graph_nav::WaypointSnapshot> DownloadWaypointSnaps
 // Return type for the DownloadEdgeSnapshot method.
 typedef Result<::bosdyn::api::graph_nav::EdgeSnapshot> DownloadEdgeSnapshotResultType;
 
+// Return type for the DownloadWaypointSnapshot and DownloadEdgeSnapshot methods that reassemble
+// the snapshot into a DataChunkSink. The response is the number of bytes received.
+typedef Result<uint64_t> DownloadSnapshotToSinkResultType;
+
+// Called with the result of a snapshot upload or download as soon as it completes.
+typedef std::function<void(const UploadWaypointSnapshotResultType&)> UploadWaypointSnapshotCallback;
+typedef std::function<void(const UploadEdgeSnapshotResultType&)> UploadEdgeSnapshotCallback;
+typedef std::function<void(const DownloadSnapshotToSinkResultType&)>
+    DownloadSnapshotToSinkCallback;
+
 
 class GraphNavClient : public ServiceClient {
  public:
@@ -160,36 +170,89 @@ class GraphNavClient : public ServiceClient {
         ::bosdyn::api::graph_nav::UploadGraphRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
-    // Asynchronous method to execute a UploadWaypointSnapshot request.
+    // Asynchronous method to execute a UploadWaypointSnapshot request. The snapshot is serialized
+    // into chunks before this returns, so the caller may change or destroy it right away, but a
+    // full serialized copy is held until the upload is done.
     std::shared_future<UploadWaypointSnapshotResultType> UploadWaypointSnapshotAsync(
         ::bosdyn::api::graph_nav::WaypointSnapshot& request,
         const RPCParameters& parameters = RPCParameters());
 
-    // Synchronous method to execute a UploadWaypointSnapshot request.
+    // Synchronous method to execute a UploadWaypointSnapshot request. The snapshot is serialized
+    // as the stream is ready to send it, without a full serialized copy.
     UploadWaypointSnapshotResultType UploadWaypointSnapshot(
         ::bosdyn::api::graph_nav::WaypointSnapshot& request,
         const RPCParameters& parameters = RPCParameters());
 
-    // Asynchronous method to execute a UploadEdgeSnapshot request.
+    // Asynchronous method to execute a UploadWaypointSnapshot request from an already serialized
+    // WaypointSnapshot, for example one read from disk with IstreamDataChunkSource. Chunks are read
+    // from the source only as the stream is ready to send them.
+    std::shared_future<UploadWaypointSnapshotResultType> UploadWaypointSnapshotAsync(
+        std::unique_ptr<DataChunkSource> serialized_request,
+        const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<UploadWaypointSnapshotResultType> UploadWaypointSnapshotAsync(
+        std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters,
+        UploadWaypointSnapshotCallback on_complete);
+
+    // Synchronous method to execute a UploadWaypointSnapshot request from a serialized message.
+    UploadWaypointSnapshotResultType UploadWaypointSnapshot(
+        std::unique_ptr<DataChunkSource> serialized_request,
+        const RPCParameters& parameters = RPCParameters());
+
+    // Asynchronous method to execute a UploadEdgeSnapshot request. As for waypoint snapshots, a
+    // full serialized copy is made before this returns.
     std::shared_future<UploadEdgeSnapshotResultType> UploadEdgeSnapshotAsync(
         ::bosdyn::api::graph_nav::EdgeSnapshot& request,
         const RPCParameters& parameters = RPCParameters());
 
-    // Synchronous method to execute a UploadEdgeSnapshot request.
+    // Synchronous method to execute a UploadEdgeSnapshot request, serialized as it is sent.
     UploadEdgeSnapshotResultType UploadEdgeSnapshot(
         ::bosdyn::api::graph_nav::EdgeSnapshot& request,
         const RPCParameters& parameters = RPCParameters());
 
-    // Asynchronous method to execute a UploadSnapshots request.
+    // Asynchronous method to execute a UploadEdgeSnapshot request from an already serialized
+    // EdgeSnapshot, for example one read from disk with IstreamDataChunkSource. Chunks are read
+    // from the source only as the stream is ready to send them.
+    std::shared_future<UploadEdgeSnapshotResultType> UploadEdgeSnapshotAsync(
+        std::unique_ptr<DataChunkSource> serialized_request,
+        const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<UploadEdgeSnapshotResultType> UploadEdgeSnapshotAsync(
+        std::unique_ptr<DataChunkSource> serialized_request, const RPCParameters& parameters,
+        UploadEdgeSnapshotCallback on_complete);
+
+    // Synchronous method to execute a UploadEdgeSnapshot request from a serialized message.
+    UploadEdgeSnapshotResultType UploadEdgeSnapshot(
+        std::unique_ptr<DataChunkSource> serialized_request,
+        const RPCParameters& parameters = RPCParameters());
+
+    // Asynchronous method to execute a UploadSnapshots request. As for waypoint snapshots, a full
+    // serialized copy is made before this returns.
     std::shared_future<UploadSnapshotsResultType> UploadSnapshotsAsync(
         ::bosdyn::api::graph_nav::UploadSnapshotsRequest::Snapshots& request,
         const RPCParameters& parameters = RPCParameters());
 
-    // Synchronous method to execute a UploadSnapshots request.
+    // Synchronous method to execute a UploadSnapshots request, serialized as it is sent.
     UploadSnapshotsResultType UploadSnapshots(
         ::bosdyn::api::graph_nav::UploadSnapshotsRequest::Snapshots& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // Asynchronous method to execute a UploadSnapshots request from an already serialized
+    // Snapshots message, for example one read from disk with IstreamDataChunkSource. Chunks are
+    // read from the source only as the stream is ready to send them.
+    std::shared_future<UploadSnapshotsResultType> UploadSnapshotsAsync(
+        std::unique_ptr<DataChunkSource> serialized_request,
+        const RPCParameters& parameters = RPCParameters());
+
+    // Synchronous method to execute a UploadSnapshots request from a serialized message.
+    UploadSnapshotsResultType UploadSnapshots(
+        std::unique_ptr<DataChunkSource> serialized_request,
+        const RPCParameters& parameters = RPCParameters());
+
     // Asynchronous method to execute a DownloadWaypointSnapshot request. Only one response
     // message is returned with all the data chunks received from the service concatenated
     // together.
@@ -204,6 +267,26 @@ class GraphNavClient : public ServiceClient {
         ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // Asynchronous method to execute a DownloadWaypointSnapshot request that hands each data
+    // chunk to the sink as soon as it arrives, for example to write the serialized snapshot to a
+    // file. Only one chunk is held in memory at a time. Finish is called on the sink once the
+    // stream completes successfully.
+    std::shared_future<DownloadSnapshotToSinkResultType> DownloadWaypointSnapshotAsync(
+        ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<DownloadSnapshotToSinkResultType> DownloadWaypointSnapshotAsync(
+        ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+        DownloadSnapshotToSinkCallback on_complete);
+
+    // Synchronous method to execute a DownloadWaypointSnapshot request into a DataChunkSink.
+    DownloadSnapshotToSinkResultType DownloadWaypointSnapshot(
+        ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters = RPCParameters());
+
     // Asynchronous method to execute a DownloadEdgeSnapshot request. Only one response
     // message is returned with all the data chunks received from the service concatenated
     // together.
@@ -218,6 +301,25 @@ class GraphNavClient : public ServiceClient {
         ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // Asynchronous method to execute a DownloadEdgeSnapshot request that hands each data chunk to
+    // the sink as soon as it arrives. Finish is called on the sink once the stream completes
+    // successfully.
+    std::shared_future<DownloadSnapshotToSinkResultType> DownloadEdgeSnapshotAsync(
+        ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<DownloadSnapshotToSinkResultType> DownloadEdgeSnapshotAsync(
+        ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+        DownloadSnapshotToSinkCallback on_complete);
+
+    // Synchronous method to execute a DownloadEdgeSnapshot request into a DataChunkSink.
+    DownloadSnapshotToSinkResultType DownloadEdgeSnapshot(
+        ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters = RPCParameters());
+
     // Convenience methods to download an edge snapshot with just an id.
     std::shared_future<DownloadEdgeSnapshotResultType> DownloadEdgeSnapshotAsync(
         const std::string& edge_snapshot_id, const RPCParameters& parameters = RPCParameters()) {
@@ -338,7 +440,8 @@ class GraphNavClient : public ServiceClient {
         MessagePumpCallBase* call,
         const std::vector<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest>&& request,
         ::bosdyn::api::graph_nav::UploadWaypointSnapshotResponse&& response,
-        const grpc::Status& status, std::promise<UploadWaypointSnapshotResultType> promise);
+        const grpc::Status& status, std::promise<UploadWaypointSnapshotResultType> promise,
+        const UploadWaypointSnapshotCallback& on_complete);
 
     // Callback that will return the UploadEdgeSnapshotResponse message after UploadEdgeSnapshot rpc
     // returns to the client.
@@ -346,7 +449,8 @@ class GraphNavClient : public ServiceClient {
         MessagePumpCallBase* call,
         const std::vector<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest>&& request,
         ::bosdyn::api::graph_nav::UploadEdgeSnapshotResponse&& response, const grpc::Status& status,
-        std::promise<UploadEdgeSnapshotResultType> promise);
+        std::promise<UploadEdgeSnapshotResultType> promise,
+        const UploadEdgeSnapshotCallback& on_complete);
 
     // Callback that will return the UploadSnapshotsResponse message after UploadSnapshots rpc
     // returns to the client.
@@ -0,0 +1,338 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/graph_nav/map_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "bosdyn/bddf/sha1.h"
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/common/mission_filesystem.h"
+#include "bosdyn/common/proto_file.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace fs = std::filesystem;
+
+const char* const MapCache::kIndexFile = "snapshot_index";
+
+namespace {
+
+constexpr char kTempSuffix[] = ".tmp";
+constexpr size_t kHashBlockSize = 1 << 20;
+
+::bosdyn::common::Status CacheError(const std::string& message) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError, "Map cache: " + message);
+}
+
+::bosdyn::common::Status Success() { return ::bosdyn::common::Status(SDKErrorCode::Success); }
+
+std::string HexDigest(const bddf::Sha1::Digest& digest) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    std::string hex(2 * digest.size(), '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kHexDigits[digest[i] >> 4];
+        hex[2 * i + 1] = kHexDigits[digest[i] & 0xf];
+    }
+    return hex;
+}
+
+::bosdyn::common::Status HashFile(const std::string& path, MapCache::SnapshotEntry* entry) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) return CacheError("could not open " + path + ".");
+    std::vector<char> buffer(kHashBlockSize);
+    bddf::Sha1 sha1;
+    entry->num_bytes = 0;
+    while (input) {
+        input.read(buffer.data(), buffer.size());
+        const size_t num_read = static_cast<size_t>(input.gcount());
+        sha1.Update(buffer.data(), num_read);
+        entry->num_bytes += num_read;
+    }
+    if (input.bad()) return CacheError("could not read " + path + ".");
+    entry->content_hash = HexDigest(sha1.Final());
+    return Success();
+}
+
+// Write data to a temporary file next to path, and rename it over path once it is complete, so a
+// reader never sees a partial file.
+::bosdyn::common::Status WriteFileAtomically(const std::string& path, const std::string& data) {
+    const std::string temp_path = path + kTempSuffix;
+    {
+        std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!output.flush()) return CacheError("could not write " + temp_path + ".");
+    }
+    std::error_code error;
+    fs::rename(temp_path, path, error);
+    if (error) return CacheError("could not rename " + temp_path + ": " + error.message());
+    return Success();
+}
+
+char TypeTag(MapCache::SnapshotType type) {
+    return type == MapCache::SnapshotType::kWaypoint ? 'w' : 'e';
+}
+
+}  // namespace
+
+bool MapCache::IsValidId(const std::string& snapshot_id) {
+    // Ids are used as file names in the snapshot directories.
+    return !snapshot_id.empty() && snapshot_id != "." && snapshot_id != ".." &&
+           snapshot_id.find_first_of("/\\") == std::string::npos;
+}
+
+std::string MapCache::SnapshotDirectory(SnapshotType type) const {
+    const std::string& directory = type == SnapshotType::kWaypoint
+                                       ? ::bosdyn::common::kWaypointSnapshotDir
+                                       : ::bosdyn::common::kEdgeSnapshotDir;
+    return (fs::path(m_root) / directory).string();
+}
+
+std::string MapCache::SnapshotPath(SnapshotType type, const std::string& snapshot_id) const {
+    return (fs::path(SnapshotDirectory(type)) / snapshot_id).string();
+}
+
+std::string MapCache::GraphPath() const {
+    return (fs::path(m_root) / ::bosdyn::common::kGraphFile).string();
+}
+
+::bosdyn::common::Status MapCache::Open(const std::string& root_directory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_root = root_directory;
+    for (EntryMap& entries : m_entries) entries.clear();
+
+    for (SnapshotType type : {SnapshotType::kWaypoint, SnapshotType::kEdge}) {
+        std::error_code error;
+        fs::create_directories(SnapshotDirectory(type), error);
+        if (error) return CacheError("could not create " + SnapshotDirectory(type) + ".");
+    }
+
+    // Later lines of the index replace earlier ones for the same snapshot.
+    std::ifstream index((fs::path(m_root) / kIndexFile).string());
+    std::string line;
+    while (std::getline(index, line)) {
+        std::istringstream fields(line);
+        char tag = 0;
+        SnapshotEntry entry;
+        std::string snapshot_id;
+        if (!(fields >> tag >> entry.content_hash >> entry.num_bytes >> snapshot_id)) continue;
+        if (tag != 'w' && tag != 'e') continue;
+        const SnapshotType type = tag == 'w' ? SnapshotType::kWaypoint : SnapshotType::kEdge;
+        m_entries[static_cast<int>(type)][snapshot_id] = std::move(entry);
+    }
+
+    // Check the index against the files, and hash the files it does not describe.
+    for (SnapshotType type : {SnapshotType::kWaypoint, SnapshotType::kEdge}) {
+        EntryMap& entries = m_entries[static_cast<int>(type)];
+        EntryMap checked;
+        std::error_code error;
+        for (const auto& file : fs::directory_iterator(SnapshotDirectory(type), error)) {
+            const std::string snapshot_id = file.path().filename().string();
+            std::error_code file_error;
+            if (!file.is_regular_file(file_error) || !IsValidId(snapshot_id)) continue;
+            if (file.path().extension() == kTempSuffix) {
+                // Left behind by a store or a download that was interrupted.
+                fs::remove(file.path(), file_error);
+                continue;
+            }
+            const uint64_t num_bytes = file.file_size(file_error);
+            if (file_error) continue;
+            auto it = entries.find(snapshot_id);
+            if (it != entries.end() && it->second.num_bytes == num_bytes) {
+                checked.emplace(snapshot_id, std::move(it->second));
+                continue;
+            }
+            SnapshotEntry entry;
+            STATUS_OK_ELSE_RETURN(HashFile(file.path().string(), &entry));
+            checked.emplace(snapshot_id, std::move(entry));
+        }
+        if (error) return CacheError("could not list " + SnapshotDirectory(type) + ".");
+        entries.swap(checked);
+    }
+    return RewriteIndex();
+}
+
+::bosdyn::common::Status MapCache::RewriteIndex() {
+    std::ostringstream index;
+    for (SnapshotType type : {SnapshotType::kWaypoint, SnapshotType::kEdge}) {
+        for (const auto& id_and_entry : m_entries[static_cast<int>(type)]) {
+            index << TypeTag(type) << ' ' << id_and_entry.second.content_hash << ' '
+                  << id_and_entry.second.num_bytes << ' ' << id_and_entry.first << '\n';
+        }
+    }
+    return WriteFileAtomically((fs::path(m_root) / kIndexFile).string(), index.str());
+}
+
+::bosdyn::common::Status MapCache::RecordEntry(SnapshotType type, const std::string& snapshot_id,
+                                               const SnapshotEntry& entry) {
+    m_entries[static_cast<int>(type)][snapshot_id] = entry;
+    std::ofstream index((fs::path(m_root) / kIndexFile).string(), std::ios::app);
+    index << TypeTag(type) << ' ' << entry.content_hash << ' ' << entry.num_bytes << ' '
+          << snapshot_id << '\n';
+    if (!index.flush()) return CacheError("could not append to the index.");
+    return Success();
+}
+
+::bosdyn::common::Status MapCache::StoreGraph(const ::bosdyn::api::graph_nav::Graph& graph) {
+    std::string data;
+    if (!graph.SerializeToString(&data)) return CacheError("could not serialize the graph.");
+    return WriteFileAtomically(GraphPath(), data);
+}
+
+::bosdyn::common::Status MapCache::LoadGraph(::bosdyn::api::graph_nav::Graph* graph) const {
+    if (!::bosdyn::common::ParseMessageFromFile(GraphPath(), graph)) {
+        return CacheError("could not read the graph from " + GraphPath() + ".");
+    }
+    return Success();
+}
+
+::bosdyn::common::Status MapCache::StoreWaypointSnapshot(
+    const ::bosdyn::api::graph_nav::WaypointSnapshot& snapshot, bool* written) {
+    std::string data;
+    if (!snapshot.SerializeToString(&data)) return CacheError("could not serialize snapshot.");
+    return StoreSerializedSnapshot(SnapshotType::kWaypoint, snapshot.id(), data, written);
+}
+
+::bosdyn::common::Status MapCache::StoreEdgeSnapshot(
+    const ::bosdyn::api::graph_nav::EdgeSnapshot& snapshot, bool* written) {
+    std::string data;
+    if (!snapshot.SerializeToString(&data)) return CacheError("could not serialize snapshot.");
+    return StoreSerializedSnapshot(SnapshotType::kEdge, snapshot.id(), data, written);
+}
+
+::bosdyn::common::Status MapCache::StoreSerializedSnapshot(SnapshotType type,
+                                                           const std::string& snapshot_id,
+                                                           const std::string& data,
+                                                           bool* written) {
+    if (written) *written = false;
+    if (!IsValidId(snapshot_id)) return CacheError("invalid snapshot id '" + snapshot_id + "'.");
+    bddf::Sha1 sha1;
+    sha1.Update(data.data(), data.size());
+    SnapshotEntry entry;
+    entry.content_hash = HexDigest(sha1.Final());
+    entry.num_bytes = data.size();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const EntryMap& entries = m_entries[static_cast<int>(type)];
+    auto it = entries.find(snapshot_id);
+    if (it != entries.end() && it->second.content_hash == entry.content_hash) return Success();
+    STATUS_OK_ELSE_RETURN(WriteFileAtomically(SnapshotPath(type, snapshot_id), data));
+    if (written) *written = true;
+    return RecordEntry(type, snapshot_id, entry);
+}
+
+::bosdyn::common::Status MapCache::AddSnapshotFile(SnapshotType type,
+                                                   const std::string& snapshot_id) {
+    if (!IsValidId(snapshot_id)) return CacheError("invalid snapshot id '" + snapshot_id + "'.");
+    SnapshotEntry entry;
+    STATUS_OK_ELSE_RETURN(HashFile(SnapshotPath(type, snapshot_id), &entry));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return RecordEntry(type, snapshot_id, entry);
+}
+
+class MapCache::SnapshotSink : public DataChunkSink {
+ public:
+    SnapshotSink(MapCache* cache, SnapshotType type, const std::string& snapshot_id)
+        : m_cache(cache),
+          m_type(type),
+          m_snapshot_id(snapshot_id),
+          m_path(cache->SnapshotPath(type, snapshot_id)),
+          m_temp_path(m_path + kTempSuffix) {}
+
+    ~SnapshotSink() override {
+        if (m_file) {
+            std::fclose(m_file);
+            std::error_code error;
+            fs::remove(m_temp_path, error);
+        }
+    }
+
+ protected:
+    ::bosdyn::common::Status Reserve(uint64_t /*total_size*/) override {
+        m_file = std::fopen(m_temp_path.c_str(), "wb");
+        if (!m_file) return CacheError("could not create " + m_temp_path + ".");
+        return Success();
+    }
+
+    ::bosdyn::common::Status WriteData(const std::string& data) override {
+        if (std::fwrite(data.data(), 1, data.size(), m_file) != data.size()) {
+            return CacheError("could not write " + m_temp_path + ".");
+        }
+        m_sha1.Update(data.data(), data.size());
+        return Success();
+    }
+
+    ::bosdyn::common::Status FinishData() override {
+        const bool closed = std::fclose(m_file) == 0;
+        m_file = nullptr;
+        std::error_code error;
+        if (!closed) {
+            fs::remove(m_temp_path, error);
+            return CacheError("could not write " + m_temp_path + ".");
+        }
+        fs::rename(m_temp_path, m_path, error);
+        if (error) return CacheError("could not rename " + m_temp_path + ": " + error.message());
+        SnapshotEntry entry;
+        entry.content_hash = HexDigest(m_sha1.Final());
+        entry.num_bytes = bytes_written();
+        std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+        return m_cache->RecordEntry(m_type, m_snapshot_id, entry);
+    }
+
+ private:
+    MapCache* m_cache;
+    SnapshotType m_type;
+    std::string m_snapshot_id;
+    std::string m_path;
+    std::string m_temp_path;
+    std::FILE* m_file = nullptr;
+    bddf::Sha1 m_sha1;
+};
+
+Result<std::shared_ptr<DataChunkSink>> MapCache::CreateSnapshotSink(
+    SnapshotType type, const std::string& snapshot_id) {
+    if (!IsValidId(snapshot_id)) {
+        return {CacheError("invalid snapshot id '" + snapshot_id + "'."), nullptr};
+    }
+    return {Success(), std::make_shared<SnapshotSink>(this, type, snapshot_id)};
+}
+
+bool MapCache::FindSnapshot(SnapshotType type, const std::string& snapshot_id,
+                            SnapshotEntry* entry) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const EntryMap& entries = m_entries[static_cast<int>(type)];
+    auto it = entries.find(snapshot_id);
+    if (it == entries.end()) return false;
+    if (entry) *entry = it->second;
+    return true;
+}
+
+size_t MapCache::NumSnapshots(SnapshotType type) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries[static_cast<int>(type)].size();
+}
+
+std::vector<std::string> MapCache::SnapshotIds(SnapshotType type) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> ids;
+    ids.reserve(m_entries[static_cast<int>(type)].size());
+    for (const auto& id_and_entry : m_entries[static_cast<int>(type)]) {
+        ids.push_back(id_and_entry.first);
+    }
+    return ids;
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/graph_nav/map.pb.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bosdyn/client/data_chunk/data_chunking.h"
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// On-disk store of a graph-nav map, in the layout of bosdyn/common/mission_filesystem.h: the graph
+// in kGraphFile, and each serialized snapshot in a file named by its id in kWaypointSnapshotDir or
+// kEdgeSnapshotDir. Maps written by the other SDKs can be opened directly.
+//
+// Every snapshot is indexed by the SHA1 of its serialized content. The index is kept in an
+// append-only file next to the snapshots and checked against the files when the cache is
+// opened, so only new or changed files are hashed again. Storing a snapshot whose content is
+// already in the cache under its id does not touch the disk.
+//
+// All functions may be called concurrently.
+class MapCache {
+ public:
+    enum class SnapshotType { kWaypoint, kEdge };
+
+    struct SnapshotEntry {
+        // Lowercase hexadecimal SHA1 of the serialized snapshot.
+        std::string content_hash;
+        uint64_t num_bytes = 0;
+    };
+
+    // Open the cache in root_directory, creating the directory and its layout if needed, index
+    // any snapshots that were added without the cache, and remove partially written files.
+    ::bosdyn::common::Status Open(const std::string& root_directory);
+    const std::string& root_directory() const { return m_root; }
+
+    ::bosdyn::common::Status StoreGraph(const ::bosdyn::api::graph_nav::Graph& graph);
+    ::bosdyn::common::Status LoadGraph(::bosdyn::api::graph_nav::Graph* graph) const;
+    std::string GraphPath() const;
+
+    // Store a snapshot under its id. If written is not null, it is set to whether the file was
+    // written, or false if the cache already held the same content.
+    ::bosdyn::common::Status StoreWaypointSnapshot(
+        const ::bosdyn::api::graph_nav::WaypointSnapshot& snapshot, bool* written = nullptr);
+    ::bosdyn::common::Status StoreEdgeSnapshot(
+        const ::bosdyn::api::graph_nav::EdgeSnapshot& snapshot, bool* written = nullptr);
+    // Store an already serialized snapshot.
+    ::bosdyn::common::Status StoreSerializedSnapshot(SnapshotType type,
+                                                     const std::string& snapshot_id,
+                                                     const std::string& data,
+                                                     bool* written = nullptr);
+    // Index a snapshot file that was written to SnapshotPath() by other means.
+    ::bosdyn::common::Status AddSnapshotFile(SnapshotType type, const std::string& snapshot_id);
+    // Create a sink that streams a snapshot, for example from a download, into a temporary file
+    // next to SnapshotPath() and hashes it as it is written. Once the sink is finished the file
+    // is renamed into place and indexed; a sink destroyed before that removes its file. The cache
+    // must outlive the sink.
+    Result<std::shared_ptr<DataChunkSink>> CreateSnapshotSink(SnapshotType type,
+                                                              const std::string& snapshot_id);
+
+    // Look up a snapshot by id. Returns false if it is not in the cache.
+    bool FindSnapshot(SnapshotType type, const std::string& snapshot_id,
+                      SnapshotEntry* entry = nullptr) const;
+    std::string SnapshotPath(SnapshotType type, const std::string& snapshot_id) const;
+    size_t NumSnapshots(SnapshotType type) const;
+    // Ids of the snapshots of the given type in the cache, in no particular order.
+    std::vector<std::string> SnapshotIds(SnapshotType type) const;
+
+    // Name of the index file in the root directory.
+    static const char* const kIndexFile;
+
+ private:
+    class SnapshotSink;
+    typedef std::unordered_map<std::string, SnapshotEntry> EntryMap;
+
+    static bool IsValidId(const std::string& snapshot_id);
+    std::string SnapshotDirectory(SnapshotType type) const;
+    // Record an entry in memory and in the index file. Requires m_mutex.
+    ::bosdyn::common::Status RecordEntry(SnapshotType type, const std::string& snapshot_id,
+                                         const SnapshotEntry& entry);
+    ::bosdyn::common::Status RewriteIndex();
+
+    std::string m_root;
+    mutable std::mutex m_mutex;
+    EntryMap m_entries[2];
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
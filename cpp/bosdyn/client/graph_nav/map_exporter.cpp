@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/graph_nav/map_exporter.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_set>
+
+#include "bosdyn/client/util/bounded_window.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct PendingDownload {
+    MapCache::SnapshotType type;
+    std::string snapshot_id;
+    SnapshotTransferStats stats;
+    std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace
+
+::bosdyn::common::Status ExportMapToCache(GraphNavClient* client, MapCache* cache,
+                                          const MapExportOptions& options,
+                                          MapExportReport* report) {
+    *report = MapExportReport();
+    const auto start = std::chrono::steady_clock::now();
+
+    auto graph_result = options.stream_graph ? client->DownloadGraphStreaming(options.parameters)
+                                             : client->DownloadGraph(options.parameters);
+    if (!graph_result) return graph_result.status;
+    const ::bosdyn::api::graph_nav::Graph& graph = graph_result.response.graph();
+    STATUS_OK_ELSE_RETURN(cache->StoreGraph(graph));
+
+    // Snapshots can be shared between waypoints or edges, so each is downloaded at most once.
+    std::vector<PendingDownload> pending;
+    std::unordered_set<std::string> seen[2];
+    auto add_pending = [&](MapCache::SnapshotType type, const std::string& snapshot_id) {
+        if (snapshot_id.empty() || !seen[static_cast<int>(type)].insert(snapshot_id).second) {
+            return;
+        }
+        if (cache->FindSnapshot(type, snapshot_id)) {
+            ++report->num_snapshots_skipped;
+        } else {
+            pending.push_back({type, snapshot_id, {}, {}});
+        }
+    };
+    for (const auto& waypoint : graph.waypoints()) {
+        add_pending(MapCache::SnapshotType::kWaypoint, waypoint.snapshot_id());
+    }
+    for (const auto& edge : graph.edges()) {
+        add_pending(MapCache::SnapshotType::kEdge, edge.snapshot_id());
+    }
+
+    ::bosdyn::common::Status final_status(SDKErrorCode::Success);
+    auto complete = [&](SnapshotTransferStats&& stats) {
+        if (stats.status) {
+            report->num_bytes_downloaded += stats.num_bytes;
+        } else {
+            final_status = stats.status;
+        }
+        if (options.on_snapshot_complete) options.on_snapshot_complete(stats);
+        report->snapshots.push_back(std::move(stats));
+    };
+
+    // Each download records its result and time from its completion callback, and is reported
+    // on this thread. The sink of a download is released once the RPC completes.
+    auto start_download = [&](size_t index, BoundedWindowDoneFunction done) {
+        PendingDownload& download = pending[index];
+        download.stats.type = download.type;
+        download.stats.snapshot_id = download.snapshot_id;
+        download.start = std::chrono::steady_clock::now();
+        auto sink = cache->CreateSnapshotSink(download.type, download.snapshot_id);
+        if (!sink) {
+            download.stats.status = sink.status;
+            done();
+            return;
+        }
+        auto on_result = [&download, done](const DownloadSnapshotToSinkResultType& result) {
+            download.stats.status = result.status;
+            download.stats.num_bytes = result.response;
+            download.stats.seconds = SecondsSince(download.start);
+            done();
+        };
+        if (download.type == MapCache::SnapshotType::kWaypoint) {
+            ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest request =
+                options.waypoint_snapshot_request;
+            request.set_waypoint_snapshot_id(download.snapshot_id);
+            StartWithCompletionCallback<DownloadSnapshotToSinkResultType>(
+                [&](DownloadSnapshotToSinkCallback on_complete) {
+                    return client->DownloadWaypointSnapshotAsync(request, sink.move(),
+                                                                 options.parameters, on_complete);
+                },
+                on_result);
+        } else {
+            ::bosdyn::api::graph_nav::DownloadEdgeSnapshotRequest request;
+            request.set_edge_snapshot_id(download.snapshot_id);
+            StartWithCompletionCallback<DownloadSnapshotToSinkResultType>(
+                [&](DownloadSnapshotToSinkCallback on_complete) {
+                    return client->DownloadEdgeSnapshotAsync(request, sink.move(),
+                                                             options.parameters, on_complete);
+                },
+                on_result);
+        }
+    };
+    RunBoundedWindow(pending.size(), options.max_concurrent_downloads, start_download,
+                     [&](size_t index) {
+                         SnapshotTransferStats& stats = pending[index].stats;
+                         if (stats.seconds > 0.0) {
+                             stats.bytes_per_second = stats.num_bytes / stats.seconds;
+                         }
+                         complete(std::move(stats));
+                     });
+
+    report->seconds = SecondsSince(start);
+    return final_status;
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/graph_nav/graph_nav.pb.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "bosdyn/client/graph_nav/graph_nav_client.h"
+#include "bosdyn/client/graph_nav/map_cache.h"
+#include "bosdyn/client/graph_nav/map_uploader.h"
+
+namespace bosdyn {
+
+namespace client {
+
+struct MapExportOptions {
+    // Number of snapshot downloads kept in flight at once.
+    size_t max_concurrent_downloads = 4;
+    // Download the graph with DownloadGraphStreaming instead of DownloadGraph, for graphs too
+    // large for a single response.
+    bool stream_graph = false;
+    // Copied into every waypoint snapshot request, with its id filled in, e.g. to set
+    // download_images.
+    ::bosdyn::api::graph_nav::DownloadWaypointSnapshotRequest waypoint_snapshot_request;
+    RPCParameters parameters;
+    // If set, called from the exporting thread as each snapshot download completes.
+    std::function<void(const SnapshotTransferStats&)> on_snapshot_complete;
+};
+
+struct MapExportReport {
+    // One entry per snapshot that was downloaded, in order of completion.
+    std::vector<SnapshotTransferStats> snapshots;
+    // Snapshots that were already in the cache, from an earlier export, and were not downloaded.
+    size_t num_snapshots_skipped = 0;
+    uint64_t num_bytes_downloaded = 0;
+    double seconds = 0.0;
+};
+
+// Download the map on the robot into a MapCache, in the layout of mission_filesystem.h.
+//
+// The graph is downloaded and stored first, then every snapshot it references that is not in the
+// cache is streamed straight to its file through MapCache::CreateSnapshotSink(), with up to
+// max_concurrent_downloads downloads in flight on the MessagePump of the client. Only the chunk
+// being written is held per download, so memory use is bounded by the window times the chunk
+// size rather than by the size of the map.
+//
+// The index of the cache is the manifest of the export: a snapshot is added to it only once its
+// file is complete, and partially written files are discarded. Exporting into the same cache
+// again after an interruption or a failure only downloads the snapshots that are still missing.
+::bosdyn::common::Status ExportMapToCache(GraphNavClient* client, MapCache* cache,
+                                          const MapExportOptions& options,
+                                          MapExportReport* report);
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/graph_nav/map_uploader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "bosdyn/client/util/bounded_window.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct PendingUpload {
+    MapCache::SnapshotType type;
+    std::string snapshot_id;
+    uint64_t num_bytes;
+    SnapshotTransferStats stats;
+    std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace
+
+::bosdyn::common::Status UploadMapFromCache(GraphNavClient* client, const MapCache& cache,
+                                            const MapUploadOptions& options,
+                                            MapUploadReport* report) {
+    *report = MapUploadReport();
+    const auto start = std::chrono::steady_clock::now();
+
+    ::bosdyn::api::graph_nav::UploadGraphRequest graph_request;
+    STATUS_OK_ELSE_RETURN(cache.LoadGraph(graph_request.mutable_graph()));
+    graph_request.set_generate_new_anchoring(options.generate_new_anchoring);
+    auto graph_result = client->UploadGraph(graph_request, options.parameters);
+    report->graph_response = std::move(graph_result.response);
+    if (!graph_result.status) return graph_result.status;
+
+    // Look up the sizes of the missing snapshots, and send the largest first so the last uploads
+    // in flight are the short ones.
+    ::bosdyn::common::Status final_status(SDKErrorCode::Success);
+    std::vector<PendingUpload> pending;
+    auto add_pending = [&](MapCache::SnapshotType type,
+                           const google::protobuf::RepeatedPtrField<std::string>& ids) {
+        for (const std::string& snapshot_id : ids) {
+            MapCache::SnapshotEntry entry;
+            if (cache.FindSnapshot(type, snapshot_id, &entry)) {
+                pending.push_back({type, snapshot_id, entry.num_bytes, {}, {}});
+                continue;
+            }
+            SnapshotTransferStats stats;
+            stats.type = type;
+            stats.snapshot_id = snapshot_id;
+            stats.status = ::bosdyn::common::Status(
+                SDKErrorCode::GenericSDKError,
+                "Snapshot " + snapshot_id + " is missing from the map cache.");
+            final_status = stats.status;
+            if (options.on_snapshot_complete) options.on_snapshot_complete(stats);
+            report->snapshots.push_back(std::move(stats));
+        }
+    };
+    const auto& graph_response = report->graph_response;
+    add_pending(MapCache::SnapshotType::kWaypoint, graph_response.unknown_waypoint_snapshot_ids());
+    add_pending(MapCache::SnapshotType::kEdge, graph_response.unknown_edge_snapshot_ids());
+    report->num_snapshots_skipped = graph_response.loaded_waypoint_snapshot_ids_size() +
+                                    graph_response.loaded_edge_snapshot_ids_size();
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const PendingUpload& a, const PendingUpload& b) {
+                         return a.num_bytes > b.num_bytes;
+                     });
+
+    // Each upload records its status and time from its completion callback, and is reported on
+    // this thread.
+    auto start_upload = [&](size_t index, BoundedWindowDoneFunction done) {
+        PendingUpload& upload = pending[index];
+        upload.stats.type = upload.type;
+        upload.stats.snapshot_id = upload.snapshot_id;
+        upload.stats.num_bytes = upload.num_bytes;
+        upload.start = std::chrono::steady_clock::now();
+        auto source = IstreamDataChunkSource::FromFile(
+            cache.SnapshotPath(upload.type, upload.snapshot_id), options.chunk_size);
+        if (!source) {
+            upload.stats.status = source.status;
+            done();
+            return;
+        }
+        auto set_status = [&upload, done](const ::bosdyn::common::Status& status) {
+            upload.stats.status = status;
+            upload.stats.seconds = SecondsSince(upload.start);
+            done();
+        };
+        if (upload.type == MapCache::SnapshotType::kWaypoint) {
+            StartWithCompletionCallback<UploadWaypointSnapshotResultType>(
+                [&](UploadWaypointSnapshotCallback on_complete) {
+                    return client->UploadWaypointSnapshotAsync(source.move(), options.parameters,
+                                                               on_complete);
+                },
+                [set_status](const UploadWaypointSnapshotResultType& result) {
+                    set_status(result.status);
+                });
+        } else {
+            StartWithCompletionCallback<UploadEdgeSnapshotResultType>(
+                [&](UploadEdgeSnapshotCallback on_complete) {
+                    return client->UploadEdgeSnapshotAsync(source.move(), options.parameters,
+                                                           on_complete);
+                },
+                [set_status](const UploadEdgeSnapshotResultType& result) {
+                    set_status(result.status);
+                });
+        }
+    };
+    RunBoundedWindow(pending.size(), options.max_concurrent_uploads, start_upload,
+                     [&](size_t index) {
+                         SnapshotTransferStats& stats = pending[index].stats;
+                         if (stats.seconds > 0.0) {
+                             stats.bytes_per_second = stats.num_bytes / stats.seconds;
+                         }
+                         if (stats.status) {
+                             report->num_bytes_uploaded += stats.num_bytes;
+                         } else {
+                             final_status = stats.status;
+                         }
+                         if (options.on_snapshot_complete) options.on_snapshot_complete(stats);
+                         report->snapshots.push_back(std::move(stats));
+                     });
+
+    report->seconds = SecondsSince(start);
+    return final_status;
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
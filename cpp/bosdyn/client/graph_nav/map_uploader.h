@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/graph_nav/graph_nav.pb.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bosdyn/client/data_chunk/data_chunking.h"
+#include "bosdyn/client/graph_nav/graph_nav_client.h"
+#include "bosdyn/client/graph_nav/map_cache.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Outcome of the transfer of one snapshot.
+struct SnapshotTransferStats {
+    MapCache::SnapshotType type = MapCache::SnapshotType::kWaypoint;
+    std::string snapshot_id;
+    ::bosdyn::common::Status status;
+    uint64_t num_bytes = 0;
+    // Time from starting the transfer to its completion.
+    double seconds = 0.0;
+    double bytes_per_second = 0.0;
+};
+
+struct MapUploadOptions {
+    // Number of snapshot uploads kept in flight at once.
+    size_t max_concurrent_uploads = 4;
+    size_t chunk_size = kDefaultDataChunkSize;
+    // Passed on in the UploadGraphRequest.
+    bool generate_new_anchoring = false;
+    RPCParameters parameters;
+    // If set, called from the uploading thread as each snapshot upload completes.
+    std::function<void(const SnapshotTransferStats&)> on_snapshot_complete;
+};
+
+struct MapUploadReport {
+    ::bosdyn::api::graph_nav::UploadGraphResponse graph_response;
+    // One entry per snapshot the robot did not have, in order of completion.
+    std::vector<SnapshotTransferStats> snapshots;
+    // Snapshots the robot already had, which were not sent.
+    size_t num_snapshots_skipped = 0;
+    uint64_t num_bytes_uploaded = 0;
+    double seconds = 0.0;
+};
+
+// Upload the map in a MapCache to the robot, sending only the snapshots it does not already have.
+//
+// The graph is uploaded first, and the unknown_waypoint_snapshot_ids and
+// unknown_edge_snapshot_ids of the response name the snapshots that are missing on the robot.
+// Those are streamed from their files with IstreamDataChunkSource, with up to
+// max_concurrent_uploads uploads in flight on the MessagePump of the client, so the memory used is
+// bounded by the chunks in flight rather than by the size of the map.
+//
+// Returns an error if the graph upload fails, or if any snapshot is missing from the cache or
+// fails to upload; the report describes every snapshot that was attempted either way.
+::bosdyn::common::Status UploadMapFromCache(GraphNavClient* client, const MapCache& cache,
+                                            const MapUploadOptions& options,
+                                            MapUploadReport* report);
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,442 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/graph_nav/route_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+uint64_t EdgeKey(uint32_t from, uint32_t to) { return (static_cast<uint64_t>(from) << 32) | to; }
+
+double EdgeCost(const ::bosdyn::api::graph_nav::Edge& edge) {
+    if (edge.annotations().has_cost()) return edge.annotations().cost().value();
+    const auto& position = edge.from_tform_to().position();
+    return std::sqrt(position.x() * position.x() + position.y() * position.y() +
+                     position.z() * position.z());
+}
+
+struct HeapEntry {
+    // Key of the heap: the cost so far, plus the heuristic for A*.
+    double key;
+    double cost;
+    uint32_t waypoint;
+
+    bool operator>(const HeapEntry& other) const { return key > other.key; }
+};
+
+// Per-direction search state. Entries are valid only where stamp matches the epoch of the
+// current search, so starting a search does not clear arrays the size of the graph.
+struct SearchState {
+    std::vector<double> cost;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> parent_edge;
+    std::vector<uint32_t> stamp;
+    std::vector<HeapEntry> heap;
+    uint32_t epoch = 0;
+
+    void Start(size_t num_waypoints) {
+        if (stamp.size() < num_waypoints) {
+            cost.resize(num_waypoints);
+            parent.resize(num_waypoints);
+            parent_edge.resize(num_waypoints);
+            stamp.resize(num_waypoints, 0);
+        }
+        if (++epoch == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+        heap.clear();
+    }
+
+    bool Reached(uint32_t waypoint) const { return stamp[waypoint] == epoch; }
+    double Cost(uint32_t waypoint) const { return Reached(waypoint) ? cost[waypoint] : kInfinity; }
+
+    // Record a cost for the waypoint if it is lower than the known one.
+    bool Relax(uint32_t waypoint, double new_cost, uint32_t from, uint32_t edge, double key) {
+        if (new_cost >= Cost(waypoint)) return false;
+        stamp[waypoint] = epoch;
+        cost[waypoint] = new_cost;
+        parent[waypoint] = from;
+        parent_edge[waypoint] = edge;
+        heap.push_back({key, new_cost, waypoint});
+        std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        return true;
+    }
+
+    HeapEntry Pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        const HeapEntry entry = heap.back();
+        heap.pop_back();
+        return entry;
+    }
+
+    // Heap entries superseded by a later Relax() are skipped when popped.
+    bool IsStale(const HeapEntry& entry) const { return entry.cost > cost[entry.waypoint]; }
+};
+
+struct SearchScratch {
+    SearchState forward;
+    SearchState backward;
+    // Result of the last search: waypoints and edges of the route, in order of travel.
+    std::vector<uint32_t> waypoints;
+    std::vector<uint32_t> edges;
+    // Targets of ComputeCostMatrix, as the target's column plus one, or 0.
+    std::vector<uint32_t> target_column;
+};
+
+SearchScratch& GetScratch() {
+    static thread_local SearchScratch scratch;
+    return scratch;
+}
+
+// Append the route from the start of the search to waypoint, following parents.
+void AppendPathTo(const SearchState& state, uint32_t waypoint, SearchScratch* scratch) {
+    const size_t waypoints_begin = scratch->waypoints.size();
+    const size_t edges_begin = scratch->edges.size();
+    for (uint32_t w = waypoint; w != kNone; w = state.parent[w]) {
+        scratch->waypoints.push_back(w);
+        if (state.parent[w] != kNone) scratch->edges.push_back(state.parent_edge[w]);
+    }
+    std::reverse(scratch->waypoints.begin() + waypoints_begin, scratch->waypoints.end());
+    std::reverse(scratch->edges.begin() + edges_begin, scratch->edges.end());
+}
+
+::bosdyn::common::Status UnknownWaypoint(const std::string& waypoint_id) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                    "Unknown waypoint " + waypoint_id + ".");
+}
+
+}  // namespace
+
+double RoutePlanner::Distance(const Position& a, const Position& b) {
+    return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) +
+                     (a.z - b.z) * (a.z - b.z));
+}
+
+template <class Fn>
+void RoutePlanner::ForEachArc(uint32_t waypoint, Fn&& fn) const {
+    if (waypoint + 1 < m_offsets.size()) {
+        for (uint32_t i = m_offsets[waypoint]; i < m_offsets[waypoint + 1]; ++i) fn(m_arcs[i]);
+    }
+    for (const Arc& arc : m_pending_arcs[waypoint]) fn(arc);
+}
+
+::bosdyn::common::Status RoutePlanner::Build(const ::bosdyn::api::graph_nav::Graph& graph) {
+    m_waypoint_ids.clear();
+    m_waypoint_index.clear();
+    m_edges.clear();
+    m_edge_index.clear();
+    m_offsets.clear();
+    m_arcs.clear();
+    m_pending_arcs.clear();
+    m_num_pending_arcs = 0;
+    m_positions.clear();
+    m_has_position.clear();
+
+    m_waypoint_ids.reserve(graph.waypoints_size());
+    m_waypoint_index.reserve(graph.waypoints_size());
+    for (const auto& waypoint : graph.waypoints()) AddWaypoint(waypoint.id());
+
+    m_edges.reserve(graph.edges_size());
+    m_edge_index.reserve(graph.edges_size());
+    for (const auto& edge : graph.edges()) {
+        uint32_t from, to;
+        if (!FindWaypoint(edge.id().from_waypoint(), &from)) {
+            return UnknownWaypoint(edge.id().from_waypoint());
+        }
+        if (!FindWaypoint(edge.id().to_waypoint(), &to)) {
+            return UnknownWaypoint(edge.id().to_waypoint());
+        }
+        const double cost = EdgeCost(edge);
+        if (!(cost >= 0.0)) {
+            return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                            "Edge from " + edge.id().from_waypoint() +
+                                                " has a negative cost.");
+        }
+        const auto inserted = m_edge_index.emplace(EdgeKey(from, to), m_edges.size());
+        if (inserted.second) {
+            m_edges.push_back({from, to, cost});
+        } else {
+            m_edges[inserted.first->second].cost = cost;
+        }
+    }
+    Compact();
+    SetAnchoring(graph.anchoring());
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+uint32_t RoutePlanner::AddWaypoint(const std::string& waypoint_id) {
+    const auto inserted = m_waypoint_index.emplace(waypoint_id, m_waypoint_ids.size());
+    if (inserted.second) {
+        m_waypoint_ids.push_back(waypoint_id);
+        m_pending_arcs.emplace_back();
+        m_positions.push_back({0.0, 0.0, 0.0});
+        m_has_position.push_back(0);
+    }
+    return inserted.first->second;
+}
+
+::bosdyn::common::Status RoutePlanner::AddEdge(const ::bosdyn::api::graph_nav::Edge& edge) {
+    const double cost = EdgeCost(edge);
+    if (!(cost >= 0.0)) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Edge from " + edge.id().from_waypoint() +
+                                            " has a negative cost.");
+    }
+    const uint32_t from = AddWaypoint(edge.id().from_waypoint());
+    const uint32_t to = AddWaypoint(edge.id().to_waypoint());
+    const auto inserted = m_edge_index.emplace(EdgeKey(from, to), m_edges.size());
+    if (!inserted.second) {
+        // Update the cost of both arcs of the known edge.
+        const uint32_t edge_index = inserted.first->second;
+        m_edges[edge_index].cost = cost;
+        for (uint32_t waypoint : {from, to}) {
+            if (waypoint + 1 < m_offsets.size()) {
+                for (uint32_t i = m_offsets[waypoint]; i < m_offsets[waypoint + 1]; ++i) {
+                    if (m_arcs[i].edge == edge_index) m_arcs[i].cost = cost;
+                }
+            }
+            for (Arc& arc : m_pending_arcs[waypoint]) {
+                if (arc.edge == edge_index) arc.cost = cost;
+            }
+        }
+        UpdateHeuristicScale(m_edges[edge_index]);
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+
+    const uint32_t edge_index = static_cast<uint32_t>(m_edges.size());
+    m_edges.push_back({from, to, cost});
+    m_pending_arcs[from].push_back({to, edge_index, cost});
+    m_pending_arcs[to].push_back({from, edge_index, cost});
+    m_num_pending_arcs += 2;
+    UpdateHeuristicScale(m_edges.back());
+    // Rebuilding is linear in the graph size, so doing it when the pending arcs grow to a fixed
+    // fraction of the CSR array keeps the amortized cost of adding an edge constant.
+    if (m_num_pending_arcs > 1024 && m_num_pending_arcs * 8 > m_arcs.size()) Compact();
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+void RoutePlanner::Compact() {
+    const size_t num_waypoints = m_waypoint_ids.size();
+    m_offsets.assign(num_waypoints + 1, 0);
+    for (const EdgeRecord& edge : m_edges) {
+        ++m_offsets[edge.from + 1];
+        ++m_offsets[edge.to + 1];
+    }
+    for (size_t i = 0; i < num_waypoints; ++i) m_offsets[i + 1] += m_offsets[i];
+    m_arcs.resize(m_offsets.back());
+    std::vector<uint32_t> next(m_offsets.begin(), m_offsets.end() - 1);
+    for (uint32_t e = 0; e < m_edges.size(); ++e) {
+        const EdgeRecord& edge = m_edges[e];
+        m_arcs[next[edge.from]++] = {edge.to, e, edge.cost};
+        m_arcs[next[edge.to]++] = {edge.from, e, edge.cost};
+    }
+    m_pending_arcs.assign(num_waypoints, std::vector<Arc>());
+    m_num_pending_arcs = 0;
+}
+
+void RoutePlanner::SetAnchoring(const ::bosdyn::api::graph_nav::Anchoring& anchoring) {
+    std::fill(m_has_position.begin(), m_has_position.end(), 0);
+    m_num_positions = 0;
+    for (const auto& anchor : anchoring.anchors()) {
+        uint32_t index;
+        if (!FindWaypoint(anchor.id(), &index)) continue;
+        const auto& position = anchor.seed_tform_waypoint().position();
+        m_positions[index] = {position.x(), position.y(), position.z()};
+        if (!m_has_position[index]) ++m_num_positions;
+        m_has_position[index] = 1;
+    }
+    m_heuristic_scale = kInfinity;
+    for (const EdgeRecord& edge : m_edges) UpdateHeuristicScale(edge);
+}
+
+void RoutePlanner::UpdateHeuristicScale(const EdgeRecord& edge) {
+    if (!m_has_position[edge.from] || !m_has_position[edge.to]) return;
+    const double length = Distance(m_positions[edge.from], m_positions[edge.to]);
+    if (length > 0.0) m_heuristic_scale = std::min(m_heuristic_scale, edge.cost / length);
+}
+
+bool RoutePlanner::HasHeuristic() const {
+    return m_num_positions == m_waypoint_ids.size() && m_heuristic_scale > 0.0 &&
+           m_heuristic_scale < kInfinity;
+}
+
+bool RoutePlanner::FindWaypoint(const std::string& waypoint_id, uint32_t* index) const {
+    const auto it = m_waypoint_index.find(waypoint_id);
+    if (it == m_waypoint_index.end()) return false;
+    *index = it->second;
+    return true;
+}
+
+double RoutePlanner::Heuristic(uint32_t waypoint, uint32_t goal) const {
+    return m_heuristic_scale * Distance(m_positions[waypoint], m_positions[goal]);
+}
+
+double RoutePlanner::AStar(uint32_t from, uint32_t to) const {
+    SearchScratch& scratch = GetScratch();
+    SearchState& state = scratch.forward;
+    state.Start(m_waypoint_ids.size());
+    state.Relax(from, 0.0, kNone, kNone, Heuristic(from, to));
+    while (!state.heap.empty()) {
+        const HeapEntry entry = state.Pop();
+        if (state.IsStale(entry)) continue;
+        if (entry.waypoint == to) {
+            AppendPathTo(state, to, &scratch);
+            return entry.cost;
+        }
+        ForEachArc(entry.waypoint, [&](const Arc& arc) {
+            const double cost = entry.cost + arc.cost;
+            if (cost < state.Cost(arc.to)) {
+                state.Relax(arc.to, cost, entry.waypoint, arc.edge, cost + Heuristic(arc.to, to));
+            }
+        });
+    }
+    return kInfinity;
+}
+
+double RoutePlanner::BidirectionalDijkstra(uint32_t from, uint32_t to) const {
+    SearchScratch& scratch = GetScratch();
+    SearchState* states[2] = {&scratch.forward, &scratch.backward};
+    states[0]->Start(m_waypoint_ids.size());
+    states[1]->Start(m_waypoint_ids.size());
+    states[0]->Relax(from, 0.0, kNone, kNone, 0.0);
+    states[1]->Relax(to, 0.0, kNone, kNone, 0.0);
+
+    // Best route found so far: forward search to meet_from, the edge, backward search from
+    // meet_to.
+    double best = from == to ? 0.0 : kInfinity;
+    uint32_t meet_from = from, meet_to = to, meet_edge = kNone;
+    while (!states[0]->heap.empty() && !states[1]->heap.empty()) {
+        // Once the two frontiers together cost more than the best route, no better one exists.
+        if (states[0]->heap.front().key + states[1]->heap.front().key >= best) break;
+        // Expand the smaller frontier.
+        const int side = states[0]->heap.size() <= states[1]->heap.size() ? 0 : 1;
+        SearchState& state = *states[side];
+        const SearchState& other = *states[1 - side];
+        const HeapEntry entry = state.Pop();
+        if (state.IsStale(entry)) continue;
+        ForEachArc(entry.waypoint, [&](const Arc& arc) {
+            const double cost = entry.cost + arc.cost;
+            state.Relax(arc.to, cost, entry.waypoint, arc.edge, cost);
+            if (other.Reached(arc.to) && cost + other.cost[arc.to] < best) {
+                best = cost + other.cost[arc.to];
+                meet_from = side == 0 ? entry.waypoint : arc.to;
+                meet_to = side == 0 ? arc.to : entry.waypoint;
+                meet_edge = arc.edge;
+            }
+        });
+    }
+    if (best == kInfinity) return best;
+
+    AppendPathTo(*states[0], meet_from, &scratch);
+    if (meet_edge != kNone) {
+        scratch.edges.push_back(meet_edge);
+        for (uint32_t w = meet_to; w != kNone; w = states[1]->parent[w]) {
+            scratch.waypoints.push_back(w);
+            if (states[1]->parent[w] != kNone) scratch.edges.push_back(states[1]->parent_edge[w]);
+        }
+    }
+    return best;
+}
+
+::bosdyn::common::Status RoutePlanner::FindRoute(const std::string& from_waypoint_id,
+                                                 const std::string& to_waypoint_id,
+                                                 ::bosdyn::api::graph_nav::Route* route,
+                                                 double* cost) const {
+    uint32_t from, to;
+    if (!FindWaypoint(from_waypoint_id, &from)) return UnknownWaypoint(from_waypoint_id);
+    if (!FindWaypoint(to_waypoint_id, &to)) return UnknownWaypoint(to_waypoint_id);
+
+    SearchScratch& scratch = GetScratch();
+    scratch.waypoints.clear();
+    scratch.edges.clear();
+    const double route_cost = HasHeuristic() ? AStar(from, to) : BidirectionalDijkstra(from, to);
+    if (route_cost == kInfinity) {
+        return ::bosdyn::common::Status(
+            SDKErrorCode::GenericSDKError,
+            "No route from " + from_waypoint_id + " to " + to_waypoint_id + ".");
+    }
+
+    route->Clear();
+    for (uint32_t waypoint : scratch.waypoints) route->add_waypoint_id(m_waypoint_ids[waypoint]);
+    for (uint32_t edge : scratch.edges) {
+        auto* edge_id = route->add_edge_id();
+        edge_id->set_from_waypoint(m_waypoint_ids[m_edges[edge].from]);
+        edge_id->set_to_waypoint(m_waypoint_ids[m_edges[edge].to]);
+    }
+    if (cost) *cost = route_cost;
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+::bosdyn::common::Status RoutePlanner::ComputeCostMatrix(const std::vector<std::string>& sources,
+                                                         const std::vector<std::string>& targets,
+                                                         std::vector<double>* costs) const {
+    std::vector<uint32_t> source_indices(sources.size());
+    std::vector<uint32_t> target_indices(targets.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (!FindWaypoint(sources[i], &source_indices[i])) return UnknownWaypoint(sources[i]);
+    }
+    for (size_t j = 0; j < targets.size(); ++j) {
+        if (!FindWaypoint(targets[j], &target_indices[j])) return UnknownWaypoint(targets[j]);
+    }
+    costs->assign(sources.size() * targets.size(), kInfinity);
+
+    SearchScratch& scratch = GetScratch();
+    // Count each waypoint once, in case targets repeat.
+    auto& target_column = scratch.target_column;
+    target_column.assign(m_waypoint_ids.size(), 0);
+    size_t num_distinct_targets = 0;
+    for (size_t j = 0; j < targets.size(); ++j) {
+        if (target_column[target_indices[j]] == 0) {
+            target_column[target_indices[j]] = static_cast<uint32_t>(j + 1);
+            ++num_distinct_targets;
+        }
+    }
+
+    SearchState& state = scratch.forward;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        double* row = costs->data() + i * targets.size();
+        state.Start(m_waypoint_ids.size());
+        state.Relax(source_indices[i], 0.0, kNone, kNone, 0.0);
+        size_t remaining = num_distinct_targets;
+        while (!state.heap.empty() && remaining > 0) {
+            const HeapEntry entry = state.Pop();
+            if (state.IsStale(entry)) continue;
+            if (target_column[entry.waypoint] != 0) {
+                row[target_column[entry.waypoint] - 1] = entry.cost;
+                --remaining;
+            }
+            ForEachArc(entry.waypoint, [&](const Arc& arc) {
+                const double cost = entry.cost + arc.cost;
+                state.Relax(arc.to, cost, entry.waypoint, arc.edge, cost);
+            });
+        }
+        // Fill in repeated targets.
+        for (size_t j = 0; j < targets.size(); ++j) {
+            row[j] = row[target_column[target_indices[j]] - 1];
+        }
+    }
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
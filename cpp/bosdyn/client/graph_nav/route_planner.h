@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/graph_nav/map.pb.h>
+#include <bosdyn/api/graph_nav/nav.pb.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Computes routes for GraphNavClient::NavigateRoute locally, from a graph downloaded with
+// DownloadGraph.
+//
+// Waypoint ids are interned to indices and the edges stored in a compressed sparse row (CSR)
+// adjacency array, so searches do not touch strings or protobuf maps. Edges can be walked in
+// both directions, and cost their Annotations.cost if it is set, or the length of from_tform_to
+// otherwise.
+//
+// If every waypoint is anchored, FindRoute() runs A* with the straight-line distance in the
+// anchoring frame as the heuristic, scaled down by the smallest ratio of edge cost to anchored
+// edge length so that it never overestimates. Otherwise it runs bidirectional Dijkstra.
+//
+// Edges and waypoints recorded after Build() can be added incrementally; they are kept in
+// per-waypoint lists next to the CSR array, which is rebuilt once they make up a sizable
+// fraction of the edges.
+//
+// Queries are const and may run concurrently; updates must not run concurrently with anything
+// else.
+class RoutePlanner {
+ public:
+    // Replace the contents of the planner with the waypoints, edges and anchoring of the graph.
+    // Returns an error if an edge references an unknown waypoint or has a negative cost.
+    ::bosdyn::common::Status Build(const ::bosdyn::api::graph_nav::Graph& graph);
+
+    // Add a waypoint if it is not already known, and return its index.
+    uint32_t AddWaypoint(const std::string& waypoint_id);
+
+    // Add an edge, adding its waypoints if needed. If the edge is already known, its cost is
+    // updated instead. Returns an error if the edge has a negative cost.
+    ::bosdyn::common::Status AddEdge(const ::bosdyn::api::graph_nav::Edge& edge);
+
+    // Replace the anchoring used for the A* heuristic.
+    void SetAnchoring(const ::bosdyn::api::graph_nav::Anchoring& anchoring);
+
+    // Fold the incrementally added edges into the CSR array.
+    void Compact();
+
+    size_t NumWaypoints() const { return m_waypoint_ids.size(); }
+    size_t NumEdges() const { return m_edges.size(); }
+    // Whether FindRoute() uses A*.
+    bool HasHeuristic() const;
+
+    // Find the lowest-cost route between two waypoints, filling route with its waypoints and
+    // edges in order of travel, and cost with its total cost if not null. Returns an error if
+    // either waypoint is unknown or no route connects them.
+    ::bosdyn::common::Status FindRoute(const std::string& from_waypoint_id,
+                                       const std::string& to_waypoint_id,
+                                       ::bosdyn::api::graph_nav::Route* route,
+                                       double* cost = nullptr) const;
+
+    // Costs of the lowest-cost routes from each of the sources to each of the targets, as a
+    // row-major sources.size() x targets.size() matrix. Unreachable pairs cost infinity. Runs one
+    // search per source, which stops once all targets are reached.
+    ::bosdyn::common::Status ComputeCostMatrix(const std::vector<std::string>& sources,
+                                               const std::vector<std::string>& targets,
+                                               std::vector<double>* costs) const;
+
+ private:
+    struct Arc {
+        uint32_t to;
+        uint32_t edge;
+        double cost;
+    };
+
+    struct EdgeRecord {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    struct Position {
+        double x;
+        double y;
+        double z;
+    };
+
+    static double Distance(const Position& a, const Position& b);
+    template <class Fn>
+    void ForEachArc(uint32_t waypoint, Fn&& fn) const;
+
+    bool FindWaypoint(const std::string& waypoint_id, uint32_t* index) const;
+    double Heuristic(uint32_t waypoint, uint32_t goal) const;
+    // Update m_heuristic_scale for an edge, if both its waypoints are anchored.
+    void UpdateHeuristicScale(const EdgeRecord& edge);
+    // Searches fill the thread's scratch space with the route, and return its cost.
+    double AStar(uint32_t from, uint32_t to) const;
+    double BidirectionalDijkstra(uint32_t from, uint32_t to) const;
+
+    std::vector<std::string> m_waypoint_ids;
+    std::unordered_map<std::string, uint32_t> m_waypoint_index;
+
+    std::vector<EdgeRecord> m_edges;
+    // Keyed by from << 32 | to.
+    std::unordered_map<uint64_t, uint32_t> m_edge_index;
+
+    // Arcs of waypoint i are m_arcs[m_offsets[i]] to m_arcs[m_offsets[i + 1]], followed by
+    // m_pending_arcs[i] for edges added since the last Compact().
+    std::vector<uint32_t> m_offsets;
+    std::vector<Arc> m_arcs;
+    std::vector<std::vector<Arc>> m_pending_arcs;
+    size_t m_num_pending_arcs = 0;
+
+    std::vector<Position> m_positions;
+    std::vector<uint8_t> m_has_position;
+    size_t m_num_positions = 0;
+    // Lower bound of cost per unit of anchored distance over all edges.
+    double m_heuristic_scale = 1.0;
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,383 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/image/depth_deprojection.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/math/frame_helpers.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+::bosdyn::common::Status InvalidImage(const std::string& message) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                    "Cannot deproject depth image: " + message);
+}
+
+// Bytes of one run of a FORMAT_RLE depth image: the run length followed by the little-endian
+// depth value.
+constexpr size_t kRLERunBytes = 3;
+
+// Where the deprojected points of an image go, and the parameters shared by all of its pixels.
+struct PointWriter {
+    float* xyz;
+    uint8_t* rgb;
+    // Visual image pixels and bytes per pixel, or null if no visual image is fused.
+    const uint8_t* visual;
+    int visual_channels;
+    const PointTransform* transform;
+    float inverse_depth_scale;
+    uint16_t min_depth_value;
+    uint16_t max_depth_value;
+    size_t num_points;
+
+    bool IsValid(uint16_t depth) const {
+        return depth != 0 && depth >= min_depth_value && depth <= max_depth_value;
+    }
+
+    // Colors of the given pixel, as three bytes.
+    void WriteColor(size_t pixel, uint8_t* out) const {
+        const uint8_t* in = visual + pixel * visual_channels;
+        if (visual_channels == 1) {
+            out[0] = out[1] = out[2] = in[0];
+        } else {
+            out[0] = in[0];
+            out[1] = in[1];
+            out[2] = in[2];
+        }
+    }
+};
+
+// Per-row scratch space for RAW images.
+struct RowBuffers {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<uint8_t> valid;
+
+    explicit RowBuffers(size_t cols) : x(cols), y(cols), z(cols), valid(cols) {}
+};
+
+// Deproject one row of a RAW image. The points of all pixels are first computed into the row
+// buffers, and the valid ones are then appended to the output; each of the loops is free of
+// branches.
+void DeprojectRawRow(const uint8_t* depth, const float* ray_x, const float* ray_y, size_t cols,
+                     size_t first_pixel, RowBuffers* row, PointWriter* writer) {
+    float* x = row->x.data();
+    float* y = row->y.data();
+    float* z = row->z.data();
+    uint8_t* valid = row->valid.data();
+    const float inverse_depth_scale = writer->inverse_depth_scale;
+    const uint16_t min_depth_value = writer->min_depth_value;
+    const uint16_t max_depth_value = writer->max_depth_value;
+    for (size_t i = 0; i < cols; ++i) {
+        const uint16_t d = static_cast<uint16_t>(depth[2 * i] | (depth[2 * i + 1] << 8));
+        const float zi = static_cast<float>(d) * inverse_depth_scale;
+        x[i] = ray_x[i] * zi;
+        y[i] = ray_y[i] * zi;
+        z[i] = zi;
+        valid[i] = (d != 0) & (d >= min_depth_value) & (d <= max_depth_value);
+    }
+    if (writer->transform) TransformPoints(*writer->transform, cols, x, y, z);
+
+    // Every point is written, and only the valid ones advance the output.
+    float* out = writer->xyz;
+    size_t n = writer->num_points;
+    for (size_t i = 0; i < cols; ++i) {
+        out[3 * n] = x[i];
+        out[3 * n + 1] = y[i];
+        out[3 * n + 2] = z[i];
+        n += valid[i];
+    }
+    if (writer->visual) {
+        // Greyscale pixels are read three times.
+        const size_t channels = writer->visual_channels;
+        const size_t green = channels == 1 ? 0 : 1;
+        const size_t blue = channels == 1 ? 0 : 2;
+        const uint8_t* in = writer->visual + first_pixel * channels;
+        uint8_t* rgb = writer->rgb;
+        size_t c = writer->num_points;
+        for (size_t i = 0; i < cols; ++i, in += channels) {
+            rgb[3 * c] = in[0];
+            rgb[3 * c + 1] = in[green];
+            rgb[3 * c + 2] = in[blue];
+            c += valid[i];
+        }
+    }
+    writer->num_points = n;
+}
+
+// Deproject count consecutive pixels that share the same valid depth z. With a transform, each
+// point is z * (R * ray) + t.
+void DeprojectRun(const float* ray_x, const float* ray_y, size_t count, float z,
+                  size_t first_pixel, PointWriter* writer) {
+    float* out = writer->xyz + 3 * writer->num_points;
+    if (writer->transform) {
+        const float* r = writer->transform->rotation;
+        const float* t = writer->transform->translation;
+        const float r0 = r[0] * z, r1 = r[1] * z, r2 = r[2] * z;
+        const float r3 = r[3] * z, r4 = r[4] * z, r5 = r[5] * z;
+        const float r6 = r[6] * z, r7 = r[7] * z, r8 = r[8] * z;
+        const float tx = t[0] + r2, ty = t[1] + r5, tz = t[2] + r8;
+        for (size_t i = 0; i < count; ++i) {
+            out[3 * i] = r0 * ray_x[i] + r1 * ray_y[i] + tx;
+            out[3 * i + 1] = r3 * ray_x[i] + r4 * ray_y[i] + ty;
+            out[3 * i + 2] = r6 * ray_x[i] + r7 * ray_y[i] + tz;
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            out[3 * i] = ray_x[i] * z;
+            out[3 * i + 1] = ray_y[i] * z;
+            out[3 * i + 2] = z;
+        }
+    }
+    if (writer->visual) {
+        uint8_t* rgb = writer->rgb + 3 * writer->num_points;
+        for (size_t i = 0; i < count; ++i) writer->WriteColor(first_pixel + i, rgb + 3 * i);
+    }
+    writer->num_points += count;
+}
+
+::bosdyn::common::Status CheckRLE(const std::string& data, size_t num_pixels) {
+    if (data.size() % kRLERunBytes != 0) return InvalidImage("truncated RLE run.");
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    size_t total = 0;
+    for (size_t i = 0; i < data.size(); i += kRLERunBytes) total += bytes[i];
+    if (total != num_pixels) return InvalidImage("RLE runs do not add up to the image size.");
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+}  // namespace
+
+bool DepthIntrinsics::operator==(const DepthIntrinsics& other) const {
+    return cols == other.cols && rows == other.rows && focal_length_x == other.focal_length_x &&
+           focal_length_y == other.focal_length_y &&
+           principal_point_x == other.principal_point_x &&
+           principal_point_y == other.principal_point_y && skew_x == other.skew_x &&
+           skew_y == other.skew_y;
+}
+
+DepthRayTable::DepthRayTable(const DepthIntrinsics& intrinsics_in) : intrinsics(intrinsics_in) {
+    // Pixel (u, v) of the point (x, y, 1) is K * (x, y, 1) with the intrinsic matrix
+    //   [[fx, sx, cx], [sy, fy, cy], [0, 0, 1]]
+    // so (x, y) is the inverse of the upper-left 2x2 block applied to (u - cx, v - cy).
+    const double det = intrinsics.focal_length_x * intrinsics.focal_length_y -
+                       intrinsics.skew_x * intrinsics.skew_y;
+    const double a = intrinsics.focal_length_y / det;
+    const double b = -intrinsics.skew_x / det;
+    const double c = -intrinsics.skew_y / det;
+    const double d = intrinsics.focal_length_x / det;
+    const size_t num_pixels = static_cast<size_t>(intrinsics.cols) * intrinsics.rows;
+    ray_x.resize(num_pixels);
+    ray_y.resize(num_pixels);
+    size_t i = 0;
+    for (int v = 0; v < intrinsics.rows; ++v) {
+        const double dv = v - intrinsics.principal_point_y;
+        for (int u = 0; u < intrinsics.cols; ++u, ++i) {
+            const double du = u - intrinsics.principal_point_x;
+            ray_x[i] = static_cast<float>(a * du + b * dv);
+            ray_y[i] = static_cast<float>(c * du + d * dv);
+        }
+    }
+}
+
+bool GetDepthIntrinsics(const ::bosdyn::api::ImageSource& source, DepthIntrinsics* intrinsics) {
+    if (!source.has_pinhole()) return false;
+    const auto& pinhole = source.pinhole().intrinsics();
+    if (pinhole.focal_length().x() * pinhole.focal_length().y() ==
+        pinhole.skew().x() * pinhole.skew().y()) {
+        return false;
+    }
+    intrinsics->cols = source.cols();
+    intrinsics->rows = source.rows();
+    intrinsics->focal_length_x = pinhole.focal_length().x();
+    intrinsics->focal_length_y = pinhole.focal_length().y();
+    intrinsics->principal_point_x = pinhole.principal_point().x();
+    intrinsics->principal_point_y = pinhole.principal_point().y();
+    intrinsics->skew_x = pinhole.skew().x();
+    intrinsics->skew_y = pinhole.skew().y();
+    return true;
+}
+
+size_t DepthDeprojector::IntrinsicsHash::operator()(const DepthIntrinsics& intrinsics) const {
+    size_t seed = std::hash<int>()(intrinsics.cols);
+    for (double value : {static_cast<double>(intrinsics.rows), intrinsics.focal_length_x,
+                         intrinsics.focal_length_y, intrinsics.principal_point_x,
+                         intrinsics.principal_point_y, intrinsics.skew_x, intrinsics.skew_y}) {
+        seed ^= std::hash<double>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+std::shared_ptr<const DepthRayTable> DepthDeprojector::GetRayTable(
+    const DepthIntrinsics& intrinsics) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& table = m_ray_tables[intrinsics];
+    if (!table) table = std::make_shared<const DepthRayTable>(intrinsics);
+    return table;
+}
+
+size_t DepthDeprojector::NumCachedRayTables() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ray_tables.size();
+}
+
+void DepthDeprojector::ClearCache() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ray_tables.clear();
+}
+
+::bosdyn::common::Status DepthDeprojector::Deproject(const ::bosdyn::api::ImageResponse& depth,
+                                                     const DepthDeprojectionOptions& options,
+                                                     DeprojectedPoints* points) {
+    return DeprojectImpl(depth, nullptr, options, points);
+}
+
+::bosdyn::common::Status DepthDeprojector::Deproject(const ::bosdyn::api::ImageResponse& depth,
+                                                     const ::bosdyn::api::ImageResponse& visual,
+                                                     const DepthDeprojectionOptions& options,
+                                                     DeprojectedPoints* points) {
+    return DeprojectImpl(depth, &visual, options, points);
+}
+
+::bosdyn::common::Status DepthDeprojector::DeprojectImpl(
+    const ::bosdyn::api::ImageResponse& depth, const ::bosdyn::api::ImageResponse* visual,
+    const DepthDeprojectionOptions& options, DeprojectedPoints* points) {
+    points->num_points = 0;
+    const auto& image = depth.shot().image();
+    if (image.pixel_format() != ::bosdyn::api::Image::PIXEL_FORMAT_DEPTH_U16) {
+        return InvalidImage("pixel format is not DEPTH_U16.");
+    }
+    if (image.format() != ::bosdyn::api::Image::FORMAT_RAW &&
+        image.format() != ::bosdyn::api::Image::FORMAT_RLE) {
+        return InvalidImage("image format is not RAW or RLE.");
+    }
+    if (depth.source().depth_scale() <= 0.0) return InvalidImage("depth scale is not set.");
+    DepthIntrinsics intrinsics;
+    if (!GetDepthIntrinsics(depth.source(), &intrinsics)) {
+        return InvalidImage("image source has no pinhole intrinsics.");
+    }
+    if (image.cols() <= 0 || image.rows() <= 0) return InvalidImage("image size is not set.");
+    // The image may be a cropped or resized version of the source.
+    intrinsics.cols = image.cols();
+    intrinsics.rows = image.rows();
+    const size_t cols = image.cols();
+    const size_t rows = image.rows();
+    const size_t num_pixels = cols * rows;
+    if (image.format() == ::bosdyn::api::Image::FORMAT_RAW) {
+        if (image.data().size() != num_pixels * sizeof(uint16_t)) {
+            return InvalidImage("data size does not match the image size.");
+        }
+    } else {
+        auto status = CheckRLE(image.data(), num_pixels);
+        if (!status) return status;
+    }
+
+    PointWriter writer{};
+    if (visual) {
+        const auto& visual_image = visual->shot().image();
+        if (visual_image.format() != ::bosdyn::api::Image::FORMAT_RAW) {
+            return InvalidImage("visual image format is not RAW.");
+        }
+        switch (visual_image.pixel_format()) {
+            case ::bosdyn::api::Image::PIXEL_FORMAT_GREYSCALE_U8:
+                writer.visual_channels = 1;
+                break;
+            case ::bosdyn::api::Image::PIXEL_FORMAT_RGB_U8:
+                writer.visual_channels = 3;
+                break;
+            case ::bosdyn::api::Image::PIXEL_FORMAT_RGBA_U8:
+                writer.visual_channels = 4;
+                break;
+            default:
+                return InvalidImage("visual pixel format is not GREYSCALE_U8, RGB_U8 or RGBA_U8.");
+        }
+        if (static_cast<size_t>(visual_image.cols()) != cols ||
+            static_cast<size_t>(visual_image.rows()) != rows ||
+            visual_image.data().size() != num_pixels * writer.visual_channels) {
+            return InvalidImage("visual image size does not match the depth image.");
+        }
+        writer.visual = reinterpret_cast<const uint8_t*>(visual_image.data().data());
+    }
+
+    PointTransform frame_tform_sensor;
+    if (!options.frame.empty()) {
+        ::bosdyn::api::SE3Pose pose;
+        if (!::bosdyn::api::get_a_tform_b(depth.shot().transforms_snapshot(), options.frame,
+                                          depth.shot().frame_name_image_sensor(), &pose)) {
+            return InvalidImage("frame " + options.frame +
+                                " is not in the transforms snapshot of the image.");
+        }
+        frame_tform_sensor = PointTransform::FromSE3Pose(pose);
+        writer.transform = &frame_tform_sensor;
+    }
+
+    // Compare the raw depth values against the limits, so the loops do not convert them first.
+    const double depth_scale = depth.source().depth_scale();
+    const double min_value = std::max(1.0, std::ceil(options.min_depth * depth_scale));
+    const double max_value = std::min(65535.0, std::floor(options.max_depth * depth_scale));
+    if (min_value <= max_value) {
+        writer.min_depth_value = static_cast<uint16_t>(min_value);
+        writer.max_depth_value = static_cast<uint16_t>(max_value);
+    } else {
+        // No depth value is in range.
+        writer.min_depth_value = 1;
+        writer.max_depth_value = 0;
+    }
+    writer.inverse_depth_scale = static_cast<float>(1.0 / depth_scale);
+
+    // The RAW row loops write one point past the last valid point, so leave room for it.
+    if (points->xyz.size() < 3 * (num_pixels + 1)) points->xyz.resize(3 * (num_pixels + 1));
+    if (visual && points->rgb.size() < 3 * (num_pixels + 1)) {
+        points->rgb.resize(3 * (num_pixels + 1));
+    }
+    writer.xyz = points->xyz.data();
+    writer.rgb = points->rgb.data();
+
+    const auto table = GetRayTable(intrinsics);
+    const float* ray_x = table->ray_x.data();
+    const float* ray_y = table->ray_y.data();
+    const auto* data = reinterpret_cast<const uint8_t*>(image.data().data());
+
+    if (image.format() == ::bosdyn::api::Image::FORMAT_RAW) {
+        RowBuffers row(cols);
+        for (size_t v = 0; v < rows; ++v) {
+            const size_t first_pixel = v * cols;
+            DeprojectRawRow(data + 2 * first_pixel, ray_x + first_pixel, ray_y + first_pixel, cols,
+                            first_pixel, &row, &writer);
+        }
+    } else {
+        size_t pixel = 0;
+        for (size_t i = 0; i < image.data().size(); i += kRLERunBytes) {
+            const size_t count = data[i];
+            const uint16_t d = static_cast<uint16_t>(data[i + 1] | (data[i + 2] << 8));
+            if (!writer.IsValid(d)) {
+                pixel += count;
+                continue;
+            }
+            // The rays are stored row after row, so a run that wraps to the next row still reads
+            // consecutive rays.
+            DeprojectRun(ray_x + pixel, ray_y + pixel, count,
+                         static_cast<float>(d) * writer.inverse_depth_scale, pixel, &writer);
+            pixel += count;
+        }
+    }
+    points->num_points = writer.num_points;
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
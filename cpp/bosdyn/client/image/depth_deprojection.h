@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/image.pb.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bosdyn/client/point_cloud/point_cloud_decoder.h"
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Pinhole intrinsics of a depth image, in pixels, as described by ImageSource.PinholeModel.
+struct DepthIntrinsics {
+    int cols = 0;
+    int rows = 0;
+    double focal_length_x = 0.0;
+    double focal_length_y = 0.0;
+    double principal_point_x = 0.0;
+    double principal_point_y = 0.0;
+    double skew_x = 0.0;
+    double skew_y = 0.0;
+
+    bool operator==(const DepthIntrinsics& other) const;
+};
+
+// For each pixel of a depth image, the x/z and y/z of the ray through that pixel in the image
+// sensor frame, stored row by row.
+struct DepthRayTable {
+    DepthIntrinsics intrinsics;
+    std::vector<float> ray_x;
+    std::vector<float> ray_y;
+
+    explicit DepthRayTable(const DepthIntrinsics& intrinsics);
+};
+
+// Points deprojected from a depth image, stored as interleaved x, y, z floats. If a visual image
+// was fused, rgb holds the three color bytes of each point (the grey value three times for
+// greyscale images). The vectors keep their size across calls to avoid reallocating them, so
+// only the first num_points points are valid.
+struct DeprojectedPoints {
+    std::vector<float> xyz;
+    std::vector<uint8_t> rgb;
+    size_t num_points = 0;
+};
+
+struct DepthDeprojectionOptions {
+    // Frame to express the points in, e.g. "odom" or "vision", looked up in the transforms
+    // snapshot of the depth image. The points are in the image sensor frame if this is empty.
+    std::string frame;
+    // Pixels with a depth outside of [min_depth, max_depth] meters are skipped. Pixels with a
+    // depth value of 0 carry no measurement and are always skipped.
+    float min_depth = 0.0f;
+    float max_depth = 1e9f;
+};
+
+// Deprojects PIXEL_FORMAT_DEPTH_U16 image responses with pinhole intrinsics into 3D points.
+//
+// The rays through each pixel only depend on the intrinsics of the source, so they are computed
+// once per intrinsics and cached; deprojecting a pixel is then three multiplies by its depth
+// followed by the optional rigid transform, done over whole rows in branch-free loops that the
+// compiler vectorizes. FORMAT_RAW data is read in place, and FORMAT_RLE data is deprojected run
+// by run without expanding it first; runs of invalid depth are skipped as a whole.
+//
+// A single deprojector can be shared by all depth sources and threads.
+class DepthDeprojector {
+ public:
+    // Deproject the depth image into points. Returns an error if the response is not a RAW or
+    // RLE DEPTH_U16 image with pinhole intrinsics and a depth scale, or if options.frame is not
+    // in the transforms snapshot.
+    ::bosdyn::common::Status Deproject(const ::bosdyn::api::ImageResponse& depth,
+                                       const DepthDeprojectionOptions& options,
+                                       DeprojectedPoints* points);
+
+    // Same as above, and also attach to each point the color of the same pixel of the visual
+    // image, e.g. the visual image of a "depth_in_visual_frame" source paired with its visual
+    // source. The visual image must be a FORMAT_RAW GREYSCALE_U8, RGB_U8 or RGBA_U8 image of the
+    // same size as the depth image.
+    ::bosdyn::common::Status Deproject(const ::bosdyn::api::ImageResponse& depth,
+                                       const ::bosdyn::api::ImageResponse& visual,
+                                       const DepthDeprojectionOptions& options,
+                                       DeprojectedPoints* points);
+
+    // Ray table for the given intrinsics, computed on first use.
+    std::shared_ptr<const DepthRayTable> GetRayTable(const DepthIntrinsics& intrinsics);
+
+    // Number of ray tables in the cache.
+    size_t NumCachedRayTables() const;
+
+    // Drop all cached ray tables.
+    void ClearCache();
+
+ private:
+    struct IntrinsicsHash {
+        size_t operator()(const DepthIntrinsics& intrinsics) const;
+    };
+
+    ::bosdyn::common::Status DeprojectImpl(const ::bosdyn::api::ImageResponse& depth,
+                                           const ::bosdyn::api::ImageResponse* visual,
+                                           const DepthDeprojectionOptions& options,
+                                           DeprojectedPoints* points);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<DepthIntrinsics, std::shared_ptr<const DepthRayTable>, IntrinsicsHash>
+        m_ray_tables;
+};
+
+// Read the pinhole intrinsics and image size of the image source. Returns false if the source has
+// no pinhole model or its intrinsic matrix is singular.
+bool GetDepthIntrinsics(const ::bosdyn::api::ImageSource& source, DepthIntrinsics* intrinsics);
+
+}  // namespace client
+
+}  // namespace bosdyn
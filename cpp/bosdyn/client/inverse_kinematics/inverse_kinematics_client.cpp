@@ -8,8 +8,13 @@
 
 
 #include "inverse_kinematics_client.h"
+
+#include <string>
+#include <unordered_map>
+
 #include "bosdyn/client/error_codes/rpc_error_code.h"
 #include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/client/util/bounded_window.h"
 
 using namespace std::placeholders;
 
@@ -23,6 +28,12 @@ const char* InverseKinematicsClient::s_service_type = "bosdyn.api.InverseKinemat
 
 std::shared_future<InverseKinematicsResultType> InverseKinematicsClient::InverseKinematicsAsync(
     ::bosdyn::api::spot::InverseKinematicsRequest& request, const RPCParameters& parameters) {
+    return InverseKinematicsAsync(request, parameters, nullptr);
+}
+
+std::shared_future<InverseKinematicsResultType> InverseKinematicsClient::InverseKinematicsAsync(
+    ::bosdyn::api::spot::InverseKinematicsRequest& request, const RPCParameters& parameters,
+    InverseKinematicsCallback on_complete) {
     std::promise<InverseKinematicsResultType> response;
     std::shared_future<InverseKinematicsResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -35,7 +46,8 @@ std::shared_future<InverseKinematicsResultType> InverseKinematicsClient::Inverse
         std::bind(
             &::bosdyn::api::spot::InverseKinematicsService::StubInterface::AsyncInverseKinematics,
             m_stub.get(), _1, _2, _3),
-        std::bind(&InverseKinematicsClient::OnInverseKinematicsComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&InverseKinematicsClient::OnInverseKinematicsComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
 
     return future;
@@ -44,11 +56,14 @@ std::shared_future<InverseKinematicsResultType> InverseKinematicsClient::Inverse
 void InverseKinematicsClient::OnInverseKinematicsComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::spot::InverseKinematicsRequest& request,
     ::bosdyn::api::spot::InverseKinematicsResponse&& response, const grpc::Status& status,
-    std::promise<InverseKinematicsResultType> promise) {
+    std::promise<InverseKinematicsResultType> promise,
+    const InverseKinematicsCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::spot::InverseKinematicsResponse>(
             status, response, response.status());
-    promise.set_value({ret_status, std::move(response)});
+    InverseKinematicsResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 InverseKinematicsResultType InverseKinematicsClient::InverseKinematics(
@@ -56,6 +71,59 @@ InverseKinematicsResultType InverseKinematicsClient::InverseKinematics(
     return InverseKinematicsAsync(request, parameters).get();
 }
 
+std::vector<InverseKinematicsResultType> InverseKinematicsClient::InverseKinematicsBatch(
+    const std::vector<::bosdyn::api::spot::InverseKinematicsRequest>& requests,
+    const InverseKinematicsBatchOptions& options) {
+    std::vector<InverseKinematicsResultType> results(requests.size());
+
+    // Indices into requests of the ones to send, each with the indices of the requests it answers.
+    std::vector<size_t> unique;
+    std::vector<std::vector<size_t>> answers;
+    std::unordered_map<std::string, size_t> unique_by_key;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        ::bosdyn::api::spot::InverseKinematicsResponse cached;
+        if (options.cache && options.cache->Lookup(requests[i], &cached)) {
+            results[i] = {::bosdyn::common::Status(cached.status()), std::move(cached)};
+            continue;
+        }
+        ::bosdyn::api::spot::InverseKinematicsRequest without_header = requests[i];
+        without_header.clear_header();
+        auto inserted = unique_by_key.emplace(without_header.SerializeAsString(), unique.size());
+        if (inserted.second) {
+            unique.push_back(i);
+            answers.emplace_back();
+        }
+        answers[inserted.first->second].push_back(i);
+    }
+
+    // Each response is stored from its completion callback, and copied to the requests it
+    // answers on this thread.
+    std::vector<InverseKinematicsResultType> unique_results(unique.size());
+    RunBoundedWindow(
+        unique.size(), options.max_in_flight,
+        [&](size_t unique_index, BoundedWindowDoneFunction done) {
+            // InverseKinematicsAsync() fills in the header of the request it is given.
+            ::bosdyn::api::spot::InverseKinematicsRequest request = requests[unique[unique_index]];
+            StartWithCompletionCallback<InverseKinematicsResultType>(
+                [&](InverseKinematicsCallback on_complete) {
+                    return InverseKinematicsAsync(request, options.parameters, on_complete);
+                },
+                [&unique_results, unique_index, done](const InverseKinematicsResultType& result) {
+                    unique_results[unique_index] = result;
+                    done();
+                });
+        },
+        [&](size_t unique_index) {
+            const InverseKinematicsResultType& result = unique_results[unique_index];
+            // Only definite answers are cached, so failed RPCs are retried by the next batch.
+            if (options.cache) {
+                options.cache->Insert(requests[unique[unique_index]], result.response);
+            }
+            for (size_t i : answers[unique_index]) results[i] = result;
+        });
+    return results;
+}
+
 ServiceClient::QualityOfService InverseKinematicsClient::GetQualityOfService() const {
     return QualityOfService::NORMAL;
 }
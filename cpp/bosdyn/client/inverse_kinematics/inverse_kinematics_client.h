@@ -13,9 +13,12 @@
 #include <bosdyn/api/spot/inverse_kinematics_service.grpc.pb.h>
 #include <bosdyn/api/spot/inverse_kinematics_service.pb.h>
 
+#include <functional>
 #include <future>
+#include <vector>
 
 #include "inverse_kinematics_error_codes.h"
+#include "bosdyn/client/inverse_kinematics/inverse_kinematics_reachability_cache.h"
 #include "bosdyn/client/service_client/service_client.h"
 #include "bosdyn/common/status.h"
 
@@ -27,6 +30,18 @@ namespace client {
 // to the data/response message the RPC was returning from the robot.
 typedef Result<::bosdyn::api::spot::InverseKinematicsResponse> InverseKinematicsResultType;
 
+// Called with the result of an InverseKinematics request as soon as it arrives.
+typedef std::function<void(const InverseKinematicsResultType&)> InverseKinematicsCallback;
+
+struct InverseKinematicsBatchOptions {
+    // Number of InverseKinematics RPCs kept in flight at once.
+    size_t max_in_flight = 8;
+    // If set, requests are answered from the cache when it has a response for their cell, and the
+    // definite responses from the robot are added to it. See InverseKinematicsReachabilityCache.
+    InverseKinematicsReachabilityCache* cache = nullptr;
+    RPCParameters parameters;
+};
+
 /**
  * The InverseKinematics service handles requests to a solution to an inverse kinematics problem for
  * Spot (or an indication that a solution could not be found). This creates a client which
@@ -44,11 +59,26 @@ class InverseKinematicsClient : public ServiceClient {
         ::bosdyn::api::spot::InverseKinematicsRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<InverseKinematicsResultType> InverseKinematicsAsync(
+        ::bosdyn::api::spot::InverseKinematicsRequest& request, const RPCParameters& parameters,
+        InverseKinematicsCallback on_complete);
+
     // Synchronous method to request a solution to an inverse kinematics problem.
     InverseKinematicsResultType InverseKinematics(
         ::bosdyn::api::spot::InverseKinematicsRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // Synchronous method to solve many inverse kinematics problems, e.g. one per candidate tool
+    // pose of a reachability sweep. Up to max_in_flight requests are in flight at once on the
+    // MessagePump of the client, requests that are identical apart from their header are sent
+    // once, and requests with a response in the cache are not sent at all. Returns one result per
+    // request, in the order of the requests.
+    std::vector<InverseKinematicsResultType> InverseKinematicsBatch(
+        const std::vector<::bosdyn::api::spot::InverseKinematicsRequest>& requests,
+        const InverseKinematicsBatchOptions& options = InverseKinematicsBatchOptions());
+
     // Start of ServiceClient overrides.
     // Sets the QualityOfService enum for the inverse kinematics client to be used for network
     // selection optimization.
@@ -75,7 +105,8 @@ class InverseKinematicsClient : public ServiceClient {
                                      const ::bosdyn::api::spot::InverseKinematicsRequest& request,
                                      ::bosdyn::api::spot::InverseKinematicsResponse&& response,
                                      const grpc::Status& status,
-                                     std::promise<InverseKinematicsResultType> promise);
+                                     std::promise<InverseKinematicsResultType> promise,
+                                     const InverseKinematicsCallback& on_complete);
 
     std::unique_ptr<::bosdyn::api::spot::InverseKinematicsService::StubInterface> m_stub;
 
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/inverse_kinematics/inverse_kinematics_reachability_cache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <cmath>
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+double Snap(double value, double resolution) {
+    if (resolution <= 0.0) return value;
+    // Adding 0.0 turns -0.0 into 0.0, so both serialize the same.
+    return std::round(value / resolution) * resolution + 0.0;
+}
+
+void SnapVec3(double resolution, ::bosdyn::api::Vec3* vec) {
+    vec->set_x(Snap(vec->x(), resolution));
+    vec->set_y(Snap(vec->y(), resolution));
+    vec->set_z(Snap(vec->z(), resolution));
+}
+
+void SnapPose(const InverseKinematicsReachabilityCacheOptions& options,
+              ::bosdyn::api::SE3Pose* pose) {
+    SnapVec3(options.position_resolution, pose->mutable_position());
+    ::bosdyn::api::Quaternion* rotation = pose->mutable_rotation();
+    double w = rotation->w(), x = rotation->x(), y = rotation->y(), z = rotation->z();
+    const double norm = std::sqrt(w * w + x * x + y * y + z * z);
+    if (norm == 0.0) return;
+    // q and -q are the same rotation, so pick the one with w >= 0.
+    const double scale = (w < 0.0 ? -1.0 : 1.0) / norm;
+    rotation->set_w(Snap(w * scale, options.rotation_resolution));
+    rotation->set_x(Snap(x * scale, options.rotation_resolution));
+    rotation->set_y(Snap(y * scale, options.rotation_resolution));
+    rotation->set_z(Snap(z * scale, options.rotation_resolution));
+}
+
+}  // namespace
+
+InverseKinematicsReachabilityCache::InverseKinematicsReachabilityCache(
+    const InverseKinematicsReachabilityCacheOptions& options)
+    : m_options(options) {}
+
+std::string InverseKinematicsReachabilityCache::Key(
+    const ::bosdyn::api::spot::InverseKinematicsRequest& request) const {
+    ::bosdyn::api::spot::InverseKinematicsRequest snapped = request;
+    snapped.clear_header();
+    if (snapped.has_scene_tform_task()) SnapPose(m_options, snapped.mutable_scene_tform_task());
+    if (snapped.has_tool_pose_task()) {
+        SnapPose(m_options, snapped.mutable_tool_pose_task()->mutable_task_tform_desired_tool());
+    } else if (snapped.has_tool_gaze_task()) {
+        auto* gaze = snapped.mutable_tool_gaze_task();
+        SnapVec3(m_options.position_resolution, gaze->mutable_target_in_task());
+        if (gaze->has_task_tform_desired_tool()) {
+            SnapPose(m_options, gaze->mutable_task_tform_desired_tool());
+        }
+    }
+
+    std::string key;
+    google::protobuf::io::StringOutputStream output(&key);
+    google::protobuf::io::CodedOutputStream coded_output(&output);
+    coded_output.SetSerializationDeterministic(true);
+    snapped.SerializeToCodedStream(&coded_output);
+    coded_output.Trim();
+    return key;
+}
+
+bool InverseKinematicsReachabilityCache::Lookup(
+    const ::bosdyn::api::spot::InverseKinematicsRequest& request,
+    ::bosdyn::api::spot::InverseKinematicsResponse* response) {
+    const std::string key = Key(request);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        ++m_num_misses;
+        return false;
+    }
+    ++m_num_hits;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    *response = it->second->second;
+    return true;
+}
+
+void InverseKinematicsReachabilityCache::Insert(
+    const ::bosdyn::api::spot::InverseKinematicsRequest& request,
+    const ::bosdyn::api::spot::InverseKinematicsResponse& response) {
+    if (response.status() != ::bosdyn::api::spot::InverseKinematicsResponse::STATUS_OK &&
+        response.status() !=
+            ::bosdyn::api::spot::InverseKinematicsResponse::STATUS_NO_SOLUTION_FOUND) {
+        return;
+    }
+    std::string key = Key(request);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        it->second->second = response;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+    m_entries.emplace_front(std::move(key), response);
+    m_index[m_entries.front().first] = m_entries.begin();
+    while (m_entries.size() > m_options.max_entries) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
+
+void InverseKinematicsReachabilityCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+}
+
+size_t InverseKinematicsReachabilityCache::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+uint64_t InverseKinematicsReachabilityCache::NumHits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_hits;
+}
+
+uint64_t InverseKinematicsReachabilityCache::NumMisses() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_misses;
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/spot/inverse_kinematics.pb.h>
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace bosdyn {
+
+namespace client {
+
+struct InverseKinematicsReachabilityCacheOptions {
+    // Size of the grid cells, in meters, that the positions of the task frame, the desired tool
+    // pose and the gaze target are snapped to.
+    double position_resolution = 0.01;
+    // Size of the grid cells that the components of their rotation quaternions are snapped to.
+    // 0.01 is roughly one degree.
+    double rotation_resolution = 0.01;
+    // The least recently used entries are evicted beyond this many.
+    size_t max_entries = 100000;
+};
+
+/**
+ * Cache of InverseKinematics responses, so repeated reachability sweeps, such as grasp planning
+ * over the same candidate poses, skip the network.
+ *
+ * Requests are keyed by scene_tform_task and the desired tool pose or gaze target, snapped to a
+ * grid, together with the exact value of every other field: the root and scene frames, the
+ * stance, the tool and the nominal configuration. Two requests in the same cell share one entry,
+ * so a hit returns the response to a pose up to one cell away, which is what reachability queries
+ * need, but whose robot_configuration is only approximate for the pose that was asked about.
+ *
+ * Only responses with STATUS_OK or STATUS_NO_SOLUTION_FOUND are cached. The cache is thread-safe.
+ */
+class InverseKinematicsReachabilityCache {
+ public:
+    explicit InverseKinematicsReachabilityCache(
+        const InverseKinematicsReachabilityCacheOptions& options =
+            InverseKinematicsReachabilityCacheOptions());
+
+    // Return true and set response if the cell of the request has a cached response.
+    bool Lookup(const ::bosdyn::api::spot::InverseKinematicsRequest& request,
+                ::bosdyn::api::spot::InverseKinematicsResponse* response);
+
+    // Cache the response to a request, if it is a definite answer.
+    void Insert(const ::bosdyn::api::spot::InverseKinematicsRequest& request,
+                const ::bosdyn::api::spot::InverseKinematicsResponse& response);
+
+    // Return the key of the cell of the request.
+    std::string Key(const ::bosdyn::api::spot::InverseKinematicsRequest& request) const;
+
+    void Clear();
+    size_t Size() const;
+    uint64_t NumHits() const;
+    uint64_t NumMisses() const;
+
+ private:
+    typedef std::pair<std::string, ::bosdyn::api::spot::InverseKinematicsResponse> Entry;
+
+    const InverseKinematicsReachabilityCacheOptions m_options;
+    mutable std::mutex m_mutex;
+    // Most recently used first.
+    std::list<Entry> m_entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    uint64_t m_num_hits = 0;
+    uint64_t m_num_misses = 0;
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
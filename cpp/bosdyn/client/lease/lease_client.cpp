@@ -189,6 +189,12 @@ ListLeasesResultType LeaseClient::ListLeases(bool include_full_lease_info,
 
 std::shared_future<RetainLeaseResultType> LeaseClient::RetainLeaseAsync(
     ::bosdyn::api::RetainLeaseRequest& request, const RPCParameters& parameters) {
+    return RetainLeaseAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RetainLeaseResultType> LeaseClient::RetainLeaseAsync(
+    ::bosdyn::api::RetainLeaseRequest& request, const RPCParameters& parameters,
+    RetainLeaseCallback on_complete) {
     std::promise<RetainLeaseResultType> response;
     std::shared_future<RetainLeaseResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -199,7 +205,8 @@ std::shared_future<RetainLeaseResultType> LeaseClient::RetainLeaseAsync(
             request,
             std::bind(&::bosdyn::api::LeaseService::StubInterface::AsyncRetainLease, m_stub.get(),
                       _1, _2, _3),
-            std::bind(&LeaseClient::OnRetainLeaseComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&LeaseClient::OnRetainLeaseComplete, this, _1, _2, _3, _4, _5,
+                      std::move(on_complete)),
             std::move(response), parameters);
 
     return future;
@@ -209,12 +216,15 @@ void LeaseClient::OnRetainLeaseComplete(MessagePumpCallBase* call,
                                         const ::bosdyn::api::RetainLeaseRequest& request,
                                         ::bosdyn::api::RetainLeaseResponse&& response,
                                         const grpc::Status& status,
-                                        std::promise<RetainLeaseResultType> promise) {
+                                        std::promise<RetainLeaseResultType> promise,
+                                        const RetainLeaseCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseWithLeaseAndGetFinalStatus<::bosdyn::api::RetainLeaseResponse>(
             status, response, response.lease_use_result().status(), m_lease_wallet.get());
 
-    promise.set_value({ret_status, std::move(response)});
+    RetainLeaseResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 RetainLeaseResultType LeaseClient::RetainLease(::bosdyn::api::RetainLeaseRequest& request,
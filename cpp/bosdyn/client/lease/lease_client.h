@@ -13,6 +13,7 @@
 #include <bosdyn/api/lease_service.grpc.pb.h>
 #include <bosdyn/api/lease_service.pb.h>
 
+#include <functional>
 #include <future>
 
 #include "lease.h"
@@ -29,6 +30,7 @@ typedef Result<::bosdyn::api::TakeLeaseResponse> TakeLeaseResultType;
 typedef Result<::bosdyn::api::ReturnLeaseResponse> ReturnLeaseResultType;
 typedef Result<::bosdyn::api::ListLeasesResponse> ListLeasesResultType;
 typedef Result<::bosdyn::api::RetainLeaseResponse> RetainLeaseResultType;
+typedef std::function<void(const RetainLeaseResultType&)> RetainLeaseCallback;
 
 // LeaseClient maintains the liveness of Leases that it manages.
 //
@@ -76,6 +78,12 @@ class LeaseClient : public ServiceClient {
         ::bosdyn::api::RetainLeaseRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<RetainLeaseResultType> RetainLeaseAsync(
+        ::bosdyn::api::RetainLeaseRequest& request, const RPCParameters& parameters,
+        RetainLeaseCallback on_complete);
+
     // Synchronous method to issue a retain lease request.
     RetainLeaseResultType RetainLease(::bosdyn::api::RetainLeaseRequest& request,
                                       const RPCParameters& parameters = RPCParameters());
@@ -131,7 +139,8 @@ class LeaseClient : public ServiceClient {
                                const ::bosdyn::api::RetainLeaseRequest& request,
                                ::bosdyn::api::RetainLeaseResponse&& response,
                                const grpc::Status& status,
-                               std::promise<RetainLeaseResultType> promise);
+                               std::promise<RetainLeaseResultType> promise,
+                               const RetainLeaseCallback& on_complete);
 
 
     std::unique_ptr<::bosdyn::api::LeaseService::StubInterface> m_stub;
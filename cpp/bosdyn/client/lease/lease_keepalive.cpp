@@ -18,7 +18,8 @@ namespace client {
 LeaseKeepAlive::LeaseKeepAlive(LeaseClient* lease_client, std::shared_ptr<LeaseWallet> lease_wallet,
                                const std::string& resource,
                                ::bosdyn::common::Duration rpc_interval_time,
-                               OnRetainLeaseFailure<LeaseKeepAlive> on_failure_fn)
+                               OnRetainLeaseFailure<LeaseKeepAlive> on_failure_fn,
+                               std::shared_ptr<PeriodicScheduler> scheduler)
     : m_resource(resource),
       m_lease_client(lease_client),
       m_rpc_interval(rpc_interval_time),
@@ -32,70 +33,61 @@ LeaseKeepAlive::LeaseKeepAlive(LeaseClient* lease_client, std::shared_ptr<LeaseW
         m_lease_wallet = m_lease_client->GetLeaseWallet();
     }
 
-    // Start the keepalive thread, which will run the periodicCheckin unless
-    // the keep_running callback says otherwise.
-    m_keepalive_thread = std::thread(&LeaseKeepAlive::PeriodicCheckIn, this);
+    // Start the keepalive task, which checks in every interval until it is stopped. A failed
+    // check-in is retried after the same interval.
+    if (!scheduler) scheduler = PeriodicScheduler::GetDefault();
+    PeriodicTaskOptions options;
+    options.period = m_rpc_interval;
+    scheduler->Schedule([this](bool) { return CheckInStep(); }, options, &m_keepalive_task);
 }
 
 LeaseKeepAlive::~LeaseKeepAlive() {
-    m_thread_is_alive = false;
-    m_cv.notify_one();
-    m_keepalive_thread.join();
+    StopKeepAliveThread();
+    // The client completes the retain lease RPC in flight, if any, so wait for it.
+    m_retain_rpc.Wait();
 }
 
 void LeaseKeepAlive::SetRpcInterval(::bosdyn::common::Duration interval) {
     m_rpc_interval = interval;
+    m_keepalive_task.SetPeriod(interval);
 }
 
 void LeaseKeepAlive::StopKeepAliveThread() {
     m_thread_is_alive = false;
-    m_cv.notify_one();
+    m_keepalive_task.Cancel();
 }
 
-void LeaseKeepAlive::PeriodicCheckIn() {
-    while (this->m_thread_is_alive) {
-        // Include the time it takes to execute keep_running, in case it takes a significant
-        // portion of our check in period.
-        auto exec_start_ns = std::chrono::steady_clock::now().time_since_epoch();
+PeriodicTaskResult LeaseKeepAlive::CheckInStep() {
+    if (!m_thread_is_alive) return PeriodicTaskResult::kStop;
+    if (!m_retain_rpc.InFlight()) {
         auto found_lease = m_lease_wallet->GetLease(m_resource);
-        if (found_lease) {
-            // Call the client to retain the lease.
-            ::bosdyn::api::RetainLeaseRequest req;
-            req.mutable_lease()->CopyFrom(found_lease.response.GetProto());
-            auto future = m_lease_client->RetainLeaseAsync(req);
-            while (std::future_status::ready != future.wait_for(std::chrono::milliseconds(100))) {
-                if (!m_thread_is_alive) {
-                    return;
-                }
-            }
-            auto retain_lease_result = future.get();
-            if (!retain_lease_result && !m_lease_wallet->GetOwnedLease(m_resource)) {
-                fprintf(stderr, "LeaseKeepAlive RetainLeases RPC failed: '%s'\n",
-                        retain_lease_result.status.DebugString().c_str());
-                if (m_on_retain_lease_failure_func) {
-                    m_on_retain_lease_failure_func(retain_lease_result, this);
-                }
-            }
-        } else {
+        if (!found_lease) {
             // Provide the lease wallet error code to the on failure function. Use an empty retain
             ::bosdyn::api::RetainLeaseResponse resp;
             if (m_on_retain_lease_failure_func) {
                 m_on_retain_lease_failure_func({found_lease.status, resp}, this);
             }
+            return m_thread_is_alive ? PeriodicTaskResult::kFailure : PeriodicTaskResult::kStop;
         }
+        // Call the client to retain the lease. Its completion triggers the task.
+        ::bosdyn::api::RetainLeaseRequest req;
+        req.mutable_lease()->CopyFrom(found_lease.response.GetProto());
+        m_retain_rpc.Start(&m_keepalive_task, [&](RetainLeaseCallback on_complete) {
+            return m_lease_client->RetainLeaseAsync(req, RPCParameters(), std::move(on_complete));
+        });
+    }
+    if (!m_retain_rpc.Ready()) return PeriodicTaskResult::kWaitForTrigger;
 
-        // How long should the thread wait if it isn't stopped by an external application.
-        std::chrono::nanoseconds exec_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now().time_since_epoch() - exec_start_ns);
-        auto wait_time = this->m_rpc_interval - exec_ns;
-
-        // Block and wait for the stop signal. If we receive it within the check-in period,
-        // leave the loop. This check must be at the end of the loop!
-        // Wait for m_rpc_interval_milliseconds minus the RPC processing time.
-        // (values < 0 are OK and will return immediately)
-        std::unique_lock<std::mutex> lock(this->m_keepalive_mutex);
-        this->m_cv.wait_for(lock, wait_time);
+    auto retain_lease_result = m_retain_rpc.Take();
+    if (retain_lease_result) return PeriodicTaskResult::kSuccess;
+    if (!m_lease_wallet->GetOwnedLease(m_resource)) {
+        fprintf(stderr, "LeaseKeepAlive RetainLeases RPC failed: '%s'\n",
+                retain_lease_result.status.DebugString().c_str());
+        if (m_on_retain_lease_failure_func) {
+            m_on_retain_lease_failure_func(retain_lease_result, this);
+        }
     }
+    return m_thread_is_alive ? PeriodicTaskResult::kFailure : PeriodicTaskResult::kStop;
 }
 
 }  // namespace client
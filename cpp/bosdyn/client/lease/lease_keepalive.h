@@ -9,10 +9,10 @@
 
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include <bosdyn/api/lease.pb.h>
@@ -21,6 +21,7 @@
 #include "bosdyn/client/lease/lease_client.h"
 #include "bosdyn/client/lease/lease_resources.h"
 #include "bosdyn/client/lease/lease_wallet.h"
+#include "bosdyn/client/util/periodic_scheduler.h"
 #include "bosdyn/common/status.h"
 
 namespace bosdyn {
@@ -35,6 +36,10 @@ typedef ::bosdyn::api::Lease LeaseProto;
  * lease keep alive class which is running the background thread as inputs, and the application
  * can respond to the failure (such as stopping the keepalive thread) within the keepalive thread.
  *
+ * The keepalive thread is a thread of a PeriodicScheduler, which by default has 2 threads shared
+ * by every keepalive and refresh in the process. The function must return quickly and not block,
+ * e.g. on a blocking RPC; hand longer work off to a thread of the application.
+ *
  * The input result can have the following error codes:
  *    RpcErrorCodes,
  *    CommonError::Code,
@@ -46,7 +51,7 @@ using OnRetainLeaseFailure =
     std::function<void(const Result<::bosdyn::api::RetainLeaseResponse>& retain_lease_result,
                        LeaseKeepAliveClass* lease_keep_alive)>;
 
-// LeaseKeepAlive issues lease liveness checks on a background thread.
+// LeaseKeepAlive issues lease liveness checks in the background.
 // The robot's lease system expects lease holders to check in at a regular
 // cadence. If the check-ins do not happen, the robot will treat it as a
 // communications loss. Typically this will result in the robot stopping,
@@ -54,6 +59,10 @@ using OnRetainLeaseFailure =
 // Using a LeaseKeepAlive object hides most of the details of issuing the
 // lease liveness check. Developers can also manage liveness checks directly
 // by using the retain_lease methods on the LeaseClient object.
+//
+// The check-ins are a task of a PeriodicScheduler, shared by default with every other keepalive
+// in the process, rather than a thread per keepalive. The "keepalive thread" of the methods below
+// refers to that task.
 class LeaseKeepAlive {
  public:
     // Constructor for the keepalive thread. This requires an argument for the lease_client to be
@@ -61,11 +70,14 @@ class LeaseKeepAlive {
     // lease wallet can (optionally) be passed; if nothing is provided, then the lease wallet of the
     // client will be used. Finally, the resource that the keepalive should be maintaining can
     // (optionally) be passed. If it is not passed, the thread defaults to preserving the "body".
+    // The check-ins run on the given scheduler, or on PeriodicScheduler::GetDefault() if none is
+    // provided.
     explicit LeaseKeepAlive(LeaseClient* lease_client,
                             std::shared_ptr<LeaseWallet> lease_wallet = nullptr,
                             const std::string& resource = ::bosdyn::client::kBodyResource,
                             ::bosdyn::common::Duration rpc_interval_time = std::chrono::seconds(2),
-                            OnRetainLeaseFailure<LeaseKeepAlive> on_failure_fn = nullptr);
+                            OnRetainLeaseFailure<LeaseKeepAlive> on_failure_fn = nullptr,
+                            std::shared_ptr<PeriodicScheduler> scheduler = nullptr);
 
     // Destructor for the keepalive thread, to shutdown the thread nicely.
     ~LeaseKeepAlive();
@@ -85,8 +97,8 @@ class LeaseKeepAlive {
     // Get the resource this keepalive maintains.
     const std::string& GetKeepAliveResource() { return m_resource; }
 
-    // The main component of the keepalive class is std::thread, which is not copyable.
-    // Therefore, the keepalive class is also not moveable or copyable.
+    // The scheduled task refers to the keepalive, so the keepalive class is not moveable or
+    // copyable.
     LeaseKeepAlive(const LeaseKeepAlive&) = delete;
     LeaseKeepAlive operator=(const LeaseKeepAlive&) = delete;
 
@@ -105,24 +117,22 @@ class LeaseKeepAlive {
     // Duration in seconds between liveness checks. This defaults to 2 seconds, but can be updated.
     ::bosdyn::common::Duration m_rpc_interval;
 
-    // Keepalive thread.
-    std::thread m_keepalive_thread;
-
-    // Main loop for the keepalive thread, which will try to retain the lease for the specified
-    // resource, and then wait for a fixed amount of time.
-    void PeriodicCheckIn();
+    // Step of the keepalive task, which starts a retain lease RPC for the specified resource, and
+    // is called again when it completes.
+    PeriodicTaskResult CheckInStep();
 
-    // Lock for the condition variable
-    std::mutex m_keepalive_mutex;
-
-    // Condition Variable for checking if the thread should still be sleeping or be stopped.
-    std::condition_variable m_cv;
+    // The retain lease RPC in flight, if any. Only used by CheckInStep, and by the destructor once
+    // the task is cancelled.
+    PeriodicTaskRpc<RetainLeaseResultType> m_retain_rpc;
 
     // Boolean indicating it the thread is still running or if it has returned.
-    bool m_thread_is_alive = true;
+    std::atomic<bool> m_thread_is_alive{true};
 
     // Function to be called when the retain lease RPC does not succeed.
     OnRetainLeaseFailure<LeaseKeepAlive> m_on_retain_lease_failure_func = nullptr;
+
+    // Keepalive task. Declared last, so it is cancelled before the members it uses are destroyed.
+    PeriodicTaskHandle m_keepalive_task;
 };
 
 }  // namespace client
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/local_grid/local_grid_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/common/time.h"
+#include "bosdyn/math/frame_helpers.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+::bosdyn::common::Status MalformedGrid(const std::string& message) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                    "Malformed local grid: " + message);
+}
+
+// Scaling is done in double precision only for FLOAT64 cells.
+template <class Cell>
+using ScaleType = typename std::conditional<std::is_same<Cell, double>::value, double, float>::type;
+
+// Copy num_cells cells of packed data into raw, and scale them into values.
+template <class Cell>
+void DecodeRaw(const uint8_t* data, size_t num_cells, double scale, double offset, Cell* raw,
+               float* values) {
+    std::memcpy(raw, data, num_cells * sizeof(Cell));
+    const auto typed_scale = static_cast<ScaleType<Cell>>(scale);
+    const auto typed_offset = static_cast<ScaleType<Cell>>(offset);
+    for (size_t i = 0; i < num_cells; ++i) {
+        values[i] = static_cast<float>(static_cast<ScaleType<Cell>>(raw[i]) * typed_scale +
+                                       typed_offset);
+    }
+}
+
+// Expand runs of cells into raw and values. Each run is scaled once and then filled, which turns
+// into memset for byte cells and into wide stores otherwise.
+template <class Cell>
+void DecodeRLE(const uint8_t* data, const google::protobuf::RepeatedField<int32_t>& counts,
+               double scale, double offset, Cell* raw, float* values) {
+    const auto typed_scale = static_cast<ScaleType<Cell>>(scale);
+    const auto typed_offset = static_cast<ScaleType<Cell>>(offset);
+    size_t cell = 0;
+    for (int run = 0; run < counts.size(); ++run) {
+        Cell value;
+        std::memcpy(&value, data + run * sizeof(Cell), sizeof(Cell));
+        const size_t count = counts[run];
+        std::fill_n(raw + cell, count, value);
+        std::fill_n(values + cell, count,
+                    static_cast<float>(static_cast<ScaleType<Cell>>(value) * typed_scale +
+                                       typed_offset));
+        cell += count;
+    }
+}
+
+template <class Cell>
+::bosdyn::common::Status DecodeCells(const ::bosdyn::api::LocalGrid& grid, size_t num_cells,
+                                     Cell* raw, float* values) {
+    const auto* data = reinterpret_cast<const uint8_t*>(grid.data().data());
+    const double scale = grid.cell_value_scale() != 0.0 ? grid.cell_value_scale() : 1.0;
+    const double offset = grid.cell_value_offset();
+
+    if (grid.encoding() == ::bosdyn::api::LocalGrid::ENCODING_RAW) {
+        if (grid.data().size() != num_cells * sizeof(Cell)) {
+            return MalformedGrid("data size does not match the extent.");
+        }
+        DecodeRaw(data, num_cells, scale, offset, raw, values);
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+
+    if (grid.encoding() != ::bosdyn::api::LocalGrid::ENCODING_RLE) {
+        return MalformedGrid("unsupported encoding.");
+    }
+    const auto& counts = grid.rle_counts();
+    if (grid.data().size() != counts.size() * sizeof(Cell)) {
+        return MalformedGrid("data size does not match rle_counts.");
+    }
+    size_t total = 0;
+    for (int32_t count : counts) {
+        if (count < 0) return MalformedGrid("negative rle count.");
+        total += count;
+    }
+    if (total != num_cells) {
+        return MalformedGrid("rle_counts do not add up to the extent.");
+    }
+    DecodeRLE(data, counts, scale, offset, raw, values);
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+// Set the pose of the grid in frame, or clear it if frame is empty.
+::bosdyn::common::Status SetFrameTformGrid(const ::bosdyn::api::LocalGrid& grid,
+                                           const std::string& frame, ::bosdyn::api::SE3Pose* pose,
+                                           bool* has_pose) {
+    *has_pose = false;
+    if (frame.empty()) return ::bosdyn::common::Status(SDKErrorCode::Success);
+    if (!::bosdyn::api::get_a_tform_b(grid.transforms_snapshot(), frame,
+                                      grid.frame_name_local_grid_data(), pose)) {
+        return ::bosdyn::common::Status(
+            SDKErrorCode::GenericSDKError,
+            "Frame " + frame + " is not in the transforms snapshot of the local grid.");
+    }
+    *has_pose = true;
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+}  // namespace
+
+size_t LocalGridBytesPerCell(::bosdyn::api::LocalGrid::CellFormat cell_format) {
+    switch (cell_format) {
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_FLOAT32:
+            return sizeof(float);
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_FLOAT64:
+            return sizeof(double);
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_INT8:
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_UINT8:
+            return 1;
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_INT16:
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_UINT16:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+::bosdyn::common::Status DecodeLocalGrid(const ::bosdyn::api::LocalGrid& grid,
+                                         const std::string& frame, DecodedLocalGrid* decoded,
+                                         bool* changed) {
+    const int64_t acquisition_time_nsec =
+        ::bosdyn::common::TimestampToNsec(grid.acquisition_time());
+    if (decoded->m_is_valid && decoded->m_acquisition_time_nsec == acquisition_time_nsec &&
+        decoded->m_local_grid_type_name == grid.local_grid_type_name()) {
+        if (changed) *changed = false;
+        if (decoded->m_frame == frame) return ::bosdyn::common::Status(SDKErrorCode::Success);
+        ::bosdyn::common::Status status = SetFrameTformGrid(
+            grid, frame, &decoded->m_frame_tform_grid, &decoded->m_has_frame_tform_grid);
+        if (!status) {
+            decoded->m_is_valid = false;
+            decoded->m_cell_format = ::bosdyn::api::LocalGrid::CELL_FORMAT_UNKNOWN;
+            return status;
+        }
+        decoded->m_frame = frame;
+        return status;
+    }
+    if (changed) *changed = true;
+    // Until decoding succeeds, the views of the object are empty.
+    decoded->m_is_valid = false;
+    decoded->m_has_frame_tform_grid = false;
+    decoded->m_cell_format = ::bosdyn::api::LocalGrid::CELL_FORMAT_UNKNOWN;
+    decoded->m_num_cells_x = 0;
+    decoded->m_num_cells_y = 0;
+
+    const size_t bytes_per_cell = LocalGridBytesPerCell(grid.cell_format());
+    if (bytes_per_cell == 0) return MalformedGrid("unsupported cell format.");
+    const auto& extent = grid.extent();
+    if (extent.num_cells_x() < 0 || extent.num_cells_y() < 0) {
+        return MalformedGrid("negative extent.");
+    }
+    const size_t num_cells = static_cast<size_t>(extent.num_cells_x()) * extent.num_cells_y();
+    if (!grid.unknown_cells().empty() && grid.unknown_cells().size() != num_cells) {
+        return MalformedGrid("unknown_cells size does not match the extent.");
+    }
+
+    decoded->m_raw.resize((num_cells * bytes_per_cell + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    decoded->m_values.resize(num_cells);
+    void* raw = decoded->m_raw.data();
+    float* values = decoded->m_values.data();
+    ::bosdyn::common::Status status;
+    switch (grid.cell_format()) {
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_FLOAT32:
+            status = DecodeCells(grid, num_cells, static_cast<float*>(raw), values);
+            break;
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_FLOAT64:
+            status = DecodeCells(grid, num_cells, static_cast<double*>(raw), values);
+            break;
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_INT8:
+            status = DecodeCells(grid, num_cells, static_cast<int8_t*>(raw), values);
+            break;
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_UINT8:
+            status = DecodeCells(grid, num_cells, static_cast<uint8_t*>(raw), values);
+            break;
+        case ::bosdyn::api::LocalGrid::CELL_FORMAT_INT16:
+            status = DecodeCells(grid, num_cells, static_cast<int16_t*>(raw), values);
+            break;
+        default:
+            status = DecodeCells(grid, num_cells, static_cast<uint16_t*>(raw), values);
+            break;
+    }
+    if (!status) return status;
+
+    status = SetFrameTformGrid(grid, frame, &decoded->m_frame_tform_grid,
+                               &decoded->m_has_frame_tform_grid);
+    if (!status) return status;
+    decoded->m_frame = frame;
+
+    decoded->m_unknown_cells.assign(grid.unknown_cells().begin(), grid.unknown_cells().end());
+    decoded->m_local_grid_type_name = grid.local_grid_type_name();
+    decoded->m_acquisition_time_nsec = acquisition_time_nsec;
+    decoded->m_frame_name_local_grid_data = grid.frame_name_local_grid_data();
+    decoded->m_cell_format = grid.cell_format();
+    decoded->m_cell_size = extent.cell_size();
+    decoded->m_num_cells_x = extent.num_cells_x();
+    decoded->m_num_cells_y = extent.num_cells_y();
+    decoded->m_is_valid = true;
+    return status;
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/api/local_grid.pb.h>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Read-only 2D view of the cells of a local grid. Cell (xi, yj) is at data[xi + num_cells_x * yj]
+// and has its center at ((xi + 0.5) * cell_size, (yj + 0.5) * cell_size) in the grid frame.
+template <class T>
+class LocalGridView {
+ public:
+    LocalGridView() = default;
+    LocalGridView(const T* data, int num_cells_x, int num_cells_y)
+        : m_data(data), m_num_cells_x(num_cells_x), m_num_cells_y(num_cells_y) {}
+
+    const T& at(int xi, int yj) const { return m_data[xi + m_num_cells_x * yj]; }
+    // Cells with the given y index, in order of x.
+    const T* row(int yj) const { return m_data + m_num_cells_x * yj; }
+
+    const T* data() const { return m_data; }
+    int num_cells_x() const { return m_num_cells_x; }
+    int num_cells_y() const { return m_num_cells_y; }
+    // A default-constructed view, or the view of a grid of another cell format, is empty.
+    bool empty() const { return m_data == nullptr; }
+
+ private:
+    const T* m_data = nullptr;
+    int m_num_cells_x = 0;
+    int m_num_cells_y = 0;
+};
+
+// A local grid decoded by DecodeLocalGrid(). Reusing the same object for every update of a grid
+// keeps its buffers, so decoding does not allocate once they have grown to the grid size.
+class DecodedLocalGrid {
+ public:
+    // Cell values with cell_value_scale and cell_value_offset applied. FLOAT64 grids are scaled
+    // in double precision before being stored as floats. All views are empty while the object
+    // does not hold a valid grid.
+    LocalGridView<float> values() const {
+        if (!m_is_valid) return LocalGridView<float>();
+        return LocalGridView<float>(m_values.data(), m_num_cells_x, m_num_cells_y);
+    }
+
+    // Unscaled cells in their cell format, e.g. raw<int16_t>() for CELL_FORMAT_INT16. Returns an
+    // empty view if T does not match the cell format.
+    template <class T>
+    LocalGridView<T> raw() const {
+        if (!m_is_valid || !IsCellType<T>()) return LocalGridView<T>();
+        return LocalGridView<T>(reinterpret_cast<const T*>(m_raw.data()), m_num_cells_x,
+                                m_num_cells_y);
+    }
+
+    // Nonzero for cells whose value is unknown. Empty if the grid has no unknown cell map.
+    LocalGridView<uint8_t> unknown_cells() const {
+        if (!m_is_valid || m_unknown_cells.empty()) return LocalGridView<uint8_t>();
+        return LocalGridView<uint8_t>(m_unknown_cells.data(), m_num_cells_x, m_num_cells_y);
+    }
+
+    const std::string& local_grid_type_name() const { return m_local_grid_type_name; }
+    int64_t acquisition_time_nsec() const { return m_acquisition_time_nsec; }
+    ::bosdyn::api::LocalGrid::CellFormat cell_format() const { return m_cell_format; }
+    double cell_size() const { return m_cell_size; }
+    int num_cells_x() const { return m_num_cells_x; }
+    int num_cells_y() const { return m_num_cells_y; }
+
+    // Name of the grid frame, whose origin is the corner of cell (0, 0).
+    const std::string& frame_name_local_grid_data() const { return m_frame_name_local_grid_data; }
+    // Transform from the grid frame to the frame passed to DecodeLocalGrid(), taken from the
+    // transforms snapshot of the grid. Only valid if has_frame_tform_grid().
+    const ::bosdyn::api::SE3Pose& frame_tform_grid() const { return m_frame_tform_grid; }
+    bool has_frame_tform_grid() const { return m_has_frame_tform_grid; }
+
+ private:
+    friend ::bosdyn::common::Status DecodeLocalGrid(const ::bosdyn::api::LocalGrid& grid,
+                                                    const std::string& frame,
+                                                    DecodedLocalGrid* decoded, bool* changed);
+
+    template <class T>
+    bool IsCellType() const {
+        switch (m_cell_format) {
+            case ::bosdyn::api::LocalGrid::CELL_FORMAT_FLOAT32:
+                return std::is_same<T, float>::value;
+            case ::bosdyn::api::LocalGrid::CELL_FORMAT_FLOAT64:
+                return std::is_same<T, double>::value;
+            case ::bosdyn::api::LocalGrid::CELL_FORMAT_INT8:
+                return std::is_same<T, int8_t>::value;
+            case ::bosdyn::api::LocalGrid::CELL_FORMAT_UINT8:
+                return std::is_same<T, uint8_t>::value;
+            case ::bosdyn::api::LocalGrid::CELL_FORMAT_INT16:
+                return std::is_same<T, int16_t>::value;
+            case ::bosdyn::api::LocalGrid::CELL_FORMAT_UINT16:
+                return std::is_same<T, uint16_t>::value;
+            default:
+                return false;
+        }
+    }
+
+    // False until a grid has been decoded successfully into this object.
+    bool m_is_valid = false;
+    std::string m_local_grid_type_name;
+    int64_t m_acquisition_time_nsec = 0;
+    std::string m_frame_name_local_grid_data;
+    // The frame passed to DecodeLocalGrid(), which m_frame_tform_grid is expressed in.
+    std::string m_frame;
+    ::bosdyn::api::SE3Pose m_frame_tform_grid;
+    bool m_has_frame_tform_grid = false;
+    ::bosdyn::api::LocalGrid::CellFormat m_cell_format =
+        ::bosdyn::api::LocalGrid::CELL_FORMAT_UNKNOWN;
+    double m_cell_size = 0.0;
+    int m_num_cells_x = 0;
+    int m_num_cells_y = 0;
+
+    // Unscaled cells, stored in 8-byte words so that they are aligned for any cell type.
+    std::vector<uint64_t> m_raw;
+    std::vector<float> m_values;
+    std::vector<uint8_t> m_unknown_cells;
+};
+
+// Decode a RAW or RLE encoded local grid into the given object, expressing its pose in the given
+// frame if that is not empty.
+//
+// If the object already holds a grid of the same type with the same acquisition time, the grid is
+// assumed unchanged and is not decoded again, and only its pose is updated if the frame differs;
+// changed, if not null, is set to whether the grid was decoded. Returns an error, and invalidates
+// the object, if the grid is malformed or the frame is not in its transforms snapshot.
+::bosdyn::common::Status DecodeLocalGrid(const ::bosdyn::api::LocalGrid& grid,
+                                         const std::string& frame, DecodedLocalGrid* decoded,
+                                         bool* changed = nullptr);
+
+// Number of bytes per cell of the given cell format, or 0 if the format is unknown.
+size_t LocalGridBytesPerCell(::bosdyn::api::LocalGrid::CellFormat cell_format);
+
+}  // namespace client
+
+}  // namespace bosdyn
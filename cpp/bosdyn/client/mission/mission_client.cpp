@@ -56,9 +56,16 @@ void MissionClient::OnLoadMissionComplete(MessagePumpCallBase* call,
                                           ::bosdyn::api::mission::LoadMissionResponse&& response,
                                           const grpc::Status& status,
                                           std::promise<LoadMissionResultType> promise) {
-    ::bosdyn::common::Status ret_status =
-        ProcessResponseWithMultiLeaseAndGetFinalStatus<::bosdyn::api::mission::LoadMissionResponse>(
-            status, response, response.status(), m_lease_wallet.get());
+    // An error producing the chunks is returned as is rather than as the RPC error it caused.
+    ::bosdyn::common::Status ret_status;
+    if (!static_cast<RequestStreamCall<::bosdyn::api::DataChunk,
+                                       ::bosdyn::api::mission::LoadMissionResponse,
+                                       ::bosdyn::api::mission::LoadMissionResponse>*>(call)
+             ->GetProducerError(&ret_status)) {
+        ret_status = ProcessResponseWithMultiLeaseAndGetFinalStatus<
+            ::bosdyn::api::mission::LoadMissionResponse>(status, response, response.status(),
+                                                         m_lease_wallet.get());
+    }
     promise.set_value({ret_status, std::move(response)});
 }
 
@@ -134,9 +141,16 @@ void MissionClient::OnLoadMissionAsChunksComplete(
     MessagePumpCallBase* call, const std::vector<::bosdyn::api::DataChunk>&& request,
     ::bosdyn::api::mission::LoadMissionResponse&& response, const grpc::Status& status,
     std::promise<LoadMissionResultType> promise) {
-    ::bosdyn::common::Status ret_status =
-        ProcessResponseWithMultiLeaseAndGetFinalStatus<::bosdyn::api::mission::LoadMissionResponse>(
-            status, response, response.status(), m_lease_wallet.get());
+    // An error producing the chunks is returned as is rather than as the RPC error it caused.
+    ::bosdyn::common::Status ret_status;
+    if (!static_cast<RequestStreamCall<::bosdyn::api::DataChunk,
+                                       ::bosdyn::api::mission::LoadMissionResponse,
+                                       ::bosdyn::api::mission::LoadMissionResponse>*>(call)
+             ->GetProducerError(&ret_status)) {
+        ret_status = ProcessResponseWithMultiLeaseAndGetFinalStatus<
+            ::bosdyn::api::mission::LoadMissionResponse>(status, response, response.status(),
+                                                         m_lease_wallet.get());
+    }
     promise.set_value({ret_status, std::move(response)});
 }
 
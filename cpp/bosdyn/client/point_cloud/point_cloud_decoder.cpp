@@ -0,0 +1,671 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/point_cloud/point_cloud_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BOSDYN_POINT_CLOUD_AVX2 1
+#include <immintrin.h>
+// Compile a function for AVX2 and FMA regardless of the flags the SDK is built with. It must only
+// be called after checking that the CPU supports them.
+#define BOSDYN_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#if defined(__ARM_NEON)
+#define BOSDYN_POINT_CLOUD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/math/frame_helpers.h"
+#include "bosdyn/math/proto_math.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+// Number of points unpacked into the per-axis arrays at a time. Small enough for the arrays to
+// stay in L1 cache.
+constexpr size_t kBlockSize = 256;
+
+struct PointBlock {
+    float x[kBlockSize];
+    float y[kBlockSize];
+    float z[kBlockSize];
+};
+
+// Per-axis constants of the 4SC and 5SC encodings.
+struct ScaledEncoding {
+    // Scale of the high byte p1, in meters: m * f / (c * f).
+    float byte_scale[3];
+    // Scale of one step of the extra value p2, in meters: m / (c * f).
+    float step_scale[3];
+    // Integer scale factor f, and the offset floor(f / 2) subtracted from each digit of p2.
+    int64_t scale_factor;
+    int64_t half_scale_factor;
+};
+
+::bosdyn::common::Status GetScaledEncoding(const ::bosdyn::api::PointCloud& point_cloud,
+                                           ScaledEncoding* encoding) {
+    const auto& parameters = point_cloud.encoding_parameters();
+    const int64_t f = parameters.scale_factor();
+    const double c = parameters.remapping_constant();
+    if (f <= 0 || c <= 0.0) {
+        return ::bosdyn::common::Status(
+            SDKErrorCode::GenericSDKError,
+            "Point cloud scale_factor and remapping_constant must be positive.");
+    }
+    const double max[3] = {parameters.max_x(), parameters.max_y(), parameters.max_z()};
+    for (int axis = 0; axis < 3; ++axis) {
+        const double step = max[axis] / (c * static_cast<double>(f));
+        encoding->step_scale[axis] = static_cast<float>(step);
+        encoding->byte_scale[axis] = static_cast<float>(step * static_cast<double>(f));
+    }
+    encoding->scale_factor = f;
+    encoding->half_scale_factor = f / 2;
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+// The high byte p1 of a 4SC or 5SC coordinate is a signed int8.
+inline float HighByte(uint8_t byte) { return static_cast<float>(static_cast<int8_t>(byte)); }
+
+inline float Truncate(float value) { return static_cast<float>(static_cast<int32_t>(value)); }
+
+std::atomic<PointCloudKernel> g_kernel{PointCloudKernel::kAuto};
+
+bool CpuSupportsAvx2() {
+#ifdef BOSDYN_POINT_CLOUD_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool BuiltWithNeon() {
+#ifdef BOSDYN_POINT_CLOUD_NEON
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TransformPointsScalar(const PointTransform& transform, size_t num_points, float* x, float* y,
+                           float* z) {
+    // Copy the transform to locals, so the compiler knows the stores to the points do not change
+    // it.
+    const float r0 = transform.rotation[0], r1 = transform.rotation[1], r2 = transform.rotation[2];
+    const float r3 = transform.rotation[3], r4 = transform.rotation[4], r5 = transform.rotation[5];
+    const float r6 = transform.rotation[6], r7 = transform.rotation[7], r8 = transform.rotation[8];
+    const float tx = transform.translation[0];
+    const float ty = transform.translation[1];
+    const float tz = transform.translation[2];
+    for (size_t i = 0; i < num_points; ++i) {
+        const float px = x[i];
+        const float py = y[i];
+        const float pz = z[i];
+        x[i] = r0 * px + r1 * py + r2 * pz + tx;
+        y[i] = r3 * px + r4 * py + r5 * pz + ty;
+        z[i] = r6 * px + r7 * py + r8 * pz + tz;
+    }
+}
+
+#ifdef BOSDYN_POINT_CLOUD_AVX2
+
+// Sign-extend byte kByte of each 32-bit lane.
+template <int kByte>
+BOSDYN_TARGET_AVX2 inline __m256 SignedByteToFloat(__m256i lanes) {
+    return _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(lanes, 24 - 8 * kByte), 24));
+}
+
+// The AVX2 kernels process the points in groups of 8 and return how many points they processed.
+// The remaining points are left to the scalar code.
+
+BOSDYN_TARGET_AVX2 size_t Unpack4SCAvx2(const uint8_t* data, size_t num_points,
+                                        const float byte_scale[3],
+                                        const float extra_offset[3][256], float* x, float* y,
+                                        float* z) {
+    const __m256 x_scale = _mm256_set1_ps(byte_scale[0]);
+    const __m256 y_scale = _mm256_set1_ps(byte_scale[1]);
+    const __m256 z_scale = _mm256_set1_ps(byte_scale[2]);
+    size_t i = 0;
+    for (; i + 8 <= num_points; i += 8) {
+        // One point per lane: x, y and z bytes, then the extra byte.
+        const __m256i points =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 4));
+        const __m256i extra = _mm256_srli_epi32(points, 24);
+        _mm256_storeu_ps(x + i, _mm256_fmadd_ps(SignedByteToFloat<0>(points), x_scale,
+                                                _mm256_i32gather_ps(extra_offset[0], extra, 4)));
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(SignedByteToFloat<1>(points), y_scale,
+                                                _mm256_i32gather_ps(extra_offset[1], extra, 4)));
+        _mm256_storeu_ps(z + i, _mm256_fmadd_ps(SignedByteToFloat<2>(points), z_scale,
+                                                _mm256_i32gather_ps(extra_offset[2], extra, 4)));
+    }
+    return i;
+}
+
+BOSDYN_TARGET_AVX2 size_t Unpack5SCAvx2(const uint8_t* data, size_t num_points,
+                                        const ScaledEncoding& encoding, float* x, float* y,
+                                        float* z) {
+    const __m256i offsets = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 30, 35);
+    const __m256 scale_factor = _mm256_set1_ps(static_cast<float>(encoding.scale_factor));
+    const __m256 inv_scale_factor =
+        _mm256_set1_ps(1.0f / static_cast<float>(encoding.scale_factor));
+    const __m256 half = _mm256_set1_ps(static_cast<float>(encoding.half_scale_factor));
+    const __m256 one_half = _mm256_set1_ps(0.5f);
+    __m256 byte_scale[3];
+    __m256 step_scale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        byte_scale[axis] = _mm256_set1_ps(encoding.byte_scale[axis]);
+        step_scale[axis] = _mm256_set1_ps(encoding.step_scale[axis]);
+    }
+    float* out[3] = {x, y, z};
+    size_t i = 0;
+    for (; i + 8 <= num_points; i += 8) {
+        // Gather the x, y, z and low extra bytes of each point into one lane, and its y, z, low
+        // and high extra bytes into another. Neither reads past the last point.
+        const uint8_t* points = data + i * 5;
+        const __m256i xyz_low =
+            _mm256_i32gather_epi32(reinterpret_cast<const int*>(points), offsets, 1);
+        const __m256i yz_extra =
+            _mm256_i32gather_epi32(reinterpret_cast<const int*>(points + 1), offsets, 1);
+        const __m256 high[3] = {SignedByteToFloat<0>(xyz_low), SignedByteToFloat<0>(yz_extra),
+                                SignedByteToFloat<1>(yz_extra)};
+
+        // Split the extra value into base-f digits as the scalar code does; the products of
+        // integers below 2^16 are exact, so the fused multiply-subtract is too.
+        __m256 remaining = _mm256_cvtepi32_ps(_mm256_srli_epi32(yz_extra, 16));
+        for (int axis = 0; axis < 3; ++axis) {
+            const __m256 quotient =
+                _mm256_round_ps(_mm256_mul_ps(_mm256_add_ps(remaining, one_half), inv_scale_factor),
+                                _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256 digit = _mm256_fnmadd_ps(quotient, scale_factor, remaining);
+            remaining = quotient;
+            const __m256 offset = _mm256_mul_ps(_mm256_sub_ps(digit, half), step_scale[axis]);
+            _mm256_storeu_ps(out[axis] + i, _mm256_fmadd_ps(high[axis], byte_scale[axis], offset));
+        }
+    }
+    return i;
+}
+
+BOSDYN_TARGET_AVX2 size_t TransformPointsAvx2(const PointTransform& transform, size_t num_points,
+                                              float* x, float* y, float* z) {
+    __m256 r[9];
+    for (int k = 0; k < 9; ++k) r[k] = _mm256_set1_ps(transform.rotation[k]);
+    const __m256 tx = _mm256_set1_ps(transform.translation[0]);
+    const __m256 ty = _mm256_set1_ps(transform.translation[1]);
+    const __m256 tz = _mm256_set1_ps(transform.translation[2]);
+    size_t i = 0;
+    for (; i + 8 <= num_points; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+        _mm256_storeu_ps(x + i, _mm256_fmadd_ps(r[0], px, _mm256_fmadd_ps(r[1], py,
+                                                                   _mm256_fmadd_ps(r[2], pz, tx))));
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(r[3], px, _mm256_fmadd_ps(r[4], py,
+                                                                   _mm256_fmadd_ps(r[5], pz, ty))));
+        _mm256_storeu_ps(z + i, _mm256_fmadd_ps(r[6], px, _mm256_fmadd_ps(r[7], py,
+                                                                   _mm256_fmadd_ps(r[8], pz, tz))));
+    }
+    return i;
+}
+
+#endif
+
+#ifdef BOSDYN_POINT_CLOUD_NEON
+
+// NEON is part of the target the SDK is built for, so the NEON kernels need no check of the CPU.
+// They use only intrinsics of both 32-bit ARM and aarch64, process the points in groups of 8, or
+// 4 for the transform, and return how many points they processed. The remaining points are left
+// to the scalar code.
+
+struct NeonEncoding {
+    float32x4_t byte_scale[3];
+    float32x4_t step_scale[3];
+    float32x4_t scale_factor;
+    float32x4_t inv_scale_factor;
+    float32x4_t half;
+};
+
+inline NeonEncoding LoadNeonEncoding(const ScaledEncoding& encoding) {
+    NeonEncoding neon;
+    for (int axis = 0; axis < 3; ++axis) {
+        neon.byte_scale[axis] = vdupq_n_f32(encoding.byte_scale[axis]);
+        neon.step_scale[axis] = vdupq_n_f32(encoding.step_scale[axis]);
+    }
+    neon.scale_factor = vdupq_n_f32(static_cast<float>(encoding.scale_factor));
+    neon.inv_scale_factor = vdupq_n_f32(1.0f / static_cast<float>(encoding.scale_factor));
+    neon.half = vdupq_n_f32(static_cast<float>(encoding.half_scale_factor));
+    return neon;
+}
+
+// Store 4 points decoded from their high bytes, as floats, and their extra values. The extra
+// values are split into base-f digits as the scalar 5SC code does; for 4SC this gives the same
+// offsets as its table.
+inline void StoreScaledNeon(const NeonEncoding& encoding, const float32x4_t high[3],
+                            float32x4_t remaining, float* x, float* y, float* z) {
+    float* out[3] = {x, y, z};
+    for (int axis = 0; axis < 3; ++axis) {
+        // vcvtq_s32_f32 truncates.
+        const float32x4_t quotient = vcvtq_f32_s32(vcvtq_s32_f32(
+            vmulq_f32(vaddq_f32(remaining, vdupq_n_f32(0.5f)), encoding.inv_scale_factor)));
+        const float32x4_t digit = vmlsq_f32(remaining, quotient, encoding.scale_factor);
+        remaining = quotient;
+        const float32x4_t offset =
+            vmulq_f32(vsubq_f32(digit, encoding.half), encoding.step_scale[axis]);
+        vst1q_f32(out[axis], vmlaq_f32(offset, high[axis], encoding.byte_scale[axis]));
+    }
+}
+
+// Store 8 points decoded from their x, y and z high bytes and their extra values.
+inline void Store8Neon(const NeonEncoding& encoding, const uint8x8_t high_bytes[3],
+                       uint16x8_t extra, float* x, float* y, float* z) {
+    float32x4_t high[2][3];
+    for (int axis = 0; axis < 3; ++axis) {
+        const int16x8_t wide = vmovl_s8(vreinterpret_s8_u8(high_bytes[axis]));
+        high[0][axis] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+        high[1][axis] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+    }
+    StoreScaledNeon(encoding, high[0], vcvtq_f32_u32(vmovl_u16(vget_low_u16(extra))), x, y, z);
+    StoreScaledNeon(encoding, high[1], vcvtq_f32_u32(vmovl_u16(vget_high_u16(extra))), x + 4,
+                    y + 4, z + 4);
+}
+
+size_t Unpack4SCNeon(const uint8_t* data, size_t num_points, const ScaledEncoding& encoding,
+                     float* x, float* y, float* z) {
+    const NeonEncoding neon = LoadNeonEncoding(encoding);
+    size_t i = 0;
+    for (; i + 8 <= num_points; i += 8) {
+        // Split the x, y, z and extra bytes of the points into a register each.
+        const uint8x8x4_t points = vld4_u8(data + i * 4);
+        const uint8x8_t high[3] = {points.val[0], points.val[1], points.val[2]};
+        Store8Neon(neon, high, vmovl_u8(points.val[3]), x + i, y + i, z + i);
+    }
+    return i;
+}
+
+size_t Unpack5SCNeon(const uint8_t* data, size_t num_points, const ScaledEncoding& encoding,
+                     float* x, float* y, float* z) {
+    const NeonEncoding neon = LoadNeonEncoding(encoding);
+    // Byte k of point p of a group of 8 points is byte 5 * p + k of the group, which is either in
+    // its first 32 bytes, looked up with vtbl4, or in its last 8, looked up with vtbx1. An index
+    // out of range gives 0 in vtbl4 and keeps the byte in vtbx1.
+    uint8x8_t first_index[5];
+    uint8x8_t last_index[5];
+    for (int k = 0; k < 5; ++k) {
+        uint8_t first[8];
+        uint8_t last[8];
+        for (int p = 0; p < 8; ++p) {
+            const int byte = 5 * p + k;
+            first[p] = static_cast<uint8_t>(byte < 32 ? byte : 0xff);
+            last[p] = static_cast<uint8_t>(byte < 32 ? 0xff : byte - 32);
+        }
+        first_index[k] = vld1_u8(first);
+        last_index[k] = vld1_u8(last);
+    }
+    size_t i = 0;
+    for (; i + 8 <= num_points; i += 8) {
+        const uint8_t* points = data + i * 5;
+        const uint8x8x4_t first = {
+            {vld1_u8(points), vld1_u8(points + 8), vld1_u8(points + 16), vld1_u8(points + 24)}};
+        const uint8x8_t last = vld1_u8(points + 32);
+        uint8x8_t bytes[5];
+        for (int k = 0; k < 5; ++k) {
+            bytes[k] = vtbx1_u8(vtbl4_u8(first, first_index[k]), last, last_index[k]);
+        }
+        const uint16x8_t extra = vorrq_u16(vmovl_u8(bytes[3]), vshll_n_u8(bytes[4], 8));
+        Store8Neon(neon, bytes, extra, x + i, y + i, z + i);
+    }
+    return i;
+}
+
+size_t TransformPointsNeon(const PointTransform& transform, size_t num_points, float* x, float* y,
+                           float* z) {
+    const float* r = transform.rotation;
+    const float32x4_t tx = vdupq_n_f32(transform.translation[0]);
+    const float32x4_t ty = vdupq_n_f32(transform.translation[1]);
+    const float32x4_t tz = vdupq_n_f32(transform.translation[2]);
+    size_t i = 0;
+    for (; i + 4 <= num_points; i += 4) {
+        const float32x4_t px = vld1q_f32(x + i);
+        const float32x4_t py = vld1q_f32(y + i);
+        const float32x4_t pz = vld1q_f32(z + i);
+        vst1q_f32(x + i, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(tx, px, r[0]), py, r[1]), pz, r[2]));
+        vst1q_f32(y + i, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(ty, px, r[3]), py, r[4]), pz, r[5]));
+        vst1q_f32(z + i, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(tz, px, r[6]), py, r[7]), pz, r[8]));
+    }
+    return i;
+}
+
+#endif
+
+// Unpacks points of one encoding into a PointBlock, in meters in the sensor frame.
+class XYZ32FUnpacker {
+ public:
+    static constexpr size_t kBytesPerPoint = 12;
+
+    void Unpack(const uint8_t* data, size_t num_points, PointCloudKernel /*kernel*/,
+                PointBlock* block) const {
+        for (size_t i = 0; i < num_points; ++i) {
+            float point[3];
+            std::memcpy(point, data + i * kBytesPerPoint, sizeof(point));
+            block->x[i] = point[0];
+            block->y[i] = point[1];
+            block->z[i] = point[2];
+        }
+    }
+};
+
+class XYZ4SCUnpacker {
+ public:
+    static constexpr size_t kBytesPerPoint = 4;
+
+    explicit XYZ4SCUnpacker(const ScaledEncoding& encoding) : m_encoding(encoding) {
+        for (int axis = 0; axis < 3; ++axis) {
+            m_byte_scale[axis] = encoding.byte_scale[axis];
+        }
+        // The offset p2 of every possible extra byte, in meters.
+        const int64_t f = encoding.scale_factor;
+        for (int64_t extra = 0; extra < 256; ++extra) {
+            int64_t digits = extra;
+            for (int axis = 0; axis < 3; ++axis) {
+                const int64_t digit = digits % f - encoding.half_scale_factor;
+                m_extra_offset[axis][extra] = static_cast<float>(digit) * encoding.step_scale[axis];
+                digits /= f;
+            }
+        }
+    }
+
+    void Unpack(const uint8_t* data, size_t num_points, PointCloudKernel kernel,
+                PointBlock* block) const {
+        size_t i = 0;
+#ifdef BOSDYN_POINT_CLOUD_AVX2
+        if (kernel == PointCloudKernel::kAvx2) {
+            i = Unpack4SCAvx2(data, num_points, m_byte_scale, m_extra_offset, block->x, block->y,
+                              block->z);
+        }
+#endif
+#ifdef BOSDYN_POINT_CLOUD_NEON
+        if (kernel == PointCloudKernel::kNeon) {
+            i = Unpack4SCNeon(data, num_points, m_encoding, block->x, block->y, block->z);
+        }
+#endif
+        (void)kernel;
+        for (; i < num_points; ++i) {
+            const uint8_t* point = data + i * kBytesPerPoint;
+            const uint8_t extra = point[3];
+            block->x[i] = HighByte(point[0]) * m_byte_scale[0] + m_extra_offset[0][extra];
+            block->y[i] = HighByte(point[1]) * m_byte_scale[1] + m_extra_offset[1][extra];
+            block->z[i] = HighByte(point[2]) * m_byte_scale[2] + m_extra_offset[2][extra];
+        }
+    }
+
+ private:
+    ScaledEncoding m_encoding;
+    float m_byte_scale[3];
+    float m_extra_offset[3][256];
+};
+
+class XYZ5SCUnpacker {
+ public:
+    static constexpr size_t kBytesPerPoint = 5;
+
+    explicit XYZ5SCUnpacker(const ScaledEncoding& encoding)
+        : m_encoding(encoding),
+          m_scale_factor(static_cast<float>(encoding.scale_factor)),
+          m_inv_scale_factor(1.0f / static_cast<float>(encoding.scale_factor)) {}
+
+    void Unpack(const uint8_t* data, size_t num_points, PointCloudKernel kernel,
+                PointBlock* block) const {
+        size_t first = 0;
+#ifdef BOSDYN_POINT_CLOUD_AVX2
+        if (kernel == PointCloudKernel::kAvx2) {
+            first = Unpack5SCAvx2(data, num_points, m_encoding, block->x, block->y, block->z);
+        }
+#endif
+#ifdef BOSDYN_POINT_CLOUD_NEON
+        if (kernel == PointCloudKernel::kNeon) {
+            first = Unpack5SCNeon(data, num_points, m_encoding, block->x, block->y, block->z);
+        }
+#endif
+        (void)kernel;
+        UnpackScalar(data, first, num_points, block);
+    }
+
+ private:
+    // Unpack points [first, end) of the block.
+    void UnpackScalar(const uint8_t* data, size_t first, size_t end, PointBlock* block) const {
+        // Split the 16-bit extra values into their base-f digits in float arithmetic, which
+        // vectorizes where integer division does not. For a dividend x < 2^16, (x + 0.5) / f is at
+        // least 0.5 / f away from an integer while the rounding error of the product is below
+        // 2^-7 / f, so truncating it gives the exact quotient.
+        float digits[3][kBlockSize];
+        for (size_t i = first; i < end; ++i) {
+            const uint8_t* point = data + i * kBytesPerPoint;
+            digits[0][i] = static_cast<float>(point[3] | (point[4] << 8));
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            float* digit = digits[axis];
+            // The quotient of the last digit is dropped.
+            float* next_digit = digits[axis < 2 ? axis + 1 : 0];
+            for (size_t i = first; i < end; ++i) {
+                const float quotient = Truncate((digit[i] + 0.5f) * m_inv_scale_factor);
+                digit[i] -= quotient * m_scale_factor;
+                if (axis < 2) next_digit[i] = quotient;
+            }
+        }
+
+        const float half = static_cast<float>(m_encoding.half_scale_factor);
+        float* out[3] = {block->x, block->y, block->z};
+        for (int axis = 0; axis < 3; ++axis) {
+            const float byte_scale = m_encoding.byte_scale[axis];
+            const float step_scale = m_encoding.step_scale[axis];
+            float* out_axis = out[axis];
+            const float* digit = digits[axis];
+            for (size_t i = first; i < end; ++i) {
+                const float high = HighByte(data[i * kBytesPerPoint + axis]);
+                out_axis[i] = high * byte_scale + (digit[i] - half) * step_scale;
+            }
+        }
+    }
+
+    ScaledEncoding m_encoding;
+    float m_scale_factor;
+    float m_inv_scale_factor;
+};
+
+// Writes blocks of points to interleaved or separate arrays.
+class InterleavedWriter {
+ public:
+    explicit InterleavedWriter(float* xyz) : m_xyz(xyz) {}
+
+    // Copy XYZ_32F data, which is already interleaved. Returns false if the writer cannot.
+    bool CopyXYZ32F(const uint8_t* data, size_t num_points) const {
+        std::memcpy(m_xyz, data, num_points * XYZ32FUnpacker::kBytesPerPoint);
+        return true;
+    }
+
+    void Write(const PointBlock& block, size_t first, size_t num_points) const {
+        float* out = m_xyz + 3 * first;
+        for (size_t i = 0; i < num_points; ++i) {
+            out[3 * i] = block.x[i];
+            out[3 * i + 1] = block.y[i];
+            out[3 * i + 2] = block.z[i];
+        }
+    }
+
+ private:
+    float* m_xyz;
+};
+
+class SeparateWriter {
+ public:
+    SeparateWriter(float* x, float* y, float* z) : m_x(x), m_y(y), m_z(z) {}
+
+    bool CopyXYZ32F(const uint8_t* /*data*/, size_t /*num_points*/) const { return false; }
+
+    void Write(const PointBlock& block, size_t first, size_t num_points) const {
+        std::memcpy(m_x + first, block.x, num_points * sizeof(float));
+        std::memcpy(m_y + first, block.y, num_points * sizeof(float));
+        std::memcpy(m_z + first, block.z, num_points * sizeof(float));
+    }
+
+ private:
+    float* m_x;
+    float* m_y;
+    float* m_z;
+};
+
+template <class Unpacker, class Writer>
+void DecodeBlocks(const Unpacker& unpacker, const uint8_t* data, size_t num_points,
+                  const PointTransform* transform, const Writer& writer) {
+    const PointCloudKernel kernel = GetPointCloudKernel();
+    PointBlock block;
+    for (size_t first = 0; first < num_points; first += kBlockSize) {
+        const size_t block_size = std::min(kBlockSize, num_points - first);
+        unpacker.Unpack(data + first * Unpacker::kBytesPerPoint, block_size, kernel, &block);
+        if (transform) TransformPoints(*transform, block_size, block.x, block.y, block.z);
+        writer.Write(block, first, block_size);
+    }
+}
+
+template <class Writer>
+::bosdyn::common::Status Decode(const ::bosdyn::api::PointCloud& point_cloud,
+                                const PointTransform* transform, const Writer& writer) {
+    const size_t bytes_per_point = PointCloudBytesPerPoint(point_cloud.encoding());
+    if (bytes_per_point == 0) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Unsupported point cloud encoding.");
+    }
+    if (point_cloud.num_points() < 0 ||
+        point_cloud.data().size() != bytes_per_point * point_cloud.num_points()) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Point cloud data size does not match num_points.");
+    }
+
+    const auto* data = reinterpret_cast<const uint8_t*>(point_cloud.data().data());
+    const size_t num_points = point_cloud.num_points();
+    if (point_cloud.encoding() == ::bosdyn::api::PointCloud::ENCODING_XYZ_32F) {
+        if (transform || !writer.CopyXYZ32F(data, num_points)) {
+            DecodeBlocks(XYZ32FUnpacker(), data, num_points, transform, writer);
+        }
+        return ::bosdyn::common::Status(SDKErrorCode::Success);
+    }
+
+    ScaledEncoding encoding;
+    auto status = GetScaledEncoding(point_cloud, &encoding);
+    if (!status) return status;
+    if (point_cloud.encoding() == ::bosdyn::api::PointCloud::ENCODING_XYZ_4SC) {
+        DecodeBlocks(XYZ4SCUnpacker(encoding), data, num_points, transform, writer);
+    } else {
+        DecodeBlocks(XYZ5SCUnpacker(encoding), data, num_points, transform, writer);
+    }
+    return status;
+}
+
+}  // namespace
+
+PointTransform PointTransform::FromSE3Pose(const ::bosdyn::api::SE3Pose& a_tform_b) {
+    PointTransform transform;
+    Eigen::Matrix<double, 3, 3> rotation;
+    ::bosdyn::api::ToMatrix(a_tform_b.rotation(), &rotation);
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            transform.rotation[3 * row + col] = static_cast<float>(rotation(row, col));
+        }
+    }
+    transform.translation[0] = static_cast<float>(a_tform_b.position().x());
+    transform.translation[1] = static_cast<float>(a_tform_b.position().y());
+    transform.translation[2] = static_cast<float>(a_tform_b.position().z());
+    return transform;
+}
+
+void TransformPoints(const PointTransform& transform, size_t num_points, float* x, float* y,
+                     float* z) {
+    const PointCloudKernel kernel = GetPointCloudKernel();
+    size_t first = 0;
+#ifdef BOSDYN_POINT_CLOUD_AVX2
+    if (kernel == PointCloudKernel::kAvx2) {
+        first = TransformPointsAvx2(transform, num_points, x, y, z);
+    }
+#endif
+#ifdef BOSDYN_POINT_CLOUD_NEON
+    if (kernel == PointCloudKernel::kNeon) {
+        first = TransformPointsNeon(transform, num_points, x, y, z);
+    }
+#endif
+    (void)kernel;
+    TransformPointsScalar(transform, num_points - first, x + first, y + first, z + first);
+}
+
+bool SetPointCloudKernel(PointCloudKernel kernel) {
+    if (kernel == PointCloudKernel::kAvx2 && !CpuSupportsAvx2()) return false;
+    if (kernel == PointCloudKernel::kNeon && !BuiltWithNeon()) return false;
+    g_kernel = kernel;
+    return true;
+}
+
+PointCloudKernel GetPointCloudKernel() {
+    const PointCloudKernel kernel = g_kernel.load(std::memory_order_relaxed);
+    if (kernel != PointCloudKernel::kAuto) return kernel;
+    if (CpuSupportsAvx2()) return PointCloudKernel::kAvx2;
+    return BuiltWithNeon() ? PointCloudKernel::kNeon : PointCloudKernel::kScalar;
+}
+
+bool GetPointCloudTransform(const ::bosdyn::api::PointCloud& point_cloud,
+                            const std::string& frame, PointTransform* frame_tform_sensor) {
+    ::bosdyn::api::SE3Pose pose;
+    if (!::bosdyn::api::get_a_tform_b(point_cloud.source().transforms_snapshot(), frame,
+                                      point_cloud.source().frame_name_sensor(), &pose)) {
+        return false;
+    }
+    *frame_tform_sensor = PointTransform::FromSE3Pose(pose);
+    return true;
+}
+
+size_t PointCloudBytesPerPoint(::bosdyn::api::PointCloud::Encoding encoding) {
+    switch (encoding) {
+        case ::bosdyn::api::PointCloud::ENCODING_XYZ_32F:
+            return XYZ32FUnpacker::kBytesPerPoint;
+        case ::bosdyn::api::PointCloud::ENCODING_XYZ_4SC:
+            return XYZ4SCUnpacker::kBytesPerPoint;
+        case ::bosdyn::api::PointCloud::ENCODING_XYZ_5SC:
+            return XYZ5SCUnpacker::kBytesPerPoint;
+        default:
+            return 0;
+    }
+}
+
+::bosdyn::common::Status DecodePointCloud(const ::bosdyn::api::PointCloud& point_cloud, float* xyz,
+                                          const PointTransform* transform) {
+    return Decode(point_cloud, transform, InterleavedWriter(xyz));
+}
+
+::bosdyn::common::Status DecodePointCloud(const ::bosdyn::api::PointCloud& point_cloud, float* x,
+                                          float* y, float* z, const PointTransform* transform) {
+    return Decode(point_cloud, transform, SeparateWriter(x, y, z));
+}
+
+::bosdyn::common::Status DecodePointCloud(const ::bosdyn::api::PointCloud& point_cloud,
+                                          std::vector<float>* xyz,
+                                          const PointTransform* transform) {
+    xyz->resize(3 * static_cast<size_t>(std::max(point_cloud.num_points(), 0)));
+    return DecodePointCloud(point_cloud, xyz->data(), transform);
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/api/point_cloud.pb.h>
+
+#include <string>
+#include <vector>
+
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Rigid transform applied to points while they are decoded: p' = rotation * p + translation, with
+// the rotation as a row-major 3x3 matrix.
+struct PointTransform {
+    float rotation[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    float translation[3] = {0.0f, 0.0f, 0.0f};
+
+    static PointTransform FromSE3Pose(const ::bosdyn::api::SE3Pose& a_tform_b);
+};
+
+// Apply the transform in place to num_points points stored as separate x, y and z arrays.
+void TransformPoints(const PointTransform& transform, size_t num_points, float* x, float* y,
+                     float* z);
+
+// Find frame_tform_sensor in the transforms snapshot of the point cloud source, to express the
+// decoded points in the given frame. Returns false if the frame is not in the snapshot.
+bool GetPointCloudTransform(const ::bosdyn::api::PointCloud& point_cloud,
+                            const std::string& frame, PointTransform* frame_tform_sensor);
+
+// Decoding of the point cloud encodings described in point_cloud.proto.
+//
+// XYZ_4SC and XYZ_5SC points are decoded per axis as
+//   P = m * (p1 * f + p2) / (c * f)
+// which is the remap() of point_cloud.proto scaled to the box [-m, m]. The extra byte(s) x are
+// read as an unsigned integer, and p2 = [x mod f, (x / f) mod f, (x / f^2) mod f] - floor(f / 2).
+//
+// Points are decoded in blocks: the bytes of a block are first unpacked into per-axis arrays, and
+// the scaling and optional transform are then applied over those arrays. The 4SC extra byte is
+// looked up in a table of 256 precomputed offsets.
+//
+// On x86 builds with GCC or Clang, the 4SC and 5SC unpacking and the transform have AVX2 kernels
+// that process 8 points at a time, selected at runtime when the CPU supports AVX2 and FMA. ARM
+// builds with NEON, which includes every aarch64 build, have NEON kernels instead; their 4SC and
+// 5SC unpacking deinterleaves the bytes with vld4 and table lookups and splits the extra bytes in
+// float arithmetic, in place of the 4SC table. Every other case uses branch-free scalar loops,
+// which the compiler vectorizes for the instruction set the SDK is built for. There is no SSE4
+// kernel: x86-64 CPUs without AVX2 predate 2013, and there the scalar loops are vectorized with
+// the SSE2 baseline of x86-64, which leaves only the 4SC table lookup scalar. The AVX2 and NEON
+// kernels add in a different order and may fuse multiplies and adds, so their results can differ
+// from the scalar loops in the last bit.
+//
+// The Decode functions return an error if the encoding is unknown, the encoding parameters are
+// invalid, or the size of data does not match num_points.
+
+// Instruction set of the decoding and transform kernels.
+enum class PointCloudKernel { kAuto, kScalar, kAvx2, kNeon };
+
+// Select the kernels used by TransformPoints and the Decode functions. kAuto, the default, picks
+// kAvx2 when the build and the CPU support it, kNeon when the build supports it, and kScalar
+// otherwise. Returns false, and keeps the current selection, if the kernel is not supported. Meant
+// for comparing kernels; set it before decoding starts on other threads.
+bool SetPointCloudKernel(PointCloudKernel kernel);
+
+// The kernel TransformPoints and the Decode functions use. Never kAuto.
+PointCloudKernel GetPointCloudKernel();
+
+// Number of bytes per point of the given encoding, or 0 if the encoding is unknown.
+size_t PointCloudBytesPerPoint(::bosdyn::api::PointCloud::Encoding encoding);
+
+// Decode into interleaved x, y, z floats. xyz must hold 3 * num_points floats.
+::bosdyn::common::Status DecodePointCloud(const ::bosdyn::api::PointCloud& point_cloud, float* xyz,
+                                          const PointTransform* transform = nullptr);
+
+// Decode into separate x, y and z arrays, each of which must hold num_points floats.
+::bosdyn::common::Status DecodePointCloud(const ::bosdyn::api::PointCloud& point_cloud, float* x,
+                                          float* y, float* z,
+                                          const PointTransform* transform = nullptr);
+
+// Decode into interleaved x, y, z floats, resizing the vector. Reusing the vector across clouds
+// avoids reallocating it.
+::bosdyn::common::Status DecodePointCloud(const ::bosdyn::api::PointCloud& point_cloud,
+                                          std::vector<float>* xyz,
+                                          const PointTransform* transform = nullptr);
+
+}  // namespace client
+
+}  // namespace bosdyn
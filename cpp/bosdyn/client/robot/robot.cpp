@@ -57,7 +57,7 @@ Robot::Robot(const std::string& client_name, const bool bypass_proxy,
 
 Robot::~Robot() {
     StopTimeSync();
-    // Release TokenManager first to join its thread before shutting down the MessagePump.
+    // Release TokenManager first to cancel its refresh task before shutting down the MessagePump.
     m_token_manager.reset(nullptr);
     // Ensure the message pump is stopped before deleting any clients.
     if (m_default_message_pump) {
@@ -521,6 +521,7 @@ void Robot::SetRPCParameters(const RPCParameters& parameters) {
     m_RPC_parameters = parameters;
 
     // Update any existing service clients;
+    std::shared_lock<std::shared_mutex> lock(m_service_client_map_mutex);
     for (auto& client_it : m_service_client_map) {
         client_it.second.service_client->SetRPCParameters(parameters);
     }
@@ -12,6 +12,7 @@
 #include <bosdyn/api/geometry.pb.h>
 #include <functional>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include "bosdyn/client/directory/directory_client.h"
 #include "bosdyn/client/error_callback/error_callback_result.h"
@@ -42,6 +43,25 @@ struct Endpoint {
     std::string GetEndpointString() const { return host_ip + "_" + std::to_string(port); }
 };
 
+// Typed reference to a ServiceClient cached by a Robot. Clients are never removed from a Robot,
+// so a handle stays valid for the lifetime of the Robot that resolved it. Using a handle is a plain
+// pointer dereference, without locking or looking up the service name, and it can be shared
+// between threads.
+template <class T>
+class ServiceClientHandle {
+ public:
+    ServiceClientHandle() = default;
+    explicit ServiceClientHandle(T* client) : m_client(client) {}
+
+    T* get() const { return m_client; }
+    T* operator->() const { return m_client; }
+    T& operator*() const { return *m_client; }
+    explicit operator bool() const { return m_client != nullptr; }
+
+ private:
+    T* m_client = nullptr;
+};
+
 // Robot represents a single user on a single robot. It manages user credentials and communications
 // to the Robot, and is used to create clients for specific services on the robot.
 
@@ -81,18 +101,9 @@ class Robot {
                                    std::shared_ptr<grpc::ChannelInterface> channel = nullptr,
                                    std::shared_ptr<MessagePump> message_pump = nullptr) {
         // Use an existing client if one exists.
-        auto it_client = m_service_client_map.find(service_name);
-        if (it_client != m_service_client_map.end()) {
-            if (T::GetServiceType() != it_client->second.service_type) {
-                return {::bosdyn::common::Status(
-                            ClientCreationErrorCode::IncorrectServiceType,
-                            "Cached service client for " + service_name + " has service type " +
-                                it_client->second.service_type +
-                                ". The expected type is: " + T::GetServiceType()),
-                        nullptr};
-            }
-            return {::bosdyn::common::Status(ClientCreationErrorCode::Success),
-                    static_cast<T*>(it_client->second.service_client.get())};
+        Result<T*> cached_client = FindCachedServiceClient<T>(service_name);
+        if (cached_client.response || !cached_client.status) {
+            return cached_client;
         }
 
         // Since no client currently exists for this service name, create a new one using the
@@ -103,15 +114,24 @@ class Robot {
         // clients/channels at the same time, adding the same entry in the ServiceClientMap at the
         // same time.
         std::lock_guard<std::recursive_mutex> lock(m_client_create_mutex);
+
+        // Another thread may have created the client while this one waited for the lock. Reuse it
+        // rather than replacing a client that callers may already hold.
+        cached_client = FindCachedServiceClient<T>(service_name);
+        if (cached_client.response || !cached_client.status) {
+            return cached_client;
+        }
+
         std::unique_ptr<T> client = std::make_unique<T>();
         auto status =
             SetupClient(client.get(), service_name, T::GetServiceType(), channel, message_pump);
         if (status) {
             // Ultimately, add the new service client into the service client map such that it can
             // be reused if there is another request for the same service name.
+            T* client_ptr = client.get();
+            std::unique_lock<std::shared_mutex> map_lock(m_service_client_map_mutex);
             m_service_client_map[service_name] = {T::GetServiceType(), std::move(client)};
-            return {status,
-                    static_cast<T*>(m_service_client_map[service_name].service_client.get())};
+            return {status, client_ptr};
         } else {
             return {status, nullptr};
         }
@@ -124,6 +144,25 @@ class Robot {
         return EnsureServiceClient<T>(T::GetDefaultServiceName(), channel, message_pump);
     }
 
+    // Resolve a ServiceClient once and return a typed handle to it, creating the client with
+    // EnsureServiceClient if needed. Code that uses a client on a hot path, or from several
+    // threads, should hold on to the handle instead of calling EnsureServiceClient each time.
+    template <class T>
+    Result<ServiceClientHandle<T>> GetServiceClientHandle(
+        const std::string& service_name, std::shared_ptr<grpc::ChannelInterface> channel = nullptr,
+        std::shared_ptr<MessagePump> message_pump = nullptr) {
+        Result<T*> client_result = EnsureServiceClient<T>(service_name, channel, message_pump);
+        return {client_result.status, ServiceClientHandle<T>(client_result.response)};
+    }
+
+    // As above, except the service_name is inferred from the type.
+    template <class T>
+    Result<ServiceClientHandle<T>> GetServiceClientHandle(
+        std::shared_ptr<grpc::ChannelInterface> channel = nullptr,
+        std::shared_ptr<MessagePump> message_pump = nullptr) {
+        return GetServiceClientHandle<T>(T::GetDefaultServiceName(), channel, message_pump);
+    }
+
     // NOTE: Most of the following methods are called by ClientSdk and not typically accessed
     // directly by SDK users.
 
@@ -314,10 +353,36 @@ class Robot {
     };
 
     // This maps holds shared_ptr for ServiceClients so they can be shared with applications
-    // while blocking duplicate instances.
+    // while blocking duplicate instances. Entries are never removed, so the clients they own keep
+    // a stable address for the lifetime of the Robot.
     typedef std::map<std::string, CachedServiceClient> ServiceClientMap;
     ServiceClientMap m_service_client_map;
 
+    // Protects m_service_client_map. Lookups take a shared lock, so concurrent readers do not
+    // block each other; inserts take an exclusive lock.
+    mutable std::shared_mutex m_service_client_map_mutex;
+
+    // Look up a cached client under a shared lock. Returns a null client with a success status if
+    // there is none, or an error if the cached client has a different service type.
+    template <class T>
+    Result<T*> FindCachedServiceClient(const std::string& service_name) const {
+        std::shared_lock<std::shared_mutex> lock(m_service_client_map_mutex);
+        auto it_client = m_service_client_map.find(service_name);
+        if (it_client == m_service_client_map.end()) {
+            return {::bosdyn::common::Status(ClientCreationErrorCode::Success), nullptr};
+        }
+        if (T::GetServiceType() != it_client->second.service_type) {
+            return {::bosdyn::common::Status(
+                        ClientCreationErrorCode::IncorrectServiceType,
+                        "Cached service client for " + service_name + " has service type " +
+                            it_client->second.service_type +
+                            ". The expected type is: " + T::GetServiceType()),
+                    nullptr};
+        }
+        return {::bosdyn::common::Status(ClientCreationErrorCode::Success),
+                static_cast<T*>(it_client->second.service_client.get())};
+    }
+
     // Helper function to setup the ServiceClient after it is created.
     ::bosdyn::common::Status SetupClient(ServiceClient* service_client,
                                          const std::string& service_name,
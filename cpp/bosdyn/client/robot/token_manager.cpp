@@ -14,83 +14,93 @@ namespace bosdyn {
 
 namespace client {
 
+namespace {
+
+// Spread of the refresh interval and retries, so that the refreshes for many robots started
+// together do not stay in step.
+constexpr double kRefreshJitter = 0.1;
+
+}  // namespace
+
 TokenManager::TokenManager(Robot* robot, ::bosdyn::common::Duration refresh_interval,
-                           ::bosdyn::common::Duration initial_retry_interval)
+                           ::bosdyn::common::Duration initial_retry_interval,
+                           std::shared_ptr<PeriodicScheduler> scheduler)
     : m_robot(robot),
-      m_periodic_thread_helper(std::make_unique<PeriodicThreadHelper>()),
-      m_refresh_thread_is_alive(true),
       m_user_token_refresh_interval(refresh_interval),
       m_user_token_initial_retry_interval(initial_retry_interval) {
-    m_refresh_thread = std::thread(&TokenManager::Update, this);
+    if (!scheduler) scheduler = PeriodicScheduler::GetDefault();
+    PeriodicTaskOptions options;
+    options.period = m_user_token_refresh_interval;
+    options.initial_delay = m_user_token_refresh_interval;
+    options.jitter = kRefreshJitter;
+    options.initial_backoff = m_user_token_initial_retry_interval;
+    options.backoff_multiplier = 2.0;
+    options.max_backoff = m_user_token_refresh_interval;
+    scheduler->Schedule([this](bool) { return RefreshStep(); }, options, &m_refresh_task);
 }
 
 
-TokenManager::~TokenManager() { Stop(); }
+TokenManager::~TokenManager() {
+    Stop();
+    // The client completes the refresh in flight, if any, so wait for it.
+    m_refresh_rpc.Wait();
+}
+
+bool TokenManager::IsAlive() const { return m_refresh_task.IsActive(); }
 
-bool TokenManager::IsAlive() const { return m_refresh_thread_is_alive; }
+void TokenManager::Stop() { m_refresh_task.Cancel(); }
 
-void TokenManager::Stop() {
-    m_periodic_thread_helper->Stop();
-    if (m_refresh_thread.joinable()) {
-        m_refresh_thread.join();
+PeriodicTaskResult TokenManager::RefreshStep() {
+    if (!m_refresh_rpc.InFlight()) {
+        Result<AuthClient*> auth_client_result = m_robot->EnsureServiceClient<AuthClient>();
+        if (!auth_client_result) return HandleRefreshFailure(auth_client_result.status);
+        // Its completion triggers the task.
+        m_refresh_rpc.Start(&m_refresh_task, [&](AuthCallback on_complete) {
+            return auth_client_result.response->GetAuthTokenAsync(
+                m_robot->GetUserToken(), RPCParameters(), std::move(on_complete));
+        });
     }
+    if (!m_refresh_rpc.Ready()) return PeriodicTaskResult::kWaitForTrigger;
+
+    AuthResultType result = m_refresh_rpc.Take();
+    if (!result) return HandleRefreshFailure(result.status);
+    m_robot->UpdateUserToken(result.response.token());
+    return PeriodicTaskResult::kSuccess;
 }
 
-void TokenManager::Update() {
-    ::bosdyn::common::Duration retry_interval = m_user_token_initial_retry_interval;
-    ::bosdyn::common::Duration wait_interval = m_user_token_refresh_interval;
-    while (m_periodic_thread_helper->WaitForInterval(wait_interval)) {
-        ::bosdyn::common::Status status = m_robot->AuthenticateWithToken(m_robot->GetUserToken());
-        if (!status) {
-            fprintf(stderr, "AuthenticateWithToken failed: '%s'\n", status.DebugString().c_str());
-            ErrorCallbackResult result = ErrorCallbackResult::kRetryWithExponentialBackOff;
-            if (status.code().value() ==
-                ::bosdyn::api::GetAuthTokenResponse::STATUS_INVALID_TOKEN) {
-                std::function<ErrorCallbackResult(const ::bosdyn::common::Status&)> callback;
-                {
-                    // Lock the mutex to safely access the callback.
-                    std::lock_guard<std::mutex> lock(m_refresh_mutex);
-                    callback = m_token_refresh_error_callback;
-                }
-                if (callback) {
-                    // Notify the callback that the token has expired.
-                    try {
-                        result = callback(status);
-                    } catch (const std::exception& e) {
-                        fprintf(stderr, "Exception in token refresh error callback: %s\n",
-                                e.what());
-                    }
-                }
-            }
-            if (result == ErrorCallbackResult::kRetryWithExponentialBackOff ||
-                result == ErrorCallbackResult::kDefaultAction) {
-                // Exponentially increase the retry interval.
-                wait_interval = retry_interval;
-                fprintf(stderr, "Retrying in %f seconds\n", ((double)wait_interval.count()) / 1e9);
-                retry_interval = std::min(retry_interval * 2, m_user_token_refresh_interval);
-            } else if (result == ErrorCallbackResult::kAbort) {
-                fprintf(stderr, "Aborting token manager thread.\n");
-                break;
-            } else if (result == ErrorCallbackResult::kResumeNormalOperation) {
-                // Reset the retry interval to the initial value.
-                retry_interval = m_user_token_initial_retry_interval;
-                wait_interval = m_user_token_refresh_interval;
-            } else if (result == ErrorCallbackResult::kRetryImmediately) {
-                // Retry immediately.
-                wait_interval = std::chrono::milliseconds(0);
+PeriodicTaskResult TokenManager::HandleRefreshFailure(const ::bosdyn::common::Status& status) {
+    fprintf(stderr, "AuthenticateWithToken failed: '%s'\n", status.DebugString().c_str());
+    ErrorCallbackResult result = ErrorCallbackResult::kRetryWithExponentialBackOff;
+    if (status.code().value() == ::bosdyn::api::GetAuthTokenResponse::STATUS_INVALID_TOKEN) {
+        std::function<ErrorCallbackResult(const ::bosdyn::common::Status&)> callback;
+        {
+            // Lock the mutex to safely access the callback.
+            std::lock_guard<std::mutex> lock(m_refresh_mutex);
+            callback = m_token_refresh_error_callback;
+        }
+        if (callback) {
+            // Notify the callback that the token has expired.
+            try {
+                result = callback(status);
+            } catch (const std::exception& e) {
+                fprintf(stderr, "Exception in token refresh error callback: %s\n", e.what());
             }
-        } else {
-            // Reset the retry interval on success.
-            retry_interval = m_user_token_initial_retry_interval;
-            wait_interval = m_user_token_refresh_interval;
         }
     }
-    // Callback result of kAbort will cause the thread to exit; mark it as down.
-    {
-        std::lock_guard<std::mutex> lock(m_refresh_mutex);
-        m_refresh_thread_is_alive = false;
+    switch (result) {
+        case ErrorCallbackResult::kAbort:
+            fprintf(stderr, "Aborting token manager thread.\n");
+            return PeriodicTaskResult::kStop;
+        case ErrorCallbackResult::kResumeNormalOperation:
+            // Reset the retry interval, and refresh again after the refresh interval.
+            return PeriodicTaskResult::kSuccess;
+        case ErrorCallbackResult::kRetryImmediately:
+            return PeriodicTaskResult::kRetry;
+        default:
+            // Exponentially increase the retry interval, up to the refresh interval.
+            fprintf(stderr, "Retrying with exponential backoff\n");
+            return PeriodicTaskResult::kFailure;
     }
-    m_periodic_thread_helper->Stop();
 }
 
 void TokenManager::SetTokenRefreshErrorCallback(
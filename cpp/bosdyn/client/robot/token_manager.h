@@ -10,13 +10,15 @@
 #pragma once
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 
 #include <bosdyn/api/auth.pb.h>
 #include "robot.h"
+#include "bosdyn/client/auth/auth_client.h"
 #include "bosdyn/client/error_callback/error_callback_result.h"
-#include "bosdyn/client/util/periodic_thread_helper.h"
+#include "bosdyn/client/util/periodic_scheduler.h"
 
 namespace bosdyn {
 
@@ -24,12 +26,16 @@ namespace client {
 
 class Robot;  // Forward class declaration to resolve the circular dependency
 
+// Refreshes the user token of a Robot periodically. The refreshes are a task of a
+// PeriodicScheduler, by default the one shared by the whole process, rather than a thread per
+// robot. The "thread" of the methods below refers to that task.
 class TokenManager {
  public:
     explicit TokenManager(
         ::bosdyn::client::Robot* robot,
         ::bosdyn::common::Duration refresh_interval = std::chrono::seconds(3600),
-        ::bosdyn::common::Duration initial_retry_interval = std::chrono::seconds(1));
+        ::bosdyn::common::Duration initial_retry_interval = std::chrono::seconds(1),
+        std::shared_ptr<PeriodicScheduler> scheduler = nullptr);
 
     ~TokenManager();
 
@@ -38,26 +44,28 @@ class TokenManager {
 
     void Stop();
 
+    // Set the callback called when a refresh fails because the token is invalid. It is called on a
+    // thread of the scheduler, which by default has 2 threads shared by every keepalive and refresh
+    // in the process, so it must return quickly and not block, e.g. on a blocking RPC.
     void SetTokenRefreshErrorCallback(
         std::function<ErrorCallbackResult(const ::bosdyn::common::Status&)> callback);
 
  private:
-    // Refreshes the user token as needed.
-    void Update();
+    // Step of the refresh task, which starts a GetAuthToken RPC with the current user token, and
+    // is called again when it completes.
+    PeriodicTaskResult RefreshStep();
 
-    ::bosdyn::client::Robot* m_robot;
+    // Report a failed refresh to the error callback, and choose when to retry from its result.
+    PeriodicTaskResult HandleRefreshFailure(const ::bosdyn::common::Status& status);
 
-    // Refresh token thread.
-    std::thread m_refresh_thread;
+    ::bosdyn::client::Robot* m_robot;
 
-    // Mutex to protect the token refresh callback and thread liveness boolean.
+    // Mutex to protect the token refresh callback.
     std::mutex m_refresh_mutex;
 
-    // Object used to coordinate the lifecycle and timing of the periodic thread.
-    std::unique_ptr<PeriodicThreadHelper> m_periodic_thread_helper;
-
-    // Boolean indicating it the thread is still running or if it has returned.
-    bool m_refresh_thread_is_alive;
+    // The refresh in flight, if any. Only used by RefreshStep, and by the destructor once the task
+    // is cancelled.
+    PeriodicTaskRpc<AuthResultType> m_refresh_rpc;
 
     // Duration between token refreshes. This defaults to 1 hour, but can be updated by
     // the value passed to the constructor.
@@ -72,6 +80,9 @@ class TokenManager {
     // the token is expired.
     std::function<ErrorCallbackResult(const ::bosdyn::common::Status&)>
         m_token_refresh_error_callback;
+
+    // Refresh task. Declared last, so it is cancelled before the members it uses are destroyed.
+    PeriodicTaskHandle m_refresh_task;
 };
 
 }  // namespace client
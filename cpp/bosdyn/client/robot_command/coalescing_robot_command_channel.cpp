@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/robot_command/coalescing_robot_command_channel.h"
+
+#include "bosdyn/client/robot_command/robot_command_builder.h"
+
+namespace bosdyn {
+
+namespace client {
+
+CoalescingRobotCommandChannel::CoalescingRobotCommandChannel(
+    RobotCommandClient* client, const CoalescingChannelOptions& options,
+    TimeSyncEndpoint* time_sync_endpoint)
+    : m_client(client), m_time_sync_endpoint(time_sync_endpoint), m_channel(options) {}
+
+std::shared_future<RobotCommandResultType> CoalescingRobotCommandChannel::SendCommand(
+    const ::bosdyn::api::RobotCommand& command, ::bosdyn::common::Duration duration,
+    const RPCParameters& parameters) {
+    typedef CoalescingCommandChannel<RobotCommandResultType>::CompletionCallback CompletionCallback;
+    return m_channel.Submit([this, command_to_send = command, duration,
+                             parameters](CompletionCallback on_complete) mutable {
+        const ::bosdyn::common::TimePoint end_time = ::bosdyn::common::NowTimePoint() + duration;
+        return m_client->RobotCommandAsync(command_to_send, nullptr, m_time_sync_endpoint, end_time,
+                                           parameters, std::move(on_complete));
+    });
+}
+
+std::shared_future<RobotCommandResultType> CoalescingRobotCommandChannel::SendVelocityCommand(
+    double vel_x, double vel_y, double vel_rot, ::bosdyn::common::Duration duration,
+    const std::string& se2_frame_name, const RPCParameters& parameters) {
+    return SendCommand(VelocityCommand(vel_x, vel_y, vel_rot, se2_frame_name), duration,
+                       parameters);
+}
+
+std::shared_future<RobotCommandResultType> CoalescingRobotCommandChannel::SendVelocityCommand(
+    double vel_x, double vel_y, double vel_rot, ::bosdyn::common::Duration duration,
+    const std::string& se2_frame_name, const ::bosdyn::api::spot::MobilityParams& params,
+    const RPCParameters& parameters) {
+    return SendCommand(VelocityCommand(vel_x, vel_y, vel_rot, se2_frame_name, params), duration,
+                       parameters);
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/robot_command.pb.h>
+#include <bosdyn/api/spot/robot_command.pb.h>
+
+#include <string>
+
+#include "bosdyn/client/robot_command/robot_command_client.h"
+#include "bosdyn/client/util/coalescing_command_channel.h"
+#include "bosdyn/math/api_common_frames.h"
+
+namespace bosdyn {
+
+namespace client {
+
+/**
+ * Sends a stream of robot commands, such as the velocity commands of a joystick, with at most one
+ * RobotCommand RPC in flight. A command submitted while another is in flight replaces any command
+ * still waiting to be sent, and is dropped if it is older than max_staleness by the time it could
+ * be sent. See CoalescingCommandChannel.
+ *
+ * The end time of a command is computed when it is sent, as the send time plus its duration, and
+ * converted to robot time with the time sync endpoint, so a command that waited for the one in
+ * flight still runs for its full duration and not longer.
+ */
+class CoalescingRobotCommandChannel {
+ public:
+    // The client and time sync endpoint must outlive the channel. If time_sync_endpoint is null,
+    // the endpoint added to the client with AddTimeSyncEndpoint() is used.
+    explicit CoalescingRobotCommandChannel(
+        RobotCommandClient* client,
+        const CoalescingChannelOptions& options = CoalescingChannelOptions(),
+        TimeSyncEndpoint* time_sync_endpoint = nullptr);
+
+    // Submit a command that runs until its duration after it is sent. The lease is applied from
+    // the lease wallet of the client.
+    std::shared_future<RobotCommandResultType> SendCommand(
+        const ::bosdyn::api::RobotCommand& command, ::bosdyn::common::Duration duration,
+        const RPCParameters& parameters = RPCParameters());
+
+    // Submit a VelocityCommand() that runs until its duration after it is sent.
+    std::shared_future<RobotCommandResultType> SendVelocityCommand(
+        double vel_x, double vel_y, double vel_rot, ::bosdyn::common::Duration duration,
+        const std::string& se2_frame_name = ::bosdyn::api::kBodyFrame,
+        const RPCParameters& parameters = RPCParameters());
+    std::shared_future<RobotCommandResultType> SendVelocityCommand(
+        double vel_x, double vel_y, double vel_rot, ::bosdyn::common::Duration duration,
+        const std::string& se2_frame_name, const ::bosdyn::api::spot::MobilityParams& params,
+        const RPCParameters& parameters = RPCParameters());
+
+    CoalescingChannelStats GetStats() const { return m_channel.GetStats(); }
+
+ private:
+    RobotCommandClient* m_client;
+    TimeSyncEndpoint* m_time_sync_endpoint;
+    CoalescingCommandChannel<RobotCommandResultType> m_channel;
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
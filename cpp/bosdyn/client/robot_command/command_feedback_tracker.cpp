@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/robot_command/command_feedback_tracker.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "bosdyn/client/error_codes/rpc_error_code.h"
+#include "bosdyn/client/robot_command/robot_command_client.h"
+#include "bosdyn/client/robot_command/robot_command_helpers.h"
+
+namespace bosdyn {
+
+namespace client {
+
+CommandFeedbackTracker::CommandFeedbackTracker(RobotCommandClient* client,
+                                               const CommandFeedbackTrackerOptions& options,
+                                               std::shared_ptr<PeriodicScheduler> scheduler)
+    : m_client(client),
+      m_options(options),
+      m_scheduler(scheduler ? std::move(scheduler) : PeriodicScheduler::GetDefault()) {}
+
+CommandFeedbackTracker::~CommandFeedbackTracker() {
+    std::map<int, std::shared_ptr<TrackedCommand>> commands;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        commands.swap(m_commands);
+    }
+    for (auto& entry : commands) {
+        TrackedCommand* command = entry.second.get();
+        command->task.Cancel();
+        // The completion of a feedback RPC in flight refers to the client, not the tracker, but
+        // wait for it so no RPC started by the tracker outlives it.
+        command->feedback_rpc.Wait();
+        for (Waiter& waiter : command->waiters) {
+            RobotCommandFeedbackResultType result = {
+                ::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
+                                         "CommandFeedbackTracker was destroyed"),
+                command->last_response};
+            if (waiter.on_finished) waiter.on_finished(result);
+            waiter.promise.set_value(std::move(result));
+        }
+    }
+}
+
+std::shared_future<RobotCommandFeedbackResultType> CommandFeedbackTracker::WaitForCommand(
+    int cmd_id, CommandFinishedFn is_finished, ::bosdyn::common::Duration timeout,
+    ::bosdyn::common::Duration poll_period, CommandFeedbackCallback on_finished) {
+    Waiter waiter;
+    waiter.is_finished = std::move(is_finished);
+    waiter.deadline = timeout > ::bosdyn::common::Duration(0)
+                          ? std::chrono::steady_clock::now() + timeout
+                          : std::chrono::steady_clock::time_point::max();
+    waiter.on_finished = std::move(on_finished);
+    std::shared_future<RobotCommandFeedbackResultType> future = waiter.promise.get_future();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::shared_ptr<TrackedCommand>& command = m_commands[cmd_id];
+    if (command) {
+        // Poll at least as often as the new waiter asks for, starting with the next request.
+        command->waiters.push_back(std::move(waiter));
+        if (poll_period < command->poll_period) {
+            command->poll_period = poll_period;
+            command->task.SetPeriod(poll_period);
+        }
+        return future;
+    }
+
+    command = std::make_shared<TrackedCommand>();
+    command->cmd_id = cmd_id;
+    command->poll_period = poll_period;
+    command->waiters.push_back(std::move(waiter));
+
+    PeriodicTaskOptions task_options;
+    task_options.period = poll_period;
+    std::weak_ptr<TrackedCommand> weak_command = command;
+    m_scheduler->Schedule([this, weak_command](bool) { return PollStep(weak_command); },
+                          task_options, &command->task);
+    return future;
+}
+
+size_t CommandFeedbackTracker::NumTrackedCommands() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_commands.size();
+}
+
+PeriodicTaskResult CommandFeedbackTracker::PollStep(
+    const std::weak_ptr<TrackedCommand>& weak_command) {
+    std::shared_ptr<TrackedCommand> command = weak_command.lock();
+    if (!command) return PeriodicTaskResult::kStop;
+
+    if (!command->feedback_rpc.InFlight()) {
+        // The completion of the request triggers the task.
+        ::bosdyn::api::RobotCommandFeedbackRequest request;
+        request.set_robot_command_id(command->cmd_id);
+        ++m_num_feedback_requests;
+        command->feedback_rpc.Start(&command->task, [&](CommandFeedbackCallback on_complete) {
+            return m_client->RobotCommandFeedbackAsync(request, m_options.parameters,
+                                                       std::move(on_complete));
+        });
+    }
+    if (!command->feedback_rpc.Ready()) return PeriodicTaskResult::kWaitForTrigger;
+    const RobotCommandFeedbackResultType result = command->feedback_rpc.Take();
+
+    std::vector<std::pair<Waiter, RobotCommandFeedbackResultType>> finished;
+    bool stop = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_commands.find(command->cmd_id);
+        // The tracker is being destroyed, which completes the remaining waiters.
+        if (it == m_commands.end() || it->second != command) return PeriodicTaskResult::kStop;
+
+        if (result.status) command->last_response = result.response;
+        // If the RPC timed out, keep trying until the waits themselves time out.
+        const bool rpc_failed =
+            !result.status && result.status.code() != RPCErrorCode::TimedOutError;
+        const auto now = std::chrono::steady_clock::now();
+        auto earliest_deadline = std::chrono::steady_clock::time_point::max();
+        auto& waiters = command->waiters;
+        for (auto waiter = waiters.begin(); waiter != waiters.end();) {
+            ::bosdyn::common::Status status;
+            bool done = false;
+            if (rpc_failed) {
+                status = result.status;
+                done = true;
+            } else if (result.status && waiter->is_finished(result.response, &status)) {
+                done = true;
+            } else if (now >= waiter->deadline) {
+                status = {BlockingRobotCommandErrorCode::CommandTimeoutError,
+                          "The command failed or timed out."};
+                done = true;
+            }
+            if (!done) {
+                earliest_deadline = std::min(earliest_deadline, waiter->deadline);
+                ++waiter;
+                continue;
+            }
+            finished.emplace_back(
+                std::move(*waiter),
+                RobotCommandFeedbackResultType{std::move(status), command->last_response});
+            waiter = waiters.erase(waiter);
+        }
+
+        if (waiters.empty()) {
+            m_commands.erase(it);
+            stop = true;
+        } else {
+            if (m_options.backoff_multiplier > 1.0) {
+                // Back off up to max_poll_period, without shortening a longer poll period asked
+                // for by the waiters.
+                command->poll_period = std::max<::bosdyn::common::Duration>(
+                    command->poll_period,
+                    std::min<::bosdyn::common::Duration>(
+                        std::chrono::duration_cast<::bosdyn::common::Duration>(
+                            command->poll_period * m_options.backoff_multiplier),
+                        m_options.max_poll_period));
+            }
+            // Poll again no later than the earliest deadline, so timeouts are not overshot by the
+            // backoff.
+            ::bosdyn::common::Duration next_poll = command->poll_period;
+            if (earliest_deadline != std::chrono::steady_clock::time_point::max()) {
+                next_poll = std::min<::bosdyn::common::Duration>(
+                    next_poll, std::chrono::duration_cast<::bosdyn::common::Duration>(
+                                   earliest_deadline - now));
+            }
+            command->task.SetPeriod(next_poll);
+        }
+    }
+
+    for (auto& waiter_and_result : finished) {
+        Waiter& waiter = waiter_and_result.first;
+        if (waiter.on_finished) waiter.on_finished(waiter_and_result.second);
+        waiter.promise.set_value(std::move(waiter_and_result.second));
+    }
+    return stop ? PeriodicTaskResult::kStop : PeriodicTaskResult::kSuccess;
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
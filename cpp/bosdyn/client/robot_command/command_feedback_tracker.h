@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/robot_command.pb.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "bosdyn/client/service_client/result.h"
+#include "bosdyn/client/service_client/rpc_parameters.h"
+#include "bosdyn/client/util/periodic_scheduler.h"
+#include "bosdyn/common/status.h"
+#include "bosdyn/common/time.h"
+
+namespace bosdyn {
+
+namespace client {
+
+class RobotCommandClient;
+typedef Result<::bosdyn::api::RobotCommandFeedbackResponse> RobotCommandFeedbackResultType;
+
+// Return true if the feedback shows that the command being waited on has finished, and set status
+// to success or to the reason it failed. See ArmCommandFinished() and its siblings in
+// robot_command_helpers.h.
+typedef std::function<bool(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                           ::bosdyn::common::Status* status)>
+    CommandFinishedFn;
+
+// Called with the final result of a wait, before its future is set.
+typedef std::function<void(const RobotCommandFeedbackResultType&)> CommandFeedbackCallback;
+
+struct CommandFeedbackTrackerOptions {
+    // By default a command is polled at the fixed poll period of its waiters. With a
+    // backoff_multiplier above 1, e.g. 1.25, the time between requests grows by it after each
+    // request that does not finish a wait, up to max_poll_period, so long trajectories are polled
+    // less often the longer they run at the cost of noticing completion later.
+    double backoff_multiplier = 1.0;
+    ::bosdyn::common::Duration max_poll_period = std::chrono::milliseconds(500);
+    RPCParameters parameters;
+};
+
+/**
+ * Waits for many robot commands to finish with one asynchronous feedback poller, instead of one
+ * blocking RobotCommandFeedback loop and thread per waiter.
+ *
+ * Each command id being waited on is polled by a task on a PeriodicScheduler, with the feedback
+ * RPCs on the MessagePump of the client. All waiters on the same id, e.g. on the arm and gripper
+ * parts of one synchronized command, share its feedback requests, and each wait completes as soon
+ * as the feedback finishes it, times out, or a feedback RPC fails. Polling for an id stops when its
+ * last wait completes.
+ */
+class CommandFeedbackTracker {
+ public:
+    // The client must outlive the tracker.
+    explicit CommandFeedbackTracker(
+        RobotCommandClient* client,
+        const CommandFeedbackTrackerOptions& options = CommandFeedbackTrackerOptions(),
+        std::shared_ptr<PeriodicScheduler> scheduler = nullptr);
+    // Completes the waits still outstanding with ClientCancelledOperationError.
+    ~CommandFeedbackTracker();
+
+    CommandFeedbackTracker(const CommandFeedbackTracker&) = delete;
+    CommandFeedbackTracker& operator=(const CommandFeedbackTracker&) = delete;
+
+    /**
+     * Wait for the command with id cmd_id to finish.
+     *
+     * @param cmd_id The command ID returned by the robot when the command was sent.
+     * @param is_finished Decides from the feedback whether the command has finished.
+     * @param timeout Duration after which the wait completes with CommandTimeoutError and the last
+     * feedback received. If zero or negative, the wait only completes on finished feedback or an
+     * RPC error.
+     * @param poll_period Time between feedback requests for this command, before any backoff.
+     * @param on_finished If set, called from a scheduler thread with the final result. The threads
+     * of the scheduler are shared with every keepalive in the process, so it must not block.
+     *
+     * @return Future set with the final result: the status chosen by is_finished, a timeout, or the
+     * error of a failed feedback RPC, along with the last feedback response. Do not block on it
+     * from a thread of the scheduler.
+     */
+    std::shared_future<RobotCommandFeedbackResultType> WaitForCommand(
+        int cmd_id, CommandFinishedFn is_finished,
+        ::bosdyn::common::Duration timeout = std::chrono::seconds(0),
+        ::bosdyn::common::Duration poll_period = std::chrono::milliseconds(100),
+        CommandFeedbackCallback on_finished = nullptr);
+
+    // Number of command ids currently being polled.
+    size_t NumTrackedCommands() const;
+
+    // Number of feedback RPCs issued so far.
+    uint64_t NumFeedbackRequests() const { return m_num_feedback_requests; }
+
+ private:
+    struct Waiter {
+        CommandFinishedFn is_finished;
+        // time_point::max() if the waiter does not time out.
+        std::chrono::steady_clock::time_point deadline;
+        CommandFeedbackCallback on_finished;
+        std::promise<RobotCommandFeedbackResultType> promise;
+    };
+
+    struct TrackedCommand {
+        int cmd_id = 0;
+        std::vector<Waiter> waiters;
+        // Time from the start of one feedback request to the next.
+        ::bosdyn::common::Duration poll_period;
+        ::bosdyn::api::RobotCommandFeedbackResponse last_response;
+        // Only used by the step function of the task, and by the destructor once it is cancelled.
+        PeriodicTaskRpc<RobotCommandFeedbackResultType> feedback_rpc;
+        PeriodicTaskHandle task;
+    };
+
+    PeriodicTaskResult PollStep(const std::weak_ptr<TrackedCommand>& weak_command);
+
+    RobotCommandClient* m_client;
+    const CommandFeedbackTrackerOptions m_options;
+    std::shared_ptr<PeriodicScheduler> m_scheduler;
+    mutable std::mutex m_mutex;
+    std::map<int, std::shared_ptr<TrackedCommand>> m_commands;
+    std::atomic<uint64_t> m_num_feedback_requests{0};
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
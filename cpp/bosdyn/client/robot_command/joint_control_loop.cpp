@@ -0,0 +1,319 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/robot_command/joint_control_loop.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/common/assert_precondition.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Sleep until the given steady clock time. On Linux, sleep on the absolute deadline so that
+// preemption between reading the clock and sleeping does not delay the wakeup.
+void SleepUntil(Clock::time_point deadline) {
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC on Linux.
+    const auto since_epoch = deadline.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    timespec deadline_spec;
+    deadline_spec.tv_sec = seconds.count();
+    deadline_spec.tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count();
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline_spec, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+void CopySetpoint(const std::array<float, kMaxJointControlDofs>& values, size_t num_dofs,
+                  google::protobuf::RepeatedField<float>* field) {
+    std::copy(values.begin(), values.begin() + num_dofs, field->mutable_data());
+}
+
+bool SetpointEquals(const std::array<float, kMaxJointControlDofs>& values, size_t num_dofs,
+                    const google::protobuf::RepeatedField<float>& field) {
+    return std::memcmp(values.data(), field.data(), num_dofs * sizeof(float)) == 0;
+}
+
+}  // namespace
+
+LatencySummary LatencyRing::Summarize() const {
+    const uint64_t count = m_count.load(std::memory_order_acquire);
+    std::vector<int64_t> samples(std::min<uint64_t>(count, kCapacity));
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = m_samples[i].load(std::memory_order_relaxed);
+    }
+
+    LatencySummary summary;
+    summary.num_samples = samples.size();
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double p) {
+        const size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+        return ::bosdyn::common::Duration(samples[index]);
+    };
+    summary.min = ::bosdyn::common::Duration(samples.front());
+    summary.p50 = percentile(0.5);
+    summary.p90 = percentile(0.9);
+    summary.p99 = percentile(0.99);
+    summary.max = ::bosdyn::common::Duration(samples.back());
+    return summary;
+}
+
+JointControlLoop::JointControlLoop(RobotCommandStreamingClient* streaming_client,
+                                   TimeSyncEndpoint* time_sync_endpoint,
+                                   const JointControlLoopParameters& parameters)
+    : JointControlLoop(
+          [streaming_client](const ::bosdyn::api::JointControlStreamRequest& request) {
+              return streaming_client->JointControlStream(request).status;
+          },
+          time_sync_endpoint, parameters) {}
+
+JointControlLoop::JointControlLoop(StreamWriter writer, TimeSyncEndpoint* time_sync_endpoint,
+                                   const JointControlLoopParameters& parameters)
+    : m_writer(std::move(writer)),
+      m_time_sync_endpoint(time_sync_endpoint),
+      m_parameters(parameters) {
+    BOSDYN_ASSERT_PRECONDITION(m_parameters.num_dofs <= kMaxJointControlDofs,
+                               "JointControlLoop supports at most %zu joints, got %zu.",
+                               kMaxJointControlDofs, m_parameters.num_dofs);
+    BOSDYN_ASSERT_PRECONDITION(m_parameters.period.count() > 0,
+                               "JointControlLoop period must be positive.");
+
+    // Size every field once; ticks only overwrite values.
+    m_request = google::protobuf::Arena::CreateMessage<::bosdyn::api::JointControlStreamRequest>(
+        &m_arena);
+    m_request->mutable_header()->set_client_name(m_parameters.client_name);
+    m_request->mutable_header()->mutable_request_timestamp();
+    auto* joint_command = m_request->mutable_joint_command();
+    joint_command->mutable_end_time();
+    ::bosdyn::common::DurationToProtobufDuration(m_parameters.extrapolation_duration,
+                                                 joint_command->mutable_extrapolation_duration());
+    const int num_dofs = static_cast<int>(m_parameters.num_dofs);
+    joint_command->mutable_position()->Resize(num_dofs, 0.0f);
+    joint_command->mutable_velocity()->Resize(num_dofs, 0.0f);
+    joint_command->mutable_load()->Resize(num_dofs, 0.0f);
+    m_gains = joint_command->mutable_gains();
+    m_gains->mutable_k_q_p()->Resize(num_dofs, 0.0f);
+    m_gains->mutable_k_qd_p()->Resize(num_dofs, 0.0f);
+}
+
+JointControlLoop::~JointControlLoop() {
+    Stop();
+    // The gains belong to the arena whether or not they are attached to the request.
+    if (!m_request->joint_command().has_gains()) {
+        m_request->mutable_joint_command()->unsafe_arena_set_allocated_gains(m_gains);
+    }
+}
+
+::bosdyn::common::Status JointControlLoop::Start() {
+    if (m_thread.joinable()) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "JointControlLoop is already running.");
+    }
+    if (!m_time_sync_endpoint->HasEstablishedTimeSync()) {
+        return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                        "Time sync has not been established with the robot.");
+    }
+
+    m_should_stop = false;
+    // A new stream may be opened after a restart, so send the gains again with the first command.
+    m_gains_sent = false;
+    std::promise<::bosdyn::common::Status> configured;
+    auto configured_future = configured.get_future();
+    m_thread = std::thread(&JointControlLoop::LoopThreadMethod, this, std::move(configured));
+    auto status = configured_future.get();
+    if (!status) {
+        m_thread.join();
+    }
+    return status;
+}
+
+void JointControlLoop::Stop() {
+    m_should_stop = true;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void JointControlLoop::SetSetpoint(const JointSetpoint& setpoint) {
+    m_setpoints.WriteBuffer() = setpoint;
+    m_setpoints.Publish();
+    m_has_setpoint.store(true, std::memory_order_release);
+}
+
+void JointControlLoop::OnRobotStateStreamResponse(
+    const ::bosdyn::api::RobotStateStreamResponse& response) {
+    const auto receive_time = Clock::now();
+    const uint32_t key = response.last_command().user_command_key();
+    // The robot reports the same last command until it receives a new one.
+    if (key == 0 || key == m_last_reported_key) return;
+    m_last_reported_key = key;
+
+    // The slot may have been reused for a newer command by the time the response arrives; the key
+    // is checked again after reading the send time.
+    const SentCommand& sent = m_sent_commands[key % kSentCommandCapacity];
+    if (sent.key.load(std::memory_order_acquire) != key) return;
+    const int64_t send_time_nsec = sent.send_time_nsec.load(std::memory_order_acquire);
+    if (sent.key.load(std::memory_order_acquire) != key) return;
+    m_round_trip.Add(receive_time.time_since_epoch() - ::bosdyn::common::Duration(send_time_nsec));
+}
+
+JointControlLoopStats JointControlLoop::GetStats() const {
+    JointControlLoopStats stats;
+    stats.ticks = m_ticks;
+    stats.write_failures = m_write_failures;
+    stats.missed_ticks = m_missed_ticks;
+    stats.jitter = m_jitter.Summarize();
+    stats.round_trip = m_round_trip.Summarize();
+    std::lock_guard<std::mutex> lock(m_error_mutex);
+    stats.last_error = m_last_error;
+    return stats;
+}
+
+void JointControlLoop::LoopThreadMethod(std::promise<::bosdyn::common::Status> configured) {
+    auto status = ConfigureThread();
+    const bool is_configured = static_cast<bool>(status);
+    configured.set_value(std::move(status));
+    if (!is_configured) return;
+
+    auto deadline = Clock::now();
+    while (!m_should_stop.load(std::memory_order_relaxed)) {
+        SleepUntil(deadline);
+        m_jitter.Add(Clock::now() - deadline);
+        if (m_should_stop.load(std::memory_order_relaxed)) break;
+
+        Tick();
+
+        // Skip the ticks whose deadline already passed rather than sending them back to back.
+        deadline += m_parameters.period;
+        const auto now = Clock::now();
+        while (deadline < now) {
+            deadline += m_parameters.period;
+            ++m_missed_ticks;
+        }
+    }
+}
+
+void JointControlLoop::Tick() {
+    if (!m_has_setpoint.load(std::memory_order_acquire)) return;
+    m_setpoints.Update();
+    const JointSetpoint& setpoint = m_setpoints.ReadBuffer();
+    const size_t num_dofs = m_parameters.num_dofs;
+
+    auto* joint_command = m_request->mutable_joint_command();
+    CopySetpoint(setpoint.position, num_dofs, joint_command->mutable_position());
+    CopySetpoint(setpoint.velocity, num_dofs, joint_command->mutable_velocity());
+    CopySetpoint(setpoint.load, num_dofs, joint_command->mutable_load());
+
+    // Attach the gains only when they have to be sent. Detaching them keeps their storage in the
+    // arena for later ticks.
+    const bool send_gains = !m_gains_sent ||
+                            !SetpointEquals(setpoint.k_q_p, num_dofs, m_gains->k_q_p()) ||
+                            !SetpointEquals(setpoint.k_qd_p, num_dofs, m_gains->k_qd_p());
+    if (send_gains) {
+        CopySetpoint(setpoint.k_q_p, num_dofs, m_gains->mutable_k_q_p());
+        CopySetpoint(setpoint.k_qd_p, num_dofs, m_gains->mutable_k_qd_p());
+        if (!joint_command->has_gains()) joint_command->unsafe_arena_set_allocated_gains(m_gains);
+    } else if (joint_command->has_gains()) {
+        joint_command->unsafe_arena_release_gains();
+    }
+
+    const auto local_now = ::bosdyn::common::NowTimePoint();
+    ::bosdyn::common::SetTimestamp(::bosdyn::common::NowNsec(),
+                                   m_request->mutable_header()->mutable_request_timestamp());
+    auto converter = m_time_sync_endpoint->GetRobotTimeConverter();
+    *joint_command->mutable_end_time() =
+        converter.RobotTimestampFromLocal(local_now + m_parameters.end_time_offset);
+
+    // Key 0 means no command, so it is skipped when the key wraps.
+    if (++m_user_command_key == 0) ++m_user_command_key;
+    joint_command->set_user_command_key(m_user_command_key);
+
+    SentCommand& sent = m_sent_commands[m_user_command_key % kSentCommandCapacity];
+    sent.key.store(0, std::memory_order_release);
+    sent.send_time_nsec.store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+    sent.key.store(m_user_command_key, std::memory_order_release);
+
+    auto status = m_writer(*m_request);
+    ++m_ticks;
+    if (status) {
+        m_gains_sent = m_gains_sent || send_gains;
+    } else {
+        ++m_write_failures;
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+        m_last_error = std::move(status);
+    }
+}
+
+::bosdyn::common::Status JointControlLoop::ConfigureThread() {
+#ifdef __linux__
+    if (!m_parameters.cpu_affinity.empty()) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : m_parameters.cpu_affinity) {
+            // CPU_SET does not check its argument.
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                return ::bosdyn::common::Status(
+                    SDKErrorCode::GenericSDKError,
+                    "CPU " + std::to_string(cpu) + " is outside of the supported range [0, " +
+                        std::to_string(CPU_SETSIZE) + ").");
+            }
+            CPU_SET(cpu, &cpu_set);
+        }
+        const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (error != 0) {
+            return ::bosdyn::common::Status(
+                SDKErrorCode::GenericSDKError,
+                "Failed to set the CPU affinity of the loop thread: " +
+                    std::string(strerror(error)));
+        }
+    }
+    if (m_parameters.realtime_priority > 0) {
+        sched_param param;
+        param.sched_priority = m_parameters.realtime_priority;
+        const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error != 0) {
+            return ::bosdyn::common::Status(
+                SDKErrorCode::GenericSDKError,
+                "Failed to set SCHED_FIFO priority of the loop thread: " +
+                    std::string(strerror(error)));
+        }
+    }
+#else
+    if (!m_parameters.cpu_affinity.empty() || m_parameters.realtime_priority > 0) {
+        return ::bosdyn::common::Status(
+            SDKErrorCode::GenericSDKError,
+            "Realtime priority and CPU affinity are only supported on Linux.");
+    }
+#endif
+    return ::bosdyn::common::Status(SDKErrorCode::Success);
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <google/protobuf/arena.h>
+
+#include <bosdyn/api/robot_command.pb.h>
+#include <bosdyn/api/robot_state.pb.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bosdyn/client/robot_command/robot_command_streaming_client.h"
+#include "bosdyn/client/time_sync/time_sync_helpers.h"
+#include "bosdyn/common/status.h"
+#include "bosdyn/common/time.h"
+#include "bosdyn/common/triple_buffer.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Largest number of joints a JointControlLoop can command. Spot with an arm has 19.
+constexpr size_t kMaxJointControlDofs = 19;
+
+// Joint setpoint handed to a JointControlLoop. Only the first num_dofs entries of each array are
+// sent.
+struct JointSetpoint {
+    std::array<float, kMaxJointControlDofs> position{};
+    std::array<float, kMaxJointControlDofs> velocity{};
+    std::array<float, kMaxJointControlDofs> load{};
+    std::array<float, kMaxJointControlDofs> k_q_p{};
+    std::array<float, kMaxJointControlDofs> k_qd_p{};
+};
+
+// Settings of a JointControlLoop.
+struct JointControlLoopParameters {
+    // Number of joints commanded, at most kMaxJointControlDofs.
+    size_t num_dofs = 12;
+
+    // Period of the loop, e.g. 3ms for 333 Hz.
+    ::bosdyn::common::Duration period = std::chrono::milliseconds(3);
+
+    // Each command expires this long after it is sent, in robot time.
+    ::bosdyn::common::Duration end_time_offset = std::chrono::milliseconds(100);
+
+    // How long the robot extrapolates each command when no new one arrives.
+    ::bosdyn::common::Duration extrapolation_duration = std::chrono::milliseconds(5);
+
+    // If positive, run the loop thread with SCHED_FIFO at this priority. Requires CAP_SYS_NICE or
+    // an rtprio limit; only supported on Linux.
+    int realtime_priority = 0;
+
+    // If non-empty, pin the loop thread to these CPUs, each in [0, CPU_SETSIZE). Only supported on
+    // Linux.
+    std::vector<int> cpu_affinity;
+
+    // Client name set in the request header.
+    std::string client_name = "joint_control_loop";
+};
+
+// Distribution of the most recent samples of a latency.
+struct LatencySummary {
+    // Number of samples the summary was computed from, at most the capacity of the ring.
+    size_t num_samples = 0;
+    ::bosdyn::common::Duration min{0};
+    ::bosdyn::common::Duration p50{0};
+    ::bosdyn::common::Duration p90{0};
+    ::bosdyn::common::Duration p99{0};
+    ::bosdyn::common::Duration max{0};
+};
+
+// Counters and latency distributions of a JointControlLoop.
+struct JointControlLoopStats {
+    // Commands sent, and how many of them the stream failed to write.
+    uint64_t ticks = 0;
+    uint64_t write_failures = 0;
+    // Ticks skipped because a tick ran past the deadline of the next one.
+    uint64_t missed_ticks = 0;
+    // How late the loop woke up relative to the deadline of each tick.
+    LatencySummary jitter;
+    // Time from sending a command to receiving robot state that reports it as the last command.
+    LatencySummary round_trip;
+    // Last error returned by the stream.
+    ::bosdyn::common::Status last_error;
+};
+
+// Fixed ring of the most recent latency samples. One thread adds samples and any thread may
+// summarize them.
+class LatencyRing {
+ public:
+    static constexpr size_t kCapacity = 4096;
+
+    void Add(::bosdyn::common::Duration sample) {
+        const uint64_t count = m_count.load(std::memory_order_relaxed);
+        m_samples[count % kCapacity].store(sample.count(), std::memory_order_relaxed);
+        m_count.store(count + 1, std::memory_order_release);
+    }
+
+    LatencySummary Summarize() const;
+
+ private:
+    std::array<std::atomic<int64_t>, kCapacity> m_samples{};
+    std::atomic<uint64_t> m_count{0};
+};
+
+// JointControlLoop streams joint commands to the robot at a fixed rate from a dedicated thread.
+//
+// Setpoints are handed to the loop through SetSetpoint(), which never blocks the loop: the latest
+// setpoint is swapped in through a triple buffer. Each tick reuses one arena-allocated
+// JointControlStreamRequest, only overwriting its values, so the loop does not allocate once it is
+// running. Ticks are scheduled on absolute deadlines, so time spent writing to the stream does not
+// accumulate as drift.
+//
+// Nothing is sent until the first setpoint is set. Gains are sent with the first command and
+// afterwards only when they change. Each command is tagged with an increasing user_command_key;
+// pass robot state stream responses to OnRobotStateStreamResponse() to measure the round trip from
+// sending a command to the robot reporting it.
+class JointControlLoop {
+ public:
+    // Writes one request to the joint control stream.
+    typedef std::function<::bosdyn::common::Status(const ::bosdyn::api::JointControlStreamRequest&)>
+        StreamWriter;
+
+    // The client and the endpoint must outlive the loop. The endpoint must have established time
+    // sync before Start() is called.
+    JointControlLoop(RobotCommandStreamingClient* streaming_client,
+                     TimeSyncEndpoint* time_sync_endpoint,
+                     const JointControlLoopParameters& parameters = JointControlLoopParameters());
+
+    // Sends commands through the given writer instead of a RobotCommandStreamingClient.
+    JointControlLoop(StreamWriter writer, TimeSyncEndpoint* time_sync_endpoint,
+                     const JointControlLoopParameters& parameters = JointControlLoopParameters());
+
+    ~JointControlLoop();
+
+    // Start the loop thread. Returns an error, and does not start, if the loop is already running,
+    // time sync is not established, or the requested scheduling or affinity cannot be applied.
+    ::bosdyn::common::Status Start();
+
+    // Stop the loop thread. Returns within about one period.
+    void Stop();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Set the setpoint sent from the next tick on. Must only be called from one thread at a time.
+    void SetSetpoint(const JointSetpoint& setpoint);
+
+    // Record the round trip of the last command reported in the response. Must only be called from
+    // one thread at a time.
+    void OnRobotStateStreamResponse(const ::bosdyn::api::RobotStateStreamResponse& response);
+
+    JointControlLoopStats GetStats() const;
+
+    // The loop owns a thread, so it is not copyable or movable.
+    JointControlLoop(const JointControlLoop&) = delete;
+    JointControlLoop& operator=(const JointControlLoop&) = delete;
+
+ private:
+    // A command that was sent, for matching robot state to it.
+    struct SentCommand {
+        std::atomic<uint32_t> key{0};
+        std::atomic<int64_t> send_time_nsec{0};
+    };
+    static constexpr size_t kSentCommandCapacity = 1024;
+
+    // Main loop of the loop thread. Sets configured once the thread is configured, and exits early
+    // if that failed.
+    void LoopThreadMethod(std::promise<::bosdyn::common::Status> configured);
+
+    // Fill the request from the latest setpoint and send it.
+    void Tick();
+
+    // Apply the realtime priority and CPU affinity to the calling thread.
+    ::bosdyn::common::Status ConfigureThread();
+
+    StreamWriter m_writer;
+    TimeSyncEndpoint* m_time_sync_endpoint = nullptr;
+    const JointControlLoopParameters m_parameters;
+
+    // The request sent every tick, and its gains while they are detached from it.
+    google::protobuf::Arena m_arena;
+    ::bosdyn::api::JointControlStreamRequest* m_request = nullptr;
+    ::bosdyn::api::JointCommand::UpdateRequest::Gains* m_gains = nullptr;
+
+    ::bosdyn::common::TripleBuffer<JointSetpoint> m_setpoints;
+    std::atomic<bool> m_has_setpoint{false};
+    // Only accessed by the loop thread.
+    bool m_gains_sent = false;
+    uint32_t m_user_command_key = 0;
+
+    std::array<SentCommand, kSentCommandCapacity> m_sent_commands;
+    // Only accessed by the thread calling OnRobotStateStreamResponse().
+    uint32_t m_last_reported_key = 0;
+
+    std::atomic<bool> m_should_stop{false};
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_ticks{0};
+    std::atomic<uint64_t> m_write_failures{0};
+    std::atomic<uint64_t> m_missed_ticks{0};
+    LatencyRing m_jitter;
+    LatencyRing m_round_trip;
+    mutable std::mutex m_error_mutex;
+    ::bosdyn::common::Status m_last_error;
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -23,8 +23,22 @@ const char* RobotCommandClient::s_default_service_name = "robot-command";
 
 const char* RobotCommandClient::s_service_type = "bosdyn.api.RobotCommandService";
 
+RobotCommandClient::~RobotCommandClient() = default;
+
+CommandFeedbackTracker* RobotCommandClient::GetFeedbackTracker() {
+    std::lock_guard<std::mutex> lock(m_feedback_tracker_mutex);
+    if (!m_feedback_tracker) m_feedback_tracker.reset(new CommandFeedbackTracker(this));
+    return m_feedback_tracker.get();
+}
+
 std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync(
     ::bosdyn::api::RobotCommandRequest& request, const RPCParameters& parameters) {
+    return RobotCommandAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync(
+    ::bosdyn::api::RobotCommandRequest& request, const RPCParameters& parameters,
+    RobotCommandCallback on_complete) {
     std::promise<RobotCommandResultType> response;
     std::shared_future<RobotCommandResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -45,7 +59,8 @@ std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync
             request,
             std::bind(&::bosdyn::api::RobotCommandService::StubInterface::AsyncRobotCommand,
                       m_stub.get(), _1, _2, _3),
-            std::bind(&RobotCommandClient::OnRobotCommandComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&RobotCommandClient::OnRobotCommandComplete, this, _1, _2, _3, _4, _5,
+                      std::move(on_complete)),
             std::move(response), parameters);
 
     return future;
@@ -54,6 +69,13 @@ std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync
 std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync(
     ::bosdyn::api::RobotCommand& command, Lease* lease, TimeSyncEndpoint* time_sync_endpoint,
     ::bosdyn::common::TimePoint end_time, const RPCParameters& parameters) {
+    return RobotCommandAsync(command, lease, time_sync_endpoint, end_time, parameters, nullptr);
+}
+
+std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync(
+    ::bosdyn::api::RobotCommand& command, Lease* lease, TimeSyncEndpoint* time_sync_endpoint,
+    ::bosdyn::common::TimePoint end_time, const RPCParameters& parameters,
+    RobotCommandCallback on_complete) {
     std::promise<RobotCommandResultType> response;
     std::shared_future<RobotCommandResultType> future = response.get_future();
 
@@ -105,7 +127,7 @@ std::shared_future<RobotCommandResultType> RobotCommandClient::RobotCommandAsync
     }
 
     // Call the base robot command RPC.
-    return RobotCommandAsync(request, parameters);
+    return RobotCommandAsync(request, parameters, std::move(on_complete));
 }
 
 void RobotCommandClient::MutateEndTime(::bosdyn::api::MobilityCommand::Request* mobility_command,
@@ -132,11 +154,14 @@ void RobotCommandClient::OnRobotCommandComplete(MessagePumpCallBase* call,
                                                 const ::bosdyn::api::RobotCommandRequest& request,
                                                 ::bosdyn::api::RobotCommandResponse&& response,
                                                 const grpc::Status& status,
-                                                std::promise<RobotCommandResultType> promise) {
+                                                std::promise<RobotCommandResultType> promise,
+                                                const RobotCommandCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseWithLeaseAndGetFinalStatus<::bosdyn::api::RobotCommandResponse>(
             status, response, response.status(), m_lease_wallet.get());
-    promise.set_value({ret_status, std::move(response)});
+    RobotCommandResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 RobotCommandResultType RobotCommandClient::RobotCommand(::bosdyn::api::RobotCommandRequest& request,
@@ -154,6 +179,12 @@ RobotCommandResultType RobotCommandClient::RobotCommand(::bosdyn::api::RobotComm
 
 std::shared_future<RobotCommandFeedbackResultType> RobotCommandClient::RobotCommandFeedbackAsync(
     ::bosdyn::api::RobotCommandFeedbackRequest& request, const RPCParameters& parameters) {
+    return RobotCommandFeedbackAsync(request, parameters, nullptr);
+}
+
+std::shared_future<RobotCommandFeedbackResultType> RobotCommandClient::RobotCommandFeedbackAsync(
+    ::bosdyn::api::RobotCommandFeedbackRequest& request, const RPCParameters& parameters,
+    CommandFeedbackCallback on_complete) {
     std::promise<RobotCommandFeedbackResultType> response;
     std::shared_future<RobotCommandFeedbackResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -164,7 +195,8 @@ std::shared_future<RobotCommandFeedbackResultType> RobotCommandClient::RobotComm
         request,
         std::bind(&::bosdyn::api::RobotCommandService::StubInterface::AsyncRobotCommandFeedback,
                   m_stub.get(), _1, _2, _3),
-        std::bind(&RobotCommandClient::OnRobotCommandFeedbackComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&RobotCommandClient::OnRobotCommandFeedbackComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
 
     return future;
@@ -173,14 +205,17 @@ std::shared_future<RobotCommandFeedbackResultType> RobotCommandClient::RobotComm
 void RobotCommandClient::OnRobotCommandFeedbackComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::RobotCommandFeedbackRequest& request,
     ::bosdyn::api::RobotCommandFeedbackResponse&& response, const grpc::Status& status,
-    std::promise<RobotCommandFeedbackResultType> promise) {
+    std::promise<RobotCommandFeedbackResultType> promise,
+    const CommandFeedbackCallback& on_complete) {
     // Feedback indicates the command conditions and does not represent an error code. As
     // such, the response.status will always be a success, regardless of the feedback status value.
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::RobotCommandFeedbackResponse>(
             status, response, SDKErrorCode::Success);
 
-    promise.set_value({ret_status, std::move(response)});
+    RobotCommandFeedbackResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 RobotCommandFeedbackResultType RobotCommandClient::RobotCommandFeedback(
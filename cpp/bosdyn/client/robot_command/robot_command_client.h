@@ -14,8 +14,11 @@
 #include <bosdyn/api/robot_command_service.pb.h>
 
 #include <future>
+#include <memory>
+#include <mutex>
 
 #include "robot_command_error_codes.h"
+#include "bosdyn/client/robot_command/command_feedback_tracker.h"
 #include "bosdyn/client/lease/lease.h"
 #include "bosdyn/client/lease/lease_processors.h"
 #include "bosdyn/client/service_client/service_client.h"
@@ -32,6 +35,9 @@ typedef Result<::bosdyn::api::RobotCommandResponse> RobotCommandResultType;
 typedef Result<::bosdyn::api::RobotCommandFeedbackResponse> RobotCommandFeedbackResultType;
 typedef Result<::bosdyn::api::ClearBehaviorFaultResponse> ClearBehaviorFaultResultType;
 
+// Called with the result of a robot command as soon as it arrives, on the MessagePump thread.
+typedef std::function<void(const RobotCommandResultType&)> RobotCommandCallback;
+
 /**
  * The RobotCommand service handles robot locomotion commands and provides feedback on command
  * status. This creates a client which communicates to the RobotCommand service and can:
@@ -42,7 +48,7 @@ typedef Result<::bosdyn::api::ClearBehaviorFaultResponse> ClearBehaviorFaultResu
 class RobotCommandClient : public ServiceClient {
  public:
     RobotCommandClient() = default;
-    ~RobotCommandClient() = default;
+    ~RobotCommandClient();
 
     // Asynchronous method to issue a robot command.
     std::shared_future<RobotCommandResultType> RobotCommandAsync(
@@ -54,6 +60,15 @@ class RobotCommandClient : public ServiceClient {
         ::bosdyn::common::TimePoint end_time =
             ::bosdyn::common::TimePoint(::bosdyn::common::Duration(0)),
         const RPCParameters& parameters = RPCParameters());
+    // Overloads that also call on_complete with the result before the future is set. The callback
+    // is not called if the command fails before its RPC is started.
+    std::shared_future<RobotCommandResultType> RobotCommandAsync(
+        ::bosdyn::api::RobotCommandRequest& request, const RPCParameters& parameters,
+        RobotCommandCallback on_complete);
+    std::shared_future<RobotCommandResultType> RobotCommandAsync(
+        ::bosdyn::api::RobotCommand& command, Lease* lease, TimeSyncEndpoint* time_sync_endpoint,
+        ::bosdyn::common::TimePoint end_time, const RPCParameters& parameters,
+        RobotCommandCallback on_complete);
 
     // Synchronous method to issue a robot command.
     RobotCommandResultType RobotCommand(::bosdyn::api::RobotCommandRequest& request,
@@ -70,6 +85,10 @@ class RobotCommandClient : public ServiceClient {
     std::shared_future<RobotCommandFeedbackResultType> RobotCommandFeedbackAsync(
         ::bosdyn::api::RobotCommandFeedbackRequest& request,
         const RPCParameters& parameters = RPCParameters());
+    // Overload that also calls on_complete with the result before the future is set.
+    std::shared_future<RobotCommandFeedbackResultType> RobotCommandFeedbackAsync(
+        ::bosdyn::api::RobotCommandFeedbackRequest& request, const RPCParameters& parameters,
+        CommandFeedbackCallback on_complete);
 
     // Synchronous method to request robot command feedback.
     RobotCommandFeedbackResultType RobotCommandFeedback(
@@ -109,6 +128,10 @@ class RobotCommandClient : public ServiceClient {
     // Get the lease wallet for the robot command service.
     std::shared_ptr<LeaseWallet> GetLeaseWallet() { return m_lease_wallet; }
 
+    // Get the feedback tracker shared by all waits on commands of this client, creating it on first
+    // use.
+    CommandFeedbackTracker* GetFeedbackTracker();
+
     // Add a timesync endpoint into the client. This will be used to convert command end times.
     void AddTimeSyncEndpoint(TimeSyncEndpoint* endpoint) { m_time_sync_endpoint = endpoint; };
 
@@ -122,14 +145,16 @@ class RobotCommandClient : public ServiceClient {
                                 const ::bosdyn::api::RobotCommandRequest& request,
                                 ::bosdyn::api::RobotCommandResponse&& response,
                                 const grpc::Status& status,
-                                std::promise<RobotCommandResultType> promise);
+                                std::promise<RobotCommandResultType> promise,
+                                const RobotCommandCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to request command feedback.
     void OnRobotCommandFeedbackComplete(MessagePumpCallBase* call,
                                         const ::bosdyn::api::RobotCommandFeedbackRequest& request,
                                         ::bosdyn::api::RobotCommandFeedbackResponse&& response,
                                         const grpc::Status& status,
-                                        std::promise<RobotCommandFeedbackResultType> promise);
+                                        std::promise<RobotCommandFeedbackResultType> promise,
+                                        const CommandFeedbackCallback& on_complete);
 
     // Callback function registered for the asynchronous calls to clear a behavior fault.
     void OnClearBehaviorFaultComplete(MessagePumpCallBase* call,
@@ -160,6 +185,11 @@ class RobotCommandClient : public ServiceClient {
 
     void MutateEndTime(::bosdyn::api::MobilityCommand::Request* mobility_command,
                        const google::protobuf::Timestamp& end_time);
+
+    std::mutex m_feedback_tracker_mutex;
+    // Declared last so it is destroyed, waiting for its feedback RPCs, before the rest of the
+    // client.
+    std::unique_ptr<CommandFeedbackTracker> m_feedback_tracker;
 };
 
 }  // namespace client
@@ -13,6 +13,7 @@
 #include <bosdyn/api/gripper_command.pb.h>
 
 #include "robot_command_helpers.h"
+#include "bosdyn/client/robot_command/command_feedback_tracker.h"
 #include "bosdyn/client/error_codes/error_type_condition.h"
 #include "bosdyn/client/error_codes/rpc_error_code.h"
 #include "bosdyn/common/status.h"
@@ -71,84 +72,138 @@ RobotCommandFeedbackResultType BlockUntilArmArrives(
                                 std::chrono::milliseconds(poll_period_msec));
 }
 
-RobotCommandFeedbackResultType BlockUntilArmArrives(
-    ::bosdyn::client::RobotCommandClient& robot_command_client, int cmd_id,
-    ::bosdyn::common::Duration timeout, ::bosdyn::common::Duration poll_period) {
-    ::bosdyn::api::RobotCommandFeedbackRequest feedback_req;
-    feedback_req.set_robot_command_id(cmd_id);
+namespace {
 
-    ::bosdyn::client::RobotCommandFeedbackResultType feedback_res;
+// Wait for a command with the feedback tracker of the client, reporting a timeout with the given
+// message.
+RobotCommandFeedbackResultType BlockUntilFinished(
+    ::bosdyn::client::RobotCommandClient& robot_command_client, int cmd_id,
+    CommandFinishedFn is_finished, ::bosdyn::common::Duration timeout,
+    ::bosdyn::common::Duration poll_period, const char* timeout_message) {
+    RobotCommandFeedbackResultType result =
+        robot_command_client.GetFeedbackTracker()
+            ->WaitForCommand(cmd_id, std::move(is_finished), timeout, poll_period)
+            .get();
+    if (result.status.code() == BlockingRobotCommandErrorCode::CommandTimeoutError) {
+        result.status = {BlockingRobotCommandErrorCode::CommandTimeoutError, timeout_message};
+    }
+    return result;
+}
 
-    auto start_time = ::bosdyn::common::NsecSinceEpoch();
-    const auto end_time = start_time + timeout;
+}  // namespace
 
-    while (timeout <= ::bosdyn::common::Duration(0) ||
-           ::bosdyn::common::NsecSinceEpoch() < end_time) {
-        feedback_res = robot_command_client.RobotCommandFeedback(feedback_req);
-        // If the RPC timed out but this function hasn't timed out, keep trying.
-        if (!feedback_res.status &&
-            feedback_res.status.code() != ::bosdyn::client::RPCErrorCode::TimedOutError) {
-            return feedback_res;
+bool ArmCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                        ::bosdyn::common::Status* status) {
+    const auto& arm_feedback = response.feedback().synchronized_feedback().arm_command_feedback();
+
+    if (arm_feedback.has_arm_cartesian_feedback()) {
+        if (arm_feedback.arm_cartesian_feedback().status() ==
+            ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_COMPLETE) {
+            *status = {BlockingRobotCommandErrorCode::Success};
+            return true;
+        } else if (arm_feedback.arm_cartesian_feedback().status() ==
+                       ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_STALLED ||
+                   arm_feedback.arm_cartesian_feedback().status() ==
+                       ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_CANCELLED) {
+            *status = {BlockingRobotCommandErrorCode::CommandFeedbackError};
+            return true;
         }
+    } else if (arm_feedback.has_arm_gaze_feedback()) {
+        if (arm_feedback.arm_gaze_feedback().status() ==
+            ::bosdyn::api::GazeCommand::Feedback::STATUS_TRAJECTORY_COMPLETE) {
+            *status = {BlockingRobotCommandErrorCode::Success};
+            return true;
+        } else if (arm_feedback.arm_gaze_feedback().status() ==
+                   ::bosdyn::api::GazeCommand::Feedback::STATUS_TOOL_TRAJECTORY_STALLED) {
+            *status = {BlockingRobotCommandErrorCode::CommandFeedbackError};
+            return true;
+        }
+    } else if (arm_feedback.has_arm_impedance_feedback()) {
+        if (arm_feedback.arm_impedance_feedback().status() ==
+            ::bosdyn::api::ArmImpedanceCommand::Feedback::STATUS_TRAJECTORY_COMPLETE) {
+            *status = {BlockingRobotCommandErrorCode::Success};
+            return true;
+        } else if (arm_feedback.arm_impedance_feedback().status() ==
+                   ::bosdyn::api::ArmImpedanceCommand::Feedback::STATUS_TRAJECTORY_STALLED) {
+            *status = {BlockingRobotCommandErrorCode::CommandFeedbackError};
+            return true;
+        }
+    } else if (arm_feedback.has_arm_joint_move_feedback()) {
+        if (arm_feedback.arm_joint_move_feedback().status() ==
+            ::bosdyn::api::ArmJointMoveCommand::Feedback::STATUS_COMPLETE) {
+            *status = {BlockingRobotCommandErrorCode::Success};
+            return true;
+        } else if (arm_feedback.arm_joint_move_feedback().status() ==
+                   ::bosdyn::api::ArmJointMoveCommand::Feedback::STATUS_STALLED) {
+            *status = {BlockingRobotCommandErrorCode::CommandFeedbackError};
+            return true;
+        }
+    } else if (arm_feedback.has_named_arm_position_feedback()) {
+        if (arm_feedback.named_arm_position_feedback().status() ==
+            ::bosdyn::api::NamedArmPositionsCommand::Feedback::STATUS_COMPLETE) {
+            *status = {BlockingRobotCommandErrorCode::Success};
+            return true;
+        } else if (arm_feedback.named_arm_position_feedback().status() ==
+                   ::bosdyn::api::NamedArmPositionsCommand::Feedback::STATUS_STALLED_HOLDING_ITEM) {
+            *status = {BlockingRobotCommandErrorCode::CommandFeedbackError};
+            return true;
+        }
+    } else {
+        *status = {BlockingRobotCommandErrorCode::CommandFeedbackError,
+                   "Expected one of the following commands: ArmCartesianCommand, GazeCommand, "
+                   "ArmJointMoveCommand, NamedArmPositionsCommand, or ArmImpedanceCommand."};
+        return true;
+    }
+    return false;
+}
 
-        auto arm_feedback =
-            feedback_res.response.feedback().synchronized_feedback().arm_command_feedback();
+bool GripperCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                            ::bosdyn::common::Status* status) {
+    const auto& gripper_feedback = response.feedback()
+                                       .synchronized_feedback()
+                                       .gripper_command_feedback()
+                                       .claw_gripper_feedback();
+
+    if (gripper_feedback.status() == ::bosdyn::api::ClawGripperCommand::Feedback::STATUS_AT_GOAL ||
+        gripper_feedback.status() ==
+            ::bosdyn::api::ClawGripperCommand::Feedback::STATUS_APPLYING_FORCE) {
+        *status = {BlockingRobotCommandErrorCode::Success};
+        return true;
+    }
+    return false;
+}
 
-        if (arm_feedback.has_arm_cartesian_feedback()) {
-            if (arm_feedback.arm_cartesian_feedback().status() ==
-                ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_COMPLETE) {
-                return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-            } else if (
-                arm_feedback.arm_cartesian_feedback().status() ==
-                    ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_STALLED ||
-                arm_feedback.arm_cartesian_feedback().status() ==
-                    ::bosdyn::api::ArmCartesianCommand::Feedback::STATUS_TRAJECTORY_CANCELLED) {
-                return {{BlockingRobotCommandErrorCode::CommandFeedbackError}, feedback_res.move()};
-            }
-        } else if (arm_feedback.has_arm_gaze_feedback()) {
-            if (arm_feedback.arm_gaze_feedback().status() ==
-                ::bosdyn::api::GazeCommand::Feedback::STATUS_TRAJECTORY_COMPLETE) {
-                return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-            } else if (arm_feedback.arm_gaze_feedback().status() ==
-                       ::bosdyn::api::GazeCommand::Feedback::STATUS_TOOL_TRAJECTORY_STALLED) {
-                return {{BlockingRobotCommandErrorCode::CommandFeedbackError}, feedback_res.move()};
-            }
-        } else if (arm_feedback.has_arm_impedance_feedback()) {
-            if (arm_feedback.arm_impedance_feedback().status() ==
-                ::bosdyn::api::ArmImpedanceCommand::Feedback::STATUS_TRAJECTORY_COMPLETE) {
-                return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-            } else if (arm_feedback.arm_impedance_feedback().status() ==
-                       ::bosdyn::api::ArmImpedanceCommand::Feedback::STATUS_TRAJECTORY_STALLED) {
-                return {{BlockingRobotCommandErrorCode::CommandFeedbackError}, feedback_res.move()};
-            }
-        } else if (arm_feedback.has_arm_joint_move_feedback()) {
-            if (arm_feedback.arm_joint_move_feedback().status() ==
-                ::bosdyn::api::ArmJointMoveCommand::Feedback::STATUS_COMPLETE) {
-                return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-            } else if (arm_feedback.arm_joint_move_feedback().status() ==
-                       ::bosdyn::api::ArmJointMoveCommand::Feedback::STATUS_STALLED) {
-                return {{BlockingRobotCommandErrorCode::CommandFeedbackError}, feedback_res.move()};
-            }
-        } else if (arm_feedback.has_named_arm_position_feedback()) {
-            if (arm_feedback.named_arm_position_feedback().status() ==
-                ::bosdyn::api::NamedArmPositionsCommand::Feedback::STATUS_COMPLETE) {
-                return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-            } else if (arm_feedback.named_arm_position_feedback().status() ==
-                       ::bosdyn::api::NamedArmPositionsCommand::Feedback::
-                           STATUS_STALLED_HOLDING_ITEM) {
-                return {{BlockingRobotCommandErrorCode::CommandFeedbackError}, feedback_res.move()};
-            }
-        } else {
-            return {{BlockingRobotCommandErrorCode::CommandFeedbackError,
-                     "Expected one of the following commands: ArmCartesianCommand, GazeCommand, "
-                     "ArmJointMoveCommand, NamedArmPositionsCommand, or ArmImpedanceCommand."},
-                    feedback_res.move()};
-        }
+bool StandCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                          ::bosdyn::common::Status* status) {
+    const auto& stand_feedback =
+        response.feedback().synchronized_feedback().mobility_command_feedback().stand_feedback();
 
-        std::this_thread::sleep_for(poll_period);
+    if (stand_feedback.status() == ::bosdyn::api::StandCommand::Feedback::STATUS_IS_STANDING) {
+        *status = {BlockingRobotCommandErrorCode::Success};
+        return true;
     }
-    return {{BlockingRobotCommandErrorCode::CommandTimeoutError, "ArmCommand failed or timed out."},
-            feedback_res.response};
+    return false;
+}
+
+bool SE2TrajectoryCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                                  ::bosdyn::common::Status* status) {
+    const auto& traj_feedback = response.feedback()
+                                    .synchronized_feedback()
+                                    .mobility_command_feedback()
+                                    .se2_trajectory_feedback();
+
+    if (traj_feedback.status() == ::bosdyn::api::SE2TrajectoryCommand::Feedback::STATUS_STOPPED) {
+        *status = {BlockingRobotCommandErrorCode::Success};
+        return true;
+    }
+    return false;
+}
+
+RobotCommandFeedbackResultType BlockUntilArmArrives(
+    ::bosdyn::client::RobotCommandClient& robot_command_client, int cmd_id,
+    ::bosdyn::common::Duration timeout, ::bosdyn::common::Duration poll_period) {
+    return BlockUntilFinished(robot_command_client, cmd_id, ArmCommandFinished, timeout,
+                              poll_period, "ArmCommand failed or timed out.");
 }
 
 RobotCommandFeedbackResultType BlockUntilGripperArrives(
@@ -161,113 +216,22 @@ RobotCommandFeedbackResultType BlockUntilGripperArrives(
 RobotCommandFeedbackResultType BlockUntilGripperArrives(
     ::bosdyn::client::RobotCommandClient& robot_command_client, int cmd_id,
     ::bosdyn::common::Duration timeout, ::bosdyn::common::Duration poll_period) {
-    ::bosdyn::api::RobotCommandFeedbackRequest feedback_req;
-    feedback_req.set_robot_command_id(cmd_id);
-
-    ::bosdyn::client::RobotCommandFeedbackResultType feedback_res;
-
-    auto start_time = ::bosdyn::common::NsecSinceEpoch();
-    const auto end_time = start_time + timeout;
-
-    while (timeout <= ::bosdyn::common::Duration(0) ||
-           ::bosdyn::common::NsecSinceEpoch() < end_time) {
-        feedback_res = robot_command_client.RobotCommandFeedback(feedback_req);
-        // If the RPC timed out but this function hasn't timed out, keep trying.
-        if (!feedback_res.status &&
-            feedback_res.status.code() != ::bosdyn::client::RPCErrorCode::TimedOutError) {
-            return feedback_res;
-        }
-
-        auto gripper_feedback = feedback_res.response.feedback()
-                                    .synchronized_feedback()
-                                    .gripper_command_feedback()
-                                    .claw_gripper_feedback();
-
-        if (gripper_feedback.status() ==
-                ::bosdyn::api::ClawGripperCommand::Feedback::STATUS_AT_GOAL ||
-            gripper_feedback.status() ==
-                ::bosdyn::api::ClawGripperCommand::Feedback::STATUS_APPLYING_FORCE) {
-            return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-        }
-
-        std::this_thread::sleep_for(poll_period);
-    }
-    return {{BlockingRobotCommandErrorCode::CommandTimeoutError,
-             "The GripperCommand failed or timed out."},
-            feedback_res.move()};
+    return BlockUntilFinished(robot_command_client, cmd_id, GripperCommandFinished, timeout,
+                              poll_period, "The GripperCommand failed or timed out.");
 }
 
 RobotCommandFeedbackResultType BlockUntilStandComplete(
     ::bosdyn::client::RobotCommandClient& robot_command_client, int cmd_id,
     ::bosdyn::common::Duration timeout, ::bosdyn::common::Duration poll_period) {
-    ::bosdyn::api::RobotCommandFeedbackRequest feedback_req;
-    feedback_req.set_robot_command_id(cmd_id);
-
-    ::bosdyn::client::RobotCommandFeedbackResultType feedback_res;
-
-    auto start_time = ::bosdyn::common::NsecSinceEpoch();
-    const auto end_time = start_time + timeout;
-
-    while (timeout <= ::bosdyn::common::Duration(0) ||
-           ::bosdyn::common::NsecSinceEpoch() < end_time) {
-        feedback_res = robot_command_client.RobotCommandFeedback(feedback_req);
-        // If the RPC timed out but this function hasn't timed out, keep trying.
-        if (!feedback_res.status &&
-            feedback_res.status.code() != ::bosdyn::client::RPCErrorCode::TimedOutError) {
-            return feedback_res;
-        }
-
-        auto stand_feedback = feedback_res.response.feedback()
-                                  .synchronized_feedback()
-                                  .mobility_command_feedback()
-                                  .stand_feedback();
-
-        if (stand_feedback.status() == ::bosdyn::api::StandCommand::Feedback::STATUS_IS_STANDING) {
-            return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-        }
-
-        std::this_thread::sleep_for(poll_period);
-    }
-    return {{BlockingRobotCommandErrorCode::CommandTimeoutError,
-             "The StandCommand failed or timed out."},
-            feedback_res.move()};
+    return BlockUntilFinished(robot_command_client, cmd_id, StandCommandFinished, timeout,
+                              poll_period, "The StandCommand failed or timed out.");
 }
 
 RobotCommandFeedbackResultType BlockUntilSE2TrajectoryComplete(
     ::bosdyn::client::RobotCommandClient& robot_command_client, int cmd_id,
     ::bosdyn::common::Duration timeout, ::bosdyn::common::Duration poll_period) {
-    ::bosdyn::api::RobotCommandFeedbackRequest feedback_req;
-    feedback_req.set_robot_command_id(cmd_id);
-
-    ::bosdyn::client::RobotCommandFeedbackResultType feedback_res;
-
-    auto start_time = ::bosdyn::common::NsecSinceEpoch();
-    const auto end_time = start_time + timeout;
-
-    while (timeout <= ::bosdyn::common::Duration(0) ||
-           ::bosdyn::common::NsecSinceEpoch() < end_time) {
-        feedback_res = robot_command_client.RobotCommandFeedback(feedback_req);
-        // If the RPC timed out but this function hasn't timed out, keep trying.
-        if (!feedback_res.status &&
-            feedback_res.status.code() != ::bosdyn::client::RPCErrorCode::TimedOutError) {
-            return feedback_res;
-        }
-
-        auto traj_feedback = feedback_res.response.feedback()
-                                 .synchronized_feedback()
-                                 .mobility_command_feedback()
-                                 .se2_trajectory_feedback();
-
-        if (traj_feedback.status() ==
-            ::bosdyn::api::SE2TrajectoryCommand::Feedback::STATUS_STOPPED) {
-            return {{BlockingRobotCommandErrorCode::Success}, feedback_res.move()};
-        }
-
-        std::this_thread::sleep_for(poll_period);
-    }
-    return {{BlockingRobotCommandErrorCode::CommandTimeoutError,
-             "The TrajectoryCommand failed or timed out."},
-            feedback_res.move()};
+    return BlockUntilFinished(robot_command_client, cmd_id, SE2TrajectoryCommandFinished, timeout,
+                              poll_period, "The TrajectoryCommand failed or timed out.");
 }
 }  // namespace client
 
@@ -9,9 +9,12 @@
 
 #pragma once
 
-// A set of free helper functions to be used with a robot command client.
+// A set of free helper functions to be used with a robot command client. The BlockUntil helpers
+// wait with the CommandFeedbackTracker of the client, so concurrent waits share its feedback
+// requests.
 
 #include "robot_command_client.h"
+#include "bosdyn/client/robot_command/command_feedback_tracker.h"
 
 namespace bosdyn {
 
@@ -27,6 +30,24 @@ enum class BlockingRobotCommandErrorCode {
 
 std::error_code make_error_code(BlockingRobotCommandErrorCode);
 
+// CommandFinishedFn checks for CommandFeedbackTracker::WaitForCommand(), one per kind of command
+// awaited by the BlockUntil helpers below. Each returns true once the feedback shows the command
+// finished, with status set to Success or CommandFeedbackError.
+
+// Checks ArmCartesianCommand, GazeCommand, ArmJointMoveCommand, NamedArmPositionsCommand and
+// ArmImpedanceCommand feedback. Finishes with CommandFeedbackError for any other arm command.
+bool ArmCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                        ::bosdyn::common::Status* status);
+// Finishes when a ClawGripperCommand reaches its goal or applies force.
+bool GripperCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                            ::bosdyn::common::Status* status);
+// Finishes when the robot is standing.
+bool StandCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                          ::bosdyn::common::Status* status);
+// Finishes when an SE2TrajectoryCommand has stopped.
+bool SE2TrajectoryCommandFinished(const ::bosdyn::api::RobotCommandFeedbackResponse& response,
+                                  ::bosdyn::common::Status* status);
+
 /**
  * Blocks until the arm achieves a finishing state for the specific arm command. This helper will
  * block and check the feedback for ArmCartesianCommand, GazeCommand, ArmJointMoveCommand,
@@ -9,6 +9,11 @@
 
 #include "bosdyn/client/robot_state/robot_state_streaming_client.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "bosdyn/common/time.h"
+
 namespace bosdyn {
 
 namespace client {
@@ -17,6 +22,60 @@ const char* RobotStateStreamingClient::s_default_service_name = "robot-state-str
 
 const char* RobotStateStreamingClient::s_service_type = "bosdyn.api.RobotStateStreamingService";
 
+namespace {
+
+void CopyVec3(const ::bosdyn::api::Vec3& vec, std::array<double, 3>* out) {
+    (*out)[0] = vec.x();
+    (*out)[1] = vec.y();
+    (*out)[2] = vec.z();
+}
+
+template <size_t N>
+size_t CopyRepeated(const google::protobuf::RepeatedField<float>& field,
+                    std::array<float, N>* out) {
+    const size_t size = std::min<size_t>(field.size(), N);
+    std::copy(field.begin(), field.begin() + size, out->begin());
+    return size;
+}
+
+}  // namespace
+
+void DecodeRobotStateStreamResponse(const ::bosdyn::api::RobotStateStreamResponse& response,
+                                    RobotStateSnapshot* snapshot) {
+    const auto& joint_states = response.joint_states();
+    snapshot->joint_acquisition_time_nsec =
+        ::bosdyn::common::TimestampToNsec(joint_states.acquisition_timestamp());
+    snapshot->num_joints = std::min({CopyRepeated(joint_states.position(), &snapshot->position),
+                                     CopyRepeated(joint_states.velocity(), &snapshot->velocity),
+                                     CopyRepeated(joint_states.load(), &snapshot->load)});
+
+    const auto& packets = response.inertial_state().packets();
+    snapshot->has_imu_packet = !packets.empty();
+    if (snapshot->has_imu_packet) {
+        const auto& packet = packets[packets.size() - 1];
+        snapshot->imu_time_nsec = ::bosdyn::common::TimestampToNsec(packet.timestamp());
+        CopyVec3(packet.acceleration_rt_odom_in_link_frame(),
+                 &snapshot->imu_acceleration_rt_odom_in_link_frame);
+        CopyVec3(packet.angular_velocity_rt_odom_in_link_frame(),
+                 &snapshot->imu_angular_velocity_rt_odom_in_link_frame);
+        snapshot->imu_odom_rot_link[0] = packet.odom_rot_link().w();
+        snapshot->imu_odom_rot_link[1] = packet.odom_rot_link().x();
+        snapshot->imu_odom_rot_link[2] = packet.odom_rot_link().y();
+        snapshot->imu_odom_rot_link[3] = packet.odom_rot_link().z();
+    }
+
+    snapshot->num_feet = std::min<size_t>(response.contact_states_size(), kMaxSnapshotFeet);
+    for (size_t i = 0; i < snapshot->num_feet; ++i) {
+        snapshot->foot_contacts[i] = response.contact_states(static_cast<int>(i));
+    }
+
+    snapshot->last_command_key = response.last_command().user_command_key();
+    snapshot->last_command_received_time_nsec =
+        ::bosdyn::common::TimestampToNsec(response.last_command().received_timestamp());
+}
+
+RobotStateStreamingClient::~RobotStateStreamingClient() { StopBackgroundStream(); }
+
 RobotStateStreamResultType RobotStateStreamingClient::GetRobotStateStream() {
     ::bosdyn::api::RobotStateStreamRequest request;
     ::bosdyn::api::RobotStateStreamResponse response;
@@ -35,6 +94,90 @@ RobotStateStreamResultType RobotStateStreamingClient::GetRobotStateStream() {
     return {::bosdyn::common::Status(JointControlStreamErrorCode::Success), std::move(response)};
 }
 
+void RobotStateStreamingClient::StartBackgroundStream(
+    const RobotStateStreamParameters& parameters) {
+    if (m_stream_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_stream_mutex);
+        m_stream_should_stop = false;
+    }
+    m_stream_thread =
+        std::thread(&RobotStateStreamingClient::BackgroundStreamThreadMethod, this, parameters);
+}
+
+void RobotStateStreamingClient::StopBackgroundStream() {
+    {
+        std::lock_guard<std::mutex> lock(m_stream_mutex);
+        m_stream_should_stop = true;
+        if (m_stream_context) m_stream_context->TryCancel();
+    }
+    m_stream_cv.notify_all();
+    if (m_stream_thread.joinable()) {
+        m_stream_thread.join();
+    }
+}
+
+::bosdyn::common::Status RobotStateStreamingClient::GetBackgroundStreamStatus() const {
+    std::lock_guard<std::mutex> lock(m_stream_mutex);
+    return m_stream_status;
+}
+
+void RobotStateStreamingClient::BackgroundStreamThreadMethod(
+    RobotStateStreamParameters parameters) {
+    // The response is reused so that reading into it stops allocating once its fields have grown.
+    ::bosdyn::api::RobotStateStreamRequest request;
+    ::bosdyn::api::RobotStateStreamResponse response;
+    uint64_t sequence = 0;
+    uint32_t stream_generation = 0;
+    auto reconnect_delay = parameters.initial_reconnect_delay;
+
+    while (true) {
+        ::grpc::ClientContext* context = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_stream_mutex);
+            if (m_stream_should_stop) break;
+            m_stream_context.reset(new ::grpc::ClientContext());
+            context = m_stream_context.get();
+        }
+
+        ++stream_generation;
+        bool received_response = false;
+        ::bosdyn::common::Status status(JointControlStreamErrorCode::StreamingFailed);
+        auto reader = m_stub->GetRobotStateStream(context, request);
+        if (!reader) {
+            status = ::bosdyn::common::Status(JointControlStreamErrorCode::ResponseReaderFailed);
+        } else {
+            while (reader->Read(&response)) {
+                RobotStateSnapshot& snapshot = m_snapshots.WriteBuffer();
+                DecodeRobotStateStreamResponse(response, &snapshot);
+                snapshot.sequence = ++sequence;
+                snapshot.stream_generation = stream_generation;
+                snapshot.receive_time_nsec = ::bosdyn::common::NowNsec();
+                m_snapshots.Publish();
+                received_response = true;
+            }
+            // The robot may end the stream cleanly, e.g. when it shuts the service down, which is
+            // not a failure even though the stream is reopened.
+            const auto grpc_status = reader->Finish();
+            status = grpc_status.ok()
+                         ? ::bosdyn::common::Status(JointControlStreamErrorCode::Success)
+                         : ::bosdyn::common::Status(JointControlStreamErrorCode::StreamingFailed,
+                                                    grpc_status.error_message());
+        }
+        reader.reset();
+
+        // Back off while the stream keeps failing without delivering anything.
+        if (received_response) reconnect_delay = parameters.initial_reconnect_delay;
+        std::unique_lock<std::mutex> lock(m_stream_mutex);
+        m_stream_status = std::move(status);
+        m_stream_context.reset();
+        const bool should_stop =
+            m_stream_cv.wait_for(lock, reconnect_delay, [this]() { return m_stream_should_stop; });
+        if (should_stop) break;
+        reconnect_delay = std::min(reconnect_delay * 2, parameters.max_reconnect_delay);
+    }
+}
+
 ServiceClient::QualityOfService RobotStateStreamingClient::GetQualityOfService() const {
     return QualityOfService::NORMAL;
 }
@@ -13,8 +13,14 @@
 #include <bosdyn/api/robot_state_service.grpc.pb.h>
 #include <bosdyn/api/robot_state_service.pb.h>
 
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "bosdyn/client/error_codes/joint_control_stream_error_code.h"
 #include "bosdyn/client/service_client/service_client.h"
+#include "bosdyn/common/triple_buffer.h"
 
 namespace bosdyn {
 
@@ -24,17 +30,91 @@ namespace client {
 // to the data/response message the RPC was returning from the robot.
 typedef Result<::bosdyn::api::RobotStateStreamResponse> RobotStateStreamResultType;
 
+// Largest number of joints and feet kept in a RobotStateSnapshot. Spot with an arm has 19 joints.
+constexpr size_t kMaxSnapshotJoints = 19;
+constexpr size_t kMaxSnapshotFeet = 4;
+
+// The parts of a RobotStateStreamResponse needed by a control loop, stored as plain values so the
+// snapshot can be handed between threads without allocating. Times are in nanoseconds since the
+// epoch; robot times are in the robot clock.
+struct RobotStateSnapshot {
+    // Number of responses received by the background stream, starting at 1. Zero if no response
+    // has been received yet.
+    uint64_t sequence = 0;
+    // Number of times the background stream was opened, including the stream this response came
+    // from. A change in this value means responses may have been missed while reconnecting.
+    uint32_t stream_generation = 0;
+    // Local time at which the response was received.
+    int64_t receive_time_nsec = 0;
+
+    // Joint states, in the order of the bosdyn.api.spot.JointIndex enum.
+    int64_t joint_acquisition_time_nsec = 0;
+    size_t num_joints = 0;
+    std::array<float, kMaxSnapshotJoints> position{};
+    std::array<float, kMaxSnapshotJoints> velocity{};
+    std::array<float, kMaxSnapshotJoints> load{};
+
+    // Newest IMU packet of the response, if it had any.
+    bool has_imu_packet = false;
+    int64_t imu_time_nsec = 0;
+    std::array<double, 3> imu_acceleration_rt_odom_in_link_frame{};
+    std::array<double, 3> imu_angular_velocity_rt_odom_in_link_frame{};
+    // Quaternion as w, x, y, z.
+    std::array<double, 4> imu_odom_rot_link{};
+
+    size_t num_feet = 0;
+    std::array<::bosdyn::api::FootState::Contact, kMaxSnapshotFeet> foot_contacts{};
+
+    // Key and robot receive time of the last joint command the robot received.
+    uint32_t last_command_key = 0;
+    int64_t last_command_received_time_nsec = 0;
+};
+
+// Copy the values of the response into the snapshot, without touching its sequence, stream
+// generation or receive time. Joints and feet beyond the capacity of the snapshot are dropped.
+void DecodeRobotStateStreamResponse(const ::bosdyn::api::RobotStateStreamResponse& response,
+                                    RobotStateSnapshot* snapshot);
+
+// Settings of the background robot state stream.
+struct RobotStateStreamParameters {
+    // When the stream fails or ends, it is reopened after this delay, doubling each time a stream
+    // ends without receiving any response, up to max_reconnect_delay.
+    ::bosdyn::common::Duration initial_reconnect_delay = std::chrono::milliseconds(10);
+    ::bosdyn::common::Duration max_reconnect_delay = std::chrono::seconds(1);
+};
+
 class RobotStateStreamingClient : public ServiceClient {
  public:
     // Constructor for the RobotStateStreaming client.
     RobotStateStreamingClient() = default;
 
-    // Destructor for the RobotStateStreaming client.
-    ~RobotStateStreamingClient() = default;
+    // Destructor for the RobotStateStreaming client. Stops the background stream.
+    ~RobotStateStreamingClient();
 
     // Synchronous method to get dynamic robot state.
     RobotStateStreamResultType GetRobotStateStream();
 
+    // Open the stream on a background thread, which decodes every response into a
+    // RobotStateSnapshot and reopens the stream with backoff when it ends. Do not mix with
+    // GetRobotStateStream(). Does nothing if the background stream is already running.
+    void StartBackgroundStream(
+        const RobotStateStreamParameters& parameters = RobotStateStreamParameters());
+
+    // Stop the background stream, cancelling the read in progress.
+    void StopBackgroundStream();
+
+    // Return the latest snapshot received by the background stream, without locking, allocating
+    // or copying. The reference stays valid until the next call. Must only be called from one
+    // thread at a time; the sequence is zero until the first response is received.
+    const RobotStateSnapshot& GetLatestRobotState() {
+        m_snapshots.Update();
+        return m_snapshots.ReadBuffer();
+    }
+
+    // Return the status of the last stream that ended: Success if the robot finished it cleanly
+    // or none has ended yet, and StreamingFailed or ResponseReaderFailed if it failed.
+    ::bosdyn::common::Status GetBackgroundStreamStatus() const;
+
     // Sets the QualityOfService enum for the robot state client to be used for network selection
     // optimization.
     QualityOfService GetQualityOfService() const override;
@@ -66,6 +146,19 @@ class RobotStateStreamingClient : public ServiceClient {
 
     std::unique_ptr<::grpc::ClientReaderInterface<::bosdyn::api::RobotStateStreamResponse>>
         m_response_reader;
+
+    // Main loop of the background stream thread.
+    void BackgroundStreamThreadMethod(RobotStateStreamParameters parameters);
+
+    ::bosdyn::common::TripleBuffer<RobotStateSnapshot> m_snapshots;
+
+    // Guards the stop flag, the context of the open background stream and its last status.
+    mutable std::mutex m_stream_mutex;
+    std::condition_variable m_stream_cv;
+    bool m_stream_should_stop = false;
+    std::unique_ptr<::grpc::ClientContext> m_stream_context;
+    ::bosdyn::common::Status m_stream_status{JointControlStreamErrorCode::Success};
+    std::thread m_stream_thread;
 };
 
 }  // namespace client
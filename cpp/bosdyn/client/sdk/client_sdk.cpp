@@ -98,6 +98,14 @@ void ClientSdk::SetClientName(const std::string& client_name) {
     return ::bosdyn::common::Status(SDKErrorCode::Success);
 }
 
+void ClientSdk::SetNumCompletionQueues(size_t num_completion_queues) {
+    BOSDYN_ASSERT_PRECONDITION(
+        !m_is_robot_created, "Completion queues cannot be set after any robots are created.");
+    BOSDYN_ASSERT_PRECONDITION(num_completion_queues > 0,
+                               "MessagePump needs at least one completion queue.");
+    m_num_completion_queues = num_completion_queues;
+}
+
 void ClientSdk::Init() {
     // Verify that all the information is set correctly
     // SDK cannot be initialized before calling Init().
@@ -176,7 +184,7 @@ Result<std::unique_ptr<::bosdyn::client::Robot>> ClientSdk::CreateRobot(
 
     if (!message_pump) {
         // ClientSdk uses one message pump per Robot by default.
-        message_pump = std::make_shared<MessagePump>();
+        message_pump = std::make_shared<MessagePump>(m_num_completion_queues);
         message_pump->AutoUpdate(std::chrono::milliseconds(100));
     }
     robot->SetDefaultMessagePump(message_pump);
@@ -46,6 +46,12 @@ class ClientSdk {
     // Initialize the SDK.
     void Init();
 
+    // Set the number of completion queues of the MessagePump that CreateRobot creates when none is
+    // passed in. Pass kNumCompletionQueueClasses to give every ServiceClient QualityOfService its
+    // own queue and worker thread, so LATENCY_CRITICAL completions are not processed behind large
+    // BULK_THROUGHPUT responses. Defaults to 1. Must be called before any robots are created.
+    void SetNumCompletionQueues(size_t num_completion_queues);
+
     // Add custom global request processor. This is used across all requests for all robots. Must be
     // called before any robots are created. The processor must be kept alive for the entire
     // lifetime of ClientSdk.
@@ -72,6 +78,7 @@ class ClientSdk {
 
     bool m_is_initialized = false;
     bool m_is_robot_created = false;
+    size_t m_num_completion_queues = 1;
 
     std::string m_client_name;
     std::string m_cert;
@@ -14,27 +14,75 @@ namespace bosdyn {
 
 namespace client {
 
+MessagePump::MessagePump(size_t num_completion_queues) {
+    BOSDYN_ASSERT_PRECONDITION(num_completion_queues > 0,
+                               "MessagePump needs at least one completion queue.");
+    for (size_t i = 0; i < num_completion_queues; ++i) {
+        m_completion_queues.push_back(std::make_unique<grpc::CompletionQueue>());
+        m_outstanding_calls.push_back(std::make_unique<OutstandingCallTracker>());
+    }
+}
+
 void MessagePump::AutoUpdate(::bosdyn::common::Duration duration) {
     if (m_has_auto_update_started) return;
-    m_auto_update_thread = std::make_unique<std::thread>(
-        std::bind(&MessagePump::UpdateLoop, this, std::placeholders::_1), duration);
+    for (size_t cq_index = 0; cq_index < m_completion_queues.size(); ++cq_index) {
+        m_auto_update_threads.push_back(
+            std::make_unique<std::thread>(&MessagePump::UpdateLoop, this, cq_index, duration));
+    }
     m_has_auto_update_started = true;
 }
 
-void MessagePump::UpdateLoop(::bosdyn::common::Duration duration) {
-    while (CompleteOne(duration) != Shutdown) {
+void MessagePump::UpdateLoop(size_t cq_index, ::bosdyn::common::Duration duration) {
+    while (CompleteOneOnQueue(cq_index, duration) != Shutdown) {
         // do nothing here
     }
 }
 
 UpdateStatus MessagePump::CompleteOne(::bosdyn::common::Duration duration) {
-    auto end_time = std::chrono::system_clock::now() + CONVERT_DURATION_FOR_GRPC(duration);
+    const size_t num_queues = m_completion_queues.size();
+    if (num_queues == 1) {
+        return CompleteOneOnQueue(0, duration);
+    }
+    const auto end_time = std::chrono::system_clock::now() + CONVERT_DURATION_FOR_GRPC(duration);
+    bool got_event = false;
+    // Drain whatever is already ready on every queue before blocking on any one of them.
+    for (size_t cq_index = 0; cq_index < num_queues; ++cq_index) {
+        if (NextOnQueue(cq_index, std::chrono::system_clock::now(), &got_event) == Shutdown) {
+            return Shutdown;
+        }
+    }
+    // Wait on the queues in turn for a short slice each, so an event on any queue is picked up
+    // within (num_queues - 1) slices instead of after the whole duration.
+    while (!got_event) {
+        const auto now = std::chrono::system_clock::now();
+        if (now >= end_time) break;
+        const size_t cq_index = m_next_blocking_cq_index.fetch_add(1) % num_queues;
+        const auto slice_end = std::min<std::chrono::system_clock::time_point>(
+            end_time, now + CONVERT_DURATION_FOR_GRPC(kCompleteOneSlice));
+        if (NextOnQueue(cq_index, slice_end, &got_event) == Shutdown) {
+            return Shutdown;
+        }
+    }
+    return Complete;
+}
+
+UpdateStatus MessagePump::CompleteOneOnQueue(size_t cq_index,
+                                             ::bosdyn::common::Duration duration) {
+    bool got_event = false;
+    return NextOnQueue(cq_index,
+                       std::chrono::system_clock::now() + CONVERT_DURATION_FOR_GRPC(duration),
+                       &got_event);
+}
+
+UpdateStatus MessagePump::NextOnQueue(size_t cq_index,
+                                      std::chrono::system_clock::time_point deadline,
+                                      bool* got_event) {
     void* tag = nullptr;
     bool ok = false;
     grpc::CompletionQueue::NextStatus next_status =
-        m_completion_queue.AsyncNext(&tag, &ok, end_time);
+        m_completion_queues[cq_index]->AsyncNext(&tag, &ok, deadline);
 
-    std::lock_guard<std::mutex> lock(m_shutdown_mutex);
+    std::shared_lock<std::shared_mutex> lock(m_shutdown_mutex);
     if (m_shutdown_requested) {
         // Don't wait for status==SHUTDOWN, gRPC won't return that until
         // it has drained its queue.
@@ -47,6 +95,7 @@ UpdateStatus MessagePump::CompleteOne(::bosdyn::common::Duration duration) {
         case grpc::CompletionQueue::TIMEOUT:
             return Complete;
         case grpc::CompletionQueue::GOT_EVENT:
+            *got_event = true;
             if (tag != nullptr) {
                 MessagePumpCallBase* call_base = static_cast<MessagePumpCallBase*>(tag);
                 if (call_base->OnCompletionQueueEvent(ok)) {
@@ -54,7 +103,7 @@ UpdateStatus MessagePump::CompleteOne(::bosdyn::common::Duration duration) {
                     // object. The call base object will be deleted by this RemoveCall function
                     // because the unique_ptr will be when it is removed from the map in the
                     // OutstandingCallTracker.
-                    m_outstanding_calls.RemoveCall(call_base);
+                    m_outstanding_calls[cq_index]->RemoveCall(call_base);
                 }
             }
             return Complete;
@@ -64,7 +113,7 @@ UpdateStatus MessagePump::CompleteOne(::bosdyn::common::Duration duration) {
 
 void MessagePump::RequestShutdown() {
     {
-        std::lock_guard<std::mutex> lock(m_shutdown_mutex);
+        std::unique_lock<std::shared_mutex> lock(m_shutdown_mutex);
         if (m_shutdown_requested) {
             return;
         }
@@ -73,25 +122,43 @@ void MessagePump::RequestShutdown() {
 
     // The call to CancelAll will simply cancel the remaining call objects - setting the promise to
     // ClientCancelledOperationError and the call status to cancelled.
-    m_outstanding_calls.CancelAll();
+    for (auto& outstanding_calls : m_outstanding_calls) {
+        outstanding_calls->CancelAll();
+    }
 
-    // Shutdown the completion queue, which will try to complete any remaining calls.
-    m_completion_queue.Shutdown();
+    // Shutdown the completion queues, which will try to complete any remaining calls.
+    for (auto& completion_queue : m_completion_queues) {
+        completion_queue->Shutdown();
+    }
 
-    // Join the auto update thread to kill it.
+    // Join the auto update threads to kill them.
     if (m_has_auto_update_started) {
-        m_auto_update_thread->join();
+        for (auto& auto_update_thread : m_auto_update_threads) {
+            auto_update_thread->join();
+        }
+        m_auto_update_threads.clear();
         m_has_auto_update_started = false;
     }
 
-    // Finally, delete all remaining call objects  from the OutstandingCallTracker. Note, we delete
+    // Finally, delete all remaining call objects  from the OutstandingCallTrackers. Note, we delete
     // these at the very end because a call object also contains references to m_context and
     // m_response, and these are referenced in any AsyncNext calls that could get issued within the
-    // CompleteOne function by the completion queue or when trying to join the auto update thread.
-    m_outstanding_calls.RemoveAllCalls();
+    // CompleteOneOnQueue function by the completion queues or when trying to join the auto update
+    // threads.
+    for (auto& outstanding_calls : m_outstanding_calls) {
+        outstanding_calls->RemoveAllCalls();
+    }
 
 }
 
+size_t MessagePump::ActiveCalls() const {
+    size_t active_calls = 0;
+    for (const auto& outstanding_calls : m_outstanding_calls) {
+        active_calls += outstanding_calls->Count();
+    }
+    return active_calls;
+}
+
 void OutstandingCallTracker::CancelAll() {
     std::lock_guard<std::mutex> lock(m_mutex);
     for (auto& call : m_calls) {
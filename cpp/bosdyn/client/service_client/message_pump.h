@@ -12,13 +12,16 @@
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/impl/codegen/async_stream.h>
 #include <grpcpp/impl/codegen/async_unary_call.h>
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <future>
 #include <mutex>
 #include <queue>
 #include <set>
+#include <shared_mutex>
 #include <thread>
+#include <vector>
 
 #include <bosdyn/api/header.pb.h>
 
@@ -54,6 +57,14 @@
 // OR calls Update method in the same thread for single threaded behavior.
 // The pump is stopped when any Robot/ServiceClient is destroyed.
 //
+// 3) Application controlled, one completion queue per quality of service:
+// Application creates std::make_shared<MessagePump>(kNumCompletionQueueClasses) and calls
+// AutoUpdate, which starts one worker thread per completion queue. Each ServiceClient issues its
+// calls on the queue matching its QualityOfService, so large BULK_THROUGHPUT responses (images,
+// point clouds) are processed on a different thread than LATENCY_CRITICAL command completions.
+// ClientSdk::SetNumCompletionQueues(kNumCompletionQueueClasses) makes CreateRobot create such a
+// pump when none is passed in.
+//
 
 namespace bosdyn {
 
@@ -61,6 +72,12 @@ namespace client {
 
 enum CallStatus { NotStarted, Called, Cancelled, Completed };
 
+// Class of completion queue a call is issued on. The values mirror ServiceClient::QualityOfService.
+// A MessagePump with fewer queues than classes folds the higher classes onto its last queue, so
+// a single-queue pump places every call on the same queue.
+enum class CompletionQueueClass { LatencyCritical = 0, Normal = 1, BulkThroughput = 2 };
+constexpr size_t kNumCompletionQueueClasses = 3;
+
 template <typename CallbackFunctionType, typename PromiseResultType>
 void CancelHelper(CallbackFunctionType& callback, std::promise<Result<PromiseResultType>> promise,
                   CallStatus* call_status) {
@@ -129,6 +146,8 @@ class MessagePumpCallBase {
     grpc::Status m_status;
     std::mutex m_call_mutex;
     grpc::CompletionQueue* m_cq = nullptr;
+    // Index of m_cq in the owning MessagePump.
+    size_t m_cq_index = 0;
     CallStatus m_call_status;
 
 };
@@ -145,6 +164,12 @@ class RequestStreamCall : public MessagePumpCallBase {
         grpc::ClientContext* context, Response* response, grpc::CompletionQueue* cq, void*)>
         RequestStreamRpcCallFunction;
 
+    // Produces the requests of a producer-driven stream one at a time. Fills in the request and
+    // sets has_request to true, or sets has_request to false once there are no more requests. An
+    // error status aborts the RPC, and the callback can get that error with GetProducerError().
+    typedef std::function<::bosdyn::common::Status(Request* request, bool* has_request)>
+        RequestProducerFunction;
+
     /**
      * Start the actual gRPC call. It should only be called once on a RequestStreamCall object.
      *
@@ -178,6 +203,51 @@ class RequestStreamCall : public MessagePumpCallBase {
         m_call_status = CallStatus::Called;
     }
 
+    /**
+     * Start the actual gRPC call, pulling each request from the producer only once the previous
+     * Write has completed. Only the request currently being written is held in memory, and gRPC
+     * flow control paces the producer. It should only be called once on a RequestStreamCall
+     * object.
+     *
+     * @param producer Function producing the requests to send to the server, in order. It is
+     *                 invoked on the MessagePump thread.
+     * @param rpc_call The RpcCallFunction object to start the RPC, and it will be invoked
+     *                 immediately.
+     * @param callback Callback function which will be invoked when the RPC completes on the same
+     *                 thread as the MessagePump. The vector of requests passed to it is empty.
+     * @param promise Promise to be set with the status and the response.
+     */
+    void Start(const RequestProducerFunction& producer,
+               const RequestStreamRpcCallFunction& rpc_call,
+               const RequestStreamCallbackFunction& callback,
+               std::promise<Result<PromiseResultType>> promise) {
+        std::lock_guard<std::mutex> lock(m_call_mutex);
+        BOSDYN_ASSERT_PRECONDITION(producer != nullptr, "Request producer cannot be null.");
+        // Start should ONLY be called if the status not started.
+        BOSDYN_ASSERT_PRECONDITION(m_call_status == CallStatus::NotStarted,
+                                   "Message pump cannot be started multiple times.");
+        m_producer = producer;
+        m_callback = callback;
+        m_promise = std::move(promise);
+        m_request_writer = rpc_call(&m_context, &m_response, m_cq, this);
+        m_next_step = NextStep::WriteRequest;
+        m_call_status = CallStatus::Called;
+    }
+
+    /**
+     * Error returned by the request producer, if it failed after the first request. The callback
+     * is then invoked with an ABORTED gRPC status, and should return this status instead, so the
+     * caller can branch on the code of the producer, e.g. a lease error or a failed read.
+     *
+     * @param status Set to the error of the producer, if it failed.
+     *
+     * @return True if the producer failed.
+     */
+    bool GetProducerError(::bosdyn::common::Status* status) const {
+        if (m_producer_failed) *status = m_producer_status;
+        return m_producer_failed;
+    }
+
     void Cancel() override {
         std::lock_guard<std::mutex> lock(m_call_mutex);
         CancelHelper(m_callback, std::move(m_promise), &m_call_status);
@@ -231,7 +301,9 @@ class RequestStreamCall : public MessagePumpCallBase {
 
         switch (m_next_step) {
             case NextStep::WriteRequest:
-                if (success) {
+                if (success && m_producer) {
+                    WriteNextProducedRequest();
+                } else if (success) {
                     m_request_writer->Write(m_requests[m_next_request_to_write], this);
                     m_next_request_to_write++;
                     if (m_next_request_to_write == m_requests.size()) {
@@ -254,8 +326,11 @@ class RequestStreamCall : public MessagePumpCallBase {
                 return false;
 
             case NextStep::CallCallback:
+                // Release anything the producer holds on to, such as open files.
+                m_producer = nullptr;
                 if (m_callback != nullptr) {
-                    m_callback(this, std::move(m_requests), std::move(m_response), m_status,
+                    m_callback(this, std::move(m_requests), std::move(m_response),
+                               m_producer_error.ok() ? m_status : m_producer_error,
                                std::move(m_promise));
                     m_call_status = CallStatus::Completed;
                 }
@@ -266,9 +341,39 @@ class RequestStreamCall : public MessagePumpCallBase {
         return false;
     }
 
+    // Produce the next request into m_produced_request and write it, or finish the stream if the
+    // producer has no more requests or fails.
+    void WriteNextProducedRequest() {
+        // The previous Write has completed, so the request can be reused.
+        m_produced_request.Clear();
+        bool has_request = false;
+        ::bosdyn::common::Status produce_status = m_producer(&m_produced_request, &has_request);
+        if (!produce_status) {
+            m_producer_error = grpc::Status(grpc::StatusCode::ABORTED,
+                                            "Failed to produce request: " +
+                                                produce_status.DebugString());
+            m_producer_status = std::move(produce_status);
+            m_producer_failed = true;
+            m_context.TryCancel();
+            m_request_writer->Finish(&m_status, this);
+            m_next_step = NextStep::CallCallback;
+        } else if (has_request) {
+            m_request_writer->Write(m_produced_request, this);
+        } else {
+            m_request_writer->WritesDone(this);
+            m_next_step = NextStep::CallFinish;
+        }
+    }
+
     std::vector<Request> m_requests;
     std::unique_ptr<grpc::ClientAsyncWriterInterface<Request>> m_request_writer;
     unsigned int m_next_request_to_write;
+    // Producer-driven streams write one request at a time from m_produced_request.
+    RequestProducerFunction m_producer;
+    Request m_produced_request;
+    grpc::Status m_producer_error;
+    bool m_producer_failed = false;
+    ::bosdyn::common::Status m_producer_status;
     Response m_response;
     NextStep m_next_step;
     RequestStreamCallbackFunction m_callback;
@@ -286,6 +391,11 @@ class ResponseStreamCall : public MessagePumpCallBase {
                                                        grpc::CompletionQueue*, void*)>
         ResponseStreamRpcCallFunction;
 
+    // Receives each response of a stream as soon as it is read, instead of collecting all
+    // responses for the completion callback. An error status cancels the RPC, and the callback can
+    // get that error with GetSinkError().
+    typedef std::function<::bosdyn::common::Status(Response&& response)> ResponseSinkFunction;
+
     /**
      * Start the actual gRPC call. It should only be called once on a ResponseStreamCall object.
      *
@@ -313,6 +423,33 @@ class ResponseStreamCall : public MessagePumpCallBase {
         m_call_status = CallStatus::Called;
     }
 
+    /**
+     * Deliver each response to the sink as it arrives. Responses handed to the sink are not kept,
+     * so the callback receives an empty vector of responses. It must be called before Start.
+     *
+     * @param sink Function invoked with each response on the MessagePump thread.
+     */
+    void SetResponseSink(const ResponseSinkFunction& sink) {
+        std::lock_guard<std::mutex> lock(m_call_mutex);
+        BOSDYN_ASSERT_PRECONDITION(m_call_status == CallStatus::NotStarted,
+                                   "Response sink must be set before the call is started.");
+        m_response_sink = sink;
+    }
+
+    /**
+     * Error returned by the response sink, if it failed. The callback is then invoked with an
+     * ABORTED gRPC status, and should return this status instead, so the caller can branch on
+     * the code of the sink, e.g. a robot status or a lease error.
+     *
+     * @param status Set to the error of the sink, if it failed.
+     *
+     * @return True if the sink failed.
+     */
+    bool GetSinkError(::bosdyn::common::Status* status) const {
+        if (m_sink_failed) *status = m_sink_status;
+        return m_sink_failed;
+    }
+
     virtual void Cancel() override {
         std::lock_guard<std::mutex> lock(m_call_mutex);
         CancelHelper(m_callback, std::move(m_promise), &m_call_status);
@@ -375,23 +512,25 @@ class ResponseStreamCall : public MessagePumpCallBase {
                 return false;
 
             case NextStep::ContinueReadOrCallFinish:
-                if (success) {
-                    m_responses.push_back(std::move(m_last_response));
+                if (success && DeliverLastResponse()) {
                     m_response_reader->Read(&m_last_response, this);
                 } else {
-                    // Done reading, call Finish.
+                    // Done reading or the sink failed, call Finish.
+                    if (!m_sink_error.ok()) {
+                        m_context.TryCancel();
+                    }
                     m_response_reader->Finish(&m_status, this);
                     m_next_step = NextStep::CallCallback;
                 }
                 return false;
 
             case NextStep::CallCallback:
-
+                m_response_sink = nullptr;
 
                 // Everything is done, call the client callback with the responses.
                 if (m_callback != nullptr) {
-                    m_callback(this, m_request, std::move(m_responses), m_status,
-                               std::move(m_promise));
+                    m_callback(this, m_request, std::move(m_responses),
+                               m_sink_error.ok() ? m_status : m_sink_error, std::move(m_promise));
                     m_call_status = CallStatus::Completed;
                 }
                 return true;
@@ -401,12 +540,34 @@ class ResponseStreamCall : public MessagePumpCallBase {
         return false;
     }
 
+    // Hand the last response read to the sink, or collect it for the callback if there is no
+    // sink. Returns false and sets m_sink_error if the sink fails.
+    bool DeliverLastResponse() {
+        if (!m_response_sink) {
+            m_responses.push_back(std::move(m_last_response));
+            return true;
+        }
+        ::bosdyn::common::Status sink_status = m_response_sink(std::move(m_last_response));
+        if (!sink_status) {
+            m_sink_error = grpc::Status(grpc::StatusCode::ABORTED,
+                                        "Failed to handle response: " + sink_status.DebugString());
+            m_sink_status = std::move(sink_status);
+            m_sink_failed = true;
+            return false;
+        }
+        return true;
+    }
+
     Request m_request;
     std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> m_response_reader;
     // m_last_response is defined as a private var because it needs to persist over multiple
     // OnCompletionQueueEvent calls.
     Response m_last_response;
     std::vector<Response> m_responses;
+    ResponseSinkFunction m_response_sink;
+    grpc::Status m_sink_error;
+    bool m_sink_failed = false;
+    ::bosdyn::common::Status m_sink_status;
     NextStep m_next_step;
     ResponseStreamCallbackFunction m_callback;
     std::promise<Result<PromiseResultType>> m_promise;
@@ -424,6 +585,11 @@ class RequestResponseStreamCall : public MessagePumpCallBase {
                                                              grpc::CompletionQueue*, void*)>
         RequestResponseStreamRpcCallFunction;
 
+    // Receives each response of a stream as soon as it is read, instead of collecting all
+    // responses for the completion callback. An error status cancels the RPC, and the callback can
+    // get that error with GetSinkError().
+    typedef std::function<::bosdyn::common::Status(Response&& response)> ResponseSinkFunction;
+
     /**
      * Start the actual gRPC call. It should only be called once on a RequestResponseStreamCall
      * object.
@@ -459,6 +625,33 @@ class RequestResponseStreamCall : public MessagePumpCallBase {
         m_next_request_to_write = 0;
     }
 
+    /**
+     * Deliver each response to the sink as it arrives. Responses handed to the sink are not kept,
+     * so the callback receives an empty vector of responses. It must be called before Start.
+     *
+     * @param sink Function invoked with each response on the MessagePump thread.
+     */
+    void SetResponseSink(const ResponseSinkFunction& sink) {
+        std::lock_guard<std::mutex> lock(m_call_mutex);
+        BOSDYN_ASSERT_PRECONDITION(m_call_status == CallStatus::NotStarted,
+                                   "Response sink must be set before the call is started.");
+        m_response_sink = sink;
+    }
+
+    /**
+     * Error returned by the response sink, if it failed. The callback is then invoked with an
+     * ABORTED gRPC status, and should return this status instead, so the caller can branch on
+     * the code of the sink, e.g. a robot status or a lease error.
+     *
+     * @param status Set to the error of the sink, if it failed.
+     *
+     * @return True if the sink failed.
+     */
+    bool GetSinkError(::bosdyn::common::Status* status) const {
+        if (m_sink_failed) *status = m_sink_status;
+        return m_sink_failed;
+    }
+
     virtual void Cancel() override {
         std::lock_guard<std::mutex> lock(m_call_mutex);
         CancelHelper(m_callback, std::move(m_promise), &m_call_status);
@@ -543,11 +736,13 @@ class RequestResponseStreamCall : public MessagePumpCallBase {
                 return false;
 
             case NextStep::ContinueReadOrCallFinish:
-                if (success) {
-                    m_responses.push_back(std::move(m_last_response));
+                if (success && DeliverLastResponse()) {
                     m_reader_writer->Read(&m_last_response, this);
                 } else {
-                    // Done reading, call Finish.
+                    // Done reading or the sink failed, call Finish.
+                    if (!m_sink_error.ok()) {
+                        m_context.TryCancel();
+                    }
                     m_reader_writer->Finish(&m_status, this);
                     m_next_step = NextStep::CallCallback;
                     return false;
@@ -555,10 +750,12 @@ class RequestResponseStreamCall : public MessagePumpCallBase {
                 return false;
 
             case NextStep::CallCallback:
+                m_response_sink = nullptr;
+
                 // Everything is done, call the client callback with the responses.
                 if (m_callback != nullptr) {
-                    m_callback(this, std::move(m_requests), std::move(m_responses), m_status,
-                               std::move(m_promise));
+                    m_callback(this, std::move(m_requests), std::move(m_responses),
+                               m_sink_error.ok() ? m_status : m_sink_error, std::move(m_promise));
                     m_call_status = CallStatus::Completed;
                 }
                 return true;
@@ -568,6 +765,24 @@ class RequestResponseStreamCall : public MessagePumpCallBase {
         return false;
     }
 
+    // Hand the last response read to the sink, or collect it for the callback if there is no
+    // sink. Returns false and sets m_sink_error if the sink fails.
+    bool DeliverLastResponse() {
+        if (!m_response_sink) {
+            m_responses.push_back(std::move(m_last_response));
+            return true;
+        }
+        ::bosdyn::common::Status sink_status = m_response_sink(std::move(m_last_response));
+        if (!sink_status) {
+            m_sink_error = grpc::Status(grpc::StatusCode::ABORTED,
+                                        "Failed to handle response: " + sink_status.DebugString());
+            m_sink_status = std::move(sink_status);
+            m_sink_failed = true;
+            return false;
+        }
+        return true;
+    }
+
     std::vector<Request> m_requests;
     std::unique_ptr<grpc::ClientAsyncReaderWriterInterface<Request, Response>> m_reader_writer;
     unsigned int m_next_request_to_write;
@@ -575,6 +790,10 @@ class RequestResponseStreamCall : public MessagePumpCallBase {
     // OnCompletionQueueEvent calls.
     Response m_last_response;
     std::vector<Response> m_responses;
+    ResponseSinkFunction m_response_sink;
+    grpc::Status m_sink_error;
+    bool m_sink_failed = false;
+    ::bosdyn::common::Status m_sink_status;
     NextStep m_next_step;
     RequestResponseStreamCallbackFunction m_callback;
     std::promise<Result<PromiseResultType>> m_promise;
@@ -729,23 +948,41 @@ enum UpdateStatus { Shutdown, Complete };
  * completion queue. The primary benefit of this approach is that a number of outstanding RPCs can
  * all be managed with a single thread of execution.
  *
- * MessagePump expects that Update is only called from a single thread of execution. Creating and
+ * A MessagePump owns one or more completion queues. Each completion queue expects to be serviced
+ * by a single thread of execution; AutoUpdate starts one such thread per queue. Creating and
  * calling RPCs can be done from any thread however.
  */
 class MessagePump {
  public:
-    MessagePump() = default;
+    // Create a pump with the given number of completion queues. Calls are assigned to a queue
+    // by their CompletionQueueClass.
+    explicit MessagePump(size_t num_completion_queues = 1);
     ~MessagePump() { RequestShutdown(); }
 
+    // How long CompleteOne waits on one completion queue before moving on to the next one.
+    static constexpr ::bosdyn::common::Duration kCompleteOneSlice = std::chrono::milliseconds(1);
+
 
     // Process any completed RPCs in the completion queue for up to the duration milliseconds before
     // returning.  A typical application will have a thread which executes
     // MessagePump::CompleteOne in a loop.
+    // With more than one completion queue, every queue is polled once without blocking. If none
+    // had an event ready, the call waits on the queues in turn for kCompleteOneSlice at a time
+    // until an event is processed or duration expires, because gRPC cannot wait on several
+    // completion queues at once. An event can therefore wait up to
+    // (NumCompletionQueues() - 1) * kCompleteOneSlice before it is processed. Use AutoUpdate or
+    // CompleteOneOnQueue to service each queue from its own thread without that added latency.
     UpdateStatus CompleteOne(::bosdyn::common::Duration duration = std::chrono::milliseconds(100));
 
-    // Start a thread and execute Update in a loop
+    // Process one event from the completion queue with the given index, waiting for up to
+    // duration. Each queue must only be serviced from one thread at a time.
+    UpdateStatus CompleteOneOnQueue(size_t cq_index, ::bosdyn::common::Duration duration);
+
+    // Start one thread per completion queue and execute CompleteOneOnQueue in a loop on each.
     void AutoUpdate(::bosdyn::common::Duration duration);
 
+    size_t NumCompletionQueues() const { return m_completion_queues.size(); }
+
     // Request that the pump shutdown. Once this happens, it can't be woken again.
     void RequestShutdown();
 
@@ -753,59 +990,89 @@ class MessagePump {
     // controlled by the MessagePump, and is guaranteed to be alive until after the Callback
     // function passed into Call completes execution.
     template <typename Request, typename Response, typename PromiseResultType>
-    std::unique_ptr<UnaryCall<Request, Response, PromiseResultType>> CreateUnaryCall() {
+    std::unique_ptr<UnaryCall<Request, Response, PromiseResultType>> CreateUnaryCall(
+        CompletionQueueClass cq_class = CompletionQueueClass::Normal) {
         if (m_shutdown_requested) return nullptr;
-        return std::unique_ptr<UnaryCall<Request, Response, PromiseResultType>>(
-            new UnaryCall<Request, Response, PromiseResultType>(&m_completion_queue
-                                                                ));
+        const size_t cq_index = CompletionQueueIndex(cq_class);
+        std::unique_ptr<UnaryCall<Request, Response, PromiseResultType>> call(
+            new UnaryCall<Request, Response, PromiseResultType>(
+                m_completion_queues[cq_index].get()));
+        call->m_cq_index = cq_index;
+        return call;
     }
 
     template <typename Request, typename Response, typename Promise>
-    std::unique_ptr<RequestStreamCall<Request, Response, Promise>> CreateRequestStreamCall() {
+    std::unique_ptr<RequestStreamCall<Request, Response, Promise>> CreateRequestStreamCall(
+        CompletionQueueClass cq_class = CompletionQueueClass::Normal) {
         if (m_shutdown_requested) return nullptr;
-        return std::unique_ptr<RequestStreamCall<Request, Response, Promise>>(
-            new RequestStreamCall<Request, Response, Promise>(&m_completion_queue
-                                                              ));
+        const size_t cq_index = CompletionQueueIndex(cq_class);
+        std::unique_ptr<RequestStreamCall<Request, Response, Promise>> call(
+            new RequestStreamCall<Request, Response, Promise>(m_completion_queues[cq_index].get()));
+        call->m_cq_index = cq_index;
+        return call;
     }
 
     template <typename Request, typename Response, typename Promise>
-    std::unique_ptr<ResponseStreamCall<Request, Response, Promise>> CreateResponseStreamCall() {
+    std::unique_ptr<ResponseStreamCall<Request, Response, Promise>> CreateResponseStreamCall(
+        CompletionQueueClass cq_class = CompletionQueueClass::Normal) {
         if (m_shutdown_requested) return nullptr;
-        return std::unique_ptr<ResponseStreamCall<Request, Response, Promise>>(
-            new ResponseStreamCall<Request, Response, Promise>(&m_completion_queue
-                                                               ));
+        const size_t cq_index = CompletionQueueIndex(cq_class);
+        std::unique_ptr<ResponseStreamCall<Request, Response, Promise>> call(
+            new ResponseStreamCall<Request, Response, Promise>(
+                m_completion_queues[cq_index].get()));
+        call->m_cq_index = cq_index;
+        return call;
     }
 
     template <typename Request, typename Response, typename Promise>
     std::unique_ptr<RequestResponseStreamCall<Request, Response, Promise>>
-    CreateRequestResponseStreamCall() {
+    CreateRequestResponseStreamCall(CompletionQueueClass cq_class = CompletionQueueClass::Normal) {
         if (m_shutdown_requested) return nullptr;
-        return std::unique_ptr<RequestResponseStreamCall<Request, Response, Promise>>(
-            new RequestResponseStreamCall<Request, Response, Promise>(&m_completion_queue
-                                                                      ));
+        const size_t cq_index = CompletionQueueIndex(cq_class);
+        std::unique_ptr<RequestResponseStreamCall<Request, Response, Promise>> call(
+            new RequestResponseStreamCall<Request, Response, Promise>(
+                m_completion_queues[cq_index].get()));
+        call->m_cq_index = cq_index;
+        return call;
     }
 
 
-    // Add a call to be tracked.
+    // Add a call to be tracked. The call is tracked alongside the other calls on its completion
+    // queue.
     MessagePumpCallBase* AddCall(std::unique_ptr<MessagePumpCallBase> call) {
         MessagePumpCallBase* call_base_out = call.get();
-        m_outstanding_calls.AddCall(std::move(call));
+        m_outstanding_calls[call_base_out->m_cq_index]->AddCall(std::move(call));
         return call_base_out;
     }
 
-    size_t ActiveCalls() const { return m_outstanding_calls.Count(); }
+    size_t ActiveCalls() const;
 
  private:
-    void UpdateLoop(::bosdyn::common::Duration duration);
+    void UpdateLoop(size_t cq_index, ::bosdyn::common::Duration duration);
+
+    // Wait until deadline for one event on the completion queue with the given index and process
+    // it. Sets got_event to true if an event was processed.
+    UpdateStatus NextOnQueue(size_t cq_index, std::chrono::system_clock::time_point deadline,
+                             bool* got_event);
+
+    size_t CompletionQueueIndex(CompletionQueueClass cq_class) const {
+        return std::min(static_cast<size_t>(cq_class), m_completion_queues.size() - 1);
+    }
 
-    grpc::CompletionQueue m_completion_queue;
+    std::vector<std::unique_ptr<grpc::CompletionQueue>> m_completion_queues;
     bool m_has_auto_update_started = false;
+    // Queue the next CompleteOne call starts waiting on. CompleteOne may run on several threads.
+    std::atomic<size_t> m_next_blocking_cq_index{0};
 
-    std::mutex m_shutdown_mutex;
+    // Held shared while a completion queue event is processed, and exclusively while a shutdown is
+    // requested, so shutdown waits for in-progress callbacks without serializing the queues
+    // against each other.
+    std::shared_mutex m_shutdown_mutex;
     std::atomic<bool> m_shutdown_requested{false};
 
-    std::unique_ptr<std::thread> m_auto_update_thread = nullptr;
-    OutstandingCallTracker m_outstanding_calls;
+    std::vector<std::unique_ptr<std::thread>> m_auto_update_threads;
+    // One tracker per completion queue, so completions on different queues do not contend.
+    std::vector<std::unique_ptr<OutstandingCallTracker>> m_outstanding_calls;
 
 };
 
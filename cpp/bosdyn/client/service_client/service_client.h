@@ -115,6 +115,20 @@ class ServiceClient {
     }
 
  protected:
+    // Completion queue class on which this client's calls are issued, so a MessagePump with
+    // several completion queues keeps each QualityOfService on its own queue.
+    CompletionQueueClass GetCompletionQueueClass() const {
+        switch (GetQualityOfService()) {
+            case QualityOfService::LATENCY_CRITICAL:
+                return CompletionQueueClass::LatencyCritical;
+            case QualityOfService::BULK_THROUGHPUT:
+                return CompletionQueueClass::BulkThroughput;
+            case QualityOfService::NORMAL:
+                break;
+        }
+        return CompletionQueueClass::Normal;
+    }
+
     /**
      * Initiate the async UnaryCall and return the future to the promise.
      *
@@ -144,7 +158,8 @@ class ServiceClient {
 
         // The one_time pointer is deleted by MessagePump::Update after the callback function
         // returns
-        auto one_time = m_message_pump->CreateUnaryCall<Request, Response, PromiseResultType>();
+        auto one_time = m_message_pump->CreateUnaryCall<Request, Response, PromiseResultType>(
+            GetCompletionQueueClass());
         if (!one_time) {
             result_promise.set_value(
                 {::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
@@ -244,9 +259,8 @@ class ServiceClient {
      * ServiceClient-derived classes. It executes all the request processors on the requests, and
      * then it initializes the RPC call through the MessagePump.
      *
-     * @param request Deserialized request. This method serializes the data into a vector of
-     *                DataChunks, then moves the contents of the vector into the
-     *                RequestStreamCall instance.
+     * @param request Deserialized request. It is moved into a MessageDataChunkSource that
+     *                serializes it into DataChunks as the stream is ready to send them.
      * @param rpc_call RPC function associated with this streaming call.
      * @param callback Callback function defined in the client to call when the RPC completes.
      * @param result_promise Promise the callback function needs to set with the status and the
@@ -288,19 +302,17 @@ class ServiceClient {
             return nullptr;
         }
 
-        // Convert request to data chunks.
-        std::vector<::bosdyn::api::DataChunk> chunks;
-        ::bosdyn::common::Status chunk_status = MessageToDataChunks<Request>(request, &chunks);
-        if (!chunk_status) {
-            promise.set_value({std::move(chunk_status), {}});
-            return nullptr;
-        }
-
-        // Initialize RPC call.
+        // Initialize RPC call. Chunks are serialized as the stream is ready for them, so no full
+        // serialized copy of the request is held.
+        std::shared_ptr<DataChunkSource> source = std::make_shared<MessageDataChunkSource>(
+            std::make_unique<Request>(std::move(request)));
         auto ret = one_time.get();
         m_message_pump->AddCall(std::move(one_time));
-        ret->Start(std::move(chunks), request.header(), rpc_call, callback, std::move(promise),
-                   Request::descriptor()->full_name());
+        ret->Start(
+            [source](::bosdyn::api::DataChunk* chunk, bool* has_chunk) {
+                return source->NextChunk(chunk, has_chunk);
+            },
+            rpc_call, callback, std::move(promise));
         return ret;
     }
 
@@ -314,9 +326,8 @@ class ServiceClient {
      * ServiceClient-derived classes. It executes all the request processors on the requests, and
      * then it initializes the RPC call through the MessagePump.
      *
-     * @param request Deserialized request. This method serializes the data into a vector of
-     *                DataChunks, then moves the contents of the vector into the
-     *                RequestStreamCall instance.
+     * @param request Deserialized request. It is moved into a MessageDataChunkSource that
+     *                serializes it into DataChunks as the stream is ready to send them.
      * @param rpc_call RPC function associated with this streaming call.
      * @param callback Callback function defined in the client to call when the RPC completes.
      * @param result_promise Promise the callback function needs to set with the status and the
@@ -335,10 +346,97 @@ class ServiceClient {
         BOSDYN_ASSERT_PRECONDITION(m_message_pump != nullptr, "Message pump cannot be null.");
         RPCParameters parameters_to_use = CombineRPCParameters(parameters);
 
+        // Set logging and process request. Processors that add call metadata run again on the
+        // first wrapper message with the real call context.
+        grpc::ClientContext request_context;
+        SetLoggingControl(parameters_to_use.logging_control, &request);
+        auto request_status = m_request_processor_chain.Process(
+            &request_context, request.mutable_header(), &request);
+        if (!request_status) {
+            promise.set_value({std::move(request_status), {}});
+            return nullptr;
+        }
+
+        return InitiateRequestStreamAsyncCallWithWrappedChunkSource<Response, PromiseResultType,
+                                                                    WrapperType>(
+            std::make_unique<MessageDataChunkSource>(std::make_unique<Request>(std::move(request))),
+            rpc_call, callback, std::move(promise), parameters);
+    }
+
+    /**
+     * Initiate the async RequestStreamCall and return the future to the promise.
+     *
+     * This method should be used when streaming a wrapper message around api::DataChunk where the
+     * chunks come from a DataChunkSource, for example a serialized message read from disk. Chunks
+     * are pulled from the source only as the stream is ready to send them, so memory use is
+     * bounded by a single chunk regardless of the total size.
+     *
+     * @param source Source of the chunks to wrap and send. It is released when the RPC completes.
+     * @param rpc_call RPC function associated with this streaming call.
+     * @param callback Callback function defined in the client to call when the RPC completes.
+     * @param result_promise Promise the callback function needs to set with the status and the
+     *                       response.
+     *
+     * @returns Instance of RequestStreamCall created, or nullptr if errors occur.
+     */
+    template <typename Response, typename PromiseResultType, typename WrapperType>
+    MessagePumpCallBase* InitiateRequestStreamAsyncCallWithWrappedChunkSource(
+        std::unique_ptr<DataChunkSource>&& source,
+        const typename ::bosdyn::client::RequestStreamCall<
+            WrapperType, Response, PromiseResultType>::RequestStreamRpcCallFunction& rpc_call,
+        const typename ::bosdyn::client::RequestStreamCall<
+            WrapperType, Response, PromiseResultType>::RequestStreamCallbackFunction& callback,
+        std::promise<Result<PromiseResultType>> promise, const RPCParameters& parameters) {
+        BOSDYN_ASSERT_PRECONDITION(source != nullptr, "Data chunk source cannot be null.");
+        std::shared_ptr<DataChunkSource> shared_source = std::move(source);
+        return InitiateRequestStreamAsyncCallWithProducer<WrapperType, Response,
+                                                          PromiseResultType>(
+            [shared_source](WrapperType* wrapper_request, bool* has_request) {
+                return shared_source->NextChunk(wrapper_request->mutable_chunk(), has_request);
+            },
+            rpc_call, callback, std::move(promise), parameters);
+    }
+
+    /**
+     * Initiate the async RequestStreamCall and return the future to the promise.
+     *
+     * This method should be used when the streamed requests are generated lazily instead of being
+     * built up front. Each request is produced, has its logging control set and is run through
+     * the request processors right before it is written, so only one request is held in memory
+     * at a time and gRPC flow control paces the producer.
+     *
+     * The first request is produced and processed before the RPC is started, so processors that
+     * add call metadata apply to the call. Any error in the first request fails the call without
+     * starting it; errors in later requests cancel the RPC, and the callback should return the
+     * error from RequestStreamCall::GetProducerError() instead of the ABORTED gRPC status.
+     *
+     * @param producer Function producing the requests to send, in order. It is invoked on the
+     *                 MessagePump thread after the first request.
+     * @param rpc_call RPC function associated with this streaming call.
+     * @param callback Callback function defined in the client to call when the RPC completes. The
+     *                 vector of requests passed to it is empty.
+     * @param result_promise Promise the callback function needs to set with the status and the
+     *                       response.
+     *
+     * @returns Instance of RequestStreamCall created, or nullptr if errors occur.
+     */
+    template <typename Request, typename Response, typename PromiseResultType>
+    MessagePumpCallBase* InitiateRequestStreamAsyncCallWithProducer(
+        const typename ::bosdyn::client::RequestStreamCall<
+            Request, Response, PromiseResultType>::RequestProducerFunction& producer,
+        const typename ::bosdyn::client::RequestStreamCall<
+            Request, Response, PromiseResultType>::RequestStreamRpcCallFunction& rpc_call,
+        const typename ::bosdyn::client::RequestStreamCall<
+            Request, Response, PromiseResultType>::RequestStreamCallbackFunction& callback,
+        std::promise<Result<PromiseResultType>> promise, const RPCParameters& parameters) {
+        BOSDYN_ASSERT_PRECONDITION(m_message_pump != nullptr, "Message pump cannot be null.");
+        BOSDYN_ASSERT_PRECONDITION(producer != nullptr, "Request producer cannot be null.");
+        RPCParameters parameters_to_use = CombineRPCParameters(parameters);
+
         // The one_time pointer is deleted by MessagePump::Update after the callback function
         // returns.
-        auto one_time = SetupRequestStreamCall<WrapperType, Response, PromiseResultType>(
-            parameters_to_use.timeout);
+        auto one_time =
+            SetupRequestStreamCall<Request, Response, PromiseResultType>(parameters_to_use.timeout);
         if (!one_time) {
             promise.set_value({::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
                                                         "MessagePump has shut down"),
@@ -346,41 +444,53 @@ class ServiceClient {
             return nullptr;
         }
 
-        // Set logging and process request.
-        SetLoggingControl(parameters_to_use.logging_control, &request);
-        auto request_status = m_request_processor_chain.Process(one_time->context(),
-                                                                request.mutable_header(), &request);
-        if (!request_status) {
-            promise.set_value({std::move(request_status), {}});
+        // Produce and process the first request with the real call context.
+        auto first_request = std::make_shared<Request>();
+        bool has_request = false;
+        auto status = producer(first_request.get(), &has_request);
+        if (!status) {
+            promise.set_value({std::move(status), {}});
             return nullptr;
         }
-
-        // Convert request to data chunks.
-        std::vector<::bosdyn::api::DataChunk> chunks;
-        ::bosdyn::common::Status chunk_status = MessageToDataChunks<Request>(request, &chunks);
-        if (!chunk_status) {
-            promise.set_value({std::move(chunk_status), {}});
+        if (!has_request) {
+            promise.set_value({::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                                        "Request stream cannot be empty."),
+                               {}});
+            return nullptr;
+        }
+        SetLoggingControl(parameters_to_use.logging_control, first_request.get());
+        status = m_request_processor_chain.Process(
+            one_time->context(), first_request->mutable_header(), first_request.get());
+        if (!status) {
+            promise.set_value({std::move(status), {}});
             return nullptr;
         }
 
-        std::vector<WrapperType> wrapper_chunks;
-        for (bosdyn::api::DataChunk& chunk : chunks) {
-            WrapperType wrapper_request;
-            bosdyn::api::DataChunk* request_chunk = wrapper_request.mutable_chunk();
-            *request_chunk = std::move(chunk);
-            auto wrapper_request_status = m_request_processor_chain.Process(
-                one_time->context(), wrapper_request.mutable_header(), &wrapper_request);
-            if (!wrapper_request_status) {
-                promise.set_value({std::move(wrapper_request_status), {}});
-                return nullptr;
+        // Later requests are processed as they are produced. The call has already started, so
+        // they are processed against a scratch context.
+        const LogRequestMode logging_control = parameters_to_use.logging_control;
+        auto processing_producer = [this, producer, first_request, logging_control](
+                                       Request* request, bool* has_next) mutable {
+            if (first_request) {
+                *request = std::move(*first_request);
+                first_request.reset();
+                *has_next = true;
+                return ::bosdyn::common::Status(SDKErrorCode::Success);
             }
-            wrapper_chunks.emplace_back(std::move(wrapper_request));
-        }
+            auto next_status = producer(request, has_next);
+            if (!next_status || !*has_next) {
+                return next_status;
+            }
+            grpc::ClientContext request_context;
+            SetLoggingControl(logging_control, request);
+            return m_request_processor_chain.Process(&request_context, request->mutable_header(),
+                                                     request);
+        };
+
         // Initialize RPC call.
         auto ret = one_time.get();
         m_message_pump->AddCall(std::move(one_time));
-        ret->Start(std::move(wrapper_chunks), request.header(), rpc_call, callback,
-                   std::move(promise), Request::descriptor()->full_name());
+        ret->Start(processing_producer, rpc_call, callback, std::move(promise));
         return ret;
     }
 
@@ -400,7 +510,8 @@ class ServiceClient {
     std::unique_ptr<RequestStreamCall<Request, Response, PromiseResultType>> SetupRequestStreamCall(
         const ::bosdyn::common::Duration& timeout) {
         auto one_time =
-            m_message_pump->CreateRequestStreamCall<Request, Response, PromiseResultType>();
+            m_message_pump->CreateRequestStreamCall<Request, Response, PromiseResultType>(
+                GetCompletionQueueClass());
         if (!one_time) {
             return nullptr;
         }
@@ -448,7 +559,8 @@ class ServiceClient {
         // returns.
         auto one_time =
             m_message_pump
-                ->CreateRequestStreamCall<::bosdyn::api::DataChunk, Response, PromiseResultType>();
+                ->CreateRequestStreamCall<::bosdyn::api::DataChunk, Response, PromiseResultType>(
+                    GetCompletionQueueClass());
         if (!one_time) {
             promise.set_value({::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
                                                         "MessagePump has shut down"),
@@ -507,12 +619,45 @@ class ServiceClient {
         const typename ::bosdyn::client::ResponseStreamCall<
             Request, Response, PromiseResultType>::ResponseStreamCallbackFunction& callback,
         std::promise<Result<PromiseResultType>> promise, const RPCParameters& parameters) {
+        return InitiateResponseStreamAsyncCallWithSink<Request, Response, PromiseResultType>(
+            request, rpc_call, nullptr, callback, std::move(promise), parameters);
+    }
+
+    /**
+     * Initiate the async ResponseStreamCall and return the future to the promise.
+     *
+     * This method should be used when each response needs to be handled as soon as it arrives,
+     * for example to reassemble a large download into a file, instead of collecting every
+     * response in memory for the callback.
+     *
+     * @param request Request messages to be sent through RPC.
+     * @param rpc_call RPC function associated with this streaming call.
+     * @param response_sink Function invoked with each response on the MessagePump thread. If it
+     *                      is null, the responses are collected for the callback instead.
+     * @param callback Callback function defined in the client to call when the RPC completes. The
+     *                 vector of responses passed to it is empty when a sink is used.
+     * @param result_promise Promise the callback function needs to set with the status and the
+     *                       result.
+     *
+     * @returns Instance of ResponseStreamCall created, or nullptr if errors occur.
+     */
+    template <typename Request, typename Response, typename PromiseResultType>
+    MessagePumpCallBase* InitiateResponseStreamAsyncCallWithSink(
+        Request& request,
+        const typename ::bosdyn::client::ResponseStreamCall<
+            Request, Response, PromiseResultType>::ResponseStreamRpcCallFunction& rpc_call,
+        const typename ::bosdyn::client::ResponseStreamCall<
+            Request, Response, PromiseResultType>::ResponseSinkFunction& response_sink,
+        const typename ::bosdyn::client::ResponseStreamCall<
+            Request, Response, PromiseResultType>::ResponseStreamCallbackFunction& callback,
+        std::promise<Result<PromiseResultType>> promise, const RPCParameters& parameters) {
         BOSDYN_ASSERT_PRECONDITION(m_message_pump != nullptr, "Message pump cannot be null.");
 
         // The one_time pointer is deleted by MessagePump::Update after the callback function
         // returns.
         auto one_time =
-            m_message_pump->CreateResponseStreamCall<Request, Response, PromiseResultType>();
+            m_message_pump->CreateResponseStreamCall<Request, Response, PromiseResultType>(
+                GetCompletionQueueClass());
         if (!one_time) {
             promise.set_value({::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
                                                         "MessagePump has shut down"),
@@ -531,12 +676,12 @@ class ServiceClient {
             promise.set_value({std::move(status), {}});
             return nullptr;
         }
+        if (response_sink) {
+            one_time->SetResponseSink(response_sink);
+        }
         auto ret = one_time.get();
         m_message_pump->AddCall(std::move(one_time));
-
-
-        ret->Start(request, rpc_call,
-                   callback, std::move(promise));
+        ret->Start(request, rpc_call, callback, std::move(promise));
         return ret;
     }
 
@@ -677,7 +822,8 @@ class ServiceClient {
     std::unique_ptr<RequestResponseStreamCall<Request, Response, PromiseResultType>>
     SetupRequestResponseStreamCall(const ::bosdyn::common::Duration& timeout) {
         auto one_time =
-            m_message_pump->CreateRequestResponseStreamCall<Request, Response, PromiseResultType>();
+            m_message_pump->CreateRequestResponseStreamCall<Request, Response, PromiseResultType>(
+                GetCompletionQueueClass());
         if (!one_time) {
             return nullptr;
         }
@@ -792,6 +938,30 @@ class ServiceClient {
         return ret_status;
     }
 
+    // Process a single response of a stream as it arrives, for use in response sinks. The gRPC
+    // status of the stream is checked separately once it completes.
+    template <typename Response>
+    ::bosdyn::common::Status ProcessStreamedResponseAndGetFinalStatus(const Response& response) {
+        ::bosdyn::common::Status ret_status =
+            m_response_processor_chain.Process(grpc::Status::OK, response.header(), response);
+        if (!ret_status) {
+            return ret_status;
+        }
+        return ::bosdyn::common::Status(response.status());
+    }
+
+    // Same as above, for responses without a status field.
+    template <typename Response>
+    ::bosdyn::common::Status ProcessStreamedResponseAndGetFinalStatus(
+        const Response& response, const std::error_code& response_status) {
+        ::bosdyn::common::Status ret_status =
+            m_response_processor_chain.Process(grpc::Status::OK, response.header(), response);
+        if (!ret_status) {
+            return ret_status;
+        }
+        return ::bosdyn::common::Status(response_status);
+    }
+
     template <typename Response>
     ::bosdyn::common::Status ProcessResponseVector(const grpc::Status& status,
                                                    const std::vector<Response>& responses) {
@@ -307,6 +307,151 @@ void MediaLogClient::OnDeleteComplete(MessagePumpCallBase* call,
     promise.set_value({ret_status, std::move(response)});
 }
 
+template <typename Request, typename Response>
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveToSinkAsync(
+    Request& request,
+    const typename ResponseStreamCall<Request, Response,
+                                      RetrieveToSinkResponse>::ResponseStreamRpcCallFunction&
+        rpc_call,
+    std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+    RetrieveToSinkCallback on_complete) {
+    std::promise<RetrieveToSinkResultType> response;
+    std::shared_future<RetrieveToSinkResultType> future = response.get_future();
+    BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
+    BOSDYN_ASSERT_PRECONDITION(sink != nullptr, "Data chunk sink cannot be null.");
+
+    // Each response is processed and its chunk written to the sink as soon as it arrives. Only the
+    // logpoint of the first response is kept for the result.
+    auto logpoint = std::make_shared<::bosdyn::api::spot_cam::Logpoint>();
+    bool first_response = true;
+    auto response_sink = [this, sink, logpoint,
+                          first_response](Response&& retrieve_response) mutable {
+        ::bosdyn::common::Status ret_status =
+            ProcessStreamedResponseAndGetFinalStatus<Response>(retrieve_response,
+                                                               SDKErrorCode::Success);
+        if (!ret_status) {
+            return ret_status;
+        }
+        if (first_response) {
+            *logpoint = std::move(*retrieve_response.mutable_logpoint());
+            first_response = false;
+        }
+        return sink->AddChunk(retrieve_response.data());
+    };
+
+    MessagePumpCallBase* one_time =
+        InitiateResponseStreamAsyncCallWithSink<Request, Response, RetrieveToSinkResponse>(
+            request, rpc_call, response_sink,
+            [sink, logpoint, on_complete = std::move(on_complete)](
+                ResponseStreamCall<Request, Response, RetrieveToSinkResponse>* call,
+                const Request& request, std::vector<Response>&& responses,
+                const grpc::Status& status, std::promise<RetrieveToSinkResultType> promise) {
+                RetrieveToSinkResultType result;
+                result.response.logpoint = std::move(*logpoint);
+                result.response.num_bytes = sink->bytes_written();
+                // An error of the response sink, e.g. a header error, is returned as is.
+                if (!call->GetSinkError(&result.status)) {
+                    result.status = ConvertGRPCStatus(status);
+                    if (result.status) result.status = sink->Finish();
+                }
+                if (on_complete) on_complete(result);
+                promise.set_value(std::move(result));
+            },
+            std::move(response), parameters);
+
+    return future;
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveAsync(
+    const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters) {
+    return RetrieveAsync(logpoint_name, std::move(sink), parameters, nullptr);
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveAsync(
+    const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters, RetrieveToSinkCallback on_complete) {
+    ::bosdyn::api::spot_cam::RetrieveRequest request;
+
+    request.mutable_point()->set_name(logpoint_name);
+
+    return RetrieveAsync(request, std::move(sink), parameters, std::move(on_complete));
+}
+
+RetrieveToSinkResultType MediaLogClient::Retrieve(const std::string& logpoint_name,
+                                                  std::shared_ptr<DataChunkSink> sink,
+                                                  const RPCParameters& parameters) {
+    return RetrieveAsync(logpoint_name, std::move(sink), parameters).get();
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveAsync(
+    ::bosdyn::api::spot_cam::RetrieveRequest& request, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters) {
+    return RetrieveAsync(request, std::move(sink), parameters, nullptr);
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveAsync(
+    ::bosdyn::api::spot_cam::RetrieveRequest& request, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters, RetrieveToSinkCallback on_complete) {
+    return RetrieveToSinkAsync<::bosdyn::api::spot_cam::RetrieveRequest,
+                               ::bosdyn::api::spot_cam::RetrieveResponse>(
+        request,
+        std::bind(&::bosdyn::api::spot_cam::MediaLogService::StubInterface::AsyncRetrieve,
+                  m_stub.get(), _1, _2, _3, _4),
+        std::move(sink), parameters, std::move(on_complete));
+}
+
+RetrieveToSinkResultType MediaLogClient::Retrieve(::bosdyn::api::spot_cam::RetrieveRequest& request,
+                                                  std::shared_ptr<DataChunkSink> sink,
+                                                  const RPCParameters& parameters) {
+    return RetrieveAsync(request, std::move(sink), parameters).get();
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveRawDataAsync(
+    const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters) {
+    return RetrieveRawDataAsync(logpoint_name, std::move(sink), parameters, nullptr);
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveRawDataAsync(
+    const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters, RetrieveToSinkCallback on_complete) {
+    ::bosdyn::api::spot_cam::RetrieveRawDataRequest request;
+
+    request.mutable_point()->set_name(logpoint_name);
+
+    return RetrieveRawDataAsync(request, std::move(sink), parameters, std::move(on_complete));
+}
+
+RetrieveToSinkResultType MediaLogClient::RetrieveRawData(const std::string& logpoint_name,
+                                                         std::shared_ptr<DataChunkSink> sink,
+                                                         const RPCParameters& parameters) {
+    return RetrieveRawDataAsync(logpoint_name, std::move(sink), parameters).get();
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveRawDataAsync(
+    ::bosdyn::api::spot_cam::RetrieveRawDataRequest& request, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters) {
+    return RetrieveRawDataAsync(request, std::move(sink), parameters, nullptr);
+}
+
+std::shared_future<RetrieveToSinkResultType> MediaLogClient::RetrieveRawDataAsync(
+    ::bosdyn::api::spot_cam::RetrieveRawDataRequest& request, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters, RetrieveToSinkCallback on_complete) {
+    return RetrieveToSinkAsync<::bosdyn::api::spot_cam::RetrieveRawDataRequest,
+                               ::bosdyn::api::spot_cam::RetrieveRawDataResponse>(
+        request,
+        std::bind(&::bosdyn::api::spot_cam::MediaLogService::StubInterface::AsyncRetrieveRawData,
+                  m_stub.get(), _1, _2, _3, _4),
+        std::move(sink), parameters, std::move(on_complete));
+}
+
+RetrieveToSinkResultType MediaLogClient::RetrieveRawData(
+    ::bosdyn::api::spot_cam::RetrieveRawDataRequest& request, std::shared_ptr<DataChunkSink> sink,
+    const RPCParameters& parameters) {
+    return RetrieveRawDataAsync(request, std::move(sink), parameters).get();
+}
+
 ServiceClient::QualityOfService MediaLogClient::GetQualityOfService() const {
     return QualityOfService::NORMAL;
 }
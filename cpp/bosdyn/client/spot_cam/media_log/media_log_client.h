@@ -11,6 +11,7 @@
 
 #include <map>
 
+#include "bosdyn/client/data_chunk/data_chunking.h"
 #include "bosdyn/client/service_client/service_client.h"
 #include "bosdyn/client/spot_cam/media_log/media_log_error_codes.h"
 
@@ -35,6 +36,17 @@ typedef Result<::bosdyn::api::spot_cam::RetrieveRawDataResponse> RetrieveRawData
 typedef Result<::bosdyn::api::spot_cam::RetrieveResponse> RetrieveResultType;
 typedef Result<::bosdyn::api::spot_cam::ListLogpointsResponse> ListLogpointsResultType;
 
+// Response of the Retrieve and RetrieveRawData methods that hand the data to a DataChunkSink.
+struct RetrieveToSinkResponse {
+    // The logpoint as described by the first response of the stream.
+    ::bosdyn::api::spot_cam::Logpoint logpoint;
+    uint64_t num_bytes = 0;
+};
+typedef Result<RetrieveToSinkResponse> RetrieveToSinkResultType;
+
+// Called with the result of a Retrieve or RetrieveRawData into a sink as soon as it completes.
+typedef std::function<void(const RetrieveToSinkResultType&)> RetrieveToSinkCallback;
+
 class MediaLogClient : public ServiceClient {
  public:
     MediaLogClient() = default;
@@ -111,6 +123,64 @@ class MediaLogClient : public ServiceClient {
     DeleteResultType Delete(::bosdyn::api::spot_cam::DeleteRequest& request,
                             const RPCParameters& parameters = RPCParameters());
 
+    // Retrieve the data of a logpoint, as processed by the Store() that created it. Each data
+    // chunk is handed to the sink as soon as it arrives, for example to write the image to a file,
+    // so only one chunk is held in memory at a time. Finish is called on the sink once the stream
+    // completes successfully.
+    std::shared_future<RetrieveToSinkResultType> RetrieveAsync(
+        const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+        const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<RetrieveToSinkResultType> RetrieveAsync(
+        const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+        const RPCParameters& parameters, RetrieveToSinkCallback on_complete);
+
+    RetrieveToSinkResultType Retrieve(const std::string& logpoint_name,
+                                      std::shared_ptr<DataChunkSink> sink,
+                                      const RPCParameters& parameters = RPCParameters());
+
+    std::shared_future<RetrieveToSinkResultType> RetrieveAsync(
+        ::bosdyn::api::spot_cam::RetrieveRequest& request, std::shared_ptr<DataChunkSink> sink,
+        const RPCParameters& parameters = RPCParameters());
+
+    std::shared_future<RetrieveToSinkResultType> RetrieveAsync(
+        ::bosdyn::api::spot_cam::RetrieveRequest& request, std::shared_ptr<DataChunkSink> sink,
+        const RPCParameters& parameters, RetrieveToSinkCallback on_complete);
+
+    RetrieveToSinkResultType Retrieve(::bosdyn::api::spot_cam::RetrieveRequest& request,
+                                      std::shared_ptr<DataChunkSink> sink,
+                                      const RPCParameters& parameters = RPCParameters());
+
+    // Retrieve the data of a logpoint with no processing applied, e.g. the individual tiles of a
+    // panorama, into a sink as for RetrieveAsync().
+    std::shared_future<RetrieveToSinkResultType> RetrieveRawDataAsync(
+        const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+        const RPCParameters& parameters = RPCParameters());
+
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. It is not called if the RPC cannot be started.
+    std::shared_future<RetrieveToSinkResultType> RetrieveRawDataAsync(
+        const std::string& logpoint_name, std::shared_ptr<DataChunkSink> sink,
+        const RPCParameters& parameters, RetrieveToSinkCallback on_complete);
+
+    RetrieveToSinkResultType RetrieveRawData(const std::string& logpoint_name,
+                                             std::shared_ptr<DataChunkSink> sink,
+                                             const RPCParameters& parameters = RPCParameters());
+
+    std::shared_future<RetrieveToSinkResultType> RetrieveRawDataAsync(
+        ::bosdyn::api::spot_cam::RetrieveRawDataRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters = RPCParameters());
+
+    std::shared_future<RetrieveToSinkResultType> RetrieveRawDataAsync(
+        ::bosdyn::api::spot_cam::RetrieveRawDataRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+        RetrieveToSinkCallback on_complete);
+
+    RetrieveToSinkResultType RetrieveRawData(
+        ::bosdyn::api::spot_cam::RetrieveRawDataRequest& request,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters = RPCParameters());
 
     // Start of ServiceClient overrides.
     QualityOfService GetQualityOfService() const override;
@@ -153,6 +223,16 @@ class MediaLogClient : public ServiceClient {
                           ::bosdyn::api::spot_cam::DeleteResponse&& response,
                           const grpc::Status& status, std::promise<DeleteResultType> promise);
 
+    // Shared implementation of RetrieveAsync() and RetrieveRawDataAsync().
+    template <typename Request, typename Response>
+    std::shared_future<RetrieveToSinkResultType> RetrieveToSinkAsync(
+        Request& request,
+        const typename ResponseStreamCall<Request, Response,
+                                          RetrieveToSinkResponse>::ResponseStreamRpcCallFunction&
+            rpc_call,
+        std::shared_ptr<DataChunkSink> sink, const RPCParameters& parameters,
+        RetrieveToSinkCallback on_complete);
+
 
     std::unique_ptr<::bosdyn::api::spot_cam::MediaLogService::StubInterface> m_stub;
 
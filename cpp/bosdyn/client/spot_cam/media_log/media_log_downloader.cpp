@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/spot_cam/media_log/media_log_downloader.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "bosdyn/client/error_codes/sdk_error_code.h"
+#include "bosdyn/client/util/bounded_window.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace spot_cam {
+
+namespace fs = std::filesystem;
+
+const char* const kMediaLogManifestFile = "media_log_manifest";
+
+namespace {
+
+constexpr char kRawSuffix[] = ".raw";
+
+::bosdyn::common::Status DownloadError(const std::string& message) {
+    return ::bosdyn::common::Status(SDKErrorCode::GenericSDKError,
+                                    "Media log download: " + message);
+}
+
+::bosdyn::common::Status Success() { return ::bosdyn::common::Status(SDKErrorCode::Success); }
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool IsValidName(const std::string& logpoint_name) {
+    // Names are used as file names in the download directory.
+    return !logpoint_name.empty() && logpoint_name != "." && logpoint_name != ".." &&
+           logpoint_name.find_first_of("/\\\n") == std::string::npos;
+}
+
+std::string ManifestPath(const std::string& directory) {
+    return (fs::path(directory) / kMediaLogManifestFile).string();
+}
+
+::bosdyn::common::Status AppendToManifest(const std::string& directory,
+                                          const MediaLogManifestEntry& entry) {
+    const ::bosdyn::api::spot_cam::Logpoint::ImageParams& image = entry.logpoint.image_params();
+    std::ofstream manifest(ManifestPath(directory), std::ios::app);
+    manifest << (entry.raw_data ? 'r' : 'p') << ' ' << entry.num_bytes << ' '
+             << entry.logpoint.type() << ' ' << image.width() << ' ' << image.height() << ' '
+             << image.format() << ' ' << entry.logpoint.name() << '\n';
+    if (!manifest.flush()) return DownloadError("could not append to the manifest.");
+    return Success();
+}
+
+struct PendingDownload {
+    LogpointDownloadStats stats;
+    std::chrono::steady_clock::time_point start;
+    ::bosdyn::api::spot_cam::Logpoint logpoint;
+};
+
+}  // namespace
+
+std::string LogpointPath(const std::string& directory, const std::string& logpoint_name,
+                         bool raw_data) {
+    return (fs::path(directory) / (raw_data ? logpoint_name + kRawSuffix : logpoint_name))
+        .string();
+}
+
+::bosdyn::common::Status LoadMediaLogManifest(const std::string& directory,
+                                              std::vector<MediaLogManifestEntry>* entries) {
+    entries->clear();
+    const std::string path = ManifestPath(directory);
+    std::error_code error;
+    if (!fs::exists(path, error)) return Success();
+    std::ifstream manifest(path);
+    if (!manifest) return DownloadError("could not open " + path + ".");
+
+    // Index of the entry of each logpoint name and kind of data.
+    std::map<std::pair<std::string, bool>, size_t> index;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        char kind = 0;
+        int type = 0, width = 0, height = 0, format = 0;
+        MediaLogManifestEntry entry;
+        std::string name;
+        if (!(fields >> kind >> entry.num_bytes >> type >> width >> height >> format)) continue;
+        // The name is the rest of the line, and may contain spaces.
+        if (!std::getline(fields >> std::ws, name) || !IsValidName(name)) continue;
+        if (kind != 'r' && kind != 'p') continue;
+        if (!::bosdyn::api::spot_cam::Logpoint::RecordType_IsValid(type) ||
+            !::bosdyn::api::Image::PixelFormat_IsValid(format)) {
+            continue;
+        }
+        entry.raw_data = kind == 'r';
+        entry.logpoint.set_name(name);
+        entry.logpoint.set_type(static_cast<::bosdyn::api::spot_cam::Logpoint::RecordType>(type));
+        entry.logpoint.mutable_image_params()->set_width(width);
+        entry.logpoint.mutable_image_params()->set_height(height);
+        entry.logpoint.mutable_image_params()->set_format(
+            static_cast<::bosdyn::api::Image::PixelFormat>(format));
+        entry.path = LogpointPath(directory, name, entry.raw_data);
+
+        auto inserted = index.emplace(std::make_pair(name, entry.raw_data), entries->size());
+        if (inserted.second) {
+            entries->push_back(std::move(entry));
+        } else {
+            (*entries)[inserted.first->second] = std::move(entry);
+        }
+    }
+    return Success();
+}
+
+::bosdyn::common::Status DownloadLogpoints(MediaLogClient* client,
+                                           const std::vector<std::string>& logpoint_names,
+                                           const std::string& directory,
+                                           const MediaLogDownloadOptions& options,
+                                           MediaLogDownloadReport* report) {
+    MediaLogDownloadReport local_report;
+    if (!report) report = &local_report;
+    *report = MediaLogDownloadReport();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error) return DownloadError("could not create " + directory + ".");
+
+    // A logpoint is complete if it is in the manifest and its file still has the recorded size.
+    std::vector<MediaLogManifestEntry> manifest;
+    STATUS_OK_ELSE_RETURN(LoadMediaLogManifest(directory, &manifest));
+    std::set<std::string> complete;
+    for (const MediaLogManifestEntry& entry : manifest) {
+        if (entry.raw_data != options.raw_data) continue;
+        std::error_code file_error;
+        if (fs::file_size(entry.path, file_error) == entry.num_bytes && !file_error) {
+            complete.insert(entry.logpoint.name());
+        }
+    }
+
+    ::bosdyn::common::Status final_status = Success();
+    auto finish = [&](LogpointDownloadStats&& stats) {
+        if (stats.status) {
+            report->num_bytes_downloaded += stats.num_bytes;
+        } else {
+            final_status = stats.status;
+        }
+        if (options.on_logpoint_complete) options.on_logpoint_complete(stats);
+        report->logpoints.push_back(std::move(stats));
+    };
+
+    std::vector<PendingDownload> pending;
+    std::set<std::string> seen;
+    for (const std::string& logpoint_name : logpoint_names) {
+        if (!seen.insert(logpoint_name).second) continue;
+        if (complete.count(logpoint_name)) {
+            ++report->num_logpoints_skipped;
+        } else if (!IsValidName(logpoint_name)) {
+            LogpointDownloadStats stats;
+            stats.logpoint_name = logpoint_name;
+            stats.status = DownloadError("invalid logpoint name '" + logpoint_name + "'.");
+            finish(std::move(stats));
+        } else {
+            pending.emplace_back();
+            pending.back().stats.logpoint_name = logpoint_name;
+        }
+    }
+
+    // Each download records its result and time from its completion callback, and is added to
+    // the manifest and reported on this thread. The sink of a download is released once the RPC
+    // completes.
+    auto start_download = [&](size_t index, BoundedWindowDoneFunction done) {
+        PendingDownload& download = pending[index];
+        const std::string& logpoint_name = download.stats.logpoint_name;
+        download.start = std::chrono::steady_clock::now();
+        auto sink = std::make_shared<TempFileDataChunkSink>(
+            LogpointPath(directory, logpoint_name, options.raw_data));
+        StartWithCompletionCallback<RetrieveToSinkResultType>(
+            [&](RetrieveToSinkCallback on_complete) {
+                return options.raw_data
+                           ? client->RetrieveRawDataAsync(logpoint_name, std::move(sink),
+                                                          options.parameters, on_complete)
+                           : client->RetrieveAsync(logpoint_name, std::move(sink),
+                                                   options.parameters, on_complete);
+            },
+            [&download, done](const RetrieveToSinkResultType& result) {
+                download.stats.status = result.status;
+                download.stats.num_bytes = result.response.num_bytes;
+                download.stats.seconds = SecondsSince(download.start);
+                download.logpoint = result.response.logpoint;
+                done();
+            });
+    };
+    RunBoundedWindow(pending.size(), options.max_concurrent_downloads, start_download,
+                     [&](size_t index) {
+                         PendingDownload& download = pending[index];
+                         LogpointDownloadStats& stats = download.stats;
+                         if (stats.seconds > 0.0) {
+                             stats.bytes_per_second = stats.num_bytes / stats.seconds;
+                         }
+                         if (stats.status) {
+                             // The file is in place, so record it. The robot may omit the name
+                             // in its responses, and the file is named after the requested one.
+                             MediaLogManifestEntry entry;
+                             entry.logpoint = std::move(download.logpoint);
+                             entry.logpoint.set_name(stats.logpoint_name);
+                             entry.raw_data = options.raw_data;
+                             entry.num_bytes = stats.num_bytes;
+                             stats.status = AppendToManifest(directory, entry);
+                         }
+                         finish(std::move(stats));
+                     });
+
+    report->seconds = SecondsSince(start);
+    if (report->seconds > 0.0) {
+        report->bytes_per_second = report->num_bytes_downloaded / report->seconds;
+    }
+    return final_status;
+}
+
+}  // namespace spot_cam
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <bosdyn/api/spot_cam/logging.pb.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bosdyn/client/spot_cam/media_log/media_log_client.h"
+#include "bosdyn/common/status.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace spot_cam {
+
+struct LogpointDownloadStats {
+    std::string logpoint_name;
+    ::bosdyn::common::Status status;
+    uint64_t num_bytes = 0;
+    // Time from starting the download to its completion.
+    double seconds = 0.0;
+    double bytes_per_second = 0.0;
+};
+
+struct MediaLogDownloadOptions {
+    // Number of logpoint downloads kept in flight at once.
+    size_t max_concurrent_downloads = 4;
+    // Download with RetrieveRawData instead of Retrieve, e.g. for the tiles of a panorama or the
+    // temperatures of an IR image.
+    bool raw_data = false;
+    RPCParameters parameters;
+    // If set, called from the downloading thread as each logpoint download completes.
+    std::function<void(const LogpointDownloadStats&)> on_logpoint_complete;
+};
+
+struct MediaLogDownloadReport {
+    // One entry per logpoint that was downloaded, in order of completion.
+    std::vector<LogpointDownloadStats> logpoints;
+    // Logpoints that were already in the directory, from an earlier download, and were not
+    // downloaded again.
+    size_t num_logpoints_skipped = 0;
+    uint64_t num_bytes_downloaded = 0;
+    double seconds = 0.0;
+    // Throughput of the whole download, num_bytes_downloaded over seconds.
+    double bytes_per_second = 0.0;
+};
+
+// A logpoint recorded in the manifest of a download directory.
+struct MediaLogManifestEntry {
+    // Name, type and image parameters of the logpoint, as returned with its data.
+    ::bosdyn::api::spot_cam::Logpoint logpoint;
+    bool raw_data = false;
+    uint64_t num_bytes = 0;
+    // Path of the file holding the data.
+    std::string path;
+};
+
+// Name of the manifest file in a download directory.
+extern const char* const kMediaLogManifestFile;
+
+// Path of the file that DownloadLogpoints() writes the data of a logpoint to: the logpoint name in
+// the directory, with a ".raw" extension for raw data.
+std::string LogpointPath(const std::string& directory, const std::string& logpoint_name,
+                         bool raw_data);
+
+// Download the data of many logpoints, e.g. the panoramas and IR images stored during an
+// inspection mission, into files in a directory.
+//
+// Up to max_concurrent_downloads Retrieve or RetrieveRawData streams are kept in flight on the
+// MessagePump of the client, and each data chunk is written to a temporary file as it arrives,
+// so memory use is bounded by the window times the chunk size rather than by the size of the
+// images. A file is renamed into place at LogpointPath() once it is complete, and then appended
+// to the manifest of the directory along with the logpoint returned by the robot, which holds
+// the image parameters needed to read raw data.
+//
+// Logpoints in the manifest whose file is still complete are skipped, so downloading into the
+// same directory again after an interruption or a failure only fetches the ones still missing.
+// All logpoints are attempted; the status is the error of the last one that failed, if any.
+::bosdyn::common::Status DownloadLogpoints(
+    MediaLogClient* client, const std::vector<std::string>& logpoint_names,
+    const std::string& directory,
+    const MediaLogDownloadOptions& options = MediaLogDownloadOptions(),
+    MediaLogDownloadReport* report = nullptr);
+
+// Read the manifest of a download directory. Later entries for the same logpoint replace earlier
+// ones. A directory without a manifest has no entries.
+::bosdyn::common::Status LoadMediaLogManifest(const std::string& directory,
+                                              std::vector<MediaLogManifestEntry>* entries);
+
+}  // namespace spot_cam
+}  // namespace client
+
+}  // namespace bosdyn
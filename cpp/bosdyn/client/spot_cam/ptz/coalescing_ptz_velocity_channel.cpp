@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/spot_cam/ptz/coalescing_ptz_velocity_channel.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace spot_cam {
+
+CoalescingPtzVelocityChannel::CoalescingPtzVelocityChannel(PtzClient* client,
+                                                           const std::string& ptz_name,
+                                                           const CoalescingChannelOptions& options)
+    : m_client(client), m_ptz_name(ptz_name), m_channel(options) {}
+
+std::shared_future<SetPtzVelocityResultType> CoalescingPtzVelocityChannel::SetPtzVelocity(
+    float pan, float tilt, float zoom, const RPCParameters& parameters) {
+    ::bosdyn::api::spot_cam::SetPtzVelocityRequest request;
+    request.mutable_velocity()->mutable_ptz()->set_name(m_ptz_name);
+    request.mutable_velocity()->mutable_pan()->set_value(pan);
+    request.mutable_velocity()->mutable_tilt()->set_value(tilt);
+    request.mutable_velocity()->mutable_zoom()->set_value(zoom);
+    typedef CoalescingCommandChannel<SetPtzVelocityResultType>::CompletionCallback
+        CompletionCallback;
+    return m_channel.Submit(
+        [this, request, parameters](CompletionCallback on_complete) mutable {
+            return m_client->SetPtzVelocityAsync(request, parameters, std::move(on_complete));
+        });
+}
+
+}  // namespace spot_cam
+
+}  // namespace client
+
+}  // namespace bosdyn
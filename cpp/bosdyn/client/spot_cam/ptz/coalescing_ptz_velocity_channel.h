@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <string>
+
+#include "bosdyn/client/spot_cam/ptz/ptz_client.h"
+#include "bosdyn/client/util/coalescing_command_channel.h"
+
+namespace bosdyn {
+
+namespace client {
+
+namespace spot_cam {
+
+// Sends a stream of velocity commands to one PTZ with at most one SetPtzVelocity RPC in flight,
+// replacing commands that are still waiting to be sent by newer ones and dropping commands older
+// than max_staleness. See CoalescingCommandChannel.
+class CoalescingPtzVelocityChannel {
+ public:
+    // The client must outlive the channel.
+    CoalescingPtzVelocityChannel(
+        PtzClient* client, const std::string& ptz_name,
+        const CoalescingChannelOptions& options = CoalescingChannelOptions());
+
+    std::shared_future<SetPtzVelocityResultType> SetPtzVelocity(
+        float pan, float tilt, float zoom, const RPCParameters& parameters = RPCParameters());
+
+    CoalescingChannelStats GetStats() const { return m_channel.GetStats(); }
+
+ private:
+    PtzClient* m_client;
+    const std::string m_ptz_name;
+    CoalescingCommandChannel<SetPtzVelocityResultType> m_channel;
+};
+
+}  // namespace spot_cam
+
+}  // namespace client
+
+}  // namespace bosdyn
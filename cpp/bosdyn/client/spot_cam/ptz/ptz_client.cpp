@@ -223,6 +223,12 @@ SetPtzVelocityResultType PtzClient::SetPtzVelocity(const std::string& ptz_name,
 
 std::shared_future<SetPtzVelocityResultType> PtzClient::SetPtzVelocityAsync(
     ::bosdyn::api::spot_cam::SetPtzVelocityRequest& request, const RPCParameters& parameters) {
+    return SetPtzVelocityAsync(request, parameters, nullptr);
+}
+
+std::shared_future<SetPtzVelocityResultType> PtzClient::SetPtzVelocityAsync(
+    ::bosdyn::api::spot_cam::SetPtzVelocityRequest& request, const RPCParameters& parameters,
+    SetPtzVelocityCallback on_complete) {
     std::promise<SetPtzVelocityResultType> response;
     std::shared_future<SetPtzVelocityResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -234,7 +240,8 @@ std::shared_future<SetPtzVelocityResultType> PtzClient::SetPtzVelocityAsync(
             request,
             std::bind(&::bosdyn::api::spot_cam::PtzService::StubInterface::AsyncSetPtzVelocity,
                       m_stub.get(), _1, _2, _3),
-            std::bind(&PtzClient::OnSetPtzVelocityComplete, this, _1, _2, _3, _4, _5),
+            std::bind(&PtzClient::OnSetPtzVelocityComplete, this, _1, _2, _3, _4, _5,
+                      std::move(on_complete)),
             std::move(response), parameters);
 
     return future;
@@ -248,12 +255,14 @@ SetPtzVelocityResultType PtzClient::SetPtzVelocity(
 void PtzClient::OnSetPtzVelocityComplete(
     MessagePumpCallBase* call, const ::bosdyn::api::spot_cam::SetPtzVelocityRequest& request,
     ::bosdyn::api::spot_cam::SetPtzVelocityResponse&& response, const grpc::Status& status,
-    std::promise<SetPtzVelocityResultType> promise) {
+    std::promise<SetPtzVelocityResultType> promise, const SetPtzVelocityCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::spot_cam::SetPtzVelocityResponse>(
             status, response, SDKErrorCode::Success);
 
-    promise.set_value({ret_status, std::move(response)});
+    SetPtzVelocityResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 std::shared_future<InitializeLensResultType> PtzClient::InitializeLensAsync(
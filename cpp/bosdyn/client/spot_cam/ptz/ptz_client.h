@@ -27,6 +27,8 @@ typedef Result<::bosdyn::api::spot_cam::GetPtzPositionResponse> GetPtzPositionRe
 typedef Result<::bosdyn::api::spot_cam::GetPtzVelocityResponse> GetPtzVelocityResultType;
 typedef Result<::bosdyn::api::spot_cam::SetPtzPositionResponse> SetPtzPositionResultType;
 typedef Result<::bosdyn::api::spot_cam::SetPtzVelocityResponse> SetPtzVelocityResultType;
+// Called with the result of a SetPtzVelocity RPC as soon as it arrives, on the MessagePump thread.
+typedef std::function<void(const SetPtzVelocityResultType&)> SetPtzVelocityCallback;
 typedef Result<::bosdyn::api::spot_cam::InitializeLensResponse> InitializeLensResultType;
 
 // manual focus rpcs
@@ -100,6 +102,12 @@ class PtzClient : public ServiceClient {
     SetPtzVelocityResultType SetPtzVelocity(::bosdyn::api::spot_cam::SetPtzVelocityRequest& request,
                                             const RPCParameters& parameters = RPCParameters());
 
+    // Also calls on_complete with the result before the future is set. The callback is not called
+    // if the RPC cannot be started.
+    std::shared_future<SetPtzVelocityResultType> SetPtzVelocityAsync(
+        ::bosdyn::api::spot_cam::SetPtzVelocityRequest& request, const RPCParameters& parameters,
+        SetPtzVelocityCallback on_complete);
+
     std::shared_future<InitializeLensResultType> InitializeLensAsync(
         const RPCParameters& parameters = RPCParameters());
 
@@ -173,7 +181,8 @@ class PtzClient : public ServiceClient {
                                   const ::bosdyn::api::spot_cam::SetPtzVelocityRequest& request,
                                   ::bosdyn::api::spot_cam::SetPtzVelocityResponse&& response,
                                   const grpc::Status& status,
-                                  std::promise<SetPtzVelocityResultType> promise);
+                                  std::promise<SetPtzVelocityResultType> promise,
+                                  const SetPtzVelocityCallback& on_complete);
     void OnInitializeLensComplete(MessagePumpCallBase* call,
                                   const ::bosdyn::api::spot_cam::InitializeLensRequest& request,
                                   ::bosdyn::api::spot_cam::InitializeLensResponse&& response,
@@ -23,6 +23,12 @@ const char* TimeSyncClient::s_service_type = "bosdyn.api.TimeSyncService";
 
 std::shared_future<TimeSyncUpdateResultType> TimeSyncClient::TimeSyncUpdateAsync(
     ::bosdyn::api::TimeSyncUpdateRequest& request, const RPCParameters& parameters) {
+    return TimeSyncUpdateAsync(request, parameters, nullptr);
+}
+
+std::shared_future<TimeSyncUpdateResultType> TimeSyncClient::TimeSyncUpdateAsync(
+    ::bosdyn::api::TimeSyncUpdateRequest& request, const RPCParameters& parameters,
+    TimeSyncUpdateCallback on_complete) {
     std::promise<TimeSyncUpdateResultType> response;
     std::shared_future<TimeSyncUpdateResultType> future = response.get_future();
     BOSDYN_ASSERT_PRECONDITION(m_stub != nullptr, "Stub for service is unset!");
@@ -33,7 +39,8 @@ std::shared_future<TimeSyncUpdateResultType> TimeSyncClient::TimeSyncUpdateAsync
         request,
         std::bind(&::bosdyn::api::TimeSyncService::StubInterface::AsyncTimeSyncUpdate, m_stub.get(),
                   _1, _2, _3),
-        std::bind(&TimeSyncClient::OnTimeSyncUpdateComplete, this, _1, _2, _3, _4, _5),
+        std::bind(&TimeSyncClient::OnTimeSyncUpdateComplete, this, _1, _2, _3, _4, _5,
+                  std::move(on_complete)),
         std::move(response), parameters);
 
     return future;
@@ -48,11 +55,14 @@ void TimeSyncClient::OnTimeSyncUpdateComplete(MessagePumpCallBase* call,
                                               const ::bosdyn::api::TimeSyncUpdateRequest& request,
                                               ::bosdyn::api::TimeSyncUpdateResponse&& response,
                                               const grpc::Status& status,
-                                              std::promise<TimeSyncUpdateResultType> promise) {
+                                              std::promise<TimeSyncUpdateResultType> promise,
+                                              const TimeSyncUpdateCallback& on_complete) {
     ::bosdyn::common::Status ret_status =
         ProcessResponseAndGetFinalStatus<::bosdyn::api::TimeSyncUpdateResponse>(
             status, response, SDKErrorCode::Success);
-    promise.set_value({ret_status, std::move(response)});
+    TimeSyncUpdateResultType result = {ret_status, std::move(response)};
+    if (on_complete) on_complete(result);
+    promise.set_value(std::move(result));
 }
 
 
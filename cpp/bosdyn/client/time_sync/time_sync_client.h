@@ -23,6 +23,9 @@ namespace client {
 
 typedef Result<::bosdyn::api::TimeSyncUpdateResponse> TimeSyncUpdateResultType;
 
+// Called with the result of a time sync update as soon as it arrives.
+typedef std::function<void(const TimeSyncUpdateResultType&)> TimeSyncUpdateCallback;
+
 class TimeSyncClient : public ServiceClient {
  public:
     TimeSyncClient() = default;
@@ -34,6 +37,13 @@ class TimeSyncClient : public ServiceClient {
         ::bosdyn::api::TimeSyncUpdateRequest& request,
         const RPCParameters& parameters = RPCParameters());
 
+    // As above, but also call on_complete with the result on the MessagePump thread, before the
+    // returned future is ready. Callers that poll the future can record when the response arrived
+    // from on_complete. It is not called if the RPC cannot be started.
+    std::shared_future<TimeSyncUpdateResultType> TimeSyncUpdateAsync(
+        ::bosdyn::api::TimeSyncUpdateRequest& request, const RPCParameters& parameters,
+        TimeSyncUpdateCallback on_complete);
+
     // Synchronous method to time sync update.
     TimeSyncUpdateResultType TimeSyncUpdate(::bosdyn::api::TimeSyncUpdateRequest& request,
                                             const RPCParameters& parameters = RPCParameters());
@@ -57,7 +67,8 @@ class TimeSyncClient : public ServiceClient {
                                   const ::bosdyn::api::TimeSyncUpdateRequest& request,
                                   ::bosdyn::api::TimeSyncUpdateResponse&& response,
                                   const grpc::Status& status,
-                                  std::promise<TimeSyncUpdateResultType> promise);
+                                  std::promise<TimeSyncUpdateResultType> promise,
+                                  const TimeSyncUpdateCallback& on_complete);
 
 
     // Default service name for the Timesync service.
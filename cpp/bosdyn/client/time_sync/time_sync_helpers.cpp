@@ -17,6 +17,14 @@ namespace bosdyn {
 
 namespace client {
 
+namespace {
+
+// Spread of the update interval, so that the updates for many robots started together do not
+// stay in step.
+constexpr double kTimeSyncIntervalJitter = 0.1;
+
+}  // namespace
+
 // TimeSyncEndpoint methods
 TimeSyncEndpoint::TimeSyncEndpoint(TimeSyncClient* client) {
     m_client = client;
@@ -30,10 +38,8 @@ TimeSyncUpdateResultType TimeSyncEndpoint::GetResult() {
     return m_locked_previous_result;
 }
 
-bool TimeSyncEndpoint::HasEstablishedTimeSync() {
-    TimeSyncUpdateResultType update_result = GetResult();
-    return update_result.status &&
-           update_result.response.state().status() == ::bosdyn::api::TimeSyncState::STATUS_OK;
+bool TimeSyncEndpoint::HasEstablishedTimeSync() const {
+    return m_has_established_time_sync.load(std::memory_order_acquire);
 }
 
 DurationResultType TimeSyncEndpoint::GetRoundTripTime() {
@@ -84,14 +90,35 @@ DurationResultType TimeSyncEndpoint::GetClockSkew() {
 }
 
 bool TimeSyncEndpoint::GetNewEstimate() {
-    TimeSyncUpdateResultType update_result = Update();
+    TimeSyncUpdateResultType update_result = GetNewEstimateAsync().get();
     if (!update_result.status) {
         std::cerr << "GetNewEstimate: Update failed - " << update_result.response.DebugString()
                   << std::endl;
         return false;
     }
-    ::google::protobuf::Timestamp rx_time = ::bosdyn::common::NowTimestamp();
+    return true;
+}
+
+std::shared_future<TimeSyncUpdateResultType> TimeSyncEndpoint::GetNewEstimateAsync() {
+    return GetNewEstimateAsync(nullptr);
+}
+
+std::shared_future<TimeSyncUpdateResultType> TimeSyncEndpoint::GetNewEstimateAsync(
+    TimeSyncUpdateCallback on_complete) {
+    ::bosdyn::api::TimeSyncUpdateRequest request = MakeUpdateRequest();
+    return m_client->TimeSyncUpdateAsync(
+        request, RPCParameters(),
+        [this, on_complete = std::move(on_complete)](
+            const TimeSyncUpdateResultType& update_result) {
+            if (update_result.status) {
+                RecordEstimate(update_result, ::bosdyn::common::NowTimestamp());
+            }
+            if (on_complete) on_complete(update_result);
+        });
+}
 
+void TimeSyncEndpoint::RecordEstimate(const TimeSyncUpdateResultType& update_result,
+                                      const ::google::protobuf::Timestamp& rx_time) {
     // Record the timing info for this gRPC call to pass to the next update.
     ::bosdyn::api::TimeSyncRoundTrip round_trip;
     round_trip.mutable_client_tx()->CopyFrom(
@@ -106,8 +133,14 @@ bool TimeSyncEndpoint::GetNewEstimate() {
     m_locked_previous_round_trip = round_trip;
     m_locked_previous_result = update_result;
     m_locked_clock_identifier = update_result.response.clock_identifier();
-
-    return true;
+    m_clock_skew_nsec.store(
+        ::bosdyn::common::DurationToNsec(
+            update_result.response.state().best_estimate().clock_skew()),
+        std::memory_order_relaxed);
+    // Release the skew along with the flag, for readers that check the flag first.
+    m_has_established_time_sync.store(
+        update_result.response.state().status() == ::bosdyn::api::TimeSyncState::STATUS_OK,
+        std::memory_order_release);
 }
 
 bool TimeSyncEndpoint::EstablishTimeSync(int max_samples, bool break_on_success) {
@@ -121,10 +154,8 @@ bool TimeSyncEndpoint::EstablishTimeSync(int max_samples, bool break_on_success)
 }
 
 ::bosdyn::common::RobotTimeConverter TimeSyncEndpoint::GetRobotTimeConverter() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
     return ::bosdyn::common::RobotTimeConverter(
-        std::chrono::nanoseconds(::bosdyn::common::DurationToNsec(
-            m_locked_previous_result.response.state().best_estimate().clock_skew())));
+        std::chrono::nanoseconds(m_clock_skew_nsec.load(std::memory_order_relaxed)));
 }
 
 google::protobuf::Timestamp TimeSyncEndpoint::RobotTimestampFromLocal(
@@ -133,45 +164,64 @@ google::protobuf::Timestamp TimeSyncEndpoint::RobotTimestampFromLocal(
     return robot_time_converter.RobotTimestampFromLocal(local_time);
 }
 
-TimeSyncUpdateResultType TimeSyncEndpoint::Update() {
+::bosdyn::api::TimeSyncUpdateRequest TimeSyncEndpoint::MakeUpdateRequest() {
     ::bosdyn::api::TimeSyncUpdateRequest request;
     // If clock_identifier not set, use empty clock_identifier.
     // Only add a round trip to a request that contains a clock identifier, otherwise the
     // sever will respond with an invalid request error.  Responses with errors may not
     // contain a clock identifier. This may happen, for example, if the service was not
     // yet ready at the time of the request.
-    StringResultType clock_id_result = GetClockIdentifier();
-    if (clock_id_result.status) {
-        request.set_clock_identifier(*clock_id_result.response);
-        request.mutable_previous_round_trip()->CopyFrom(m_locked_previous_round_trip);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_locked_clock_identifier.empty()) {
+            request.set_clock_identifier(m_locked_clock_identifier);
+            request.mutable_previous_round_trip()->CopyFrom(m_locked_previous_round_trip);
+        }
     }
-
-    return m_client->TimeSyncUpdate(request);
+    return request;
 }
 
 // TimeSyncThread Methods
 void TimeSyncThread::Start() {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
     if (!IsStoppedLocked(lock)) {
         return;
     }
     m_locked_should_exit = false;
     m_locked_thread_stopped = false;
-    m_thread = std::thread(&TimeSyncThread::TimeSyncThreadMethod, this);
+    if (!m_scheduler) m_scheduler = PeriodicScheduler::GetDefault();
+
+    // A failed update is retried at once, as is one that has not established time sync yet. Only
+    // a time sync service that is not ready yet is polled at a fixed, slower interval.
+    PeriodicTaskOptions options;
+    options.period = m_time_sync_interval;
+    options.jitter = kTimeSyncIntervalJitter;
+    options.initial_backoff = kTimeSyncServiceNotReadyInterval;
+    options.max_backoff = kTimeSyncServiceNotReadyInterval;
+    m_scheduler->Schedule([this](bool) { return UpdateStep(); }, options, &m_update_task);
 }
 
 void TimeSyncThread::Stop() {
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        if (IsStoppedLocked(lock)) {
+        if (m_locked_thread_stopped) {
             return;
         }
         m_locked_should_exit = true;
     }
-    m_thread.join();
+    m_update_task.Cancel();
+    // The estimate in flight records into the endpoint when it arrives, so wait for it, and drop
+    // it so a restart begins with a new one.
+    m_estimate_rpc.Wait();
+    m_estimate_rpc.Reset();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_locked_thread_stopped = true;
+    }
+    m_cv.notify_all();
 }
 
-bool TimeSyncThread::IsStoppedLocked(const std::lock_guard<std::mutex>& lock) const {
+bool TimeSyncThread::IsStoppedLocked(const std::unique_lock<std::mutex>& lock) const {
     return m_locked_thread_stopped;
 }
 
@@ -184,20 +234,10 @@ bool TimeSyncThread::WaitForSync(::bosdyn::common::Duration timeout) {
     if (HasEstablishedTimeSync()) {
         return true;
     }
-    auto end_time = std::chrono::system_clock::now() + timeout;
-    while (std::chrono::system_clock::now() < end_time) {
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            if (IsStoppedLocked(lock)) {
-                return false;
-            }
-        }
-        if (HasEstablishedTimeSync()) {
-            return true;
-        }
-        std::this_thread::sleep_for(kSleepInterval);
-    }
-    return false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait_for(lock, timeout,
+                  [this, &lock]() { return IsStoppedLocked(lock) || HasEstablishedTimeSync(); });
+    return !IsStoppedLocked(lock) && HasEstablishedTimeSync();
 }
 
 DurationResultType TimeSyncThread::GetRobotClockSkew(::bosdyn::common::Duration time_sync_timeout) {
@@ -246,43 +286,40 @@ TimestampResultType TimeSyncThread::RobotTimestampFromLocal(
     return result;
 }
 
-void TimeSyncThread::TimeSyncThreadMethod() {
-    while (true) {
-        // If exit requested, break from loop.
-        if (ShouldExit()) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_locked_thread_stopped = true;
-            return;
-        }
+PeriodicTaskResult TimeSyncThread::UpdateStep() {
+    // Make RPC call to update time sync estimate. Its completion triggers the task.
+    if (!m_estimate_rpc.InFlight()) {
+        m_estimate_rpc.Start(&m_update_task, [this](TimeSyncUpdateCallback on_complete) {
+            return m_time_sync_endpoint.GetNewEstimateAsync(std::move(on_complete));
+        });
+    }
+    if (!m_estimate_rpc.Ready()) return PeriodicTaskResult::kWaitForTrigger;
+    const ::bosdyn::common::Status update_status = m_estimate_rpc.Take().status;
+    if (!update_status) {
+        std::cerr << "TimeSyncThread failed to get new estimate: " << update_status.DebugString()
+                  << std::endl;
+    }
+
+    // Wake up WaitForSync() callers. Taking the lock ensures none of them is between checking
+    // for time sync and starting to wait.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_cv.notify_all();
 
-        TimeSyncUpdateResultType result = m_time_sync_endpoint.GetResult();
-        auto sleep_nanos = std::chrono::nanoseconds(0);
+    // Choose the next update from the latest estimate, which a failed update leaves unchanged.
+    TimeSyncUpdateResultType result = m_time_sync_endpoint.GetResult();
+    if (!result.status) return PeriodicTaskResult::kRetry;
+    switch (result.response.state().status()) {
         // If time sync service not running, wait for interval before polling again.
-        if (result.status && result.response.state().status() ==
-                                 ::bosdyn::api::TimeSyncState::STATUS_SERVICE_NOT_READY) {
-            sleep_nanos = kTimeSyncServiceNotReadyInterval;
-        }
+        case ::bosdyn::api::TimeSyncState::STATUS_SERVICE_NOT_READY:
+            return PeriodicTaskResult::kFailure;
         // Else if time sync already established, wait for interval before polling again.
-        else if (result.status &&
-                 result.response.state().status() == ::bosdyn::api::TimeSyncState::STATUS_OK) {
-            sleep_nanos = m_time_sync_interval;
-        }  // Else if time sync not yet established, no delay.
-
-        // Wait selected time, break if stop requested
-        auto end_time = std::chrono::system_clock::now() + sleep_nanos;
-        while (std::chrono::system_clock::now() < end_time) {
-            std::this_thread::sleep_for(kSleepInterval);
-            if (ShouldExit()) {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_locked_thread_stopped = true;
-                return;
-            }
-        }
-
-        // Make RPC call to update time sync estimate.
-        if (!m_time_sync_endpoint.GetNewEstimate()) {
-            std::cerr << "TimeSyncThreadMethod failed to get new estimate";
-        }
+        case ::bosdyn::api::TimeSyncState::STATUS_OK:
+            return PeriodicTaskResult::kSuccess;
+        // Else if time sync not yet established, no delay.
+        default:
+            return PeriodicTaskResult::kRetry;
     }
 }
 
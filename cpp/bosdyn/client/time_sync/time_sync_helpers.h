@@ -9,12 +9,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 
 #include "bosdyn/client/service_client/common_result_types.h"
 #include "bosdyn/client/time_sync/time_sync_client.h"
+#include "bosdyn/client/util/periodic_scheduler.h"
 #include "bosdyn/common/robot_time_converter.h"
 
 namespace bosdyn {
@@ -31,7 +35,8 @@ class TimeSyncEndpoint {
 
     TimeSyncUpdateResultType GetResult();
 
-    bool HasEstablishedTimeSync();
+    // Return true if the latest estimate reports time sync established. Does not take a lock.
+    bool HasEstablishedTimeSync() const;
 
     DurationResultType GetRoundTripTime();
 
@@ -41,14 +46,32 @@ class TimeSyncEndpoint {
 
     bool GetNewEstimate();
 
+    // Async version of GetNewEstimate. The estimate is recorded on the MessagePump thread as soon
+    // as the response arrives, before the returned future is ready, so a caller that polls the
+    // future does not add its polling delay to the measured round trip. The endpoint must outlive
+    // the returned future.
+    std::shared_future<TimeSyncUpdateResultType> GetNewEstimateAsync();
+
+    // As above, but also call on_complete with the result on the MessagePump thread, once the
+    // estimate is recorded and before the returned future is ready. It is not called if the RPC
+    // cannot be started.
+    std::shared_future<TimeSyncUpdateResultType> GetNewEstimateAsync(
+        TimeSyncUpdateCallback on_complete);
+
     bool EstablishTimeSync(int max_samples, bool break_on_success);
 
+    // Return a converter for the clock skew of the latest estimate. This reads a snapshot of the
+    // estimate without taking a lock, so it is cheap enough for timestamp conversion on hot paths.
     ::bosdyn::common::RobotTimeConverter GetRobotTimeConverter() const;
 
     google::protobuf::Timestamp RobotTimestampFromLocal(::bosdyn::common::TimePoint local_time);
 
  private:
-    TimeSyncUpdateResultType Update();
+    ::bosdyn::api::TimeSyncUpdateRequest MakeUpdateRequest();
+
+    // Record a successful update, whose response was received at rx_time.
+    void RecordEstimate(const TimeSyncUpdateResultType& update_result,
+                        const ::google::protobuf::Timestamp& rx_time);
 
     TimeSyncClient* m_client = nullptr;
     mutable std::mutex m_mutex;
@@ -56,14 +79,24 @@ class TimeSyncEndpoint {
     ::bosdyn::api::TimeSyncRoundTrip m_locked_previous_round_trip;
     TimeSyncUpdateResultType m_locked_previous_result;
     std::string m_locked_clock_identifier;
+
+    // Snapshot of the latest estimate, written under the lock and read without it.
+    std::atomic<int64_t> m_clock_skew_nsec{0};
+    std::atomic<bool> m_has_established_time_sync{false};
 };
 
 // The TimeSyncThread class is used to establish and maintain robot timesync asynchronously.
+// The updates are a task of a PeriodicScheduler, by default the one shared by the whole process,
+// rather than a thread per robot. The "thread" of the methods below refers to that task.
 class TimeSyncThread {
  public:
-    explicit TimeSyncThread(TimeSyncClient* client, ::bosdyn::common::Duration time_sync_interval =
-                                                        std::chrono::nanoseconds(int64_t(60 * 1e9)))
-        : m_time_sync_interval(time_sync_interval), m_time_sync_endpoint(client), m_thread() {}
+    explicit TimeSyncThread(TimeSyncClient* client,
+                            ::bosdyn::common::Duration time_sync_interval =
+                                std::chrono::nanoseconds(int64_t(60 * 1e9)),
+                            std::shared_ptr<PeriodicScheduler> scheduler = nullptr)
+        : m_time_sync_interval(time_sync_interval),
+          m_time_sync_endpoint(client),
+          m_scheduler(std::move(scheduler)) {}
 
     ~TimeSyncThread() { Stop(); }
 
@@ -82,7 +115,8 @@ class TimeSyncThread {
     // Return true if time sync has been established with the robot.
     bool HasEstablishedTimeSync() { return m_time_sync_endpoint.HasEstablishedTimeSync(); }
 
-    // Wait up to timeout for time sync to be achieved.
+    // Wait up to timeout for time sync to be achieved. Returns as soon as the thread gets an
+    // estimate that establishes time sync, or as soon as the thread is stopped.
     bool WaitForSync(::bosdyn::common::Duration timeout = std::chrono::seconds(3));
 
     // Get the current estimate for robot clock skew from local time.
@@ -95,26 +129,34 @@ class TimeSyncThread {
     TimestampResultType RobotTimestampFromLocal(::bosdyn::common::TimePoint local_time);
 
  private:
-    // Background thread that achieves and maintains timesync with the robot.
-    void TimeSyncThreadMethod();
+    // Step of the background task that achieves and maintains timesync with the robot. It gets a
+    // new estimate, and then chooses when to get the next one from the latest result.
+    PeriodicTaskResult UpdateStep();
 
     // Return true if the thread is no longer running. Passed in
     // unique_lock should own m_mutex before calling.
-    bool IsStoppedLocked(const std::lock_guard<std::mutex>& lock) const;
+    bool IsStoppedLocked(const std::unique_lock<std::mutex>& lock) const;
 
     // After achieving time sync, update estimate at this interval.
     ::bosdyn::common::Duration m_time_sync_interval;
     // When the time sync service is not yet ready, poll it at this interval.
     const ::bosdyn::common::Duration kTimeSyncServiceNotReadyInterval = std::chrono::seconds(5);
-    // How long to sleep in between stop request checks (10 ms)
-    const ::bosdyn::common::Duration kSleepInterval = std::chrono::nanoseconds(10000000);
     // TimeSyncEndpoint object created with the provided TimeSyncClient.
     TimeSyncEndpoint m_time_sync_endpoint;
 
+    // Scheduler running the updates, PeriodicScheduler::GetDefault() unless one was passed.
+    std::shared_ptr<PeriodicScheduler> m_scheduler;
+
     std::mutex m_mutex;
+    // Notified when the thread gets a new estimate, is asked to exit, or stops.
+    std::condition_variable m_cv;
     bool m_locked_should_exit = false;
     bool m_locked_thread_stopped = true;
-    std::thread m_thread;
+
+    // The estimate in flight, if any. Only used by UpdateStep, and by Stop once the task is
+    // cancelled.
+    PeriodicTaskRpc<TimeSyncUpdateResultType> m_estimate_rpc;
+    PeriodicTaskHandle m_update_task;
 };
 
 }  // namespace client
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/util/bounded_window.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace bosdyn {
+namespace client {
+
+namespace {
+
+// Indices of the operations that finished since the window last woke up. Shared with the done
+// functions, which may outlive the call in unusual cases such as a callback running late.
+struct FinishedOperations {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<size_t> indices;
+};
+
+}  // namespace
+
+void RunBoundedWindow(size_t num_operations, size_t window,
+                      const BoundedWindowStartFunction& start,
+                      const BoundedWindowCompleteFunction& complete) {
+    window = std::max<size_t>(window, 1);
+    auto finished = std::make_shared<FinishedOperations>();
+    std::vector<size_t> completed;
+    size_t next = 0;
+    size_t in_flight = 0;
+    while (next < num_operations || in_flight > 0) {
+        while (next < num_operations && in_flight < window) {
+            const size_t index = next++;
+            ++in_flight;
+            start(index, [finished, index]() {
+                std::lock_guard<std::mutex> lock(finished->mutex);
+                finished->indices.push_back(index);
+                finished->cv.notify_one();
+            });
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(finished->mutex);
+            finished->cv.wait(lock, [&finished]() { return !finished->indices.empty(); });
+            completed.swap(finished->indices);
+        }
+        for (size_t index : completed) {
+            --in_flight;
+            complete(index);
+        }
+        completed.clear();
+    }
+}
+
+}  // namespace client
+}  // namespace bosdyn
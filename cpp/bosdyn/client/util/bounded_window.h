@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace bosdyn {
+namespace client {
+
+// Called exactly once when an operation started by RunBoundedWindow finishes. It may be called
+// from any thread, including from within the start function.
+typedef std::function<void()> BoundedWindowDoneFunction;
+
+// Starts operation index, and arranges for done to be called once it finishes.
+typedef std::function<void(size_t index, BoundedWindowDoneFunction done)>
+    BoundedWindowStartFunction;
+
+// Handles the completion of operation index.
+typedef std::function<void(size_t index)> BoundedWindowCompleteFunction;
+
+// Run num_operations asynchronous operations in index order, with at most window of them in flight
+// at a time. Each time an operation calls its done function, complete is called for it and the
+// next operation is started. Both start and complete are only called on the calling thread, which
+// sleeps on a condition variable while the window is full. Returns once every operation has
+// completed.
+void RunBoundedWindow(size_t num_operations, size_t window,
+                      const BoundedWindowStartFunction& start,
+                      const BoundedWindowCompleteFunction& complete);
+
+// Start an RPC through an Async method overload that takes a completion callback, and call
+// on_result exactly once with its result. start_rpc is called with the callback to pass to the
+// Async method and returns the future it returns. The client does not call the callback if the RPC
+// cannot be started; on_result is then called right away with the result in the future.
+template <class ResultType, class StartRpcFunction>
+void StartWithCompletionCallback(const StartRpcFunction& start_rpc,
+                                 std::function<void(const ResultType&)> on_result) {
+    auto called = std::make_shared<std::atomic<bool>>(false);
+    std::shared_future<ResultType> future =
+        start_rpc([called, on_result](const ResultType& result) {
+            called->store(true);
+            on_result(result);
+        });
+    // The callback runs before the future is set, so a ready future with the flag unset means the
+    // RPC was never started.
+    if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !called->load()) {
+        on_result(future.get());
+    }
+}
+
+}  // namespace client
+}  // namespace bosdyn
@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include "bosdyn/client/error_codes/rpc_error_code.h"
+#include "bosdyn/common/status.h"
+#include "bosdyn/common/time.h"
+
+namespace bosdyn {
+
+namespace client {
+
+struct CoalescingChannelOptions {
+    // A command still waiting to be sent this long after it was submitted is dropped instead of
+    // sent. Zero means commands never go stale.
+    ::bosdyn::common::Duration max_staleness = std::chrono::milliseconds(500);
+};
+
+struct CoalescingChannelStats {
+    uint64_t num_submitted = 0;
+    // Commands whose RPC was started.
+    uint64_t num_sent = 0;
+    // Commands replaced by a newer command before they were sent.
+    uint64_t num_replaced = 0;
+    // Commands dropped because they were older than max_staleness when they could be sent.
+    uint64_t num_dropped = 0;
+};
+
+// Sends a stream of commands, such as joystick velocity commands, where only the latest command
+// matters. At most one RPC of the stream is in flight at a time. A command submitted while one is
+// in flight waits, and is replaced if a newer command is submitted before it can be sent, so a
+// slow link delays the stream by at most one round trip instead of queueing stale commands.
+//
+// ResultType is the Result<> of the RPC. Replaced and dropped commands complete with
+// ClientCancelledOperationError.
+template <class ResultType>
+class CoalescingCommandChannel {
+ public:
+    typedef std::function<void(const ResultType&)> CompletionCallback;
+    // Starts the RPC of one command and returns its future. The RPC must call on_complete with
+    // its result before setting the future, or not at all if the future is set before this
+    // returns. Called when the command is sent, so it can fill in time-dependent fields then.
+    typedef std::function<std::shared_future<ResultType>(CompletionCallback on_complete)> SendFn;
+
+    explicit CoalescingCommandChannel(
+        const CoalescingChannelOptions& options = CoalescingChannelOptions())
+        : m_options(options) {}
+
+    // Cancel the command waiting to be sent, and wait for the one in flight to complete.
+    ~CoalescingCommandChannel() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_pending) {
+            std::promise<ResultType> promise = std::move(m_pending->promise);
+            m_pending.reset();
+            lock.unlock();
+            promise.set_value({::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
+                                                        "Command channel was destroyed"),
+                               {}});
+            lock.lock();
+        }
+        m_idle_cv.wait(lock, [this]() { return !m_in_flight && m_num_sending == 0; });
+    }
+
+    CoalescingCommandChannel(const CoalescingCommandChannel&) = delete;
+    CoalescingCommandChannel& operator=(const CoalescingCommandChannel&) = delete;
+
+    // Send a command now if none is in flight, otherwise when the one in flight completes,
+    // replacing any command still waiting to be sent.
+    std::shared_future<ResultType> Submit(SendFn send) {
+        std::promise<ResultType> promise;
+        std::shared_future<ResultType> future = promise.get_future();
+        std::unique_ptr<PendingCommand> replaced;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_stats.num_submitted;
+            if (m_pending) {
+                ++m_stats.num_replaced;
+                replaced = std::move(m_pending);
+            }
+            m_pending.reset(new PendingCommand{std::move(send), std::move(promise),
+                                               std::chrono::steady_clock::now()});
+            SendPending(&lock);
+        }
+        if (replaced) {
+            replaced->promise.set_value(
+                {::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
+                                          "Replaced by a newer command before it was sent"),
+                 {}});
+        }
+        return future;
+    }
+
+    CoalescingChannelStats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+ private:
+    struct PendingCommand {
+        SendFn send;
+        std::promise<ResultType> promise;
+        std::chrono::steady_clock::time_point submit_time;
+    };
+
+    // Send the pending command if no command is in flight, dropping it if it is stale. Requires
+    // the lock, which is released while the RPC is started.
+    void SendPending(std::unique_lock<std::mutex>* lock) {
+        ++m_num_sending;
+        while (!m_in_flight && m_pending) {
+            std::unique_ptr<PendingCommand> command = std::move(m_pending);
+            if (m_options.max_staleness > ::bosdyn::common::Duration(0) &&
+                std::chrono::steady_clock::now() - command->submit_time > m_options.max_staleness) {
+                ++m_stats.num_dropped;
+                lock->unlock();
+                command->promise.set_value(
+                    {::bosdyn::common::Status(RPCErrorCode::ClientCancelledOperationError,
+                                              "Dropped because it was too old to send"),
+                     {}});
+                lock->lock();
+                continue;
+            }
+            ++m_stats.num_sent;
+            m_in_flight = true;
+            const uint64_t send_id = ++m_last_send_id;
+            m_in_flight_promise = std::move(command->promise);
+
+            lock->unlock();
+            std::shared_future<ResultType> future = command->send(
+                [this, send_id](const ResultType& result) { OnSendComplete(send_id, result); });
+            lock->lock();
+
+            // A command that failed before its RPC started, e.g. without a lease, completes its
+            // future without calling on_complete.
+            if (m_in_flight && m_last_send_id == send_id &&
+                future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                m_in_flight = false;
+                std::promise<ResultType> promise = std::move(m_in_flight_promise);
+                lock->unlock();
+                promise.set_value(future.get());
+                lock->lock();
+            }
+        }
+        --m_num_sending;
+        m_idle_cv.notify_all();
+    }
+
+    // Called on the MessagePump thread when the RPC in flight completes. Sends the pending
+    // command, if any, from that thread.
+    void OnSendComplete(uint64_t send_id, const ResultType& result) {
+        std::promise<ResultType> promise;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_in_flight || m_last_send_id != send_id) return;
+            m_in_flight = false;
+            promise = std::move(m_in_flight_promise);
+            SendPending(&lock);
+        }
+        promise.set_value(result);
+    }
+
+    const CoalescingChannelOptions m_options;
+    mutable std::mutex m_mutex;
+    // Notified when SendPending returns, so the destructor can wait for the channel to go idle.
+    std::condition_variable m_idle_cv;
+    std::unique_ptr<PendingCommand> m_pending;
+    bool m_in_flight = false;
+    // Number of threads in SendPending, which releases the lock while it sends.
+    int m_num_sending = 0;
+    uint64_t m_last_send_id = 0;
+    std::promise<ResultType> m_in_flight_promise;
+    CoalescingChannelStats m_stats;
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
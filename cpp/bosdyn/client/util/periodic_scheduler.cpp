@@ -0,0 +1,395 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "bosdyn/client/util/periodic_scheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace bosdyn {
+
+namespace client {
+
+namespace {
+
+constexpr uint64_t kNoEvent = std::numeric_limits<uint64_t>::max();
+
+int CountTrailingZeros(uint64_t bits) {
+    int count = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+// State of a task. All fields but step are guarded by the mutex of the scheduler.
+struct PeriodicTaskHandle::Task : public std::enable_shared_from_this<Task> {
+    PeriodicTaskFn step;
+    PeriodicTaskOptions options;
+    // False once the task is cancelled or its step function returns kStop.
+    bool active = true;
+    // The step function is being called, by running_thread.
+    bool running = false;
+    std::thread::id running_thread;
+    // The last call of the step function returned kWaitForTrigger. The task is then only in the
+    // wheel until its deadline, if it has one.
+    bool waiting = false;
+    bool deadline_reported = false;
+    // Trigger() was called while the task was running.
+    bool triggered = false;
+    std::chrono::steady_clock::time_point run_start;
+    ::bosdyn::common::Duration backoff{0};
+    // Position in the wheel, if level >= 0, or in the ready list, if in_ready.
+    uint64_t expires_tick = 0;
+    int level = -1;
+    uint64_t slot = 0;
+    size_t slot_index = 0;
+    bool in_ready = false;
+    Task* ready_prev = nullptr;
+    Task* ready_next = nullptr;
+    // Index in the task list of the scheduler, while active.
+    size_t task_index = 0;
+};
+
+PeriodicTaskHandle& PeriodicTaskHandle::operator=(PeriodicTaskHandle&& other) {
+    if (this != &other) {
+        Cancel();
+        m_scheduler = std::move(other.m_scheduler);
+        m_task = std::move(other.m_task);
+    }
+    return *this;
+}
+
+void PeriodicTaskHandle::Cancel() {
+    if (m_task) m_scheduler->Cancel(m_task);
+}
+
+void PeriodicTaskHandle::Trigger() {
+    if (m_task) m_scheduler->Trigger(m_task);
+}
+
+void PeriodicTaskHandle::SetPeriod(::bosdyn::common::Duration period) {
+    if (!m_task) return;
+    std::lock_guard<std::mutex> lock(m_scheduler->m_mutex);
+    m_task->options.period = period;
+}
+
+bool PeriodicTaskHandle::IsActive() const {
+    if (!m_task) return false;
+    std::lock_guard<std::mutex> lock(m_scheduler->m_mutex);
+    return m_task->active;
+}
+
+PeriodicScheduler::PeriodicScheduler(size_t num_threads)
+    : m_start(std::chrono::steady_clock::now()), m_random(std::random_device()()) {
+    for (size_t i = 0; i < std::max<size_t>(num_threads, 1); ++i) {
+        m_threads.emplace_back(&PeriodicScheduler::RunThread, this);
+    }
+}
+
+PeriodicScheduler::~PeriodicScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_cv.notify_all();
+    for (std::thread& thread : m_threads) {
+        // The last handle can be released by a step function, on a thread of this scheduler.
+        if (thread.get_id() == std::this_thread::get_id()) {
+            thread.detach();
+        } else {
+            thread.join();
+        }
+    }
+}
+
+std::shared_ptr<PeriodicScheduler> PeriodicScheduler::GetDefault() {
+    static std::shared_ptr<PeriodicScheduler> scheduler = std::make_shared<PeriodicScheduler>();
+    return scheduler;
+}
+
+PeriodicTaskHandle PeriodicScheduler::Schedule(PeriodicTaskFn step,
+                                               const PeriodicTaskOptions& options) {
+    PeriodicTaskHandle handle;
+    Schedule(std::move(step), options, &handle);
+    return handle;
+}
+
+void PeriodicScheduler::Schedule(PeriodicTaskFn step, const PeriodicTaskOptions& options,
+                                 PeriodicTaskHandle* handle) {
+    auto task = std::make_shared<Task>();
+    task->step = std::move(step);
+    task->options = options;
+    // Cancel the previous task without holding the mutex, which Cancel() takes.
+    handle->Cancel();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Set the handle first, so the first run sees it.
+        handle->m_scheduler = shared_from_this();
+        handle->m_task = task;
+        task->task_index = m_tasks.size();
+        m_tasks.push_back(task);
+        Insert(task.get(), DueTick(Jittered(options.initial_delay, options)));
+    }
+    m_cv.notify_all();
+}
+
+size_t PeriodicScheduler::NumTasks() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+uint64_t PeriodicScheduler::NowTick() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                 m_start)
+        .count();
+}
+
+std::chrono::steady_clock::time_point PeriodicScheduler::TickTime(uint64_t tick) const {
+    return m_start + std::chrono::milliseconds(tick);
+}
+
+uint64_t PeriodicScheduler::DueTick(::bosdyn::common::Duration delay) const {
+    // Round up, so tasks never run early.
+    const auto due = std::chrono::steady_clock::now() - m_start +
+                     std::max(delay, ::bosdyn::common::Duration::zero());
+    return std::chrono::ceil<std::chrono::milliseconds>(due).count();
+}
+
+void PeriodicScheduler::Insert(Task* task, uint64_t expires_tick) {
+    if (expires_tick <= m_current_tick) {
+        task->in_ready = true;
+        task->ready_prev = m_ready_tail;
+        task->ready_next = nullptr;
+        (m_ready_tail ? m_ready_tail->ready_next : m_ready_head) = task;
+        m_ready_tail = task;
+        return;
+    }
+    // Level k holds the tasks due in [64^k, 64^(k+1)) ticks, in the slot of bits [6k, 6k+6) of
+    // their due tick. Tasks due beyond the top level wait in it and are placed again when it
+    // cascades.
+    const uint64_t max_delta = (uint64_t{1} << (kSlotBits * kNumLevels)) - 1;
+    expires_tick = std::min(expires_tick, m_current_tick + max_delta);
+    const uint64_t delta = expires_tick - m_current_tick;
+    int level = 0;
+    while (level < kNumLevels - 1 && delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    const uint64_t slot = (expires_tick >> (kSlotBits * level)) & (kNumSlots - 1);
+    std::vector<Task*>& tasks = m_levels[level].slots[slot];
+    task->expires_tick = expires_tick;
+    task->level = level;
+    task->slot = slot;
+    task->slot_index = tasks.size();
+    tasks.push_back(task);
+    m_levels[level].occupied |= uint64_t{1} << slot;
+}
+
+void PeriodicScheduler::Remove(Task* task) {
+    if (task->in_ready) {
+        (task->ready_prev ? task->ready_prev->ready_next : m_ready_head) = task->ready_next;
+        (task->ready_next ? task->ready_next->ready_prev : m_ready_tail) = task->ready_prev;
+        task->ready_prev = task->ready_next = nullptr;
+        task->in_ready = false;
+    }
+    if (task->level < 0) return;
+    Level& level = m_levels[task->level];
+    std::vector<Task*>& tasks = level.slots[task->slot];
+    tasks.back()->slot_index = task->slot_index;
+    tasks[task->slot_index] = tasks.back();
+    tasks.pop_back();
+    if (tasks.empty()) level.occupied &= ~(uint64_t{1} << task->slot);
+    task->level = -1;
+}
+
+PeriodicScheduler::Task* PeriodicScheduler::PopReady() {
+    Task* task = m_ready_head;
+    if (task) Remove(task);
+    return task;
+}
+
+void PeriodicScheduler::EraseTask(Task* task) {
+    m_tasks.back()->task_index = task->task_index;
+    std::swap(m_tasks[task->task_index], m_tasks.back());
+    m_tasks.pop_back();
+}
+
+uint64_t PeriodicScheduler::NextEventTick() const {
+    // The next event of a level is when its first occupied slot after the current one is reached:
+    // tasks in level 0 are then due, and tasks in higher levels cascade to lower ones.
+    uint64_t next = kNoEvent;
+    for (int k = 0; k < kNumLevels; ++k) {
+        const uint64_t occupied = m_levels[k].occupied;
+        if (!occupied) continue;
+        const int shift = kSlotBits * k;
+        const uint64_t current_slot = (m_current_tick >> shift) & (kNumSlots - 1);
+        // Rotate so that bit 0 is the slot after the current one.
+        const uint64_t first = (current_slot + 1) & (kNumSlots - 1);
+        const uint64_t rotated =
+            (occupied >> first) | (first ? occupied << (kNumSlots - first) : 0);
+        const uint64_t distance = CountTrailingZeros(rotated) + 1;
+        next = std::min(next, ((m_current_tick >> shift) + distance) << shift);
+    }
+    return next;
+}
+
+void PeriodicScheduler::ExpireSlot(Level* level, uint64_t slot) {
+    std::vector<Task*> tasks;
+    tasks.swap(level->slots[slot]);
+    level->occupied &= ~(uint64_t{1} << slot);
+    for (Task* task : tasks) {
+        task->level = -1;
+        Insert(task, task->expires_tick);
+    }
+}
+
+void PeriodicScheduler::AdvanceTo(uint64_t tick) {
+    while (m_current_tick < tick) {
+        m_current_tick = std::min(NextEventTick(), tick);
+        // Cascade the levels whose slot boundary was reached, from the top down, so tasks move
+        // through every level they belong to in this tick.
+        for (int k = kNumLevels - 1; k > 0; --k) {
+            const int shift = kSlotBits * k;
+            if (m_current_tick & ((uint64_t{1} << shift) - 1)) continue;
+            ExpireSlot(&m_levels[k], (m_current_tick >> shift) & (kNumSlots - 1));
+        }
+        ExpireSlot(&m_levels[0], m_current_tick & (kNumSlots - 1));
+    }
+}
+
+::bosdyn::common::Duration PeriodicScheduler::Jittered(::bosdyn::common::Duration delay,
+                                                       const PeriodicTaskOptions& options) {
+    if (options.jitter <= 0.0 || delay <= ::bosdyn::common::Duration::zero()) return delay;
+    std::uniform_real_distribution<double> factor(1.0 - options.jitter, 1.0 + options.jitter);
+    return std::chrono::duration_cast<::bosdyn::common::Duration>(delay * factor(m_random));
+}
+
+void PeriodicScheduler::Reschedule(Task* task, PeriodicTaskResult result) {
+    if (!task->active) return;
+    if (result == PeriodicTaskResult::kStop) {
+        task->active = false;
+        EraseTask(task);
+        return;
+    }
+    if (result == PeriodicTaskResult::kWaitForTrigger) {
+        task->waiting = true;
+        if (task->triggered) {
+            // The work completed while the step function was still running.
+            task->triggered = false;
+            Insert(task, m_current_tick);
+        } else if (task->options.deadline.count() && !task->deadline_reported) {
+            Insert(task, DueTick(task->options.deadline -
+                                 (std::chrono::steady_clock::now() - task->run_start)));
+        }
+        return;
+    }
+    task->waiting = false;
+
+    const PeriodicTaskOptions& options = task->options;
+    ::bosdyn::common::Duration delay(0);
+    if (result == PeriodicTaskResult::kSuccess) {
+        task->backoff = ::bosdyn::common::Duration(0);
+        delay = Jittered(options.period, options);
+    } else if (result == PeriodicTaskResult::kFailure) {
+        const auto max_backoff = options.max_backoff.count() ? options.max_backoff : options.period;
+        if (task->backoff.count() == 0) {
+            task->backoff = options.initial_backoff.count() ? options.initial_backoff
+                                                            : options.period;
+        } else {
+            task->backoff = std::chrono::duration_cast<::bosdyn::common::Duration>(
+                task->backoff * options.backoff_multiplier);
+        }
+        task->backoff = std::min(task->backoff, max_backoff);
+        delay = Jittered(task->backoff, options);
+    }
+    // Delays count from the start of the run, so slow runs do not stretch the period.
+    delay -= std::chrono::steady_clock::now() - task->run_start;
+    if (task->triggered) {
+        task->triggered = false;
+        delay = ::bosdyn::common::Duration(0);
+    }
+    Insert(task, DueTick(delay));
+}
+
+void PeriodicScheduler::RunThread() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_shutdown) {
+        AdvanceTo(NowTick());
+        Task* task = PopReady();
+        if (!task) {
+            const uint64_t next = NextEventTick();
+            if (next == kNoEvent) {
+                m_cv.wait(lock);
+            } else {
+                m_cv.wait_until(lock, TickTime(next));
+            }
+            continue;
+        }
+
+        // Keep the task alive while its step runs, even if it is cancelled meanwhile.
+        std::shared_ptr<Task> keep = task->shared_from_this();
+        task->running = true;
+        task->running_thread = std::this_thread::get_id();
+        const auto now = std::chrono::steady_clock::now();
+        bool deadline_exceeded = false;
+        if (!task->waiting) {
+            task->run_start = now;
+            task->deadline_reported = false;
+        } else if (!task->deadline_reported && task->options.deadline.count() &&
+                   now - task->run_start >= task->options.deadline) {
+            deadline_exceeded = true;
+            task->deadline_reported = true;
+        }
+
+        lock.unlock();
+        const PeriodicTaskResult result = task->step(deadline_exceeded);
+        lock.lock();
+
+        task->running = false;
+        Reschedule(task, result);
+        // Wake Cancel() calls waiting for this run, and threads sleeping past a new due time.
+        m_cv.notify_all();
+    }
+}
+
+void PeriodicScheduler::Cancel(const std::shared_ptr<Task>& task) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (task->active) {
+        task->active = false;
+        Remove(task.get());
+        EraseTask(task.get());
+    }
+    // A step function cancelling its own task cannot wait for itself.
+    m_cv.wait(lock, [&task]() {
+        return !task->running || task->running_thread == std::this_thread::get_id();
+    });
+}
+
+void PeriodicScheduler::Trigger(const std::shared_ptr<Task>& task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!task->active || task->in_ready) return;
+        if (task->running) {
+            task->triggered = true;
+            return;
+        }
+        // Run a task waiting for its next period or its deadline now. A task waiting for a
+        // trigger and nothing else is in neither the wheel nor the ready list.
+        Remove(task.get());
+        Insert(task.get(), m_current_tick);
+    }
+    m_cv.notify_all();
+}
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bosdyn/common/time.h"
+
+namespace bosdyn {
+
+namespace client {
+
+// Outcome of one call of the step function of a periodic task.
+enum class PeriodicTaskResult {
+    // The run succeeded. The next run starts one period after the start of this one.
+    kSuccess,
+    // The run failed. The next run starts after the current backoff, which then grows.
+    kFailure,
+    // Run again as soon as possible, without changing the backoff.
+    kRetry,
+    // The run started asynchronous work, e.g. an RPC on a MessagePump, that has not completed
+    // yet. The task is not rescheduled until Trigger() is called, typically from the completion
+    // callback of that work, and the step function is then called again to finish the run.
+    kWaitForTrigger,
+    // Do not run the task again.
+    kStop,
+};
+
+struct PeriodicTaskOptions {
+    // Time between the starts of successful runs.
+    ::bosdyn::common::Duration period = std::chrono::seconds(1);
+    // Delay before the first run.
+    ::bosdyn::common::Duration initial_delay = std::chrono::seconds(0);
+    // Each delay is scaled by a random factor in [1 - jitter, 1 + jitter], so that tasks started
+    // together, e.g. for many robots at once, spread out over time.
+    double jitter = 0.0;
+    // Delay after the first of consecutive failed runs, multiplied by backoff_multiplier after
+    // each further failure up to max_backoff. Zero durations mean the period.
+    ::bosdyn::common::Duration initial_backoff = std::chrono::seconds(0);
+    double backoff_multiplier = 1.0;
+    ::bosdyn::common::Duration max_backoff = std::chrono::seconds(0);
+    // If a run is still waiting for a trigger this long after it started, the step function is
+    // called once with deadline_exceeded set. Zero means no deadline.
+    ::bosdyn::common::Duration deadline = std::chrono::seconds(0);
+};
+
+// Step function of a periodic task. It is called when the task is due, and then again on each
+// Trigger() while it returns kWaitForTrigger. A task never runs concurrently with itself, so the
+// step function can keep the state of a waiting run, such as a PeriodicTaskRpc, in its object.
+// Step functions share the few threads of the scheduler and must not block.
+typedef std::function<PeriodicTaskResult(bool deadline_exceeded)> PeriodicTaskFn;
+
+class PeriodicScheduler;
+
+// Handle to a task of a PeriodicScheduler. The task is cancelled when the handle is destroyed.
+class PeriodicTaskHandle {
+ public:
+    PeriodicTaskHandle() = default;
+    ~PeriodicTaskHandle() { Cancel(); }
+
+    PeriodicTaskHandle(PeriodicTaskHandle&& other) = default;
+    PeriodicTaskHandle& operator=(PeriodicTaskHandle&& other);
+    PeriodicTaskHandle(const PeriodicTaskHandle&) = delete;
+    PeriodicTaskHandle& operator=(const PeriodicTaskHandle&) = delete;
+
+    // Stop the task. Once this returns, the step function is not running and will not be called
+    // again, unless this is called from the step function itself.
+    void Cancel();
+
+    // Run the task as soon as possible, or right after the run in progress completes. A run waiting
+    // for a trigger resumes, and is not restarted.
+    void Trigger();
+
+    // Change the period, starting with the next run.
+    void SetPeriod(::bosdyn::common::Duration period);
+
+    // Return true until the task is cancelled or its step function returns kStop.
+    bool IsActive() const;
+
+ private:
+    friend class PeriodicScheduler;
+    struct Task;
+
+    std::shared_ptr<PeriodicScheduler> m_scheduler;
+    std::shared_ptr<Task> m_task;
+};
+
+// Runs the periodic tasks of many objects, such as keepalives and refresh loops, on a fixed number
+// of threads, so the number of threads does not grow with the number of tasks or robots.
+//
+// Due times are kept in a hierarchical timer wheel with millisecond ticks: 64-slot levels that
+// each cover 64 times the range of the level below. Tasks that are due wait in an intrusive FIFO
+// list, so scheduling and cancelling a task are O(1), and the threads sleep until the next
+// occupied slot rather than waking every tick.
+class PeriodicScheduler : public std::enable_shared_from_this<PeriodicScheduler> {
+ public:
+    // Start a scheduler running step functions on num_threads threads.
+    explicit PeriodicScheduler(size_t num_threads = 2);
+    ~PeriodicScheduler();
+
+    PeriodicScheduler(const PeriodicScheduler&) = delete;
+    PeriodicScheduler& operator=(const PeriodicScheduler&) = delete;
+
+    // Return the scheduler shared by the whole process, creating it on first use.
+    static std::shared_ptr<PeriodicScheduler> GetDefault();
+
+    // Add a task. It runs until the returned handle is cancelled or destroyed, or its step
+    // function returns kStop.
+    PeriodicTaskHandle Schedule(PeriodicTaskFn step, const PeriodicTaskOptions& options);
+
+    // As above, but store the handle in *handle before the task first runs, so the step function
+    // and the callbacks of the work it starts can use it. Any task in *handle is cancelled.
+    void Schedule(PeriodicTaskFn step, const PeriodicTaskOptions& options,
+                  PeriodicTaskHandle* handle);
+
+    size_t NumTasks() const;
+    size_t NumThreads() const { return m_threads.size(); }
+
+ private:
+    friend class PeriodicTaskHandle;
+    typedef PeriodicTaskHandle::Task Task;
+
+    static constexpr int kSlotBits = 6;
+    static constexpr uint64_t kNumSlots = uint64_t{1} << kSlotBits;
+    static constexpr int kNumLevels = 5;
+
+    struct Level {
+        std::array<std::vector<Task*>, kNumSlots> slots;
+        // Bit i is set if slot i is not empty.
+        uint64_t occupied = 0;
+    };
+
+    uint64_t NowTick() const;
+    std::chrono::steady_clock::time_point TickTime(uint64_t tick) const;
+    // Return the tick at which a delay starting now ends.
+    uint64_t DueTick(::bosdyn::common::Duration delay) const;
+
+    // Wheel, ready list and task list operations. All of these require m_mutex.
+    void Insert(Task* task, uint64_t expires_tick);
+    void Remove(Task* task);
+    Task* PopReady();
+    void EraseTask(Task* task);
+    void AdvanceTo(uint64_t tick);
+    void ExpireSlot(Level* level, uint64_t slot);
+    uint64_t NextEventTick() const;
+    // Schedule the next run of a task after a run finished with the given result.
+    void Reschedule(Task* task, PeriodicTaskResult result);
+    ::bosdyn::common::Duration Jittered(::bosdyn::common::Duration delay,
+                                        const PeriodicTaskOptions& options);
+
+    void RunThread();
+    void Cancel(const std::shared_ptr<Task>& task);
+    void Trigger(const std::shared_ptr<Task>& task);
+
+    const std::chrono::steady_clock::time_point m_start;
+    mutable std::mutex m_mutex;
+    // Notified when tasks become ready, when the next due time moves earlier, and when a run
+    // completes.
+    std::condition_variable m_cv;
+    bool m_shutdown = false;
+    uint64_t m_current_tick = 0;
+    std::array<Level, kNumLevels> m_levels;
+    // Tasks that are due, in order, linked through their ready_prev and ready_next fields.
+    Task* m_ready_head = nullptr;
+    Task* m_ready_tail = nullptr;
+    // Active tasks. Each task holds its index, so it can be removed by swapping with the last.
+    std::vector<std::shared_ptr<Task>> m_tasks;
+    std::minstd_rand m_random;
+    std::vector<std::thread> m_threads;
+};
+
+/**
+ * An RPC started by the step function of a periodic task, whose completion callback triggers the
+ * task. The step function starts it, returns kWaitForTrigger until Ready(), and then takes the
+ * result:
+ *
+ *     if (!m_rpc.InFlight()) {
+ *         m_rpc.Start(&m_task, [&](FooCallback on_complete) {
+ *             return m_client->FooAsync(request, RPCParameters(), std::move(on_complete));
+ *         });
+ *     }
+ *     if (!m_rpc.Ready()) return PeriodicTaskResult::kWaitForTrigger;
+ *     FooResultType result = m_rpc.Take();
+ *
+ * The owner must Wait() for the RPC in flight after cancelling the task and before it is
+ * destroyed.
+ */
+template <class ResultType>
+class PeriodicTaskRpc {
+ public:
+    PeriodicTaskRpc() = default;
+    PeriodicTaskRpc(const PeriodicTaskRpc&) = delete;
+    PeriodicTaskRpc& operator=(const PeriodicTaskRpc&) = delete;
+
+    // Start the RPC through an Async method overload that takes a completion callback. start_rpc
+    // is called with the callback to pass to it, and returns the future it returns.
+    template <class StartRpcFunction>
+    void Start(PeriodicTaskHandle* task, const StartRpcFunction& start_rpc) {
+        m_completed = false;
+        m_future = start_rpc([this, task](const ResultType&) {
+            m_completed = true;
+            task->Trigger();
+        });
+    }
+
+    // Return true from Start() until Take().
+    bool InFlight() const { return m_future.valid(); }
+
+    // Return true once the result can be taken. The client does not call the callback if the RPC
+    // cannot be started, so a future that is already set also counts.
+    bool Ready() const {
+        return m_future.valid() &&
+               (m_completed || m_future.wait_for(std::chrono::seconds(0)) ==
+                                   std::future_status::ready);
+    }
+
+    // Return the result once Ready(). The callback runs just before the future is set, so this may
+    // wait for the MessagePump thread to set it.
+    ResultType Take() {
+        std::shared_future<ResultType> future = std::move(m_future);
+        m_future = std::shared_future<ResultType>();
+        return future.get();
+    }
+
+    // Wait for the RPC in flight, if any, including its completion callback.
+    void Wait() const {
+        if (m_future.valid()) m_future.wait();
+    }
+
+    // Drop the RPC, if any, without its result. Wait() for it first if it may still be in flight.
+    void Reset() { m_future = std::shared_future<ResultType>(); }
+
+ private:
+    std::shared_future<ResultType> m_future;
+    std::atomic<bool> m_completed{false};
+};
+
+}  // namespace client
+
+}  // namespace bosdyn
@@ -13,6 +13,7 @@
 #include <google/protobuf/any.pb.h>
 
 #include <chrono>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -28,20 +29,36 @@ void PrepareResponseHeader(const ::bosdyn::api::RequestHeader& request_header,
     SetTimestamp(NowNsec(), out_header->mutable_request_received_timestamp());
     out_header->mutable_request_header()->CopyFrom(request_header);
     if (reflected_request) {
+        const google::protobuf::Descriptor* descriptor = reflected_request->GetDescriptor();
+        const strip_messages::StripFunction strip_function =
+            strip_messages::FindStripFunction(descriptor);
+        if (!strip_function) {
+            // Nothing to strip, so pack the request directly instead of packing a copy.
+            out_header->mutable_request()->PackFrom(*reflected_request);
+            return;
+        }
         std::unique_ptr<google::protobuf::Message> copy(reflected_request->New());
-        copy->CopyFrom(*reflected_request);
-        StripLargeByteFields(copy.get());
+        const auto* stripped_fields =
+            strip_messages::FindStrippedFields(descriptor, strip_function);
+        if (stripped_fields) {
+            // Copy the request without its large bytes fields, rather than copying all of it and
+            // then clearing them.
+            strip_messages::CopyWithoutStrippedFields(*reflected_request, *stripped_fields,
+                                                      copy.get());
+        } else {
+            copy->CopyFrom(*reflected_request);
+            strip_function(copy.get());
+        }
         out_header->mutable_request()->PackFrom(*copy);
     }
 }
 
 void StripLargeByteFields(::google::protobuf::Message* proto_message) {
     // Operates on Request and Response messages.
-    const std::string& message_type = proto_message->GetTypeName();
-    const auto& whitelist_map = ::bosdyn::common::strip_messages::kWhitelistedBytesFieldsMap;
-    auto strip_message_func = whitelist_map.find(message_type);
-    if (strip_message_func != whitelist_map.end()) {
-        strip_message_func->second(proto_message);
+    const strip_messages::StripFunction strip_function =
+        strip_messages::FindStripFunction(proto_message->GetDescriptor());
+    if (strip_function) {
+        strip_function(proto_message);
     }
 }
 
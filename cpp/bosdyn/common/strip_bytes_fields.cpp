@@ -9,8 +9,16 @@
 
 #include "strip_bytes_fields.h"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+
+#include "bosdyn/common/assert_precondition.h"
 
 namespace bosdyn {
 
@@ -33,8 +41,313 @@ std::map<std::string, bool (&)(google::protobuf::Message*)> kWhitelistedBytesFie
     {"bosdyn.api.StoreDataRequest", StripStoreDataRequest},
 };
 
+namespace {
+
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::Message;
+using ::google::protobuf::Reflection;
+
+// Fields cleared by a built-in strip function from messages of its type.
+struct StripFunctionFields {
+    StripFunction strip_function;
+    std::vector<StrippedField> fields;
+};
+typedef std::unordered_map<const Descriptor*, StripFunctionFields> StrippedFieldsMap;
+
+// kWhitelistedBytesFieldsMap resolved to the descriptors of the generated message types, so
+// looking up the strip function of a message does not build or compare type name strings.
+struct StripFunctionCache {
+    // Size of kWhitelistedBytesFieldsMap when the cache was built. Adding or removing entries
+    // changes it, which makes the cache stale.
+    size_t map_size;
+    std::unordered_map<const Descriptor*, StripFunction> strip_functions;
+};
+
+// Current cache, or null if it has to be built. Only a pointer is loaded for a lookup, so
+// lookups never take a lock.
+std::atomic<const StripFunctionCache*> g_strip_function_cache{nullptr};
+
+// A concurrent lookup may still read a cache after it is replaced, so replaced caches are kept
+// until exit. kWhitelistedBytesFieldsMap is rarely changed after startup.
+std::mutex& strip_function_cache_mutex() {
+    static std::mutex ret;
+    return ret;
+}
+
+std::vector<std::unique_ptr<StripFunctionCache>>& strip_function_caches() {
+    static std::vector<std::unique_ptr<StripFunctionCache>> ret;
+    return ret;
+}
+
+const StripFunctionCache* BuildStripFunctionCache() {
+    std::lock_guard<std::mutex> lock(strip_function_cache_mutex());
+    const StripFunctionCache* cache = g_strip_function_cache.load(std::memory_order_acquire);
+    if (cache && cache->map_size == kWhitelistedBytesFieldsMap.size()) return cache;
+
+    auto new_cache = std::make_unique<StripFunctionCache>();
+    new_cache->map_size = kWhitelistedBytesFieldsMap.size();
+    const auto* pool = ::google::protobuf::DescriptorPool::generated_pool();
+    for (const auto& entry : kWhitelistedBytesFieldsMap) {
+        const Descriptor* descriptor = pool->FindMessageTypeByName(entry.first);
+        if (descriptor) new_cache->strip_functions[descriptor] = &entry.second;
+    }
+    strip_function_caches().push_back(std::move(new_cache));
+    cache = strip_function_caches().back().get();
+    g_strip_function_cache.store(cache, std::memory_order_release);
+    return cache;
+}
+
+// Returns proto_message as a T if it is a generated T, and nullptr otherwise. Every generated
+// message of a type shares one Reflection, so comparing it is what protobuf itself does in place
+// of a dynamic_cast.
+template <class T>
+T* CastToGenerated(Message* proto_message) {
+    if (proto_message->GetReflection() != T::default_instance().GetReflection()) return nullptr;
+    return static_cast<T*>(proto_message);
+}
+
+// Adds the field at the dot-separated path of field names below descriptor to the tree of
+// stripped fields.
+void AddStrippedFieldPath(const Descriptor* descriptor, const std::string& path,
+                          std::vector<StrippedField>* stripped_fields) {
+    std::istringstream path_stream(path);
+    std::string field_name;
+    while (std::getline(path_stream, field_name, '.')) {
+        const FieldDescriptor* field =
+            descriptor ? descriptor->FindFieldByName(field_name) : nullptr;
+        BOSDYN_ASSERT_PRECONDITION(field != nullptr, "Unknown field \"%s\" in path \"%s\"",
+                                   field_name.c_str(), path.c_str());
+        if (!field) return;
+
+        auto node =
+            std::find_if(stripped_fields->begin(), stripped_fields->end(),
+                         [field](const StrippedField& other) { return other.field == field; });
+        if (node == stripped_fields->end()) {
+            stripped_fields->push_back({field, {}});
+            node = stripped_fields->end() - 1;
+        }
+        descriptor = field->message_type();
+        stripped_fields = &node->children;
+    }
+}
+
+StrippedFieldsMap BuildStrippedFieldsMap() {
+    struct StripFunctionPath {
+        StripFunction strip_function;
+        const Descriptor* descriptor;
+        // Dot-separated path to the large bytes field. Repeated message fields along a path are
+        // stripped in each of their messages.
+        const char* path;
+    };
+    // The fields each built-in strip function clears, so the functions can be applied while
+    // copying a message. Which message types are stripped is up to kWhitelistedBytesFieldsMap.
+    const std::vector<StripFunctionPath> paths = {
+        {StripGetImageResponse, ::bosdyn::api::GetImageResponse::descriptor(),
+         "image_responses.shot.image.data"},
+        {StripLocalGridResponse, ::bosdyn::api::GetLocalGridsResponse::descriptor(),
+         "local_grid_responses.local_grid.data"},
+        {StripPointCloudResponse, ::bosdyn::api::GetPointCloudResponse::descriptor(),
+         "point_cloud_responses.point_cloud.data"},
+        {StripUploadWaypointRequest,
+         ::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest::descriptor(), "chunk.data"},
+        {StripUploadEdgeRequest, ::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest::descriptor(),
+         "chunk.data"},
+        {StripUploadSnapshotsRequest,
+         ::bosdyn::api::graph_nav::UploadSnapshotsRequest::descriptor(), "chunk.data"},
+        {StripDownloadWaypointResponse,
+         ::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse::descriptor(), "chunk.data"},
+        {StripDownloadEdgeResponse,
+         ::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse::descriptor(), "chunk.data"},
+        {StripRecordDataBlobsRequest, ::bosdyn::api::RecordDataBlobsRequest::descriptor(),
+         "blob_data.data"},
+        {StripRecordSignalTickRequest, ::bosdyn::api::RecordSignalTicksRequest::descriptor(),
+         "tick_data.data"},
+        {StripStoreImageRequest, ::bosdyn::api::StoreImageRequest::descriptor(),
+         "image.image.data"},
+        {StripStoreDataRequest, ::bosdyn::api::StoreDataRequest::descriptor(), "data"},
+    };
+
+    StrippedFieldsMap stripped_fields_map;
+    for (const auto& path : paths) {
+        StripFunctionFields& entry = stripped_fields_map[path.descriptor];
+        entry.strip_function = path.strip_function;
+        AddStrippedFieldPath(path.descriptor, path.path, &entry.fields);
+    }
+    return stripped_fields_map;
+}
+
+const StrippedField* FindStrippedField(const std::vector<StrippedField>& stripped_fields,
+                                       const FieldDescriptor* field) {
+    // The trees are tiny, so a linear search is fastest.
+    for (const auto& stripped_field : stripped_fields) {
+        if (stripped_field.field == field) return &stripped_field;
+    }
+    return nullptr;
+}
+
+// Copies one set field from source to destination through reflection. Repeated fields are
+// appended to the destination field.
+void CopyField(const Message& source, const FieldDescriptor* field, Message* destination) {
+    const Reflection* from = source.GetReflection();
+    const Reflection* to = destination->GetReflection();
+    if (field->is_repeated()) {
+        const int size = from->FieldSize(source, field);
+        for (int i = 0; i < size; i++) {
+            switch (field->cpp_type()) {
+                case FieldDescriptor::CPPTYPE_INT32:
+                    to->AddInt32(destination, field, from->GetRepeatedInt32(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_INT64:
+                    to->AddInt64(destination, field, from->GetRepeatedInt64(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_UINT32:
+                    to->AddUInt32(destination, field, from->GetRepeatedUInt32(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_UINT64:
+                    to->AddUInt64(destination, field, from->GetRepeatedUInt64(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_DOUBLE:
+                    to->AddDouble(destination, field, from->GetRepeatedDouble(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_FLOAT:
+                    to->AddFloat(destination, field, from->GetRepeatedFloat(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_BOOL:
+                    to->AddBool(destination, field, from->GetRepeatedBool(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_ENUM:
+                    to->AddEnumValue(destination, field,
+                                     from->GetRepeatedEnumValue(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_STRING:
+                    to->AddString(destination, field, from->GetRepeatedString(source, field, i));
+                    break;
+                case FieldDescriptor::CPPTYPE_MESSAGE:
+                    to->AddMessage(destination, field)
+                        ->CopyFrom(from->GetRepeatedMessage(source, field, i));
+                    break;
+            }
+        }
+        return;
+    }
+
+    switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_INT32:
+            to->SetInt32(destination, field, from->GetInt32(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_INT64:
+            to->SetInt64(destination, field, from->GetInt64(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_UINT32:
+            to->SetUInt32(destination, field, from->GetUInt32(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_UINT64:
+            to->SetUInt64(destination, field, from->GetUInt64(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            to->SetDouble(destination, field, from->GetDouble(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            to->SetFloat(destination, field, from->GetFloat(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_BOOL:
+            to->SetBool(destination, field, from->GetBool(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+            to->SetEnumValue(destination, field, from->GetEnumValue(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_STRING:
+            to->SetString(destination, field, from->GetString(source, field));
+            break;
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+            to->MutableMessage(destination, field)->CopyFrom(from->GetMessage(source, field));
+            break;
+    }
+}
+
+}  // namespace
+
+StripFunction FindStripFunction(const Descriptor* descriptor) {
+    const StripFunctionCache* cache = g_strip_function_cache.load(std::memory_order_acquire);
+    if (!cache || cache->map_size != kWhitelistedBytesFieldsMap.size()) {
+        cache = BuildStripFunctionCache();
+    }
+    auto strip_function = cache->strip_functions.find(descriptor);
+    if (strip_function != cache->strip_functions.end()) return strip_function->second;
+    if (descriptor->file()->pool() == ::google::protobuf::DescriptorPool::generated_pool()) {
+        return nullptr;
+    }
+    // Types from other pools, e.g. of dynamic messages, are not in the cache.
+    auto by_name = kWhitelistedBytesFieldsMap.find(descriptor->full_name());
+    if (by_name == kWhitelistedBytesFieldsMap.end()) return nullptr;
+    return &by_name->second;
+}
+
+void ResetStripFunctionCache() { g_strip_function_cache.store(nullptr, std::memory_order_release); }
+
+const std::vector<StrippedField>* FindStrippedFields(const Descriptor* descriptor,
+                                                     StripFunction strip_function) {
+    static const StrippedFieldsMap kStrippedFieldsMap = BuildStrippedFieldsMap();
+    auto stripped_fields = kStrippedFieldsMap.find(descriptor);
+    if (stripped_fields == kStrippedFieldsMap.end() ||
+        stripped_fields->second.strip_function != strip_function) {
+        return nullptr;
+    }
+    return &stripped_fields->second.fields;
+}
+
+void CopyWithoutStrippedFields(const Message& source,
+                               const std::vector<StrippedField>& stripped_fields,
+                               Message* destination) {
+    const Reflection* from = source.GetReflection();
+    const Reflection* to = destination->GetReflection();
+    std::vector<const FieldDescriptor*> fields;
+    from->ListFields(source, &fields);
+    for (const FieldDescriptor* field : fields) {
+        const StrippedField* stripped_field = FindStrippedField(stripped_fields, field);
+        if (!stripped_field) {
+            CopyField(source, field, destination);
+        } else if (stripped_field->children.empty()) {
+            // The stripped bytes field itself, which is left cleared.
+            continue;
+        } else if (field->is_repeated()) {
+            const int size = from->FieldSize(source, field);
+            for (int i = 0; i < size; i++) {
+                CopyWithoutStrippedFields(from->GetRepeatedMessage(source, field, i),
+                                          stripped_field->children,
+                                          to->AddMessage(destination, field));
+            }
+        } else {
+            CopyWithoutStrippedFields(from->GetMessage(source, field), stripped_field->children,
+                                      to->MutableMessage(destination, field));
+        }
+    }
+    to->MutableUnknownFields(destination)->MergeFrom(from->GetUnknownFields(source));
+}
+
+void ClearStrippedFields(const std::vector<StrippedField>& stripped_fields,
+                         Message* proto_message) {
+    const Reflection* reflection = proto_message->GetReflection();
+    for (const StrippedField& stripped_field : stripped_fields) {
+        const FieldDescriptor* field = stripped_field.field;
+        if (stripped_field.children.empty()) {
+            reflection->ClearField(proto_message, field);
+        } else if (field->is_repeated()) {
+            const int size = reflection->FieldSize(*proto_message, field);
+            for (int i = 0; i < size; i++) {
+                ClearStrippedFields(stripped_field.children,
+                                    reflection->MutableRepeatedMessage(proto_message, field, i));
+            }
+        } else if (reflection->HasField(*proto_message, field)) {
+            ClearStrippedFields(stripped_field.children,
+                                reflection->MutableMessage(proto_message, field));
+        }
+    }
+}
+
 bool StripGetImageResponse(::google::protobuf::Message* proto_message) {
-    if (auto* image_message = dynamic_cast<::bosdyn::api::GetImageResponse*>(proto_message)) {
+    if (auto* image_message = CastToGenerated<::bosdyn::api::GetImageResponse>(proto_message)) {
         for (int i = 0; i < image_message->image_responses_size(); i++) {
             image_message->mutable_image_responses(i)
                 ->mutable_shot()
@@ -47,7 +360,7 @@ bool StripGetImageResponse(::google::protobuf::Message* proto_message) {
 }
 
 bool StripLocalGridResponse(::google::protobuf::Message* proto_message) {
-    if (auto* grid_message = dynamic_cast<::bosdyn::api::GetLocalGridsResponse*>(proto_message)) {
+    if (auto* grid_message = CastToGenerated<::bosdyn::api::GetLocalGridsResponse>(proto_message)) {
         for (int i = 0; i < grid_message->local_grid_responses_size(); i++) {
             grid_message->mutable_local_grid_responses(i)->mutable_local_grid()->clear_data();
         }
@@ -57,7 +370,7 @@ bool StripLocalGridResponse(::google::protobuf::Message* proto_message) {
 }
 
 bool StripPointCloudResponse(::google::protobuf::Message* proto_message) {
-    if (auto* pc_message = dynamic_cast<::bosdyn::api::GetPointCloudResponse*>(proto_message)) {
+    if (auto* pc_message = CastToGenerated<::bosdyn::api::GetPointCloudResponse>(proto_message)) {
         for (int i = 0; i < pc_message->point_cloud_responses_size(); i++) {
             pc_message->mutable_point_cloud_responses(i)->mutable_point_cloud()->clear_data();
         }
@@ -69,7 +382,8 @@ bool StripPointCloudResponse(::google::protobuf::Message* proto_message) {
 
 bool StripUploadWaypointRequest(::google::protobuf::Message* proto_message) {
     if (auto* upload_msg =
-            dynamic_cast<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest*>(proto_message)) {
+            CastToGenerated<::bosdyn::api::graph_nav::UploadWaypointSnapshotRequest>(
+                proto_message)) {
         upload_msg->mutable_chunk()->clear_data();
         return true;
     }
@@ -78,7 +392,7 @@ bool StripUploadWaypointRequest(::google::protobuf::Message* proto_message) {
 
 bool StripUploadEdgeRequest(::google::protobuf::Message* proto_message) {
     if (auto* upload_msg =
-            dynamic_cast<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest*>(proto_message)) {
+            CastToGenerated<::bosdyn::api::graph_nav::UploadEdgeSnapshotRequest>(proto_message)) {
         upload_msg->mutable_chunk()->clear_data();
         return true;
     }
@@ -87,7 +401,7 @@ bool StripUploadEdgeRequest(::google::protobuf::Message* proto_message) {
 
 bool StripUploadSnapshotsRequest(::google::protobuf::Message* proto_message) {
     if (auto* upload_msg =
-            dynamic_cast<::bosdyn::api::graph_nav::UploadSnapshotsRequest*>(proto_message)) {
+            CastToGenerated<::bosdyn::api::graph_nav::UploadSnapshotsRequest>(proto_message)) {
         upload_msg->mutable_chunk()->clear_data();
         return true;
     }
@@ -96,7 +410,7 @@ bool StripUploadSnapshotsRequest(::google::protobuf::Message* proto_message) {
 
 bool StripDownloadWaypointResponse(::google::protobuf::Message* proto_message) {
     if (auto* download_msg =
-            dynamic_cast<::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse*>(
+            CastToGenerated<::bosdyn::api::graph_nav::DownloadWaypointSnapshotResponse>(
                 proto_message)) {
         download_msg->mutable_chunk()->clear_data();
         return true;
@@ -106,7 +420,8 @@ bool StripDownloadWaypointResponse(::google::protobuf::Message* proto_message) {
 
 bool StripDownloadEdgeResponse(::google::protobuf::Message* proto_message) {
     if (auto* download_msg =
-            dynamic_cast<::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse*>(proto_message)) {
+            CastToGenerated<::bosdyn::api::graph_nav::DownloadEdgeSnapshotResponse>(
+                proto_message)) {
         download_msg->mutable_chunk()->clear_data();
         return true;
     }
@@ -114,7 +429,7 @@ bool StripDownloadEdgeResponse(::google::protobuf::Message* proto_message) {
 }
 
 bool StripRecordDataBlobsRequest(::google::protobuf::Message* proto_message) {
-    if (auto* req_msg = dynamic_cast<::bosdyn::api::RecordDataBlobsRequest*>(proto_message)) {
+    if (auto* req_msg = CastToGenerated<::bosdyn::api::RecordDataBlobsRequest>(proto_message)) {
         for (int i = 0; i < req_msg->blob_data_size(); i++) {
             req_msg->mutable_blob_data(i)->clear_data();
         }
@@ -124,7 +439,7 @@ bool StripRecordDataBlobsRequest(::google::protobuf::Message* proto_message) {
 }
 
 bool StripRecordSignalTickRequest(::google::protobuf::Message* proto_message) {
-    if (auto* req_msg = dynamic_cast<::bosdyn::api::RecordSignalTicksRequest*>(proto_message)) {
+    if (auto* req_msg = CastToGenerated<::bosdyn::api::RecordSignalTicksRequest>(proto_message)) {
         for (int i = 0; i < req_msg->tick_data_size(); i++) {
             req_msg->mutable_tick_data(i)->clear_data();
         }
@@ -135,7 +450,7 @@ bool StripRecordSignalTickRequest(::google::protobuf::Message* proto_message) {
 
 
 bool StripStoreImageRequest(::google::protobuf::Message* proto_message) {
-    if (auto* req_msg = dynamic_cast<::bosdyn::api::StoreImageRequest*>(proto_message)) {
+    if (auto* req_msg = CastToGenerated<::bosdyn::api::StoreImageRequest>(proto_message)) {
         req_msg->mutable_image()->mutable_image()->clear_data();
         return true;
     }
@@ -143,7 +458,7 @@ bool StripStoreImageRequest(::google::protobuf::Message* proto_message) {
 }
 
 bool StripStoreDataRequest(::google::protobuf::Message* proto_message) {
-    if (auto* req_msg = dynamic_cast<::bosdyn::api::StoreDataRequest*>(proto_message)) {
+    if (auto* req_msg = CastToGenerated<::bosdyn::api::StoreDataRequest>(proto_message)) {
         req_msg->clear_data();
         return true;
     }
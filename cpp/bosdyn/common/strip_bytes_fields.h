@@ -15,6 +15,9 @@
 #include <bosdyn/api/graph_nav/graph_nav.pb.h>
 #include <bosdyn/api/graph_nav/nav.pb.h>
 #include <functional>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace bosdyn {
 
@@ -22,6 +25,56 @@ namespace common {
 
 namespace strip_messages {
 
+/**
+ * Node in the tree of large fields to strip from one message type. A node without children is a
+ * bytes field that gets cleared. Otherwise, the node is a message field, singular or repeated, and
+ * its children are stripped from each of its messages.
+ */
+struct StrippedField {
+    const google::protobuf::FieldDescriptor* field;
+    std::vector<StrippedField> children;
+};
+
+typedef bool (*StripFunction)(google::protobuf::Message*);
+
+/**
+ * Returns the function that kWhitelistedBytesFieldsMap maps the type of the descriptor to, or
+ * nullptr if the message type has no whitelisted bytes fields. The map is resolved to descriptor
+ * pointers once and cached, so the lookup does not compare type names. Adding or removing map
+ * entries rebuilds the cache on the next lookup.
+ */
+StripFunction FindStripFunction(const google::protobuf::Descriptor* descriptor);
+
+/**
+ * Rebuilds the cache of FindStripFunction on its next lookup. Only needed after replacing an
+ * entry of kWhitelistedBytesFieldsMap without changing its size.
+ */
+void ResetStripFunctionCache();
+
+/**
+ * Returns the fields that strip_function clears from messages with the given descriptor, if it is
+ * one of the Strip functions below and the descriptor is that of its message type, or nullptr
+ * otherwise, e.g. for functions added to kWhitelistedBytesFieldsMap at runtime. Those have to be
+ * called on a copy of the message instead.
+ */
+const std::vector<StrippedField>* FindStrippedFields(const google::protobuf::Descriptor* descriptor,
+                                                     StripFunction strip_function);
+
+/**
+ * Copies source into the empty message destination, leaving out the given stripped fields. The
+ * result is the same as copying the whole message and stripping the copy, without ever copying
+ * the large fields.
+ */
+void CopyWithoutStrippedFields(const google::protobuf::Message& source,
+                               const std::vector<StrippedField>& stripped_fields,
+                               google::protobuf::Message* destination);
+
+/**
+ * Clears the given stripped fields from proto_message in place.
+ */
+void ClearStrippedFields(const std::vector<StrippedField>& stripped_fields,
+                         google::protobuf::Message* proto_message);
+
 /**
  * Creates a map linking a protobuf message type (string) to the specific function
  * which will remove large fields that should not be added in the grpc logs or copied
@@ -30,9 +83,9 @@ namespace strip_messages {
 extern std::map<std::string, bool (&)(google::protobuf::Message*)> kWhitelistedBytesFieldsMap;
 
 /**
- * Message-specific helper functions that perform a dynamic cast to convert the
- * generic protobuf message into a specific type of message and remove the bytes
- * fields (or other large) fields from that message.
+ * Message-specific helper functions that convert the generic protobuf message into a specific
+ * type of message, if it is a generated message of that type, and remove the bytes fields (or
+ * other large) fields from that message.
  */
 bool StripGetImageResponse(::google::protobuf::Message* proto_message);
 bool StripLocalGridResponse(::google::protobuf::Message* proto_message);
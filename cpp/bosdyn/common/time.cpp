@@ -16,8 +16,8 @@
 #include <chrono>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <string>
+#include <vector>
 
 #include "bosdyn/common/numbers.h"
 
@@ -32,10 +32,22 @@ namespace {
         ::std::chrono::system_clock::now().time_since_epoch());
 }
 
-std::shared_ptr<ClockFn>& clock_fn() {
+// Clock function set by SetClock(), or null to read the system clock directly. Only a pointer is
+// loaded on every NowNsec() call, so reading the clock never takes a lock.
+std::atomic<const ClockFn*> g_clock_override{nullptr};
+
+// Clock functions passed to SetClock(). A concurrent NowNsec() may still be calling a clock after
+// it is replaced, so they are kept until exit. SetClock() is meant for tests and simulation, and
+// is called rarely.
+std::mutex& clock_mutex() {
     // Using a static _local_ variable here avoids the static initialization order fiasco.
     // See https://isocpp.org/wiki/faq/ctors#static-init-order-on-first-use.
-    static auto ret = std::make_shared<ClockFn>(_default_clock_fn);
+    static std::mutex ret;
+    return ret;
+}
+
+std::vector<std::unique_ptr<ClockFn>>& clock_fns() {
+    static std::vector<std::unique_ptr<ClockFn>> ret;
     return ret;
 }
 
@@ -45,15 +57,17 @@ using TimeUtil = google::protobuf::util::TimeUtil;
 
 /// Set a clock function which overrides default functionality of NowNsec.
 void SetClock(const ClockFn& fn) {
-    auto fn_shared = std::make_shared<ClockFn>(fn);
-    std::atomic_store_explicit(&clock_fn(), fn_shared, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(clock_mutex());
+    clock_fns().push_back(std::make_unique<ClockFn>(fn));
+    g_clock_override.store(clock_fns().back().get(), std::memory_order_release);
 }
 
-void RestoreDefaultClock() { SetClock(_default_clock_fn); }
+void RestoreDefaultClock() { g_clock_override.store(nullptr, std::memory_order_release); }
 
 std::chrono::nanoseconds NsecSinceEpoch() {
-    auto fn_shared = std::atomic_load_explicit(&clock_fn(), std::memory_order_acquire);
-    return (*fn_shared)();
+    const ClockFn* clock_override = g_clock_override.load(std::memory_order_acquire);
+    if (clock_override) return (*clock_override)();
+    return _default_clock_fn();
 }
 
 std::chrono::seconds SecSinceEpoch() {
@@ -79,26 +93,6 @@ int64_t NowNsecWall() { return _default_clock_fn().count(); }
     return TimeUtil::NanosecondsToTimestamp(nanos.count());
 }
 
-void SetTimestamp(int64_t nsec, ::google::protobuf::Timestamp* timestamp) {
-    const int64_t seconds = nsec / kBillion;
-    const int64_t nsec_remainder = (nsec - kBillion * seconds);
-    timestamp->set_seconds(seconds);
-    timestamp->set_nanos(nsec_remainder);
-}
-
-void SetTimestamp(const std::chrono::nanoseconds& nsec, ::google::protobuf::Timestamp* timestamp) {
-    SetTimestamp(nsec.count(), timestamp);
-}
-
-int64_t TimestampToNsec(const ::google::protobuf::Timestamp& timestamp) {
-    return TimeUtil::TimestampToNanoseconds(timestamp);
-}
-
-std::chrono::nanoseconds TimestampToNanosecondsSinceEpoch(
-    const ::google::protobuf::Timestamp& timestamp) {
-    return std::chrono::nanoseconds(TimestampToNsec(timestamp));
-}
-
 std::string TimestampToDateString(const ::google::protobuf::Timestamp& timestamp) {
     return TimeUtil::ToString(timestamp);
 }
@@ -107,24 +101,12 @@ std::string NsecToDateString(const std::chrono::nanoseconds& nsec) {
     return TimestampToDateString(Timestamp(nsec));
 }
 
-void SetDuration(int64_t nsec, ::google::protobuf::Duration* duration) {
-    const int64_t seconds = nsec / kBillion;
-    const int64_t nsec_remainder = (nsec - kBillion * seconds);
-    duration->set_seconds(seconds);
-    duration->set_nanos(nsec_remainder);
-}
-
 void SetDurationSinceTimestamp(const ::google::protobuf::Timestamp& timestamp,
                                ::google::protobuf::Duration* duration) {
     int64_t delta_nsec = NowNsec() - TimestampToNsec(timestamp);
     SetDuration(delta_nsec, duration);
 }
 
-int64_t DurationToNsec(const ::google::protobuf::Duration& duration) {
-    const int64_t seconds = duration.seconds();
-    return (seconds * kBillion) + duration.nanos();
-}
-
 double DurationToSec(const ::google::protobuf::Duration& duration) {
     const int64_t seconds = duration.seconds();
     return seconds + static_cast<double>(duration.nanos()) / kBillion;
@@ -17,6 +17,7 @@
 #include <functional>
 #include <string>
 
+#include "bosdyn/common/numbers.h"
 
 #ifdef _WIN32
 #    define CONVERT_DURATION_FOR_GRPC(tp) std::chrono::duration_cast<std::chrono::microseconds>(tp)
@@ -57,21 +58,45 @@ void SetClock(const ClockFn& fn);
 /// Restore default implementation of NowNsec.
 void RestoreDefaultClock();
 
+// The conversions between nanoseconds and Timestamp/Duration protos below run on every request,
+// so they are inline and do not go through TimeUtil and its validity checks.
+
+/// Split nanoseconds into whole seconds and the nanoseconds remainder, both with the sign of nsec.
+constexpr int64_t NsecToWholeSeconds(int64_t nsec) { return nsec / kBillion; }
+constexpr int32_t NsecToNanosRemainder(int64_t nsec) {
+    return static_cast<int32_t>(nsec - kBillion * (nsec / kBillion));
+}
+
+/// Combine whole seconds and nanoseconds into nanoseconds.
+constexpr int64_t SecondsAndNanosToNsec(int64_t seconds, int32_t nanos) {
+    return seconds * kBillion + nanos;
+}
+
 /// Set a Timestamp proto from nanoseconds since the UNIX epoch.
-void SetTimestamp(int64_t nsec, ::google::protobuf::Timestamp* timestamp);
+inline void SetTimestamp(int64_t nsec, ::google::protobuf::Timestamp* timestamp) {
+    timestamp->set_seconds(NsecToWholeSeconds(nsec));
+    timestamp->set_nanos(NsecToNanosRemainder(nsec));
+}
 
 /// Set a Timestamp proto from nanoseconds since the UNIX epoch.
-void SetTimestamp(const std::chrono::nanoseconds& nsec, ::google::protobuf::Timestamp* timestamp);
+inline void SetTimestamp(const std::chrono::nanoseconds& nsec,
+                         ::google::protobuf::Timestamp* timestamp) {
+    SetTimestamp(nsec.count(), timestamp);
+}
 
 /// Return a protobuf timestamp for a chrono nanoseconds time.
 ::google::protobuf::Timestamp Timestamp(const std::chrono::nanoseconds& nsec);
 
 /// Given a Timestamp proto, return from nanoseconds since the UNIX epoch as an int64_t.
-int64_t TimestampToNsec(const ::google::protobuf::Timestamp& timestamp);
+inline int64_t TimestampToNsec(const ::google::protobuf::Timestamp& timestamp) {
+    return SecondsAndNanosToNsec(timestamp.seconds(), timestamp.nanos());
+}
 
 /// Given a Timestamp proto, return duration since the UNIX epoch as std::chrono::nanoseconds.
-std::chrono::nanoseconds TimestampToNanosecondsSinceEpoch(
-    const ::google::protobuf::Timestamp& timestamp);
+inline std::chrono::nanoseconds TimestampToNanosecondsSinceEpoch(
+    const ::google::protobuf::Timestamp& timestamp) {
+    return std::chrono::nanoseconds(TimestampToNsec(timestamp));
+}
 
 /// Given a Timestamp proto, return as string in RFC 3339 format
 std::string TimestampToDateString(const ::google::protobuf::Timestamp& timestamp);
@@ -80,14 +105,19 @@ std::string TimestampToDateString(const ::google::protobuf::Timestamp& timestamp
 std::string NsecToDateString(const std::chrono::nanoseconds& nsec);
 
 /// Set a Duration proto from nanoseconds since the UNIX epoch.
-void SetDuration(int64_t nsec, ::google::protobuf::Duration* duration);
+inline void SetDuration(int64_t nsec, ::google::protobuf::Duration* duration) {
+    duration->set_seconds(NsecToWholeSeconds(nsec));
+    duration->set_nanos(NsecToNanosRemainder(nsec));
+}
 
 /// Set a Duration proto from nanoseconds since the timestamp.
 void SetDurationSinceTimestamp(const ::google::protobuf::Timestamp& timestamp,
                                ::google::protobuf::Duration* duration);
 
 /// Convert a duration to nanoseconds.
-int64_t DurationToNsec(const ::google::protobuf::Duration& duration);
+inline int64_t DurationToNsec(const ::google::protobuf::Duration& duration) {
+    return SecondsAndNanosToNsec(duration.seconds(), duration.nanos());
+}
 
 /// Convert a duration to seconds.
 double DurationToSec(const ::google::protobuf::Duration& duration);
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace bosdyn {
+
+namespace common {
+
+// Wait-free hand-off of the latest value from one writer thread to one reader thread.
+//
+// The writer fills WriteBuffer() and calls Publish(); the reader calls Update() and then reads
+// ReadBuffer(). Neither side ever blocks or copies: the three buffers are swapped by index, so the
+// reader always sees a complete value, and values published between two Update() calls are
+// skipped. Each side must only be used from one thread at a time.
+template <class T>
+class TripleBuffer {
+ public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial_value)
+        : m_buffers{initial_value, initial_value, initial_value} {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side. The write buffer holds an older value, not necessarily the last one published.
+    T& WriteBuffer() { return m_buffers[m_write_index]; }
+
+    // Make the write buffer the latest value, and get a new write buffer.
+    void Publish() {
+        m_write_index =
+            m_middle.exchange(m_write_index | kNewValueBit, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Reader side. Switch the read buffer to the latest published value, if any. Returns false if
+    // nothing was published since the last call.
+    bool Update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & kNewValueBit)) return false;
+        m_read_index = m_middle.exchange(m_read_index, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& ReadBuffer() const { return m_buffers[m_read_index]; }
+    T& ReadBuffer() { return m_buffers[m_read_index]; }
+
+ private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kNewValueBit = 0x4;
+
+    T m_buffers[3];
+
+    // Index of the buffer that is neither being written nor read, and whether it holds a value the
+    // reader has not seen yet. The indices of the two sides are on their own cache lines.
+    alignas(64) std::atomic<uint8_t> m_middle{1};
+    alignas(64) uint8_t m_write_index = 0;
+    alignas(64) uint8_t m_read_index = 2;
+};
+
+}  // namespace common
+
+}  // namespace bosdyn
@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "compiled_frame_tree.h"
+
+#include "bosdyn/math/api_common_frames.h"
+#include "bosdyn/math/proto_math.h"
+
+namespace bosdyn {
+
+namespace api {
+
+namespace {
+
+enum VisitState { kUnvisited = 0, kOnStack = 1, kDone = 2 };
+
+// Parent id of a frame whose parent frame name is not in the snapshot.
+constexpr int kUnknownParentId = -2;
+
+Eigen::Matrix<double, 3, 3> SkewFromEigen(const Eigen::Vector3d& v) {
+    Eigen::Matrix<double, 3, 3> skew;
+    skew << 0.0, -v.z(), v.y(), v.z(), 0.0, -v.x(), -v.y(), v.x(), 0.0;
+    return skew;
+}
+
+}  // namespace
+
+CompiledFrameTree::CompiledFrameTree(const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot) {
+    Compile(frame_tree_snapshot);
+}
+
+void CompiledFrameTree::Clear() {
+    m_frame_ids.clear();
+    m_frame_names.clear();
+    m_parent_ids.clear();
+    m_parent_tform_frame.clear();
+    m_root_tform_frame.clear();
+    m_root_id = kInvalidFrameId;
+}
+
+ValidateFrameTreeSnapshotStatus CompiledFrameTree::Compile(
+    const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot) {
+    Clear();
+    m_status = ValidateFrameTreeSnapshotStatus::VALID;
+    const auto& child_to_parent_edge_map = frame_tree_snapshot.child_to_parent_edge_map();
+    if (child_to_parent_edge_map.empty()) {
+        m_status = ValidateFrameTreeSnapshotStatus::EMPTY;
+        return m_status;
+    }
+
+    // Intern all child frame names first, so parents can be resolved regardless of map order.
+    const size_t num_frames = child_to_parent_edge_map.size();
+    m_frame_ids.reserve(num_frames);
+    m_frame_names.reserve(num_frames);
+    for (const auto& key_value_pair : child_to_parent_edge_map) {
+        m_frame_ids.emplace(key_value_pair.first, static_cast<int>(m_frame_names.size()));
+        m_frame_names.push_back(key_value_pair.first);
+    }
+
+    // Resolve parent ids and convert each edge to Eigen once. Parents that are not in the map are
+    // only reported when a walk reaches them, so errors come out in the same order as
+    // ValidateFrameTreeSnapshot().
+    m_parent_ids.resize(num_frames, kInvalidFrameId);
+    m_parent_tform_frame.resize(num_frames, Eigen::Isometry3d::Identity());
+    m_root_tform_frame.resize(num_frames, Eigen::Isometry3d::Identity());
+    for (size_t frame_id = 0; frame_id < num_frames; ++frame_id) {
+        const auto& parent_edge = child_to_parent_edge_map.at(m_frame_names[frame_id]);
+        const std::string& parent_frame_name = parent_edge.parent_frame_name();
+        if (parent_frame_name.empty()) {
+            continue;
+        }
+        auto it = m_frame_ids.find(parent_frame_name);
+        m_parent_ids[frame_id] = it == m_frame_ids.end() ? kUnknownParentId : it->second;
+        m_parent_tform_frame[frame_id] = EigenFromApiProto(parent_edge.parent_tform_child());
+    }
+
+    // Walk each frame, in map order, up towards the root until reaching a frame whose
+    // root_tform_frame is already known, then accumulate transforms back down the walked path.
+    // Every frame is visited once, so compiling is linear in the number of frames. The checks on
+    // each walk run in the order FindTreeRoot() runs them, so a snapshot with several defects
+    // reports the same one ValidateFrameTreeSnapshot() does.
+    m_visit_state.assign(num_frames, kUnvisited);
+    for (size_t frame_id = 0;
+         m_status == ValidateFrameTreeSnapshotStatus::VALID && frame_id < num_frames; ++frame_id) {
+        if (m_frame_names[frame_id].empty()) {
+            m_status = ValidateFrameTreeSnapshotStatus::EMPTY_CHILD_FRAME_NAME;
+            break;
+        }
+        m_stack.clear();
+        int cur_id = static_cast<int>(frame_id);
+        while (cur_id >= 0 && m_visit_state[cur_id] == kUnvisited) {
+            m_visit_state[cur_id] = kOnStack;
+            m_stack.push_back(cur_id);
+            cur_id = m_parent_ids[cur_id];
+        }
+        if (cur_id == kUnknownParentId) {
+            m_status = ValidateFrameTreeSnapshotStatus::UNKNOWN_PARENT_FRAME_NAME;
+            break;
+        }
+        if (cur_id != kInvalidFrameId && m_visit_state[cur_id] == kOnStack) {
+            m_status = ValidateFrameTreeSnapshotStatus::CYCLE;
+            break;
+        }
+        if (cur_id == kInvalidFrameId) {
+            // The last frame on the stack is a root.
+            const int root_id = m_stack.back();
+            m_stack.pop_back();
+            m_visit_state[root_id] = kDone;
+            m_root_tform_frame[root_id] = Eigen::Isometry3d::Identity();
+            if (m_root_id == kInvalidFrameId) {
+                m_root_id = root_id;
+            } else if (m_root_id != root_id) {
+                m_status = ValidateFrameTreeSnapshotStatus::DISJOINT;
+                break;
+            }
+        }
+        while (!m_stack.empty()) {
+            const int child_id = m_stack.back();
+            m_stack.pop_back();
+            m_root_tform_frame[child_id] =
+                m_root_tform_frame[m_parent_ids[child_id]] * m_parent_tform_frame[child_id];
+            m_visit_state[child_id] = kDone;
+        }
+    }
+
+    if (m_status != ValidateFrameTreeSnapshotStatus::VALID) {
+        Clear();
+    }
+    return m_status;
+}
+
+int CompiledFrameTree::FrameId(const std::string& frame_name) const {
+    auto it = m_frame_ids.find(frame_name);
+    if (it == m_frame_ids.end()) {
+        return kInvalidFrameId;
+    }
+    return it->second;
+}
+
+bool CompiledFrameTree::a_tform_b(int frame_a_id, int frame_b_id,
+                                  Eigen::Isometry3d* out_a_tform_b) const {
+    const int num_frames = static_cast<int>(m_frame_names.size());
+    if (frame_a_id < 0 || frame_a_id >= num_frames || frame_b_id < 0 ||
+        frame_b_id >= num_frames) {
+        return false;
+    }
+    if (out_a_tform_b) {
+        *out_a_tform_b =
+            m_root_tform_frame[frame_a_id].inverse(Eigen::Isometry) * m_root_tform_frame[frame_b_id];
+    }
+    return true;
+}
+
+bool CompiledFrameTree::get_a_tform_b(const std::string& frame_a, const std::string& frame_b,
+                                      Eigen::Isometry3d* out_a_tform_b) const {
+    return a_tform_b(FrameId(frame_a), FrameId(frame_b), out_a_tform_b);
+}
+
+bool CompiledFrameTree::get_a_tform_b(const std::string& frame_a, const std::string& frame_b,
+                                      ::bosdyn::api::SE3Pose* out_a_tform_b) const {
+    Eigen::Isometry3d a_tform_b_eigen;
+    if (!get_a_tform_b(frame_a, frame_b, &a_tform_b_eigen)) {
+        return false;
+    }
+    if (out_a_tform_b) {
+        *out_a_tform_b = EigenToApiProto(a_tform_b_eigen);
+    }
+    return true;
+}
+
+bool CompiledFrameTree::get_a_tform_b(const std::string& se2_frame_a,
+                                      const std::string& se2_frame_b,
+                                      ::bosdyn::api::SE2Pose* out_a_tform_b) const {
+    ::bosdyn::api::SE3Pose se3_a_tform_b;
+    if (!get_a_tform_b(::bosdyn::api::SE2StringToClosestSE3String(se2_frame_a),
+                       ::bosdyn::api::SE2StringToClosestSE3String(se2_frame_b), &se3_a_tform_b)) {
+        return false;
+    }
+    if (!SafeFlatten(se3_a_tform_b, se2_frame_a, out_a_tform_b)) {
+        out_a_tform_b->Clear();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledFrameTree::ExpressVelocityInNewFrame(
+    int frame_b_id, int frame_c_id, const Eigen::Matrix<double, 6, 1>& vel_of_a_in_b,
+    Eigen::Matrix<double, 6, 1>* output_vel_of_a_in_c) const {
+    Eigen::Isometry3d c_tform_b;
+    if (!a_tform_b(frame_c_id, frame_b_id, &c_tform_b)) {
+        return false;
+    }
+    // Same adjoint as Adjoint(const SE3Pose&), applied blockwise to avoid forming the 6x6 matrix.
+    const Eigen::Matrix<double, 3, 3> c_R_b = c_tform_b.linear();
+    const Eigen::Vector3d linear = vel_of_a_in_b.head<3>();
+    const Eigen::Vector3d angular = vel_of_a_in_b.tail<3>();
+    const Eigen::Vector3d angular_in_c = c_R_b * angular;
+    output_vel_of_a_in_c->head<3>() =
+        c_R_b * linear + SkewFromEigen(c_tform_b.translation()) * angular_in_c;
+    output_vel_of_a_in_c->tail<3>() = angular_in_c;
+    return true;
+}
+
+bool CompiledFrameTree::ExpressVelocityInNewFrame(
+    const std::string& frame_b, const std::string& frame_c,
+    const ::bosdyn::api::SE3Velocity& vel_of_a_in_b,
+    ::bosdyn::api::SE3Velocity* output_vel_of_a_in_c) const {
+    Eigen::Matrix<double, 6, 1> vel_of_a_in_c;
+    if (!ExpressVelocityInNewFrame(FrameId(frame_b), FrameId(frame_c),
+                                   EigenFromApiProto(vel_of_a_in_b), &vel_of_a_in_c)) {
+        return false;
+    }
+    output_vel_of_a_in_c->CopyFrom(EigenToApiProto(vel_of_a_in_c));
+    return true;
+}
+
+bool CompiledFrameTree::ExpressVelocityInNewFrame(
+    const std::string& se2_frame_b, const std::string& se2_frame_c,
+    const ::bosdyn::api::SE2Velocity& vel_of_a_in_b,
+    ::bosdyn::api::SE2Velocity* output_vel_of_a_in_c) const {
+    ::bosdyn::api::SE2Pose se2_c_tform_b;
+    if (!get_a_tform_b(se2_frame_c, se2_frame_b, &se2_c_tform_b)) {
+        return false;
+    }
+    auto c_adjoint_b = Adjoint(se2_c_tform_b);
+    output_vel_of_a_in_c->CopyFrom(TransformVelocity(c_adjoint_b, vel_of_a_in_b));
+    return true;
+}
+
+}  // namespace api
+
+}  // namespace bosdyn
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+#include <bosdyn/api/geometry.pb.h>
+#include "bosdyn/math/frame_helpers.h"
+
+namespace bosdyn {
+
+namespace api {
+
+// A FrameTreeSnapshot that has been validated once and flattened into arrays indexed by an
+// interned integer frame id. Every frame's root_tform_frame is computed at compile time, so
+// repeated transform queries against the same snapshot only cost one lookup per frame name and
+// one Isometry3d product, without revalidating the tree or allocating temporary edge lists.
+//
+// The free functions in frame_helpers.h remain the simplest option for one-off queries. Use this
+// class when the same snapshot answers many queries, e.g. resolving every camera and gripper
+// transform for a single robot state.
+class CompiledFrameTree {
+ public:
+    // Id returned by FrameId() for frames that are not in the tree.
+    static constexpr int kInvalidFrameId = -1;
+
+    CompiledFrameTree() = default;
+    explicit CompiledFrameTree(const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot);
+
+    // Validate and compile the given snapshot, replacing any previously compiled tree. The flat
+    // per-frame arrays keep their capacity between calls.
+    // Returns the same status ValidateFrameTreeSnapshot() would return for the snapshot. If the
+    // status is not VALID, the tree is left empty and every query fails.
+    ValidateFrameTreeSnapshotStatus Compile(
+        const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot);
+
+    // Status of the last Compile() call. Default constructed trees are EMPTY.
+    ValidateFrameTreeSnapshotStatus status() const { return m_status; }
+    bool IsValid() const { return m_status == ValidateFrameTreeSnapshotStatus::VALID; }
+
+    // Number of frames in the compiled tree, and the name of the frame with the given id.
+    size_t NumFrames() const { return m_frame_names.size(); }
+    const std::string& FrameName(int frame_id) const { return m_frame_names[frame_id]; }
+
+    // Id of the given frame name, or kInvalidFrameId if the frame is not in the tree. Ids are
+    // stable for the lifetime of a compiled tree and can be cached by the caller to skip the
+    // name lookup on subsequent queries.
+    int FrameId(const std::string& frame_name) const;
+    bool IsFrameInTree(const std::string& frame_name) const {
+        return FrameId(frame_name) != kInvalidFrameId;
+    }
+
+    // Id of the root of the tree, or kInvalidFrameId if the tree is not valid.
+    int RootFrameId() const { return m_root_id; }
+
+    // Transform from the root of the tree to the given frame.
+    const Eigen::Isometry3d& root_tform_frame(int frame_id) const {
+        return m_root_tform_frame[frame_id];
+    }
+
+    // Transform between the frames with the given ids. Returns false if either id is invalid.
+    bool a_tform_b(int frame_a_id, int frame_b_id, Eigen::Isometry3d* out_a_tform_b) const;
+
+    // Same as the free functions of the same name in frame_helpers.h, without revalidating the
+    // snapshot on each call.
+    bool get_a_tform_b(const std::string& frame_a, const std::string& frame_b,
+                       Eigen::Isometry3d* out_a_tform_b) const;
+    bool get_a_tform_b(const std::string& frame_a, const std::string& frame_b,
+                       ::bosdyn::api::SE3Pose* out_a_tform_b) const;
+    bool get_a_tform_b(const std::string& se2_frame_a, const std::string& se2_frame_b,
+                       ::bosdyn::api::SE2Pose* out_a_tform_b) const;
+
+    bool ExpressVelocityInNewFrame(int frame_b_id, int frame_c_id,
+                                   const Eigen::Matrix<double, 6, 1>& vel_of_a_in_b,
+                                   Eigen::Matrix<double, 6, 1>* output_vel_of_a_in_c) const;
+    bool ExpressVelocityInNewFrame(const std::string& frame_b, const std::string& frame_c,
+                                   const ::bosdyn::api::SE3Velocity& vel_of_a_in_b,
+                                   ::bosdyn::api::SE3Velocity* output_vel_of_a_in_c) const;
+    bool ExpressVelocityInNewFrame(const std::string& se2_frame_b, const std::string& se2_frame_c,
+                                   const ::bosdyn::api::SE2Velocity& vel_of_a_in_b,
+                                   ::bosdyn::api::SE2Velocity* output_vel_of_a_in_c) const;
+
+ private:
+    void Clear();
+
+    ValidateFrameTreeSnapshotStatus m_status = ValidateFrameTreeSnapshotStatus::EMPTY;
+
+    // Interned frame names. Indices into the vectors below are frame ids.
+    std::unordered_map<std::string, int> m_frame_ids;
+    std::vector<std::string> m_frame_names;
+
+    // Parent id of each frame; kInvalidFrameId for the root.
+    std::vector<int> m_parent_ids;
+
+    // parent_tform_child of each frame's edge, and the accumulated root_tform_frame.
+    std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d>>
+        m_parent_tform_frame;
+    std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d>> m_root_tform_frame;
+
+    // Scratch space used while compiling.
+    std::vector<int> m_visit_state;
+    std::vector<int> m_stack;
+
+    int m_root_id = kInvalidFrameId;
+};
+
+}  // namespace api
+
+}  // namespace bosdyn
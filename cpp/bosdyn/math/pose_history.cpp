@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#include "pose_history.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bosdyn {
+
+namespace api {
+namespace math {
+
+PlainSE3Pose PlainSE3Pose::FromProto(const ::bosdyn::api::SE3Pose& pose) {
+    PlainSE3Pose plain_pose;
+    plain_pose.position[0] = pose.position().x();
+    plain_pose.position[1] = pose.position().y();
+    plain_pose.position[2] = pose.position().z();
+    plain_pose.rotation[0] = pose.rotation().w();
+    plain_pose.rotation[1] = pose.rotation().x();
+    plain_pose.rotation[2] = pose.rotation().y();
+    plain_pose.rotation[3] = pose.rotation().z();
+    return plain_pose;
+}
+
+void PlainSE3Pose::ToProto(::bosdyn::api::SE3Pose* pose) const {
+    pose->mutable_position()->set_x(position[0]);
+    pose->mutable_position()->set_y(position[1]);
+    pose->mutable_position()->set_z(position[2]);
+    pose->mutable_rotation()->set_w(rotation[0]);
+    pose->mutable_rotation()->set_x(rotation[1]);
+    pose->mutable_rotation()->set_y(rotation[2]);
+    pose->mutable_rotation()->set_z(rotation[3]);
+}
+
+PlainSE3Pose Interp(const PlainSE3Pose& a, const PlainSE3Pose& b, double t) {
+    PlainSE3Pose result;
+    // The fixed-size loops below have no branches, so they can be vectorized.
+    for (int i = 0; i < 3; ++i) {
+        result.position[i] = a.position[i] * (1.0 - t) + b.position[i] * t;
+    }
+
+    // Same slerp as for Quaternion protos: take the shorter path by flipping b if needed, and fall
+    // back to a normalized lerp when the rotations are nearly identical.
+    double dot = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        dot += a.rotation[i] * b.rotation[i];
+    }
+    const double sign = dot < 0.0 ? -1.0 : 1.0;
+    dot *= sign;
+
+    const double DOT_THRESHOLD = 1.0 - 1e-4;
+    double s0;
+    double s1;
+    if (dot > DOT_THRESHOLD) {
+        s0 = 1.0 - t;
+        s1 = t;
+    } else {
+        const double theta_0 = acos(dot);
+        const double theta = theta_0 * t;
+        const double sin_theta = sin(theta);
+        s0 = cos(theta) - dot * sin_theta / sin(theta_0);
+        s1 = sin_theta / sin(theta_0);
+    }
+    s1 *= sign;
+
+    double norm_sq = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        result.rotation[i] = s0 * a.rotation[i] + s1 * b.rotation[i];
+        norm_sq += result.rotation[i] * result.rotation[i];
+    }
+    if (dot > DOT_THRESHOLD) {
+        const double inv_norm = 1.0 / sqrt(norm_sq);
+        for (int i = 0; i < 4; ++i) {
+            result.rotation[i] *= inv_norm;
+        }
+    }
+    return result;
+}
+
+PoseHistory::PoseHistory(size_t capacity)
+    : m_timestamps(std::max<size_t>(capacity, 1)), m_poses(std::max<size_t>(capacity, 1)) {}
+
+void PoseHistory::Clear() {
+    m_start = 0;
+    m_size = 0;
+}
+
+bool PoseHistory::MaybeAddPose(int64_t timestamp, const PlainSE3Pose& pose) {
+    // Only accept monotonically increasing timestamps.
+    if (m_size > 0 && this->timestamp(m_size - 1) >= timestamp) {
+        return false;
+    }
+
+    if (m_size < capacity()) {
+        ++m_size;
+    } else {
+        // Overwrite the oldest sample.
+        m_start = PhysicalIndex(1);
+    }
+    const size_t index = PhysicalIndex(m_size - 1);
+    m_timestamps[index] = timestamp;
+    m_poses[index] = pose;
+    return true;
+}
+
+bool PoseHistory::MaybeAddPose(int64_t timestamp, const ::bosdyn::api::SE3Pose& pose) {
+    return MaybeAddPose(timestamp, PlainSE3Pose::FromProto(pose));
+}
+
+size_t PoseHistory::LowerBound(int64_t timestamp, size_t first) const {
+    size_t count = m_size - first;
+    while (count > 0) {
+        const size_t step = count / 2;
+        const size_t middle = first + step;
+        if (this->timestamp(middle) < timestamp) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+PoseLookupResult PoseHistory::LookupAt(size_t greatest, int64_t timestamp,
+                                       PlainSE3Pose* out) const {
+    if (m_size == 0) {
+        return PoseLookupResult::EMPTY_BUFFER;
+    }
+
+    // Everything was older than the query. Return the newest.
+    if (greatest == m_size) {
+        *out = pose(m_size - 1);
+        return PoseLookupResult::CLAMPED_TOO_NEW;
+    }
+
+    // We found an exact match for the pose.
+    const int64_t greatest_timestamp = this->timestamp(greatest);
+    if (greatest_timestamp == timestamp) {
+        *out = pose(greatest);
+        return PoseLookupResult::EXACT;
+    }
+
+    // The query was too old and overran the buffer.
+    if (greatest == 0) {
+        *out = pose(0);
+        return PoseLookupResult::CLAMPED_TOO_OLD;
+    }
+
+    // Now, we know we're between two poses.
+    const int64_t least_timestamp = this->timestamp(greatest - 1);
+    const double t = static_cast<double>(timestamp - least_timestamp) /
+                     static_cast<double>(greatest_timestamp - least_timestamp);
+    *out = Interp(pose(greatest - 1), pose(greatest), t);
+    return PoseLookupResult::INTERPOLATED;
+}
+
+PoseLookupResult PoseHistory::Lookup(int64_t timestamp, PlainSE3Pose* out) const {
+    return LookupAt(LowerBound(timestamp, 0), timestamp, out);
+}
+
+PoseLookupResult PoseHistory::Lookup(int64_t timestamp, ::bosdyn::api::SE3Pose* out) const {
+    PlainSE3Pose plain_pose;
+    PoseLookupResult result = Lookup(timestamp, &plain_pose);
+    if (result != PoseLookupResult::EMPTY_BUFFER) {
+        plain_pose.ToProto(out);
+    }
+    return result;
+}
+
+void PoseHistory::Lookup(const std::vector<int64_t>& timestamps, std::vector<PlainSE3Pose>* out,
+                         std::vector<PoseLookupResult>* results) const {
+    out->resize(timestamps.size());
+    if (results) {
+        results->resize(timestamps.size());
+    }
+
+    // Merge the queries with the history. While the queries increase, the lower bound only moves
+    // forward from where the previous query left it.
+    size_t greatest = 0;
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        const int64_t timestamp = timestamps[i];
+        if (i > 0 && timestamp < timestamps[i - 1]) {
+            greatest = LowerBound(timestamp, 0);
+        } else {
+            while (greatest < m_size && this->timestamp(greatest) < timestamp) {
+                ++greatest;
+            }
+        }
+        PoseLookupResult result = LookupAt(greatest, timestamp, &(*out)[i]);
+        if (results) {
+            (*results)[i] = result;
+        }
+    }
+}
+
+}  // namespace math
+}  // namespace api
+
+}  // namespace bosdyn
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2023 Boston Dynamics, Inc.  All rights reserved.
+ *
+ * Downloading, reproducing, distributing or otherwise using the SDK Software
+ * is subject to the terms and conditions of the Boston Dynamics Software
+ * Development Kit License (20191101-BDSDK-SL).
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bosdyn/math/pose_interpolation.h"
+
+namespace bosdyn {
+
+namespace api {
+namespace math {
+
+// SE3 pose stored as plain values, so it can be copied and interpolated without touching protobuf
+// or the heap.
+struct PlainSE3Pose {
+    // Position as x, y, z.
+    double position[3] = {0.0, 0.0, 0.0};
+    // Rotation quaternion as w, x, y, z.
+    double rotation[4] = {1.0, 0.0, 0.0, 0.0};
+
+    static PlainSE3Pose FromProto(const ::bosdyn::api::SE3Pose& pose);
+    void ToProto(::bosdyn::api::SE3Pose* pose) const;
+};
+
+// Interpolates between poses a and b at the given interpolation factor between 0 and 1, with the
+// same lerp/slerp as Interp() for SE3Pose protos.
+PlainSE3Pose Interp(const PlainSE3Pose& a, const PlainSE3Pose& b, double factor);
+
+// Fixed-capacity pose history for looking up poses by timestamp, e.g. aligning camera frames to
+// odometry.
+//
+// Compared to a PoseBuffer, samples are kept in a ring so adding a pose never moves the others,
+// poses are stored as PlainSE3Pose, and timestamps are kept in their own array so lookups are a
+// binary search over contiguous integers. Lookups return the same PoseLookupResult values as
+// Lookup() on a PoseBuffer.
+class PoseHistory {
+ public:
+    // The history holds at least one sample.
+    explicit PoseHistory(size_t capacity = 100);
+
+    // Add the given pose to the history. If the history is full, the oldest sample is dropped.
+    // Timestamps must be monotonically increasing. If this is not the case, the pose is not added
+    // and the function returns false.
+    bool MaybeAddPose(int64_t timestamp, const PlainSE3Pose& pose);
+    bool MaybeAddPose(int64_t timestamp, const ::bosdyn::api::SE3Pose& pose);
+
+    // Find the pose at the given timestamp in O(log n).
+    PoseLookupResult Lookup(int64_t timestamp, PlainSE3Pose* out) const;
+    PoseLookupResult Lookup(int64_t timestamp, ::bosdyn::api::SE3Pose* out) const;
+
+    // Find the poses at each of the given timestamps. When the timestamps are sorted in increasing
+    // order, all of them are resolved in a single pass over the history. Unsorted timestamps are
+    // still looked up correctly, at the cost of a binary search for each out-of-order timestamp.
+    // The output vectors are resized to the number of timestamps; results may be null.
+    void Lookup(const std::vector<int64_t>& timestamps, std::vector<PlainSE3Pose>* out,
+                std::vector<PoseLookupResult>* results) const;
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_timestamps.size(); }
+    bool empty() const { return m_size == 0; }
+    void Clear();
+
+    // Timestamp and pose of the i-th oldest sample, for i < size().
+    int64_t timestamp(size_t i) const { return m_timestamps[PhysicalIndex(i)]; }
+    const PlainSE3Pose& pose(size_t i) const { return m_poses[PhysicalIndex(i)]; }
+
+ private:
+    size_t PhysicalIndex(size_t i) const {
+        const size_t index = m_start + i;
+        return index < m_timestamps.size() ? index : index - m_timestamps.size();
+    }
+
+    // Index of the oldest sample with a timestamp greater than or equal to the given one, or
+    // size() if there is none.
+    size_t LowerBound(int64_t timestamp, size_t first) const;
+
+    // Resolve a lookup given the LowerBound index of the timestamp.
+    PoseLookupResult LookupAt(size_t greatest, int64_t timestamp, PlainSE3Pose* out) const;
+
+    std::vector<int64_t> m_timestamps;
+    std::vector<PlainSE3Pose> m_poses;
+    // Physical index of the oldest sample, and number of samples stored.
+    size_t m_start = 0;
+    size_t m_size = 0;
+};
+
+}  // namespace math
+}  // namespace api
+
+}  // namespace bosdyn
@@ -9,6 +9,8 @@
 
 #include "pose_interpolation.h"
 
+#include <algorithm>
+
 namespace bosdyn {
 
 namespace api {
@@ -77,19 +79,14 @@ PoseLookupResult Lookup(const PoseBuffer& buffer, int64_t timestamp, ::bosdyn::a
     if (buffer.empty()) {
         return PoseLookupResult::EMPTY_BUFFER;
     }
-    size_t greatest = 0;
-    size_t least = 0;
-
-    for (size_t i = 0; i < buffer.size(); i++) {
-        const auto& pose = buffer[i];
-        if (pose.timestamp <= timestamp) {
-            least = i;
-        }
-        if (pose.timestamp >= timestamp) {
-            greatest = i;
-            break;
-        }
-    }
+    // Binary search for the oldest pose that is not older than the query. The deque has
+    // constant-time random access and its timestamps are increasing.
+    const auto it = std::lower_bound(
+        buffer.begin(), buffer.end(), timestamp,
+        [](const TimedPose& pose, int64_t query) { return pose.timestamp < query; });
+    // If everything is older than the query, point at the newest pose.
+    const size_t greatest =
+        it == buffer.end() ? buffer.size() - 1 : static_cast<size_t>(it - buffer.begin());
 
     // We found an exact match for the pose.
     if (buffer.at(greatest).timestamp == timestamp) {
@@ -111,7 +108,7 @@ PoseLookupResult Lookup(const PoseBuffer& buffer, int64_t timestamp, ::bosdyn::a
     }
 
     // Now, we know we're between two poses.
-    *out = Interp(buffer.at(least), buffer.at(greatest), timestamp);
+    *out = Interp(buffer.at(greatest - 1), buffer.at(greatest), timestamp);
     return PoseLookupResult::INTERPOLATED;
 }
 
@@ -124,7 +121,7 @@ bool MaybeAddPose(int64_t timestamp, const ::bosdyn::api::SE3Pose& pose, PoseBuf
 
     buffer->push_back(TimedPose{timestamp, pose});
     if (buffer->size() > max_poses) {
-        buffer->erase(buffer->begin());
+        buffer->pop_front();
     }
     return true;
 }
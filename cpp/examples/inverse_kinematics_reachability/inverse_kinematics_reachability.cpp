@@ -273,31 +273,33 @@ void PrintResults(const std::vector<bool>& reachable_ik, const std::vector<bool>
             ::bosdyn::api::CreateVec3(x_rt_task[i], y_rt_task[i], 0.0)));
     }
 
-    // These arrays store the reachability results as determined by the IK responses
-    // (`reachable_ik`) or by trying to move to the desired tool pose (`reachable_cmd`).
-    std::vector<bool> reachable_ik;
-    std::vector<bool> reachable_cmd;
-    for (int i = 0; i < task_T_desired_tools.size(); ++i) {
-        // Query the IK service for the reachability of the desired tool pose.
-        // Construct the IK request for this reachability problem. Note that since
-        // `root_tform_scene` is unset, the "scene" frame is the same as the "root" frame in
-        // this case.
-
-        auto task_T_desired_tool = task_T_desired_tools[i];
+    // Query the IK service for the reachability of all of the desired tool poses at once.
+    // Construct the IK request for each reachability problem. Note that since `root_tform_scene`
+    // is unset, the "scene" frame is the same as the "root" frame in this case.
+    std::vector<::bosdyn::api::spot::InverseKinematicsRequest> ik_requests;
+    for (const auto& task_T_desired_tool : task_T_desired_tools) {
         ::bosdyn::api::spot::InverseKinematicsRequest ik_request;
         ik_request.set_root_frame_name(::bosdyn::api::kOdomFrame);
         *(ik_request.mutable_scene_tform_task()) = odom_T_task;
         *(ik_request.mutable_wrist_mounted_tool()->mutable_wrist_tform_tool()) = wr1_T_tool;
         *(ik_request.mutable_tool_pose_task()->mutable_task_tform_desired_tool()) =
             task_T_desired_tool;
+        ik_requests.push_back(ik_request);
+    }
 
-        // Note: we're not checking the return status of this request, because we expect some of
-        // the requests to fail. We'll add the results to a list and count the numbers of
-        // failures later.
-        ::bosdyn::client::InverseKinematicsResultType ik_result =
-            ik_client->InverseKinematics(ik_request);
+    // Note: we're not checking the return status of these requests, because we expect some of
+    // the requests to fail. We'll add the results to a list and count the numbers of failures
+    // later.
+    std::vector<::bosdyn::client::InverseKinematicsResultType> ik_results =
+        ik_client->InverseKinematicsBatch(ik_requests);
 
-        auto ik_response = ik_result.response;
+    // These arrays store the reachability results as determined by the IK responses
+    // (`reachable_ik`) or by trying to move to the desired tool pose (`reachable_cmd`).
+    std::vector<bool> reachable_ik;
+    std::vector<bool> reachable_cmd;
+    for (int i = 0; i < task_T_desired_tools.size(); ++i) {
+        const auto& task_T_desired_tool = task_T_desired_tools[i];
+        const auto& ik_response = ik_results[i].response;
         reachable_ik.push_back(ik_response.status() ==
                                ::bosdyn::api::spot::InverseKinematicsResponse::STATUS_OK);
 